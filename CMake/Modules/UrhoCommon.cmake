@@ -455,6 +455,12 @@ foreach (OPT
     endif ()
 endforeach ()
 
+# Make the Bullet constraint solver safe to use on several simulation islands in parallel, used by the multithreaded PhysicsWorld mode.
+# Bullet's mutexes and pool allocators are inline, so Bullet, the Urho3D library and the applications using them must all agree on it
+if (URHO3D_PHYSICS AND URHO3D_THREADING)
+    add_definitions (-DBT_THREADSAFE=1)
+endif ()
+
 # TODO: The logic below is earmarked to be moved into SDL's CMakeLists.txt when refactoring the library dependency handling, until then ensure the DirectX package is not being searched again in external projects such as when building LuaJIT library
 if (WIN32 AND NOT CMAKE_PROJECT_NAME MATCHES ^Urho3D-ExternalProject-)
     set (DIRECTX_REQUIRED_COMPONENTS)
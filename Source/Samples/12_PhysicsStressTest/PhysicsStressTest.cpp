@@ -36,6 +36,7 @@
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsEvents.h>
 #include <Urho3D/Physics/PhysicsWorld.h>
 #include <Urho3D/Physics/RigidBody.h>
 #include <Urho3D/Resource/ResourceCache.h>
@@ -52,6 +53,9 @@ URHO3D_DEFINE_APPLICATION_MAIN(PhysicsStressTest)
 
 PhysicsStressTest::PhysicsStressTest(Context* context) :
     Sample(context),
+    stepUSec_(0),
+    numSteps_(0),
+    statsTime_(0.0f),
     drawDebug_(false)
 {
 }
@@ -190,7 +194,8 @@ void PhysicsStressTest::CreateInstructions()
         "Use WASD keys and mouse/touch to move\n"
         "LMB to spawn physics objects\n"
         "F5 to save scene, F7 to load\n"
-        "Space to toggle physics debug geometry"
+        "Space to toggle physics debug geometry\n"
+        "M to toggle multithreaded physics"
     );
     instructionText->SetFont(cache->GetResource<Font>("Fonts/Anonymous Pro.ttf"), 15);
     // The text has multiple rows. Center them in relation to each other
@@ -200,6 +205,13 @@ void PhysicsStressTest::CreateInstructions()
     instructionText->SetHorizontalAlignment(HA_CENTER);
     instructionText->SetVerticalAlignment(VA_CENTER);
     instructionText->SetPosition(0, ui->GetRoot()->GetHeight() / 4);
+
+    // Construct a text for showing the average physics step time
+    statsText_ = ui->GetRoot()->CreateChild<Text>();
+    statsText_->SetFont(cache->GetResource<Font>("Fonts/Anonymous Pro.ttf"), 15);
+    statsText_->SetHorizontalAlignment(HA_CENTER);
+    statsText_->SetVerticalAlignment(VA_TOP);
+    statsText_->SetPosition(0, 10);
 }
 
 void PhysicsStressTest::SetupViewport()
@@ -219,6 +231,10 @@ void PhysicsStressTest::SubscribeToEvents()
     // Subscribe HandlePostRenderUpdate() function for processing the post-render update event, during which we request
     // debug geometry
     SubscribeToEvent(E_POSTRENDERUPDATE, URHO3D_HANDLER(PhysicsStressTest, HandlePostRenderUpdate));
+
+    // Subscribe to the physics step events to measure the time taken by each simulation step
+    SubscribeToEvent(E_PHYSICSPRESTEP, URHO3D_HANDLER(PhysicsStressTest, HandlePhysicsPreStep));
+    SubscribeToEvent(E_PHYSICSPOSTSTEP, URHO3D_HANDLER(PhysicsStressTest, HandlePhysicsPostStep));
 }
 
 void PhysicsStressTest::MoveCamera(float timeStep)
@@ -272,6 +288,13 @@ void PhysicsStressTest::MoveCamera(float timeStep)
     // Toggle physics debug geometry with space
     if (input->GetKeyPress(KEY_SPACE))
         drawDebug_ = !drawDebug_;
+
+    // Toggle solving the simulation islands in worker threads with M
+    if (input->GetKeyPress(KEY_M))
+    {
+        auto* physicsWorld = scene_->GetComponent<PhysicsWorld>();
+        physicsWorld->SetMultiThreaded(!physicsWorld->GetMultiThreaded());
+    }
 }
 
 void PhysicsStressTest::SpawnObject()
@@ -311,6 +334,18 @@ void PhysicsStressTest::HandleUpdate(StringHash eventType, VariantMap& eventData
 
     // Move the camera, scale movement with time step
     MoveCamera(timeStep);
+
+    // Show the average physics step time once per second
+    statsTime_ += timeStep;
+    if (statsTime_ >= 1.0f)
+    {
+        bool multiThreaded = scene_->GetComponent<PhysicsWorld>()->GetMultiThreaded();
+        float stepMSec = numSteps_ ? (float)stepUSec_ / numSteps_ / 1000.0f : 0.0f;
+        statsText_->SetText(ToString("Physics step %.2f ms (%s)", stepMSec, multiThreaded ? "multithreaded" : "single-threaded"));
+        stepUSec_ = 0;
+        numSteps_ = 0;
+        statsTime_ = 0.0f;
+    }
 }
 
 void PhysicsStressTest::HandlePostRenderUpdate(StringHash eventType, VariantMap& eventData)
@@ -319,3 +354,14 @@ void PhysicsStressTest::HandlePostRenderUpdate(StringHash eventType, VariantMap&
     if (drawDebug_)
         scene_->GetComponent<PhysicsWorld>()->DrawDebugGeometry(true);
 }
+
+void PhysicsStressTest::HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData)
+{
+    stepTimer_.Reset();
+}
+
+void PhysicsStressTest::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
+{
+    stepUSec_ += stepTimer_.GetUSec(false);
+    ++numSteps_;
+}
@@ -24,11 +24,14 @@
 
 #include "Sample.h"
 
+#include <Urho3D/Core/Timer.h>
+
 namespace Urho3D
 {
 
 class Node;
 class Scene;
+class Text;
 
 }
 
@@ -37,6 +40,7 @@ class Scene;
 ///     - Physics and rendering performance with a high (1000) moving object count
 ///     - Using triangle meshes for collision
 ///     - Optimizing physics simulation by leaving out collision event signaling
+///     - Measuring the physics step time, and solving simulation islands in worker threads
 class PhysicsStressTest : public Sample
 {
     URHO3D_OBJECT(PhysicsStressTest, Sample);
@@ -88,7 +92,21 @@ private:
     void HandleUpdate(StringHash eventType, VariantMap& eventData);
     /// Handle the post-render update event.
     void HandlePostRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the physics pre-step event.
+    void HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData);
+    /// Handle the physics post-step event.
+    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
 
+    /// Physics step time statistics text.
+    SharedPtr<Text> statsText_;
+    /// Timer for measuring the physics step.
+    HiresTimer stepTimer_;
+    /// Accumulated physics step time in microseconds.
+    long long stepUSec_;
+    /// Number of physics steps measured.
+    unsigned numSteps_;
+    /// Time since the statistics were last shown.
+    float statsTime_;
     /// Flag for drawing debug geometry.
     bool drawDebug_;
 };
@@ -125,6 +125,8 @@ public:
 	
     // Urho3D: added function to know when we have too many obstacle requests without update
     bool isObstacleQueueFull() const { return m_nreqs >= MAX_REQUESTS; }
+    // Urho3D: added function to know whether obstacle changes are still waiting to be applied to the navigation mesh
+    bool isUpToDate() const { return m_nreqs == 0 && m_nupdate == 0; }
 
 	/// Encodes a tile id.
 	inline dtCompressedTileRef encodeTileId(unsigned int salt, unsigned int it) const
@@ -182,6 +182,7 @@ float defaultTicksPerSecond_ = 4800.0f;
 float importStartTime_ = 0.0f;
 float importEndTime_ = 0.0f;
 bool suppressFbxPivotNodes_ = true;
+bool compressAnimations_ = false;
 
 int main(int argc, char** argv);
 void Run(const Vector<String>& arguments);
@@ -313,6 +314,7 @@ void Run(const Vector<String>& arguments)
             "-split <start> <end> (animation model only)\n"
             "            Split animation, will only import from start frame to end frame\n"
             "-np         Do not suppress $fbx pivot nodes (FBX files only)\n"
+            "-ca         Compress animation keyframes (lossy quantization)\n"
         );
     }
 
@@ -463,6 +465,8 @@ void Run(const Vector<String>& arguments)
                 checkUniqueModel_ = false;
             else if (argument == "bp")
                 moveToBindPose_ = true;
+            else if (argument == "ca")
+                compressAnimations_ = true;
             else if (argument == "split")
             {
                 String value2 = i + 2 < arguments.Size() ? arguments[i + 2] : String::EMPTY;
@@ -1489,6 +1493,8 @@ void BuildAndSaveAnimations(OutModel* model)
         File outFile(context_);
         if (!outFile.Open(animOutName, FILE_WRITE))
             ErrorExit("Could not open output file " + animOutName);
+        if (compressAnimations_)
+            outAnim->Compress();
         outAnim->Save(outFile);
     }
 }
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Audio/Audio.h>
+#include <Urho3D/Audio/Sound.h>
+#include <Urho3D/Audio/SoundSource.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Create a sine wave test sound.
+static SharedPtr<Sound> CreateTestSound(Context* context, unsigned type)
+{
+    bool sixteenBit = type < 2;
+    bool stereo = (type & 1) != 0;
+    unsigned frames = 22050 + type * 1000;
+    unsigned bytes = frames * (sixteenBit ? 2 : 1) * (stereo ? 2 : 1);
+    unsigned numSamples = sixteenBit ? bytes / 2 : bytes;
+
+    SharedArrayPtr<signed char> data(new signed char[bytes]);
+    for (unsigned i = 0; i < numSamples; ++i)
+    {
+        float value = sinf((float)i * (0.01f + 0.02f * type)) * 0.8f;
+        if (sixteenBit)
+            reinterpret_cast<short*>(data.Get())[i] = (short)(value * 32767.0f);
+        else
+            data[i] = (signed char)(value * 127.0f);
+    }
+
+    SharedPtr<Sound> sound(new Sound(context));
+    sound->SetSize(bytes);
+    sound->SetData(data.Get(), bytes);
+    sound->SetFormat(22050 + type * 11025, sixteenBit, stereo);
+    // One of the formats plays once, so that voices also stop during the benchmark
+    sound->SetLooped(type != 3);
+    return sound;
+}
+
+int RunAudioBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    auto numVoices = (unsigned)Max(options.GetInt("voices", 200), 1);
+    auto numFragments = (unsigned)Max(options.GetInt("fragments", 400), 1);
+    auto fragmentSamples = (unsigned)Max(options.GetInt("samples", 1024), 1);
+    auto maxVoices = (unsigned)Max(options.GetInt("maxvoices", 0), 0);
+    bool stereo = !options.HasFlag("mono");
+    bool interpolation = !options.HasFlag("point");
+
+    // Mix without an audio device, so that the benchmark runs headless
+    auto* audio = new Audio(context);
+    context->RegisterSubsystem(audio);
+    if (!audio->SetOfflineMode(44100, stereo, interpolation))
+    {
+        context->RemoveSubsystem<Audio>();
+        PrintResult("could not initialize offline audio mixing");
+        return EXIT_FAILURE;
+    }
+    audio->SetMaxVoices(maxVoices);
+
+    Vector<SharedPtr<Sound> > sounds;
+    for (unsigned i = 0; i < 4; ++i)
+        sounds.Push(CreateTestSound(context, i));
+
+    // Every 7th voice is quiet enough to be virtual
+    SetRandomSeed(1234);
+    Vector<SharedPtr<Node> > nodes;
+    for (unsigned i = 0; i < numVoices; ++i)
+    {
+        SharedPtr<Node> node(new Node(context));
+        auto* source = node->CreateComponent<SoundSource>();
+        source->SetFrequency(Random(8000.0f, 48000.0f));
+        source->SetGain(i % 7 ? Random(0.01f, 0.02f) : 0.001f);
+        source->SetPanning(Random(-1.0f, 1.0f));
+        source->Play(sounds[i % sounds.Size()]);
+        nodes.Push(node);
+    }
+
+    PODVector<short> output(fragmentSamples * (stereo ? 2 : 1));
+    BenchmarkSamples mixTimes;
+    for (unsigned i = 0; i < numFragments; ++i)
+    {
+        long long start = GetBenchmarkUSec();
+        audio->MixOutput(&output[0], fragmentSamples);
+        mixTimes.Add((float)(GetBenchmarkUSec() - start));
+    }
+
+    PrintResult("%u voices, %u audible, %s %s, %u-sample fragments: mix %s", numVoices, audio->GetNumAudibleVoices(),
+        stereo ? "stereo" : "mono", interpolation ? "interpolated" : "point sampled", fragmentSamples, mixTimes.ToString().CString());
+
+    nodes.Clear();
+    context->RemoveSubsystem<Audio>();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Write the XML test files. Return true if successful.
+static bool WriteTestFiles(Context* context, const String& path, unsigned numFiles, unsigned numElements)
+{
+    auto* fileSystem = context->GetSubsystem<FileSystem>();
+    if (!fileSystem->CreateDir(path))
+        return false;
+
+    for (unsigned i = 0; i < numFiles; ++i)
+    {
+        XMLFile xml(context);
+        XMLElement root = xml.CreateRoot("resource");
+        for (unsigned j = 0; j < numElements; ++j)
+        {
+            XMLElement element = root.CreateChild("element");
+            element.SetInt("index", j);
+            element.SetVector3("position", Vector3((float)i, (float)j, (float)(i + j)));
+            element.SetAttribute("name", "Element" + String(j));
+        }
+
+        File file(context, path + "File" + String(i) + ".xml", FILE_WRITE);
+        if (!file.IsOpen() || !xml.Save(file))
+            return false;
+    }
+
+    return true;
+}
+
+int RunBackgroundLoadBenchmark(Context* context, const BenchmarkOptions& options)
+{
+#ifdef URHO3D_THREADING
+    auto maxThreads = (unsigned)Max(options.GetInt("threads", Max((int)GetNumLogicalCPUs(), 1)), 1);
+    auto numFiles = (unsigned)Max(options.GetInt("files", 200), 1);
+    auto numElements = (unsigned)Max(options.GetInt("elements", 1000), 1);
+
+    if (!context->GetObjectFactories().Contains(XMLFile::GetTypeStatic()))
+        RegisterResourceLibrary(context);
+
+    String path = context->GetSubsystem<FileSystem>()->GetTemporaryDir() + "UrhoBenchmark/";
+    if (!WriteTestFiles(context, path, numFiles, numElements))
+    {
+        PrintResult("could not write test files to %s", path.CString());
+        return EXIT_FAILURE;
+    }
+
+    auto* cache = new ResourceCache(context);
+    context->RegisterSubsystem(cache);
+    cache->AddResourceDir(path);
+    cache->SetFinishBackgroundResourcesMs(1000);
+    auto* time = context->GetSubsystem<Time>();
+    int exitCode = EXIT_SUCCESS;
+
+    for (unsigned numThreads = 1;; numThreads = Min(numThreads * 2, maxThreads))
+    {
+        cache->SetNumBackgroundLoadThreads(numThreads);
+        cache->ReleaseAllResources(true);
+
+        long long start = GetBenchmarkUSec();
+        for (unsigned i = 0; i < numFiles; ++i)
+            cache->BackgroundLoadResource<XMLFile>("File" + String(i) + ".xml");
+
+        // Loaded resources are finished in the main thread at the beginning of each frame. Sleep between frames
+        // instead of spinning, so that the main thread does not take CPU time from the loader threads
+        unsigned numFrames = 0;
+        while (cache->GetNumBackgroundLoadResources())
+        {
+            time->BeginFrame(0.016f);
+            time->EndFrame();
+            ++numFrames;
+            Time::Sleep(1);
+        }
+        long long totalTime = Max(GetBenchmarkUSec() - start, 1LL);
+
+        PODVector<XMLFile*> loaded;
+        cache->GetResources<XMLFile>(loaded);
+        if (loaded.Size() != numFiles)
+        {
+            PrintResult("check failed: %u of %u files loaded", loaded.Size(), numFiles);
+            exitCode = EXIT_FAILURE;
+            break;
+        }
+
+        PrintResult("%u threads: %u files of %u elements in %.1f ms (%.0f files/s, %u frames)", numThreads, numFiles, numElements,
+            totalTime / 1000.0, numFiles * 1000000.0 / totalTime, numFrames);
+
+        if (numThreads == maxThreads)
+            break;
+    }
+
+    context->RemoveSubsystem<ResourceCache>();
+    auto* fileSystem = context->GetSubsystem<FileSystem>();
+    for (unsigned i = 0; i < numFiles; ++i)
+        fileSystem->Delete(path + "File" + String(i) + ".xml");
+
+    return exitCode;
+#else
+    PrintResult("background loading requires URHO3D_THREADING");
+    return EXIT_SUCCESS;
+#endif
+}
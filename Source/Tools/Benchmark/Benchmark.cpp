@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Container/Sort.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "Benchmark.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+#include <Urho3D/DebugNew.h>
+
+/// Benchmark registration.
+struct BenchmarkInfo
+{
+    /// Name used on the command line.
+    const char* name_;
+    /// Description and options.
+    const char* description_;
+    /// Function to run.
+    int (*function_)(Context*, const BenchmarkOptions&);
+};
+
+static const BenchmarkInfo benchmarks[] =
+{
+    {"workqueue", "WorkQueue item throughput and start latency as the thread count grows\n"
+        "    -threads <max threads> -items <items per batch> -batches <batches> -work <loop iterations per item>",
+        RunWorkQueueBenchmark},
+    {"events", "Typed and VariantMap event send cost with sender-specific subscribers. Checks typed subscription behavior first\n"
+        "    -senders <senders> -iterations <iterations>",
+        RunEventBenchmark},
+    {"hashmap", "HashMap and FlatHashMap insert, find, iterate and erase times with unsigned and StringHash keys\n"
+        "    -keys <keys> -iterations <iterations>",
+        RunHashMapBenchmark},
+    {"sceneload", "Scene load time and heap allocation count from binary, XML and JSON, and StringHash construction time\n"
+        "    -nodes <nodes> -iterations <iterations>",
+        RunSceneLoadBenchmark},
+    {"backgroundload", "Background loading time of many XML files with 1, 2, 4... loader threads\n"
+        "    -threads <max threads> -files <files> -elements <elements per file>",
+        RunBackgroundLoadBenchmark},
+    {"audio", "Offline mixing time of many sound sources with mixed formats and voice virtualization\n"
+        "    -voices <voices> -fragments <fragments> -samples <samples per fragment> -maxvoices <audible voice limit> -mono -point",
+        RunAudioBenchmark},
+    {"culling", "Octree or bounding volume hierarchy update and query times with many moving drawables, without graphics. Checks frustum query results first\n"
+        "    -drawables <drawables> -frames <frames> -levels <octree levels> -move <moved fraction per frame> -distance <move distance> -jitter -bvh",
+        RunCullingBenchmark},
+};
+
+static HiresTimer benchmarkTimer;
+
+int main(int argc, char** argv);
+int Run(const Vector<String>& arguments);
+
+int main(int argc, char** argv)
+{
+    Vector<String> arguments;
+
+    #ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+    #else
+    arguments = ParseArguments(argc, argv);
+    #endif
+
+    return Run(arguments);
+}
+
+int Run(const Vector<String>& arguments)
+{
+    if (arguments.Empty())
+    {
+        String usage = "Usage: Benchmark <name|all> [options]\n\nBenchmarks:\n";
+        for (const BenchmarkInfo& info : benchmarks)
+            usage += String(info.name_) + " - " + info.description_ + "\n";
+        ErrorExit(usage);
+    }
+
+    SharedPtr<Context> context(new Context());
+    context->RegisterSubsystem(new Time(context));
+    context->RegisterSubsystem(new FileSystem(context));
+    context->RegisterSubsystem(new Log(context));
+    context->RegisterSubsystem(new WorkQueue(context));
+    context->GetSubsystem<Log>()->SetLevel(LOG_WARNING);
+    benchmarkTimer.Reset();
+
+    const String& name = arguments[0];
+    BenchmarkOptions options(Vector<String>(arguments.Buffer() + 1, arguments.Size() - 1));
+    bool found = false;
+    int exitCode = EXIT_SUCCESS;
+
+    for (const BenchmarkInfo& info : benchmarks)
+    {
+        if (name == "all" || name.Compare(info.name_, false) == 0)
+        {
+            found = true;
+            PrintLine(String("Benchmark ") + info.name_);
+            int result = info.function_(context, options);
+            if (result != EXIT_SUCCESS)
+                exitCode = result;
+        }
+    }
+
+    if (!found)
+        ErrorExit("Unknown benchmark " + name);
+
+    return exitCode;
+}
+
+unsigned BenchmarkOptions::FindValue(const String& name) const
+{
+    for (unsigned i = 0; i + 1 < arguments_.Size(); ++i)
+    {
+        if (arguments_[i].Length() > 1 && arguments_[i][0] == '-' && arguments_[i].Substring(1).Compare(name, false) == 0)
+            return i + 1;
+    }
+    return M_MAX_UNSIGNED;
+}
+
+int BenchmarkOptions::GetInt(const String& name, int defaultValue) const
+{
+    unsigned index = FindValue(name);
+    return index != M_MAX_UNSIGNED ? ToInt(arguments_[index]) : defaultValue;
+}
+
+float BenchmarkOptions::GetFloat(const String& name, float defaultValue) const
+{
+    unsigned index = FindValue(name);
+    return index != M_MAX_UNSIGNED ? ToFloat(arguments_[index]) : defaultValue;
+}
+
+String BenchmarkOptions::GetString(const String& name, const String& defaultValue) const
+{
+    unsigned index = FindValue(name);
+    return index != M_MAX_UNSIGNED ? arguments_[index] : defaultValue;
+}
+
+bool BenchmarkOptions::HasFlag(const String& name) const
+{
+    for (unsigned i = 0; i < arguments_.Size(); ++i)
+    {
+        if (arguments_[i].Length() > 1 && arguments_[i][0] == '-' && arguments_[i].Substring(1).Compare(name, false) == 0)
+            return true;
+    }
+    return false;
+}
+
+float BenchmarkSamples::GetPercentile(float percentile) const
+{
+    if (samples_.Empty())
+        return 0.0f;
+
+    if (!sorted_)
+    {
+        Sort(samples_.Begin(), samples_.End());
+        sorted_ = true;
+    }
+
+    auto index = (unsigned)(Clamp(percentile, 0.0f, 100.0f) * 0.01f * (samples_.Size() - 1) + 0.5f);
+    return samples_[index];
+}
+
+float BenchmarkSamples::GetAverage() const
+{
+    if (samples_.Empty())
+        return 0.0f;
+
+    double sum = 0.0;
+    for (unsigned i = 0; i < samples_.Size(); ++i)
+        sum += samples_[i];
+    return (float)(sum / samples_.Size());
+}
+
+String BenchmarkSamples::ToString() const
+{
+    char buffer[256];
+    snprintf(buffer, sizeof buffer, "avg %.2f us, median %.2f us, p99 %.2f us, max %.2f us", GetAverage(), GetPercentile(50.0f),
+        GetPercentile(99.0f), GetPercentile(100.0f));
+    return String(buffer);
+}
+
+long long GetBenchmarkUSec()
+{
+    return benchmarkTimer.GetUSec(false);
+}
+
+void PrintResult(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof buffer, format, args);
+    va_end(args);
+    PrintLine("  " + String(buffer));
+}
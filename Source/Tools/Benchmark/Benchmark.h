@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Context.h>
+
+using namespace Urho3D;
+
+/// Benchmark command line options in the form "-name value".
+class BenchmarkOptions
+{
+public:
+    /// Construct from the arguments following the benchmark name.
+    explicit BenchmarkOptions(const Vector<String>& arguments) :
+        arguments_(arguments)
+    {
+    }
+
+    /// Return an integer option, or the default if not specified.
+    int GetInt(const String& name, int defaultValue) const;
+    /// Return a float option, or the default if not specified.
+    float GetFloat(const String& name, float defaultValue) const;
+    /// Return a string option, or the default if not specified.
+    String GetString(const String& name, const String& defaultValue = String::EMPTY) const;
+    /// Return whether a flag option is present.
+    bool HasFlag(const String& name) const;
+
+private:
+    /// Return index of an option's value, or M_MAX_UNSIGNED if not specified.
+    unsigned FindValue(const String& name) const;
+
+    /// Arguments.
+    Vector<String> arguments_;
+};
+
+/// Collection of measured sample times with percentile statistics.
+class BenchmarkSamples
+{
+public:
+    /// Add a sample in microseconds.
+    void Add(float usec)
+    {
+        samples_.Push(usec);
+        sorted_ = false;
+    }
+    /// Remove all samples.
+    void Clear() { samples_.Clear(); }
+
+    /// Return the sample at the given percentile (0-100).
+    float GetPercentile(float percentile) const;
+    /// Return the average sample.
+    float GetAverage() const;
+    /// Return the number of samples.
+    unsigned GetNumSamples() const { return samples_.Size(); }
+    /// Return a summary of the average, median, 99th percentile and maximum.
+    String ToString() const;
+
+private:
+    /// Samples in microseconds.
+    mutable PODVector<float> samples_;
+    /// Whether the samples are known to be sorted.
+    mutable bool sorted_ = false;
+};
+
+/// Return microseconds since the benchmark started.
+long long GetBenchmarkUSec();
+/// Print a line of benchmark output using printf-style formatting.
+void PrintResult(const char* format, ...);
+
+/// Run the work queue throughput and latency benchmark. Return the exit code.
+int RunWorkQueueBenchmark(Context* context, const BenchmarkOptions& options);
+/// Check typed event subscriptions and run the event send benchmark. Return the exit code.
+int RunEventBenchmark(Context* context, const BenchmarkOptions& options);
+/// Run the HashMap and FlatHashMap comparison benchmark. Return the exit code.
+int RunHashMapBenchmark(Context* context, const BenchmarkOptions& options);
+/// Run the scene load allocation benchmark. Return the exit code.
+int RunSceneLoadBenchmark(Context* context, const BenchmarkOptions& options);
+/// Run the background resource loading benchmark. Return the exit code.
+int RunBackgroundLoadBenchmark(Context* context, const BenchmarkOptions& options);
+/// Run the offline audio mixing benchmark. Return the exit code.
+int RunAudioBenchmark(Context* context, const BenchmarkOptions& options);
+/// Run the headless octree culling benchmark. Return the exit code.
+int RunCullingBenchmark(Context* context, const BenchmarkOptions& options);
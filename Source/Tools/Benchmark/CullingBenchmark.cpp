@@ -0,0 +1,212 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Container/Sort.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Graphics/Drawable.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/OctreeQuery.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Drawable with a fixed local bounding box, so that no graphics resources are needed.
+class CullingBenchmarkDrawable : public Drawable
+{
+    URHO3D_OBJECT(CullingBenchmarkDrawable, Drawable);
+
+public:
+    /// Construct.
+    explicit CullingBenchmarkDrawable(Context* context) :
+        Drawable(context, DRAWABLE_GEOMETRY)
+    {
+    }
+
+    /// Set local bounding box and drawable flags.
+    void SetBoundingBox(const BoundingBox& box, unsigned char drawableFlags)
+    {
+        boundingBox_ = box;
+        drawableFlags_ = drawableFlags;
+        OnMarkedDirty(node_);
+    }
+
+protected:
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override { worldBoundingBox_ = boundingBox_.Transformed(node_->GetWorldTransform()); }
+};
+
+/// Return the drawables a frustum query should find by testing all of them, sorted by address.
+static void GetFrustumReference(const PODVector<CullingBenchmarkDrawable*>& drawables, const Frustum& frustum,
+    unsigned char drawableFlags, unsigned viewMask, PODVector<Drawable*>& dest)
+{
+    dest.Clear();
+    for (unsigned i = 0; i < drawables.Size(); ++i)
+    {
+        CullingBenchmarkDrawable* drawable = drawables[i];
+        if (drawable->IsEnabledEffective() && (drawable->GetDrawableFlags() & drawableFlags) &&
+            (drawable->GetViewMask() & viewMask) && frustum.IsInsideFast(drawable->GetWorldBoundingBox()) != OUTSIDE)
+            dest.Push(drawable);
+    }
+    Sort(dest.Begin(), dest.End());
+}
+
+int RunCullingBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    auto numDrawables = (unsigned)Max(options.GetInt("drawables", 100000), 1);
+    auto numFrames = (unsigned)Max(options.GetInt("frames", 50), 1);
+    auto levels = (unsigned)Clamp(options.GetInt("levels", 8), 1, 16);
+    float moveFraction = Clamp(options.GetFloat("move", 0.2f), 0.0f, 1.0f);
+    float moveDistance = options.GetFloat("distance", 2.0f);
+    bool jitter = options.HasFlag("jitter");
+    SpatialIndex spatialIndex = options.HasFlag("bvh") ? SPATIAL_INDEX_BVH : SPATIAL_INDEX_OCTREE;
+    const float worldSize = 10000.0f;
+
+    if (!context->GetObjectFactories().Contains(Scene::GetTypeStatic()))
+        RegisterSceneLibrary(context);
+    if (!context->GetObjectFactories().Contains(Octree::GetTypeStatic()))
+        Octree::RegisterObject(context);
+    context->RegisterFactory<CullingBenchmarkDrawable>();
+
+    long long buildStart = GetBenchmarkUSec();
+    SharedPtr<Scene> scene(new Scene(context));
+    auto* octree = scene->CreateComponent<Octree>();
+    octree->SetSize(BoundingBox(-worldSize, worldSize), levels);
+    octree->SetSpatialIndex(spatialIndex);
+
+    // Scatter boxes of varying size; every 20th is a light, which is not an occludee, and a quarter use another view mask
+    SetRandomSeed(1234);
+    PODVector<CullingBenchmarkDrawable*> drawables;
+    for (unsigned i = 0; i < numDrawables; ++i)
+    {
+        Node* node = scene->CreateChild();
+        node->SetPosition(Vector3(Random(-worldSize, worldSize), Random(-100.0f, 100.0f), Random(-worldSize, worldSize)));
+        auto* drawable = node->CreateComponent<CullingBenchmarkDrawable>();
+        float size = Random(0.5f, 4.0f);
+        unsigned type = Rand() % 20;
+        drawable->SetBoundingBox(BoundingBox(-Vector3::ONE * size, Vector3::ONE * size), type == 0 ? DRAWABLE_LIGHT : DRAWABLE_GEOMETRY);
+        drawable->SetViewMask(type < 15 ? 1 : 2);
+        drawable->SetOccludee(type != 0);
+        drawables.Push(drawable);
+    }
+
+    FrameInfo frame;
+    frame.timeStep_ = 0.016f;
+    octree->Update(frame);
+    const char* indexName = spatialIndex == SPATIAL_INDEX_BVH ? "bounding volume hierarchy" : "octree";
+    PrintResult("build %u drawables, %s, %u levels: %.1f ms", numDrawables, indexName, levels, (GetBenchmarkUSec() - buildStart) / 1000.0);
+
+    BenchmarkSamples updateTimes;
+    BenchmarkSamples frustumTimes;
+    BenchmarkSamples boxTimes;
+    BenchmarkSamples sphereTimes;
+    BenchmarkSamples rayTimes;
+    PODVector<Drawable*> result;
+    PODVector<Drawable*> reference;
+    PODVector<RayQueryResult> rayResult;
+    unsigned numVisible = 0;
+    auto numMoved = (unsigned)(numDrawables * moveFraction);
+
+    // The first drawables keep moving at a constant velocity, like vehicles or characters. With -jitter, random drawables
+    // move in random directions instead, which is the worst case for the bounding volume hierarchy
+    PODVector<Vector3> velocities(numMoved);
+    for (unsigned j = 0; j < numMoved; ++j)
+        velocities[j] = Vector3(Random(-moveDistance, moveDistance), 0.0f, Random(-moveDistance, moveDistance));
+
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        for (unsigned j = 0; j < numMoved; ++j)
+        {
+            if (jitter)
+                drawables[Rand() % numDrawables]->GetNode()->Translate(Vector3(Random(-moveDistance, moveDistance), 0.0f,
+                    Random(-moveDistance, moveDistance)));
+            else
+                drawables[j]->GetNode()->Translate(velocities[j]);
+        }
+
+        // Halfway through, change view masks, occludee flags and disable some drawables to exercise the packed data refresh
+        // and moving drawables in and out of the bounding volume hierarchy
+        if (i == numFrames / 2)
+        {
+            for (unsigned j = 0; j < numDrawables; j += 50)
+                drawables[j]->SetViewMask(j % 100 ? 1 : 2);
+            for (unsigned j = 3; j < numDrawables; j += 30)
+                drawables[j]->SetOccludee(!drawables[j]->IsOccludee());
+            for (unsigned j = 7; j < numDrawables; j += 97)
+                drawables[j]->SetEnabled(false);
+        }
+
+        long long start = GetBenchmarkUSec();
+        octree->Update(frame);
+        updateTimes.Add((float)(GetBenchmarkUSec() - start));
+
+        Vector3 cameraPosition(Random(-worldSize, worldSize) * 0.8f, 20.0f, Random(-worldSize, worldSize) * 0.8f);
+        Quaternion cameraRotation(Random(0.0f, 360.0f), Vector3::UP);
+        Frustum frustum;
+        frustum.Define(60.0f, 16.0f / 9.0f, 1.0f, 0.1f, 1000.0f, Matrix3x4(cameraPosition, cameraRotation, 1.0f));
+
+        start = GetBenchmarkUSec();
+        FrustumOctreeQuery frustumQuery(result, frustum, DRAWABLE_GEOMETRY, 1);
+        octree->GetDrawables(frustumQuery);
+        frustumTimes.Add((float)(GetBenchmarkUSec() - start));
+        numVisible += result.Size();
+
+        // Check the frustum query against testing every drawable on the first and last frame
+        if (i == 0 || i == numFrames - 1)
+        {
+            Sort(result.Begin(), result.End());
+            GetFrustumReference(drawables, frustum, DRAWABLE_GEOMETRY, 1, reference);
+            if (result != reference)
+            {
+                PrintResult("check failed: frame %u frustum query found %u drawables, expected %u", i, result.Size(), reference.Size());
+                return EXIT_FAILURE;
+            }
+        }
+
+        start = GetBenchmarkUSec();
+        BoxOctreeQuery boxQuery(result, BoundingBox(cameraPosition - Vector3(200.0f, 200.0f, 200.0f),
+            cameraPosition + Vector3(200.0f, 200.0f, 200.0f)), DRAWABLE_GEOMETRY, 1);
+        octree->GetDrawables(boxQuery);
+        boxTimes.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        SphereOctreeQuery sphereQuery(result, Sphere(cameraPosition, 300.0f), DRAWABLE_ANY, M_MAX_UNSIGNED);
+        octree->GetDrawables(sphereQuery);
+        sphereTimes.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        RayOctreeQuery rayQuery(rayResult, Ray(cameraPosition, cameraRotation * Vector3::FORWARD), RAY_AABB, 3000.0f, DRAWABLE_GEOMETRY);
+        octree->Raycast(rayQuery);
+        rayTimes.Add((float)(GetBenchmarkUSec() - start));
+    }
+
+    PrintResult("frustum and reference results match");
+    PrintResult("update (%u moved): %s", numMoved, updateTimes.ToString().CString());
+    PrintResult("frustum query (%u visible on average): %s", numVisible / numFrames, frustumTimes.ToString().CString());
+    PrintResult("box query: %s", boxTimes.ToString().CString());
+    PrintResult("sphere query: %s", sphereTimes.ToString().CString());
+    PrintResult("raycast: %s", rayTimes.ToString().CString());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/ProcessUtils.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Event sent by the event benchmark.
+URHO3D_EVENT(E_BENCHMARKEVENT, BenchmarkEvent)
+{
+    URHO3D_PARAM(P_VALUE, Value);                  // int
+}
+
+/// Typed benchmark event.
+struct BenchmarkEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_BENCHMARKEVENT; }
+    /// Convert to VariantMap event data.
+    void ToVariantMap(VariantMap& eventData) const { eventData[BenchmarkEvent::P_VALUE] = value_; }
+    /// Convert from VariantMap event data.
+    void FromVariantMap(const VariantMap& eventData) { value_ = GetEventParam(eventData, BenchmarkEvent::P_VALUE).GetInt(); }
+
+    /// Value.
+    int value_;
+};
+
+/// Event sender.
+class EventBenchmarkSender : public Object
+{
+    URHO3D_OBJECT(EventBenchmarkSender, Object);
+
+public:
+    /// Construct.
+    explicit EventBenchmarkSender(Context* context) :
+        Object(context)
+    {
+    }
+};
+
+/// Event receiver that records the events it gets.
+class EventBenchmarkReceiver : public Object
+{
+    URHO3D_OBJECT(EventBenchmarkReceiver, Object);
+
+public:
+    /// Construct.
+    explicit EventBenchmarkReceiver(Context* context) :
+        Object(context)
+    {
+    }
+
+    /// Subscribe to the event from a sender, in typed or VariantMap form.
+    void SubscribeToSender(Object* sender, bool typed)
+    {
+        if (typed)
+            SubscribeToTypedEvent(sender, &EventBenchmarkReceiver::HandleSpecific);
+        else
+            SubscribeToEvent(sender, E_BENCHMARKEVENT, URHO3D_HANDLER(EventBenchmarkReceiver, HandleVariantMap));
+    }
+
+    /// Handle the typed event from a specific sender.
+    void HandleSpecific(BenchmarkEventData& eventData)
+    {
+        specificSenders_.Push(GetEventSender());
+        sum_ += eventData.value_;
+    }
+
+    /// Handle the typed event from any sender.
+    void HandleGlobal(BenchmarkEventData& eventData)
+    {
+        globalSenders_.Push(GetEventSender());
+        sum_ += eventData.value_;
+    }
+
+    /// Handle the VariantMap event.
+    void HandleVariantMap(StringHash eventType, VariantMap& eventData)
+    {
+        sum_ += eventData[BenchmarkEvent::P_VALUE].GetInt();
+    }
+
+    /// Forget the recorded events.
+    void Reset()
+    {
+        specificSenders_.Clear();
+        globalSenders_.Clear();
+    }
+
+    /// Senders of the events received through specific subscriptions.
+    PODVector<Object*> specificSenders_;
+    /// Senders of the events received through the non-specific subscription.
+    PODVector<Object*> globalSenders_;
+    /// Sum of the received values.
+    long long sum_ = 0;
+};
+
+/// Return whether the events were received from the expected senders, and print the failure if not.
+static bool CheckReceived(EventBenchmarkReceiver* receiver, const char* step, unsigned numSpecific, Object* specificSender,
+    unsigned numGlobal, Object* globalSender)
+{
+    bool success = receiver->specificSenders_.Size() == numSpecific && receiver->globalSenders_.Size() == numGlobal &&
+        (!numSpecific || receiver->specificSenders_[0] == specificSender) && (!numGlobal || receiver->globalSenders_[0] == globalSender);
+    if (!success)
+    {
+        PrintResult("check failed: %s: %u specific and %u global events received, expected %u and %u", step,
+            receiver->specificSenders_.Size(), receiver->globalSenders_.Size(), numSpecific, numGlobal);
+    }
+
+    receiver->Reset();
+    return success;
+}
+
+/// Check typed subscriptions to several senders and to all senders. Return true if successful.
+static bool CheckTypedSubscriptions(Context* context)
+{
+    SharedPtr<EventBenchmarkSender> senderA(new EventBenchmarkSender(context));
+    SharedPtr<EventBenchmarkSender> senderB(new EventBenchmarkSender(context));
+    SharedPtr<EventBenchmarkReceiver> receiver(new EventBenchmarkReceiver(context));
+    BenchmarkEventData eventData;
+    eventData.value_ = 1;
+    bool success = true;
+
+    // Subscriptions to different senders and the non-specific subscription must all stay active
+    receiver->SubscribeToTypedEvent(senderA, &EventBenchmarkReceiver::HandleSpecific);
+    receiver->SubscribeToTypedEvent(&EventBenchmarkReceiver::HandleGlobal);
+    receiver->SubscribeToTypedEvent(senderB, &EventBenchmarkReceiver::HandleSpecific);
+    senderA->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send from sender A", 1, senderA, 1, senderA);
+    senderB->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send from sender B", 1, senderB, 1, senderB);
+    senderA->SendEvent(E_BENCHMARKEVENT, BenchmarkEvent::P_VALUE, 1);
+    success &= CheckReceived(receiver, "VariantMap send from sender A", 1, senderA, 1, senderA);
+
+    // Subscribing again to the same sender replaces only that subscription
+    receiver->SubscribeToTypedEvent(senderA, &EventBenchmarkReceiver::HandleSpecific);
+    senderA->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send after resubscribing to sender A", 1, senderA, 1, senderA);
+    senderB->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send from sender B after resubscribing to sender A", 1, senderB, 1, senderB);
+
+    // Unsubscribing from one sender leaves the others
+    receiver->UnsubscribeFromEvent(senderA, E_BENCHMARKEVENT);
+    senderA->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send after unsubscribing from sender A", 0, nullptr, 1, senderA);
+    senderB->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send from sender B after unsubscribing from sender A", 1, senderB, 1, senderB);
+
+    // Destroying a sender removes its subscriptions
+    senderB.Reset();
+    senderA->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send after destroying sender B", 0, nullptr, 1, senderA);
+
+    receiver->UnsubscribeFromTypedEvent<BenchmarkEventData>();
+    senderA->SendTypedEvent(eventData);
+    success &= CheckReceived(receiver, "typed send after unsubscribing from all", 0, nullptr, 0, nullptr);
+
+    return success;
+}
+
+int RunEventBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    if (!CheckTypedSubscriptions(context))
+        return EXIT_FAILURE;
+    PrintResult("typed subscriptions to several senders and to all senders: ok");
+
+    auto numSenders = (unsigned)Max(options.GetInt("senders", 1000), 1);
+    auto numIterations = (unsigned)Max(options.GetInt("iterations", 100), 1);
+
+    // Each sender has its own receiver subscribed to it, as components subscribe to their node's events
+    Vector<SharedPtr<EventBenchmarkSender> > senders;
+    Vector<SharedPtr<EventBenchmarkReceiver> > receivers;
+    for (unsigned i = 0; i < numSenders; ++i)
+    {
+        senders.Push(SharedPtr<EventBenchmarkSender>(new EventBenchmarkSender(context)));
+        receivers.Push(SharedPtr<EventBenchmarkReceiver>(new EventBenchmarkReceiver(context)));
+    }
+
+    for (unsigned pass = 0; pass < 2; ++pass)
+    {
+        bool typed = pass == 0;
+        for (unsigned i = 0; i < numSenders; ++i)
+        {
+            receivers[i]->UnsubscribeFromAllEvents();
+            receivers[i]->SubscribeToSender(senders[i], typed);
+        }
+
+        BenchmarkSamples sendTimes;
+        BenchmarkEventData eventData;
+        eventData.value_ = 1;
+        for (unsigned iteration = 0; iteration < numIterations; ++iteration)
+        {
+            long long start = GetBenchmarkUSec();
+            for (unsigned i = 0; i < numSenders; ++i)
+            {
+                if (typed)
+                    senders[i]->SendTypedEvent(eventData);
+                else
+                    senders[i]->SendEvent(E_BENCHMARKEVENT, BenchmarkEvent::P_VALUE, 1);
+            }
+            sendTimes.Add((float)(GetBenchmarkUSec() - start));
+
+            for (unsigned i = 0; i < numSenders; ++i)
+                receivers[i]->Reset();
+        }
+
+        PrintResult("%s send from %u senders with one subscriber each: %.1f ns per event, all senders %s",
+            typed ? "typed" : "VariantMap", numSenders, sendTimes.GetAverage() * 1000.0f / numSenders, sendTimes.ToString().CString());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Container/FlatHashMap.h>
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Math/StringHash.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Results of running the operations on one map type.
+struct HashMapBenchmarkResult
+{
+    /// Insert times.
+    BenchmarkSamples insertTimes_;
+    /// Times to find every key.
+    BenchmarkSamples findTimes_;
+    /// Times to look up keys that are not in the map.
+    BenchmarkSamples missTimes_;
+    /// Iteration times.
+    BenchmarkSamples iterateTimes_;
+    /// Erase times.
+    BenchmarkSamples eraseTimes_;
+    /// Checksum of the found values, which must match between map types.
+    unsigned long long checksum_ = 0;
+};
+
+/// Insert the keys, then find, iterate and erase them in the lookup order with the given map type.
+template <class MapType, class KeyType> static void RunMapOperations(const PODVector<KeyType>& keys, const PODVector<KeyType>& lookupKeys,
+    const PODVector<KeyType>& missingKeys, unsigned numIterations, HashMapBenchmarkResult& result)
+{
+    for (unsigned iteration = 0; iteration < numIterations; ++iteration)
+    {
+        MapType map;
+
+        long long start = GetBenchmarkUSec();
+        for (unsigned i = 0; i < keys.Size(); ++i)
+            map[keys[i]] = i;
+        result.insertTimes_.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        for (unsigned i = 0; i < lookupKeys.Size(); ++i)
+        {
+            typename MapType::ConstIterator it = map.Find(lookupKeys[i]);
+            if (it != map.End())
+                result.checksum_ += it->second_;
+        }
+        result.findTimes_.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        for (unsigned i = 0; i < missingKeys.Size(); ++i)
+            result.checksum_ += map.Contains(missingKeys[i]) ? 1 : 0;
+        result.missTimes_.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        for (typename MapType::ConstIterator it = map.Begin(); it != map.End(); ++it)
+            result.checksum_ += it->second_;
+        result.iterateTimes_.Add((float)(GetBenchmarkUSec() - start));
+
+        start = GetBenchmarkUSec();
+        for (unsigned i = 0; i < lookupKeys.Size(); ++i)
+            map.Erase(lookupKeys[i]);
+        result.eraseTimes_.Add((float)(GetBenchmarkUSec() - start));
+
+        result.checksum_ += map.Size();
+    }
+}
+
+/// Compare HashMap and FlatHashMap with one key type. Return true if both gave the same results.
+template <class KeyType> static bool CompareMaps(const char* keyName, const PODVector<KeyType>& keys, const PODVector<KeyType>& missingKeys,
+    unsigned numIterations)
+{
+    // Look up in random order, as finding keys in insertion order would favor HashMap's sequentially allocated nodes
+    PODVector<KeyType> lookupKeys = keys;
+    for (unsigned i = lookupKeys.Size() - 1; i > 0; --i)
+        Swap(lookupKeys[i], lookupKeys[((unsigned)Rand() << 15 | (unsigned)Rand()) % (i + 1)]);
+
+    HashMapBenchmarkResult results[2];
+    RunMapOperations<HashMap<KeyType, unsigned> >(keys, lookupKeys, missingKeys, numIterations, results[0]);
+    RunMapOperations<FlatHashMap<KeyType, unsigned> >(keys, lookupKeys, missingKeys, numIterations, results[1]);
+
+    if (results[0].checksum_ != results[1].checksum_)
+    {
+        PrintResult("check failed: %s keys give checksum %llu with HashMap and %llu with FlatHashMap", keyName, results[0].checksum_,
+            results[1].checksum_);
+        return false;
+    }
+
+    const char* mapNames[] = {"HashMap", "FlatHashMap"};
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        const HashMapBenchmarkResult& result = results[i];
+        PrintResult("%s<%s> %u keys: insert %.0f us, find %.0f us, miss %.0f us, iterate %.0f us, erase %.0f us", mapNames[i], keyName,
+            keys.Size(), result.insertTimes_.GetPercentile(50.0f), result.findTimes_.GetPercentile(50.0f),
+            result.missTimes_.GetPercentile(50.0f), result.iterateTimes_.GetPercentile(50.0f), result.eraseTimes_.GetPercentile(50.0f));
+    }
+
+    return true;
+}
+
+int RunHashMapBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    auto numKeys = (unsigned)Max(options.GetInt("keys", 100000), 1);
+    auto numIterations = (unsigned)Max(options.GetInt("iterations", 20), 1);
+
+    // Node and component IDs are mostly sequential; StringHash keys are spread over the whole range
+    PODVector<unsigned> idKeys;
+    PODVector<unsigned> missingIdKeys;
+    PODVector<StringHash> hashKeys;
+    PODVector<StringHash> missingHashKeys;
+    SetRandomSeed(1234);
+    for (unsigned i = 0; i < numKeys; ++i)
+    {
+        idKeys.Push(i * 3 + 1);
+        missingIdKeys.Push(i * 3 + 2);
+        hashKeys.Push(StringHash("Key" + String(i)));
+        missingHashKeys.Push(StringHash("Missing" + String(i)));
+    }
+
+    if (!CompareMaps("unsigned", idKeys, missingIdKeys, numIterations) || !CompareMaps("StringHash", hashKeys, missingHashKeys,
+        numIterations))
+        return EXIT_FAILURE;
+
+    PrintResult("HashMap and FlatHashMap results match");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SmoothedTransform.h>
+
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// The global allocation functions are replaced to count the heap allocations made while loading
+static std::atomic<unsigned> numAllocations(0);
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    ++numAllocations;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+/// Scene file format to benchmark.
+enum SceneLoadFormat
+{
+    SLF_BINARY = 0,
+    SLF_XML,
+    SLF_JSON
+};
+
+/// Load a scene from a buffer, recording the time and the number of allocations. Return true if successful.
+static bool LoadScene(Scene* scene, VectorBuffer& buffer, SceneLoadFormat format, BenchmarkSamples& times, BenchmarkSamples& allocations)
+{
+    buffer.Seek(0);
+    unsigned startAllocations = numAllocations;
+    long long start = GetBenchmarkUSec();
+
+    bool success;
+    if (format == SLF_XML)
+        success = scene->LoadXML(buffer);
+    else if (format == SLF_JSON)
+        success = scene->LoadJSON(buffer);
+    else
+        success = scene->Load(buffer);
+
+    times.Add((float)(GetBenchmarkUSec() - start));
+    allocations.Add((float)(numAllocations - startAllocations));
+    return success;
+}
+
+int RunSceneLoadBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    auto numNodes = (unsigned)Max(options.GetInt("nodes", 10000), 1);
+    auto numIterations = (unsigned)Max(options.GetInt("iterations", 10), 1);
+
+    if (!context->GetObjectFactories().Contains(Scene::GetTypeStatic()))
+        RegisterSceneLibrary(context);
+
+    // Typical short node names, tags and variables, and a component on every fourth node
+    SharedPtr<Scene> scene(new Scene(context));
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = (i % 8 && scene->GetNumChildren()) ? scene->GetChild(scene->GetNumChildren() - 1)->CreateChild("Child" + String(i)) :
+            scene->CreateChild("Node" + String(i));
+        node->SetPosition(Vector3((float)(i % 100), 0.0f, (float)(i / 100)));
+        node->AddTag(i % 2 ? "Static" : "Dynamic");
+        node->SetVar("Health", 100);
+        node->SetVar("Team", i % 2 ? "Red" : "Blue");
+        if (i % 4 == 0)
+            node->CreateComponent<SmoothedTransform>();
+    }
+
+    VectorBuffer buffers[3];
+    scene->Save(buffers[SLF_BINARY]);
+    scene->SaveXML(buffers[SLF_XML]);
+    scene->SaveJSON(buffers[SLF_JSON]);
+    const char* formatNames[] = {"binary", "XML", "JSON"};
+
+    SharedPtr<Scene> loadScene(new Scene(context));
+    for (unsigned format = SLF_BINARY; format <= SLF_JSON; ++format)
+    {
+        BenchmarkSamples times;
+        BenchmarkSamples allocations;
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            if (!LoadScene(loadScene, buffers[format], (SceneLoadFormat)format, times, allocations))
+            {
+                PrintResult("check failed: could not load %s scene", formatNames[format]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (loadScene->GetNumChildren(true) != numNodes)
+        {
+            PrintResult("check failed: %s scene has %u nodes, expected %u", formatNames[format], loadScene->GetNumChildren(true), numNodes);
+            return EXIT_FAILURE;
+        }
+
+        PrintResult("load %u nodes from %s (%u bytes): %.0f allocations, %s", numNodes, formatNames[format], buffers[format].GetSize(),
+            allocations.GetAverage(), times.ToString().CString());
+    }
+
+    // Hashing strings, which also registers them for reversing
+    BenchmarkSamples hashTimes;
+    const char* names[] = {"Position", "Rotation", "Scale", "Variables", "Tags", "Health", "Team", "Model", "Material"};
+    unsigned hashSum = 0;
+    for (unsigned i = 0; i < numIterations; ++i)
+    {
+        long long start = GetBenchmarkUSec();
+        for (unsigned j = 0; j < numNodes; ++j)
+            hashSum += StringHash(names[j % 9]).Value();
+        hashTimes.Add((float)(GetBenchmarkUSec() - start));
+    }
+    PrintResult("hash %u strings: %s (checksum %08X)", numNodes, hashTimes.ToString().CString(), hashSum);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "Benchmark.h"
+
+#include <Urho3D/DebugNew.h>
+
+/// Shared state of the work queue benchmark items.
+struct WorkQueueBenchmarkData
+{
+    /// Time each item was added, in microseconds.
+    PODVector<long long> addTimes_;
+    /// Time from adding to starting each item, in microseconds.
+    PODVector<long long> startLatencies_;
+    /// Loop iterations per item.
+    unsigned work_;
+};
+
+/// Simulate a small amount of work.
+static float DoWork(unsigned iterations)
+{
+    volatile float value = 1.0f;
+    for (unsigned i = 0; i < iterations; ++i)
+        value = value * 1.0001f + 0.0001f;
+    return value;
+}
+
+static void BenchmarkWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* data = reinterpret_cast<WorkQueueBenchmarkData*>(item->aux_);
+    auto index = (unsigned)(size_t)item->start_;
+    data->startLatencies_[index] = GetBenchmarkUSec() - data->addTimes_[index];
+    DoWork(data->work_);
+}
+
+int RunWorkQueueBenchmark(Context* context, const BenchmarkOptions& options)
+{
+    auto maxThreads = (unsigned)Max(options.GetInt("threads", Max((int)GetNumLogicalCPUs(), 1)), 1);
+    auto numItems = (unsigned)Max(options.GetInt("items", 1000), 1);
+    auto numBatches = (unsigned)Max(options.GetInt("batches", 200), 1);
+
+    WorkQueueBenchmarkData data;
+    data.work_ = (unsigned)Max(options.GetInt("work", 200), 0);
+    data.addTimes_.Resize(numItems);
+    data.startLatencies_.Resize(numItems);
+
+    for (unsigned numThreads = 1;; numThreads = Min(numThreads * 2, maxThreads))
+    {
+        // Worker threads can only be created once, so use a new queue for each thread count. The main thread also executes work
+        SharedPtr<WorkQueue> queue(new WorkQueue(context));
+        queue->CreateThreads(numThreads - 1);
+
+        BenchmarkSamples latencies;
+        BenchmarkSamples batchTimes;
+        long long totalStart = GetBenchmarkUSec();
+
+        for (unsigned batch = 0; batch < numBatches; ++batch)
+        {
+            long long batchStart = GetBenchmarkUSec();
+            for (unsigned i = 0; i < numItems; ++i)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->workFunction_ = BenchmarkWork;
+                item->start_ = reinterpret_cast<void*>((size_t)i);
+                item->aux_ = &data;
+                item->priority_ = M_MAX_UNSIGNED;
+                data.addTimes_[i] = GetBenchmarkUSec();
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+            batchTimes.Add((float)(GetBenchmarkUSec() - batchStart));
+
+            for (unsigned i = 0; i < numItems; ++i)
+                latencies.Add((float)data.startLatencies_[i]);
+        }
+
+        long long totalTime = Max(GetBenchmarkUSec() - totalStart, 1LL);
+        PrintResult("items, %u threads: %.0f items/s, batch %s", numThreads,
+            (double)numItems * numBatches * 1000000.0 / totalTime, batchTimes.ToString().CString());
+        PrintResult("items, %u threads: start latency %s", numThreads, latencies.ToString().CString());
+
+        // Parallel loop over the same amount of work, with automatic chunk size
+        ParallelForCost cost;
+        BenchmarkSamples loopTimes;
+        for (unsigned batch = 0; batch < numBatches; ++batch)
+        {
+            long long loopStart = GetBenchmarkUSec();
+            queue->ParallelFor(numItems, 0, [&data](unsigned begin, unsigned end, unsigned threadIndex)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    DoWork(data.work_);
+            }, &cost);
+            loopTimes.Add((float)(GetBenchmarkUSec() - loopStart));
+        }
+        PrintResult("ParallelFor, %u threads: loop %s", numThreads, loopTimes.ToString().CString());
+
+        if (numThreads == maxThreads)
+            break;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -54,6 +54,8 @@ String basePath_;
 Vector<FileEntry> entries_;
 unsigned checksum_ = 0;
 bool compress_ = false;
+bool sequential_ = false;
+int compressionLevel_ = 0;
 bool quiet_ = false;
 unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
 
@@ -91,6 +93,8 @@ void Run(const Vector<String>& arguments)
             "\n"
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
+            "-s      Write compressed files sequentially without a block index (legacy format, no random access)\n"
+            "-x      Use the maximum LZ4-HC compression level (slower to pack, as fast to decompress)\n"
             "-q      Enable quiet mode\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
@@ -119,6 +123,12 @@ void Run(const Vector<String>& arguments)
                     case 'c':
                         compress_ = true;
                         break;
+                    case 's':
+                        sequential_ = true;
+                        break;
+                    case 'x':
+                        compressionLevel_ = LZ4HC_CLEVEL_MAX;
+                        break;
                     case 'q':
                         quiet_ = true;
                         break;
@@ -172,6 +182,8 @@ void Run(const Vector<String>& arguments)
             PrintLine("Package size: " + String(packageFile->GetTotalSize()));
             PrintLine("Checksum: " + String(packageFile->GetChecksum()));
             PrintLine("Compressed: " + String(packageFile->IsCompressed() ? "yes" : "no"));
+            if (packageFile->GetBlockSize())
+                PrintLine("Block size: " + String(packageFile->GetBlockSize()));
             break;
         case 'L':
             if (!packageFile->IsCompressed())
@@ -274,6 +286,51 @@ void WritePackageFile(const String& fileName, const String& rootDir)
                 PrintLine(entries_[i].name_ + " size " + String(dataSize));
             dest.Write(&buffer[0], entries_[i].size_);
         }
+        else if (!sequential_)
+        {
+            // Compress each block independently and write an index of the block end offsets before the blocks,
+            // so that the file can be read from any position. Blocks which do not compress are stored as is
+            unsigned numBlocks = (dataSize + blockSize_ - 1) / blockSize_;
+            PODVector<unsigned> blockEnds(numBlocks);
+            PODVector<unsigned char> packedData;
+            SharedArrayPtr<unsigned char> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
+
+            for (unsigned j = 0; j < numBlocks; ++j)
+            {
+                unsigned pos = j * blockSize_;
+                unsigned unpackedSize = Min(blockSize_, dataSize - pos);
+
+                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.Get(), unpackedSize, LZ4_compressBound(unpackedSize), compressionLevel_);
+                if (!packedSize)
+                    ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + String(pos));
+
+                const unsigned char* blockData = compressBuffer.Get();
+                if (packedSize >= unpackedSize)
+                {
+                    blockData = &buffer[pos];
+                    packedSize = unpackedSize;
+                }
+
+                unsigned packedPos = packedData.Size();
+                packedData.Resize(packedPos + packedSize);
+                memcpy(&packedData[packedPos], blockData, packedSize);
+                blockEnds[j] = packedData.Size();
+            }
+
+            for (unsigned j = 0; j < numBlocks; ++j)
+                dest.WriteUInt(blockEnds[j]);
+            if (packedData.Size())
+                dest.Write(&packedData[0], packedData.Size());
+
+            if (!quiet_)
+            {
+                unsigned totalPackedBytes = dest.GetSize() - lastOffset;
+                String fileEntry(entries_[i].name_);
+                fileEntry.AppendWithFormat("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
+                    totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
+                PrintLine(fileEntry);
+            }
+        }
         else
         {
             SharedArrayPtr<unsigned char> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
@@ -286,7 +343,7 @@ void WritePackageFile(const String& fileName, const String& rootDir)
                 if (pos + unpackedSize > dataSize)
                     unpackedSize = dataSize - pos;
 
-                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.Get(), unpackedSize, LZ4_compressBound(unpackedSize), 0);
+                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.Get(), unpackedSize, LZ4_compressBound(unpackedSize), compressionLevel_);
                 if (!packedSize)
                     ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + String(pos));
 
@@ -331,6 +388,8 @@ void WritePackageFile(const String& fileName, const String& rootDir)
         PrintLine("Package size: " + String(dest.GetSize()));
         PrintLine("Checksum: " + String(checksum_));
         PrintLine("Compressed: " + String(compress_ ? "yes" : "no"));
+        if (compress_ && !sequential_)
+            PrintLine("Block size: " + String(blockSize_));
     }
 }
 
@@ -338,8 +397,12 @@ void WriteHeader(File& dest)
 {
     if (!compress_)
         dest.WriteFileID("UPAK");
-    else
+    else if (sequential_)
         dest.WriteFileID("ULZ4");
+    else
+        dest.WriteFileID("ULZI");
     dest.WriteUInt(entries_.Size());
     dest.WriteUInt(checksum_);
+    if (compress_ && !sequential_)
+        dest.WriteUInt(blockSize_);
 }
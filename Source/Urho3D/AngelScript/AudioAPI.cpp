@@ -84,6 +84,7 @@ void RegisterAudio(asIScriptEngine* engine)
 {
     RegisterObject<Audio>(engine, "Audio");
     engine->RegisterObjectMethod("Audio", "void SetMode(int, int, bool, bool interpolate = true)", asMETHOD(Audio, SetMode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "bool SetOfflineMode(int, bool, bool interpolate = true)", asMETHOD(Audio, SetOfflineMode), asCALL_THISCALL);
     engine->RegisterObjectMethod("Audio", "bool Play()", asMETHOD(Audio, Play), asCALL_THISCALL);
     engine->RegisterObjectMethod("Audio", "void Stop()", asMETHOD(Audio, Stop), asCALL_THISCALL);
     engine->RegisterObjectMethod("Audio", "void PauseSoundType(const String&in)", asMETHOD(Audio, PauseSoundType), asCALL_THISCALL);
@@ -101,6 +102,12 @@ void RegisterAudio(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Audio", "bool get_interpolation() const", asMETHOD(Audio, GetInterpolation), asCALL_THISCALL);
     engine->RegisterObjectMethod("Audio", "bool get_playing() const", asMETHOD(Audio, IsPlaying), asCALL_THISCALL);
     engine->RegisterObjectMethod("Audio", "bool get_initialized() const", asMETHOD(Audio, IsInitialized), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "bool get_offline() const", asMETHOD(Audio, IsOffline), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "void set_maxVoices(uint)", asMETHOD(Audio, SetMaxVoices), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "uint get_maxVoices() const", asMETHOD(Audio, GetMaxVoices), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "void set_virtualGainThreshold(float)", asMETHOD(Audio, SetVirtualGainThreshold), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "float get_virtualGainThreshold() const", asMETHOD(Audio, GetVirtualGainThreshold), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Audio", "uint get_numAudibleVoices() const", asMETHOD(Audio, GetNumAudibleVoices), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Audio@+ get_audio()", asFUNCTION(GetAudio), asCALL_CDECL);
 }
 
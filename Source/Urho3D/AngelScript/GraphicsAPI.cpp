@@ -1106,8 +1106,11 @@ static void RegisterAnimation(asIScriptEngine* engine)
     engine->RegisterObjectMethod("AnimationTrack", "void RemoveKeyFrame(uint)", asMETHOD(AnimationTrack, RemoveKeyFrame), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimationTrack", "void RemoveAllKeyFrames()", asMETHOD(AnimationTrack, RemoveAllKeyFrames), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimationTrack", "void set_keyFrames(uint, const AnimationKeyFrame&in)", asMETHOD(AnimationTrack, SetKeyFrame), asCALL_THISCALL);
-    engine->RegisterObjectMethod("AnimationTrack", "const AnimationKeyFrame& get_keyFrames(uint) const", asMETHOD(AnimationTrack, GetKeyFrame), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimationTrack", "const AnimationKeyFrame& get_keyFrames(uint) const", asMETHODPR(AnimationTrack, GetKeyFrame, (unsigned), AnimationKeyFrame*), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimationTrack", "uint get_numKeyFrames() const", asMETHOD(AnimationTrack, GetNumKeyFrames), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimationTrack", "void Compress()", asMETHOD(AnimationTrack, Compress), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimationTrack", "void Decompress()", asMETHOD(AnimationTrack, Decompress), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimationTrack", "bool get_compressed() const", asMETHOD(AnimationTrack, IsCompressed), asCALL_THISCALL);
     engine->RegisterObjectProperty("AnimationTrack", "uint8 channelMask", offsetof(AnimationTrack, channelMask_));
     engine->RegisterObjectProperty("AnimationTrack", "const String name", offsetof(AnimationTrack, name_));
     engine->RegisterObjectProperty("AnimationTrack", "const StringHash nameHash", offsetof(AnimationTrack, nameHash_));
@@ -1128,6 +1131,7 @@ static void RegisterAnimation(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Animation", "void RemoveTrigger(uint)", asMETHOD(Animation, RemoveTrigger), asCALL_THISCALL);
     engine->RegisterObjectMethod("Animation", "void RemoveAllTriggers()", asMETHOD(Animation, RemoveAllTriggers), asCALL_THISCALL);
     engine->RegisterObjectMethod("Animation", "Animation@ Clone(const String&in cloneName = String()) const", asFUNCTION(AnimationClone), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("Animation", "void Compress()", asMETHOD(Animation, Compress), asCALL_THISCALL);
     engine->RegisterObjectMethod("Animation", "void set_animationName(const String&in) const", asMETHOD(Animation, SetAnimationName), asCALL_THISCALL);
     engine->RegisterObjectMethod("Animation", "const String& get_animationName() const", asMETHOD(Animation, GetAnimationName), asCALL_THISCALL);
     engine->RegisterObjectMethod("Animation", "void set_length(float)", asMETHOD(Animation, SetLength), asCALL_THISCALL);
@@ -1419,6 +1423,12 @@ static void RegisterAnimatedModel(asIScriptEngine* engine)
     engine->RegisterObjectMethod("AnimatedModel", "float get_animationLodBias() const", asMETHOD(AnimatedModel, GetAnimationLodBias), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimatedModel", "void set_updateInvisible(bool)", asMETHOD(AnimatedModel, SetUpdateInvisible), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimatedModel", "bool get_updateInvisible() const", asMETHOD(AnimatedModel, GetUpdateInvisible), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "void set_animationLodInterpolation(bool)", asMETHOD(AnimatedModel, SetAnimationLodInterpolation), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "bool get_animationLodInterpolation() const", asMETHOD(AnimatedModel, GetAnimationLodInterpolation), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "void set_boneLodDistance(float)", asMETHOD(AnimatedModel, SetBoneLodDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "float get_boneLodDistance() const", asMETHOD(AnimatedModel, GetBoneLodDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "void set_updateBoneNodes(bool)", asMETHOD(AnimatedModel, SetUpdateBoneNodes), asCALL_THISCALL);
+    engine->RegisterObjectMethod("AnimatedModel", "bool get_updateBoneNodes() const", asMETHOD(AnimatedModel, GetUpdateBoneNodes), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimatedModel", "Skeleton@+ get_skeleton()", asMETHOD(AnimatedModel, GetSkeleton), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimatedModel", "uint get_numAnimationStates() const", asMETHOD(AnimatedModel, GetNumAnimationStates), asCALL_THISCALL);
     engine->RegisterObjectMethod("AnimatedModel", "AnimationState@+ get_animationStates(const String&in) const", asMETHODPR(AnimatedModel, GetAnimationState, (const String&) const, AnimationState*), asCALL_THISCALL);
@@ -2026,6 +2036,8 @@ static void RegisterRenderer(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Renderer", "float get_occluderSizeThreshold() const", asMETHOD(Renderer, GetOccluderSizeThreshold), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "void set_threadedOcclusion(bool)", asMETHOD(Renderer, SetThreadedOcclusion), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "bool get_threadedOcclusion() const", asMETHOD(Renderer, GetThreadedOcclusion), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Renderer", "void set_batchCaching(bool)", asMETHOD(Renderer, SetBatchCaching), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Renderer", "bool get_batchCaching() const", asMETHOD(Renderer, GetBatchCaching), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "void set_mobileShadowBiasMul(float)", asMETHOD(Renderer, SetMobileShadowBiasMul), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "float get_mobileShadowBiasMul() const", asMETHOD(Renderer, GetMobileShadowBiasMul), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "void set_mobileShadowBiasAdd(float)", asMETHOD(Renderer, SetMobileShadowBiasAdd), asCALL_THISCALL);
@@ -2039,6 +2051,8 @@ static void RegisterRenderer(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Renderer", "uint get_numLights(bool) const", asMETHOD(Renderer, GetNumLights), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "uint get_numShadowMaps(bool) const", asMETHOD(Renderer, GetNumShadowMaps), asCALL_THISCALL);
     engine->RegisterObjectMethod("Renderer", "uint get_numOccluders(bool) const", asMETHOD(Renderer, GetNumOccluders), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Renderer", "uint get_numBatchCacheHits(bool) const", asMETHOD(Renderer, GetNumBatchCacheHits), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Renderer", "uint get_numBatchCacheMisses(bool) const", asMETHOD(Renderer, GetNumBatchCacheMisses), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Renderer@+ get_renderer()", asFUNCTION(GetRenderer), asCALL_CDECL);
 }
 
@@ -2191,6 +2205,10 @@ static void RegisterOctree(asIScriptEngine* engine)
     engine->RegisterObjectMethod("RayQueryResult", "Node@+ get_node() const", asFUNCTION(RayQueryResultGetNode), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectProperty("RayQueryResult", "uint subObject", offsetof(RayQueryResult, subObject_));
 
+    engine->RegisterEnum("SpatialIndex");
+    engine->RegisterEnumValue("SpatialIndex", "SPATIAL_INDEX_OCTREE", SPATIAL_INDEX_OCTREE);
+    engine->RegisterEnumValue("SpatialIndex", "SPATIAL_INDEX_BVH", SPATIAL_INDEX_BVH);
+
     RegisterComponent<Octree>(engine, "Octree");
     engine->RegisterObjectMethod("Octree", "void SetSize(const BoundingBox&in, uint)", asMETHOD(Octree, SetSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("Octree", "void DrawDebugGeometry(bool) const", asMETHODPR(Octree, DrawDebugGeometry, (bool), void), asCALL_THISCALL);
@@ -2205,6 +2223,10 @@ static void RegisterOctree(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Octree", "Array<Drawable@>@ GetAllDrawables(uint8 drawableFlags = DRAWABLE_ANY, uint viewMask = DEFAULT_VIEWMASK)", asFUNCTION(OctreeGetAllDrawables), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Octree", "const BoundingBox& get_worldBoundingBox() const", asMETHODPR(Octree, GetWorldBoundingBox, () const, const BoundingBox&), asCALL_THISCALL);
     engine->RegisterObjectMethod("Octree", "uint get_numLevels() const", asMETHOD(Octree, GetNumLevels), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Octree", "void set_spatialIndex(SpatialIndex)", asMETHOD(Octree, SetSpatialIndex), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Octree", "SpatialIndex get_spatialIndex() const", asMETHOD(Octree, GetSpatialIndex), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Octree", "void set_bvhMargin(float)", asMETHOD(Octree, SetBVHMargin), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Octree", "float get_bvhMargin() const", asMETHOD(Octree, GetBVHMargin), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "Octree@+ get_octree() const", asFUNCTION(SceneGetOctree), asCALL_CDECL_OBJLAST);
     engine->RegisterGlobalFunction("Octree@+ get_octree()", asFUNCTION(GetOctree), asCALL_CDECL);
 }
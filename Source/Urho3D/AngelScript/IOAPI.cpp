@@ -168,6 +168,14 @@ static void RegisterLog(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Log", "String get_lastMessage()", asMETHOD(Log, GetLastMessage), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "void set_quiet(bool)", asMETHOD(Log, SetQuiet), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "bool get_quiet() const", asMETHOD(Log, IsQuiet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void OpenJSON(const String&in)", asMETHOD(Log, OpenJSON), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void CloseJSON()", asMETHOD(Log, CloseJSON), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_async(bool)", asMETHOD(Log, SetAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "bool get_async() const", asMETHOD(Log, IsAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_maxRepeats(uint)", asMETHOD(Log, SetMaxRepeats), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_maxRepeats() const", asMETHOD(Log, GetMaxRepeats), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_numDroppedMessages() const", asMETHOD(Log, GetNumDroppedMessages), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_numSuppressedMessages() const", asMETHOD(Log, GetNumSuppressedMessages), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Log@+ get_log()", asFUNCTION(GetLog), asCALL_CDECL);
 
     // Register also Print() functions for convenience
@@ -425,6 +433,7 @@ static void RegisterPackageFile(asIScriptEngine* engine)
     engine->RegisterObjectMethod("PackageFile", "uint get_totalDataSize() const", asMETHOD(PackageFile, GetTotalDataSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("PackageFile", "uint get_checksum() const", asMETHOD(PackageFile, GetChecksum), asCALL_THISCALL);
     engine->RegisterObjectMethod("PackageFile", "bool compressed() const", asMETHOD(PackageFile, IsCompressed), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PackageFile", "uint get_blockSize() const", asMETHOD(PackageFile, GetBlockSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("PackageFile", "Array<String>@ GetEntryNames() const", asFUNCTION(PackageFileGetEntryNames), asCALL_CDECL_OBJLAST);
 }
 
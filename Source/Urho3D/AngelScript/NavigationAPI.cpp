@@ -131,6 +131,9 @@ template<class T> static void RegisterNavMeshBase(asIScriptEngine* engine, const
     engine->RegisterObjectMethod(name, "float GetAreaCost(uint) const", asMETHOD(T, GetAreaCost), asCALL_THISCALL);
     engine->RegisterObjectMethod(name, "Vector3 FindNearestPoint(const Vector3&in, const Vector3&in extents = Vector3(1.0, 1.0, 1.0))", asFUNCTION(NavigationMeshFindNearestPoint), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod(name, "Vector3 MoveAlongSurface(const Vector3&in, const Vector3&in, const Vector3&in extents = Vector3(1.0, 1.0, 1.0), int maxVisited = 3)", asFUNCTION(NavigationMeshMoveAlongSurface), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod(name, "uint FindPathAsync(const Vector3&in, const Vector3&in, const Vector3&in extents = Vector3(1.0, 1.0, 1.0))", asMETHOD(T, FindPathAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void CancelPathRequest(uint)", asMETHOD(T, CancelPathRequest), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "bool IsPathRequestPending(uint) const", asMETHOD(T, IsPathRequestPending), asCALL_THISCALL);
     engine->RegisterObjectMethod(name, "Vector3 GetRandomPoint()", asFUNCTION(NavigationMeshGetRandomPoint), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod(name, "Vector3 GetRandomPointInCircle(const Vector3&in, float, const Vector3&in extents = Vector3(1.0, 1.0, 1.0))", asFUNCTION(NavigationMeshGetRandomPointInCircle), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod(name, "float GetDistanceToWall(const Vector3&in, float, const Vector3&in extents = Vector3(1.0, 1.0, 1.0))", asFUNCTION(NavigationMeshGetDistanceToWall), asCALL_CDECL_OBJLAST);
@@ -174,6 +177,17 @@ template<class T> static void RegisterNavMeshBase(asIScriptEngine* engine, const
     engine->RegisterObjectMethod(name, "bool get_drawOffMeshConnections() const", asMETHOD(T, GetDrawOffMeshConnections), asCALL_THISCALL);
     engine->RegisterObjectMethod(name, "void set_drawNavAreas(bool)", asMETHOD(T, SetDrawNavAreas), asCALL_THISCALL);
     engine->RegisterObjectMethod(name, "bool get_drawNavAreas() const", asMETHOD(T, GetDrawNavAreas), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void set_asyncBuild(bool)", asMETHOD(T, SetAsyncBuild), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "bool get_asyncBuild() const", asMETHOD(T, GetAsyncBuild), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "bool get_building() const", asMETHOD(T, IsBuilding), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "float get_buildProgress() const", asMETHOD(T, GetBuildProgress), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void CompleteBuild()", asMETHOD(T, CompleteBuild), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void CancelBuild()", asMETHOD(T, CancelBuild), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void set_pathQueryBudget(int)", asMETHOD(T, SetPathQueryBudget), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "int get_pathQueryBudget() const", asMETHOD(T, GetPathQueryBudget), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "void set_pathCacheSize(uint)", asMETHOD(T, SetPathCacheSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "uint get_pathCacheSize() const", asMETHOD(T, GetPathCacheSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod(name, "uint get_numPathRequests() const", asMETHOD(T, GetNumPathRequests), asCALL_THISCALL);
 }
 
 void RegisterNavigationMesh(asIScriptEngine* engine)
@@ -397,6 +397,10 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "LoadMode get_asyncLoadMode() const", asMETHOD(Scene, GetAsyncLoadMode), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void set_asyncLoadingMs(int)", asMETHOD(Scene, SetAsyncLoadingMs), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "int get_asyncLoadingMs() const", asMETHOD(Scene, GetAsyncLoadingMs), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_networkGridCellSize(float)", asMETHOD(Scene, SetNetworkGridCellSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "float get_networkGridCellSize() const", asMETHOD(Scene, GetNetworkGridCellSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_batchedTransforms(bool)", asMETHOD(Scene, SetBatchedTransforms), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool get_batchedTransforms() const", asMETHOD(Scene, GetBatchedTransforms), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "uint get_checksum() const", asMETHOD(Scene, GetChecksum), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "const String& get_fileName() const", asMETHOD(Scene, GetFileName), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "Array<PackageFile@>@ get_requiredPackageFiles() const", asFUNCTION(SceneGetRequiredPackageFiles), asCALL_CDECL_OBJLAST);
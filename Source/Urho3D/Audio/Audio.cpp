@@ -30,10 +30,18 @@
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
+#include "../Container/Sort.h"
 #include "../IO/Log.h"
 
 #include <SDL/SDL.h>
 
+#if defined(URHO3D_SSE)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define URHO3D_AUDIO_NEON
+#endif
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -49,14 +57,54 @@ static const int MIN_BUFFERLENGTH = 20;
 static const int MIN_MIXRATE = 11025;
 static const int MAX_MIXRATE = 48000;
 static const StringHash SOUND_MASTER_HASH("Master");
+/// Default gain below which a voice is inaudible. The former fixed point mixer rounded such voices to silence.
+static const float DEFAULT_VIRTUAL_GAIN_THRESHOLD = 1.0f / 512.0f;
 
 static void SDLAudioCallback(void* userdata, Uint8* stream, int len);
 
+/// Convert mixed samples to 16-bit output with clipping.
+static void ClipSamples(short* dest, const float* src, unsigned count)
+{
+    unsigned i = 0;
+#if defined(URHO3D_SSE)
+    __m128 minValue = _mm_set1_ps(-32768.0f);
+    __m128 maxValue = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[i]), minValue), maxValue));
+        __m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[i + 4]), minValue), maxValue));
+        _mm_storeu_si128((__m128i*)&dest[i], _mm_packs_epi32(a, b));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    float32x4_t minValue = vdupq_n_f32(-32768.0f);
+    float32x4_t maxValue = vdupq_n_f32(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        int32x4_t a = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vld1q_f32(&src[i]), minValue), maxValue));
+        int32x4_t b = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vld1q_f32(&src[i + 4]), minValue), maxValue));
+        vst1q_s16(&dest[i], vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = (short)Clamp(src[i], -32768.0f, 32767.0f);
+}
+
+/// Compare voices by descending gain.
+static bool CompareVoices(const Pair<float, SoundSource*>& lhs, const Pair<float, SoundSource*>& rhs)
+{
+    return lhs.first_ > rhs.first_;
+}
+
 Audio::Audio(Context* context) :
     Object(context),
     deviceID_(0),
     sampleSize_(0),
-    playing_(false)
+    playing_(false),
+    offline_(false),
+    maxVoices_(0),
+    virtualGainThreshold_(DEFAULT_VIRTUAL_GAIN_THRESHOLD),
+    numAudibleVoices_(0),
+    profiler_(GetSubsystem<Profiler>())
 {
     context_->RequireSDL(SDL_INIT_AUDIO);
 
@@ -121,7 +169,7 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     fragmentSize_ = Min(NextPowerOfTwo((unsigned)(mixRate >> 6)), (unsigned)obtained.samples);
     mixRate_ = obtained.freq;
     interpolation_ = interpolation;
-    clipBuffer_ = new int[stereo ? fragmentSize_ << 1 : fragmentSize_];
+    clipBuffer_ = new float[stereo ? fragmentSize_ << 1 : fragmentSize_];
 
     URHO3D_LOGINFO("Set audio mode " + String(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " +
             (interpolation_ ? "interpolated" : ""));
@@ -129,6 +177,24 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     return Play();
 }
 
+bool Audio::SetOfflineMode(int mixRate, bool stereo, bool interpolation)
+{
+    Release();
+
+    offline_ = true;
+    stereo_ = stereo;
+    sampleSize_ = (unsigned)(stereo_ ? sizeof(int) : sizeof(short));
+    mixRate_ = Clamp(mixRate, MIN_MIXRATE, MAX_MIXRATE);
+    fragmentSize_ = NextPowerOfTwo((unsigned)(mixRate_ >> 6));
+    interpolation_ = interpolation;
+    clipBuffer_ = new float[stereo ? fragmentSize_ << 1 : fragmentSize_];
+
+    URHO3D_LOGINFO("Set offline audio mode " + String(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " +
+            (interpolation_ ? "interpolated" : ""));
+
+    return Play();
+}
+
 void Audio::Update(float timeStep)
 {
     if (!playing_)
@@ -142,13 +208,14 @@ bool Audio::Play()
     if (playing_)
         return true;
 
-    if (!deviceID_)
+    if (!deviceID_ && !offline_)
     {
         URHO3D_LOGERROR("No audio mode set, can not start playback");
         return false;
     }
 
-    SDL_PauseAudioDevice(deviceID_, 0);
+    if (deviceID_)
+        SDL_PauseAudioDevice(deviceID_, 0);
 
     // Update sound sources before resuming playback to make sure 3D positions are up to date
     UpdateInternal(0.0f);
@@ -205,6 +272,16 @@ void Audio::StopSound(Sound* sound)
     }
 }
 
+void Audio::SetMaxVoices(unsigned voices)
+{
+    maxVoices_ = voices;
+}
+
+void Audio::SetVirtualGainThreshold(float gain)
+{
+    virtualGainThreshold_ = Max(gain, 0.0f);
+}
+
 float Audio::GetMasterGain(const String& type) const
 {
     // By definition previously unknown types return full volume
@@ -229,6 +306,9 @@ void Audio::AddSoundSource(SoundSource* soundSource)
 {
     MutexLock lock(audioMutex_);
     soundSources_.Push(soundSource);
+    // Reserve space for every source as a voice, so that collecting the voices in the audio thread does not allocate
+    if (voices_.Capacity() < soundSources_.Size())
+        voices_.Reserve(soundSources_.Capacity());
 }
 
 void Audio::RemoveSoundSource(SoundSource* soundSource)
@@ -267,6 +347,11 @@ void SDLAudioCallback(void* userdata, Uint8* stream, int len)
 
 void Audio::MixOutput(void* dest, unsigned samples)
 {
+#ifdef URHO3D_PROFILING
+    // Called in the audio thread, which must not look up subsystems
+    AutoProfileBlock profileBlock(profiler_, "MixAudio");
+#endif
+
     if (!playing_ || !clipBuffer_)
     {
         memset(dest, 0, samples * (size_t)sampleSize_);
@@ -282,10 +367,11 @@ void Audio::MixOutput(void* dest, unsigned samples)
             clipSamples <<= 1;
 
         // Clear clip buffer
-        int* clipPtr = clipBuffer_.Get();
-        memset(clipPtr, 0, clipSamples * sizeof(int));
+        float* clipPtr = clipBuffer_.Get();
+        memset(clipPtr, 0, clipSamples * sizeof(float));
 
-        // Mix samples to clip buffer
+        // Collect the playing voices with their effective gain
+        voices_.Clear();
         for (PODVector<SoundSource*>::Iterator i = soundSources_.Begin(); i != soundSources_.End(); ++i)
         {
             SoundSource* source = *i;
@@ -297,12 +383,27 @@ void Audio::MixOutput(void* dest, unsigned samples)
                     continue;
             }
 
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
+            if (source->IsPlaying())
+                voices_.Push(MakePair(source->GetEffectiveGain(), source));
+        }
+
+        // If the voice count is limited, mix the loudest voices first
+        if (maxVoices_ && voices_.Size() > maxVoices_)
+            Sort(voices_.Begin(), voices_.End(), CompareVoices);
+
+        // Mix samples to clip buffer. Inaudible voices and voices over the limit are virtual: only their playback position advances
+        unsigned audibleVoices = 0;
+        for (unsigned i = 0; i < voices_.Size(); ++i)
+        {
+            bool audible = voices_[i].first_ >= virtualGainThreshold_ && (!maxVoices_ || audibleVoices < maxVoices_);
+            if (audible)
+                ++audibleVoices;
+            voices_[i].second_->Mix(audible ? clipPtr : nullptr, workSamples, mixRate_, stereo_, interpolation_);
         }
+        numAudibleVoices_ = audibleVoices;
+
         // Copy output from clip buffer to destination
-        auto* destPtr = (short*)dest;
-        while (clipSamples--)
-            *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
+        ClipSamples((short*)dest, clipPtr, clipSamples);
         samples -= workSamples;
         ((unsigned char*&)dest) += sampleSize_ * workSamples;
     }
@@ -323,8 +424,10 @@ void Audio::Release()
     {
         SDL_CloseAudioDevice(deviceID_);
         deviceID_ = 0;
-        clipBuffer_.Reset();
     }
+
+    offline_ = false;
+    clipBuffer_.Reset();
 }
 
 void Audio::UpdateInternal(float timeStep)
@@ -32,6 +32,7 @@ namespace Urho3D
 {
 
 class AudioImpl;
+class Profiler;
 class Sound;
 class SoundListener;
 class SoundSource;
@@ -49,6 +50,8 @@ public:
 
     /// Initialize sound output with specified buffer length and output mode.
     bool SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpolation = true);
+    /// Initialize offline mixing with specified output mode without opening an audio device. Output is produced only by calling MixOutput().
+    bool SetOfflineMode(int mixRate, bool stereo, bool interpolation = true);
     /// Run update on sound sources. Not required for continued playback, but frees unused sound sources & sounds and updates 3D positions.
     void Update(float timeStep);
     /// Restart sound output.
@@ -67,6 +70,10 @@ public:
     void SetListener(SoundListener* listener);
     /// Stop any sound source playing a certain sound clip.
     void StopSound(Sound* sound);
+    /// Set maximum number of voices mixed audibly. The quietest voices above the limit are virtualized, only advancing their playback position. 0 (default) is unlimited.
+    void SetMaxVoices(unsigned voices);
+    /// Set gain below which a voice is inaudible and virtualized.
+    void SetVirtualGainThreshold(float gain);
 
     /// Return byte size of one sample.
     unsigned GetSampleSize() const { return sampleSize_; }
@@ -83,8 +90,20 @@ public:
     /// Return whether audio is being output.
     bool IsPlaying() const { return playing_; }
 
-    /// Return whether an audio stream has been reserved.
-    bool IsInitialized() const { return deviceID_ != 0; }
+    /// Return whether an audio stream has been reserved or offline mixing has been initialized.
+    bool IsInitialized() const { return deviceID_ != 0 || offline_; }
+
+    /// Return whether mixing offline without an audio device.
+    bool IsOffline() const { return offline_; }
+
+    /// Return maximum number of voices mixed audibly. 0 is unlimited.
+    unsigned GetMaxVoices() const { return maxVoices_; }
+
+    /// Return gain below which a voice is virtualized.
+    float GetVirtualGainThreshold() const { return virtualGainThreshold_; }
+
+    /// Return number of voices mixed audibly in the last output fragment.
+    unsigned GetNumAudibleVoices() const { return numAudibleVoices_; }
 
     /// Return master gain for a specific sound source type. Unknown sound types will return full gain (1).
     float GetMasterGain(const String& type) const;
@@ -124,7 +143,7 @@ private:
     void UpdateInternal(float timeStep);
 
     /// Clipping buffer for mixing.
-    SharedArrayPtr<int> clipBuffer_;
+    SharedArrayPtr<float> clipBuffer_;
     /// Audio thread mutex.
     Mutex audioMutex_;
     /// SDL audio device ID.
@@ -141,12 +160,24 @@ private:
     bool stereo_;
     /// Playing flag.
     bool playing_;
+    /// Offline mixing flag.
+    bool offline_;
+    /// Maximum number of audible voices.
+    unsigned maxVoices_;
+    /// Gain below which a voice is virtualized.
+    float virtualGainThreshold_;
+    /// Number of audible voices in the last output fragment.
+    unsigned numAudibleVoices_;
+    /// Profiler for the audio thread, looked up at construction.
+    Profiler* profiler_;
     /// Master gain by sound source type.
     HashMap<StringHash, Variant> masterGain_;
     /// Paused sound types.
     HashSet<StringHash> pausedSoundTypes_;
     /// Sound sources.
     PODVector<SoundSource*> soundSources_;
+    /// Playing sound sources with their effective gain, collected in the audio thread for voice virtualization. Capacity is reserved when sound sources are added.
+    PODVector<Pair<float, SoundSource*> > voices_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
 };
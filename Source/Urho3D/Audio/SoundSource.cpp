@@ -33,66 +33,109 @@
 #include "../Scene/Node.h"
 #include "../Scene/ReplicationState.h"
 
+#if defined(URHO3D_SSE)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define URHO3D_AUDIO_NEON
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
-#define INC_POS_LOOPED() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_ONESHOT() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define INC_POS_STEREO_LOOPED() \
-    pos += (intAdd << 1); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_STEREO_ONESHOT() \
-    pos += (intAdd << 1); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define GET_IP_SAMPLE() (((((int)pos[1] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_LEFT() (((((int)pos[2] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_RIGHT() (((((int)pos[3] - (int)pos[1]) * fractPos) / 65536) + (int)pos[1])
+/// Number of output samples resampled and mixed at a time.
+static const unsigned MIX_BLOCK_SIZE = 256;
+
+/// Convert fetched source samples to floating point.
+static void ConvertSamples(float* dest, const int* samples, unsigned count)
+{
+    unsigned i = 0;
+#if defined(URHO3D_SSE)
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(&dest[i], _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&samples[i])));
+#elif defined(URHO3D_AUDIO_NEON)
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(&dest[i], vcvtq_f32_s32(vld1q_s32(&samples[i])));
+#endif
+    for (; i < count; ++i)
+        dest[i] = (float)samples[i];
+}
+
+/// Linearly interpolate fetched source samples toward the next samples by 16-bit fractional positions, and convert to floating point.
+static void InterpolateSamples(float* dest, const int* samples, const int* next, const int* fract, unsigned count)
+{
+    const float fractScale = 1.0f / 65536.0f;
+    unsigned i = 0;
+#if defined(URHO3D_SSE)
+    __m128 scale = _mm_set1_ps(fractScale);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&samples[i]));
+        __m128 delta = _mm_sub_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&next[i])), s);
+        __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&fract[i])), scale);
+        _mm_storeu_ps(&dest[i], _mm_add_ps(s, _mm_mul_ps(delta, f)));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t s = vcvtq_f32_s32(vld1q_s32(&samples[i]));
+        float32x4_t delta = vsubq_f32(vcvtq_f32_s32(vld1q_s32(&next[i])), s);
+        float32x4_t f = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(&fract[i])), fractScale);
+        vst1q_f32(&dest[i], vmlaq_f32(s, delta, f));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = (float)samples[i] + (float)(next[i] - samples[i]) * ((float)fract[i] * fractScale);
+}
+
+/// Mix source samples with gain to a mono buffer.
+static void MixSamplesMono(float* dest, const float* samples, unsigned count, float gain)
+{
+    unsigned i = 0;
+#if defined(URHO3D_SSE)
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_loadu_ps(&dest[i]), _mm_mul_ps(_mm_loadu_ps(&samples[i]), g)));
+#elif defined(URHO3D_AUDIO_NEON)
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(&dest[i], vmlaq_n_f32(vld1q_f32(&dest[i]), vld1q_f32(&samples[i]), gain));
+#endif
+    for (; i < count; ++i)
+        dest[i] += samples[i] * gain;
+}
+
+/// Mix left and right source samples with per-channel gain to an interleaved stereo buffer. For a mono source both may point to the same samples.
+static void MixSamplesStereo(float* dest, const float* left, const float* right, unsigned count, float leftGain, float rightGain)
+{
+    unsigned i = 0;
+#if defined(URHO3D_SSE)
+    __m128 lg = _mm_set1_ps(leftGain);
+    __m128 rg = _mm_set1_ps(rightGain);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 l = _mm_mul_ps(_mm_loadu_ps(&left[i]), lg);
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(&right[i]), rg);
+        float* d = &dest[i << 1];
+        _mm_storeu_ps(d, _mm_add_ps(_mm_loadu_ps(d), _mm_unpacklo_ps(l, r)));
+        _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_unpackhi_ps(l, r)));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4x2_t d = vld2q_f32(&dest[i << 1]);
+        d.val[0] = vmlaq_n_f32(d.val[0], vld1q_f32(&left[i]), leftGain);
+        d.val[1] = vmlaq_n_f32(d.val[1], vld1q_f32(&right[i]), rightGain);
+        vst2q_f32(&dest[i << 1], d);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dest[i << 1] += left[i] * leftGain;
+        dest[(i << 1) + 1] += right[i] * rightGain;
+    }
+}
 
 static const int STREAM_SAFETY_SAMPLES = 4;
 
@@ -316,6 +359,16 @@ bool SoundSource::IsPlaying() const
     return (sound_ || soundStream_) && position_ != nullptr;
 }
 
+float SoundSource::GetEffectiveGain() const
+{
+    float totalGain = masterGain_ * attenuation_ * gain_;
+    // Panning a mono sound raises the gain of one channel
+    Sound* sound = soundStream_ ? streamBuffer_.Get() : sound_.Get();
+    if (sound && !sound->IsStereo())
+        totalGain *= 1.0f + Abs(panning_);
+    return totalGain;
+}
+
 void SoundSource::SetPlayPosition(signed char* pos)
 {
     // Setting play position on a stream is not supported
@@ -363,7 +416,7 @@ void SoundSource::Update(float timeStep)
     }
 }
 
-void SoundSource::Mix(int* dest, unsigned samples, int mixRate, bool stereo, bool interpolation)
+void SoundSource::Mix(float* dest, unsigned samples, int mixRate, bool stereo, bool interpolation)
 {
     if (!position_ || (!sound_ && !soundStream_) || !IsEnabledEffective())
         return;
@@ -401,40 +454,34 @@ void SoundSource::Mix(int* dest, unsigned samples, int mixRate, bool stereo, boo
     if (!sound)
         return;
 
-    // Choose the correct mixing routine
-    if (!sound->IsStereo())
+    float totalGain = masterGain_ * attenuation_ * gain_;
+    float leftGain = totalGain;
+    float rightGain = totalGain;
+    // Panning applies only to mono sounds in stereo output
+    if (stereo && !sound->IsStereo())
     {
-        if (interpolation)
-        {
-            if (stereo)
-                MixMonoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixMonoToMonoIP(sound, dest, samples, mixRate);
-        }
+        leftGain *= 1.0f - panning_;
+        rightGain *= 1.0f + panning_;
+    }
+
+    if (!dest || (leftGain <= 0.0f && rightGain <= 0.0f))
+        MixZeroVolume(sound, samples, mixRate);
+    else if (sound->IsSixteenBit())
+    {
+        if (sound->IsStereo())
+            MixBlocks<short, true>(sound, dest, samples, mixRate, stereo, interpolation, leftGain, rightGain);
         else
-        {
-            if (stereo)
-                MixMonoToStereo(sound, dest, samples, mixRate);
-            else
-                MixMonoToMono(sound, dest, samples, mixRate);
-        }
+            MixBlocks<short, false>(sound, dest, samples, mixRate, stereo, interpolation, leftGain, rightGain);
     }
     else
     {
-        if (interpolation)
-        {
-            if (stereo)
-                MixStereoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixStereoToMonoIP(sound, dest, samples, mixRate);
-        }
+        // 8-bit samples are scaled to the 16-bit output range
+        leftGain *= 256.0f;
+        rightGain *= 256.0f;
+        if (sound->IsStereo())
+            MixBlocks<signed char, true>(sound, dest, samples, mixRate, stereo, interpolation, leftGain, rightGain);
         else
-        {
-            if (stereo)
-                MixStereoToStereo(sound, dest, samples, mixRate);
-            else
-                MixStereoToMono(sound, dest, samples, mixRate);
-        }
+            MixBlocks<signed char, false>(sound, dest, samples, mixRate, stereo, interpolation, leftGain, rightGain);
     }
 
     // Update the time position. In stream mode, copy unused data back to the beginning of the stream buffer
@@ -602,632 +649,173 @@ void SoundSource::SetPlayPositionLockless(signed char* pos)
     timePosition_ = ((float)(int)(size_t)(pos - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
 }
 
-void SoundSource::MixMonoToMono(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereo(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToMonoIP(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereoIP(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMono(Sound* sound, int* dest, unsigned samples, int mixRate)
+template <class T, bool StereoSound> void SoundSource::MixBlocks(Sound* sound, float* dest, unsigned samples, int mixRate, bool stereo,
+    bool interpolation, float leftGain, float rightGain)
 {
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
+    const int channels = StereoSound ? 2 : 1;
+    // Stereo sound to mono output mixes the average of both channels, summed already when fetching
+    const bool downmix = StereoSound && !stereo;
+    if (downmix)
+        leftGain *= 0.5f;
 
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToStereo(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
+    // Source samples fetched for one block, and the following samples with fractional positions for interpolation
+    int left[MIX_BLOCK_SIZE];
+    int right[MIX_BLOCK_SIZE];
+    int nextLeft[MIX_BLOCK_SIZE];
+    int nextRight[MIX_BLOCK_SIZE];
+    int fract[MIX_BLOCK_SIZE];
+    // Resampled floating point samples of one block
+    float leftOut[MIX_BLOCK_SIZE];
+    float rightOut[MIX_BLOCK_SIZE];
 
     float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
+    int intAdd = (int)add * channels;
     auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
+    unsigned frameStep = ((unsigned)add << 16) + (unsigned)fractAdd;
     int fractPos = fractPosition_;
 
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
+    auto* pos = (T*)position_;
+    auto* end = (T*)sound->GetEnd();
+    auto* repeat = (T*)sound->GetRepeat();
+    bool looped = sound->IsLooped();
+
+    while (samples && pos)
+    {
+        unsigned count = Min(samples, MIX_BLOCK_SIZE);
+        unsigned fetched = 0;
+
+        // Fetch the source samples. While the playback position can not reach the end, step with a fixed point position
+        // relative to the block start. Otherwise step one sample at a time with wrapping
+        while (fetched < count)
+        {
+            auto remaining = (unsigned)((end - pos) / channels);
+            unsigned safe = remaining ? count - fetched : 0;
+            if (safe && (unsigned long long)safe * frameStep + fractPos >= (unsigned long long)remaining << 16)
+                safe = (unsigned)(((unsigned long long)remaining * 65536 - fractPos - 1) / frameStep);
+
+            if (safe)
+            {
+                auto acc = (unsigned)fractPos;
+                unsigned last = fetched + safe;
+                if (interpolation)
+                {
+                    for (; fetched < last; ++fetched)
+                    {
+                        const T* p = pos + (acc >> 16) * channels;
+                        if (!StereoSound)
+                        {
+                            left[fetched] = p[0];
+                            nextLeft[fetched] = p[1];
+                        }
+                        else if (downmix)
+                        {
+                            left[fetched] = p[0] + p[1];
+                            nextLeft[fetched] = p[2] + p[3];
+                        }
+                        else
+                        {
+                            left[fetched] = p[0];
+                            right[fetched] = p[1];
+                            nextLeft[fetched] = p[2];
+                            nextRight[fetched] = p[3];
+                        }
+                        fract[fetched] = acc & 65535;
+                        acc += frameStep;
+                    }
+                }
+                else
+                {
+                    for (; fetched < last; ++fetched)
+                    {
+                        const T* p = pos + (acc >> 16) * channels;
+                        if (!StereoSound)
+                            left[fetched] = p[0];
+                        else if (downmix)
+                            left[fetched] = p[0] + p[1];
+                        else
+                        {
+                            left[fetched] = p[0];
+                            right[fetched] = p[1];
+                        }
+                        acc += frameStep;
+                    }
+                }
+                pos += (acc >> 16) * channels;
+                fractPos = acc & 65535;
+                continue;
+            }
+
+            if (!StereoSound)
+                left[fetched] = pos[0];
+            else if (downmix)
+                left[fetched] = pos[0] + pos[1];
+            else
             {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
+                left[fetched] = pos[0];
+                right[fetched] = pos[1];
             }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
+            if (interpolation)
             {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
+                if (!StereoSound)
+                    nextLeft[fetched] = pos[1];
+                else if (downmix)
+                    nextLeft[fetched] = pos[2] + pos[3];
+                else
+                {
+                    nextLeft[fetched] = pos[2];
+                    nextRight[fetched] = pos[3];
+                }
+                fract[fetched] = fractPos;
             }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
+            ++fetched;
 
-        if (sound->IsLooped())
-        {
-            while (samples--)
+            pos += intAdd;
+            fractPos += fractAdd;
+            if (fractPos > 65535)
             {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
+                fractPos &= 65535;
+                pos += channels;
             }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
+            if (pos >= end)
             {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
+                if (!looped)
+                {
+                    pos = nullptr;
+                    break;
+                }
+                while (pos >= end)
+                    pos -= (end - repeat);
             }
-            position_ = pos;
         }
-    }
 
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMonoIP(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
+        if (interpolation)
         {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
+            InterpolateSamples(leftOut, left, nextLeft, fract, fetched);
+            if (StereoSound && !downmix)
+                InterpolateSamples(rightOut, right, nextRight, fract, fetched);
         }
         else
         {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
+            ConvertSamples(leftOut, left, fetched);
+            if (StereoSound && !downmix)
+                ConvertSamples(rightOut, right, fetched);
         }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToStereoIP(Sound* sound, int* dest, unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
 
-        if (sound->IsLooped())
+        if (stereo)
         {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
+            MixSamplesStereo(dest, leftOut, StereoSound ? rightOut : leftOut, fetched, leftGain, rightGain);
+            dest += fetched << 1;
         }
         else
         {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
+            MixSamplesMono(dest, leftOut, fetched, leftGain);
+            dest += fetched;
         }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
 
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
+        samples -= fetched;
     }
 
+    position_ = (signed char*)pos;
     fractPosition_ = fractPos;
 }
 
@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include "../Container/Hash.h"
+#include "../Container/Swap.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Urho3D
+{
+
+/// Flat hash set/map base class. Elements are stored in one contiguous slot array using open addressing. Each slot has a control byte, which is either empty, deleted or the low 7 bits of the element's hash, and slots are probed in aligned groups by comparing the whole group of control bytes at once.
+/** Note that to prevent extra memory use due to vtable pointer, %FlatHashBase intentionally does not declare a virtual destructor
+    and therefore %FlatHashBase pointers should never be used.
+  */
+class URHO3D_API FlatHashBase
+{
+public:
+    /// Number of slots probed at once. Also the minimum capacity.
+    static const unsigned GROUP_SIZE = 16;
+    /// Control byte of an empty slot.
+    static const unsigned char CTRL_EMPTY = 0x80;
+    /// Control byte of an erased slot.
+    static const unsigned char CTRL_DELETED = 0xfe;
+
+    /// Construct.
+    FlatHashBase() :
+        ctrl_(nullptr),
+        capacity_(0),
+        size_(0),
+        growthLeft_(0)
+    {
+    }
+
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+
+    /// Return number of slots.
+    unsigned Capacity() const { return capacity_; }
+
+    /// Return whether has no elements.
+    bool Empty() const { return size_ == 0; }
+
+protected:
+    /// Swap the control bytes and counts with another flat hash set or map. The derived classes also swap their slots.
+    void Swap(FlatHashBase& rhs)
+    {
+        Urho3D::Swap(ctrl_, rhs.ctrl_);
+        Urho3D::Swap(capacity_, rhs.capacity_);
+        Urho3D::Swap(size_, rhs.size_);
+        Urho3D::Swap(growthLeft_, rhs.growthLeft_);
+    }
+
+    /// Return bitmask of the slots in a group whose control byte equals the value.
+    static unsigned MatchByte(const unsigned char* group, unsigned char value)
+    {
+#ifdef URHO3D_SSE
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < GROUP_SIZE; ++i)
+        {
+            if (group[i] == value)
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    /// Return bitmask of the empty or deleted slots in a group. These have the high bit set in the control byte.
+    static unsigned MatchFree(const unsigned char* group)
+    {
+#ifdef URHO3D_SSE
+        return (unsigned)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+        unsigned mask = 0;
+        for (unsigned i = 0; i < GROUP_SIZE; ++i)
+        {
+            if (group[i] & 0x80)
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    /// Return index of the lowest set bit in a nonzero mask.
+    static unsigned LowestBit(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (unsigned)index;
+#elif defined(__GNUC__)
+        return (unsigned)__builtin_ctz(mask);
+#else
+        unsigned index = 0;
+        while (!(mask & 1u))
+        {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    /// Scramble a key hash so that both the group index and the control byte bits are well distributed, as many MakeHash() variants return the value itself.
+    static unsigned MixHash(unsigned hash)
+    {
+        hash *= 0x9e3779b1u;
+        return hash ^ (hash >> 16);
+    }
+
+    /// Return the control byte for a full slot with the mixed hash.
+    static unsigned char HashToCtrl(unsigned hash) { return (unsigned char)(hash & 0x7f); }
+
+    /// Return the smallest capacity that holds the number of elements within the maximum load factor.
+    static unsigned CapacityFor(unsigned size)
+    {
+        unsigned capacity = GROUP_SIZE;
+        while (capacity - capacity / 8 < size)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    /// Return the first slot of the group to probe first for the mixed hash.
+    unsigned FirstGroup(unsigned hash) const { return ((hash >> 7) & (capacity_ / GROUP_SIZE - 1)) * GROUP_SIZE; }
+
+    /// Return the first slot of the next group in the probe sequence. Step starts from 1 and is incremented after each group.
+    unsigned NextGroup(unsigned group, unsigned step) const { return (group + step * GROUP_SIZE) & (capacity_ - 1); }
+
+    /// Return index of a free slot for inserting an element with the mixed hash. An empty slot must exist.
+    unsigned FindFreeSlot(unsigned hash) const
+    {
+        unsigned group = FirstGroup(hash);
+        for (unsigned step = 1;; ++step)
+        {
+            unsigned mask = MatchFree(ctrl_ + group);
+            if (mask)
+                return group + LowestBit(mask);
+            group = NextGroup(group, step);
+        }
+    }
+
+    /// Mark a slot full after constructing an element into it.
+    void SetFull(unsigned index, unsigned hash)
+    {
+        if (ctrl_[index] == CTRL_EMPTY)
+            --growthLeft_;
+        ctrl_[index] = HashToCtrl(hash);
+        ++size_;
+    }
+
+    /// Mark a slot free after destructing its element.
+    void SetErased(unsigned index)
+    {
+        // If the group still has empty slots, it has never been full and no probe sequence has continued past it,
+        // so the slot can be returned to empty instead of leaving a tombstone
+        if (MatchByte(ctrl_ + (index & ~(GROUP_SIZE - 1)), CTRL_EMPTY))
+        {
+            ctrl_[index] = CTRL_EMPTY;
+            ++growthLeft_;
+        }
+        else
+            ctrl_[index] = CTRL_DELETED;
+        --size_;
+    }
+
+    /// Return index of the first full slot at or after index, or capacity if none.
+    unsigned NextFull(unsigned index) const
+    {
+        while (index < capacity_)
+        {
+            unsigned group = index & ~(GROUP_SIZE - 1);
+            unsigned mask = ~MatchFree(ctrl_ + group) & (0xffffu << (index - group)) & 0xffffu;
+            if (mask)
+                return group + LowestBit(mask);
+            index = group + GROUP_SIZE;
+        }
+        return capacity_;
+    }
+
+    /// Allocate control bytes for a capacity, which must be a power of two and at least the group size, and mark all slots empty. Return the previous control bytes, which the caller must free.
+    unsigned char* AllocateCtrl(unsigned capacity);
+    /// Mark all slots empty.
+    void ResetCtrl();
+
+    /// Control bytes.
+    unsigned char* ctrl_;
+    /// Number of slots.
+    unsigned capacity_;
+    /// Number of elements.
+    unsigned size_;
+    /// Number of empty slots that can still be filled before a rehash is needed.
+    unsigned growthLeft_;
+};
+
+}
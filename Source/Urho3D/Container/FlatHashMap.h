@@ -0,0 +1,528 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/FlatHashBase.h"
+#include "../Container/Pair.h"
+#include "../Container/Vector.h"
+
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Flat hash map template class. Stores the key-value pairs in one contiguous array with open addressing, which avoids the per-node allocation and pointer chasing of HashMap. Iteration order is the slot order and not the insertion order, and it changes when the map grows. Iterators and pointers to values are invalidated by inserting new keys, but not by erasing.
+template <class T, class U> class FlatHashMap : public FlatHashBase
+{
+public:
+    using KeyType = T;
+    using ValueType = U;
+
+    /// Flat hash map key-value pair with const key.
+    class KeyValue
+    {
+    public:
+        /// Construct with key and value.
+        KeyValue(const T& first, const U& second) :
+            first_(first),
+            second_(second)
+        {
+        }
+
+        /// Copy-construct.
+        KeyValue(const KeyValue& value) :
+            first_(value.first_),
+            second_(value.second_)
+        {
+        }
+
+        /// Move-construct. The key is copied as it is const.
+        KeyValue(KeyValue&& value) :
+            first_(value.first_),
+            second_(std::move(value.second_))
+        {
+        }
+
+        /// Prevent assignment.
+        KeyValue& operator =(const KeyValue& rhs) = delete;
+
+        /// Test for equality with another pair.
+        bool operator ==(const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
+        /// Test for inequality with another pair.
+        bool operator !=(const KeyValue& rhs) const { return first_ != rhs.first_ || second_ != rhs.second_; }
+
+        /// Key.
+        const T first_;
+        /// Value.
+        U second_;
+    };
+
+    /// Flat hash map iterator.
+    struct Iterator
+    {
+        /// Construct.
+        Iterator() :
+            map_(nullptr),
+            index_(0)
+        {
+        }
+
+        /// Construct with a map and slot index.
+        Iterator(FlatHashMap* map, unsigned index) :
+            map_(map),
+            index_(index)
+        {
+        }
+
+        /// Preincrement the slot index.
+        Iterator& operator ++()
+        {
+            index_ = map_->NextFull(index_ + 1);
+            return *this;
+        }
+
+        /// Postincrement the slot index.
+        Iterator operator ++(int)
+        {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const Iterator& rhs) const { return index_ == rhs.index_ && map_ == rhs.map_; }
+        /// Test for inequality with another iterator.
+        bool operator !=(const Iterator& rhs) const { return index_ != rhs.index_ || map_ != rhs.map_; }
+
+        /// Point to the pair.
+        KeyValue* operator ->() const { return map_->slots_ + index_; }
+
+        /// Dereference the pair.
+        KeyValue& operator *() const { return map_->slots_[index_]; }
+
+        /// Map.
+        FlatHashMap* map_;
+        /// Slot index.
+        unsigned index_;
+    };
+
+    /// Flat hash map const iterator.
+    struct ConstIterator
+    {
+        /// Construct.
+        ConstIterator() :
+            map_(nullptr),
+            index_(0)
+        {
+        }
+
+        /// Construct with a map and slot index.
+        ConstIterator(const FlatHashMap* map, unsigned index) :
+            map_(map),
+            index_(index)
+        {
+        }
+
+        /// Construct from a non-const iterator.
+        ConstIterator(const Iterator& rhs) :        // NOLINT(google-explicit-constructor)
+            map_(rhs.map_),
+            index_(rhs.index_)
+        {
+        }
+
+        /// Preincrement the slot index.
+        ConstIterator& operator ++()
+        {
+            index_ = map_->NextFull(index_ + 1);
+            return *this;
+        }
+
+        /// Postincrement the slot index.
+        ConstIterator operator ++(int)
+        {
+            ConstIterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const ConstIterator& rhs) const { return index_ == rhs.index_ && map_ == rhs.map_; }
+        /// Test for inequality with another iterator.
+        bool operator !=(const ConstIterator& rhs) const { return index_ != rhs.index_ || map_ != rhs.map_; }
+
+        /// Point to the pair.
+        const KeyValue* operator ->() const { return map_->slots_ + index_; }
+
+        /// Dereference the pair.
+        const KeyValue& operator *() const { return map_->slots_[index_]; }
+
+        /// Map.
+        const FlatHashMap* map_;
+        /// Slot index.
+        unsigned index_;
+    };
+
+    /// Construct empty.
+    FlatHashMap() :
+        slots_(nullptr)
+    {
+    }
+
+    /// Construct from another flat hash map.
+    FlatHashMap(const FlatHashMap<T, U>& map) :
+        slots_(nullptr)
+    {
+        *this = map;
+    }
+
+    /// Move-construct from another flat hash map.
+    FlatHashMap(FlatHashMap<T, U>&& map) noexcept :
+        slots_(nullptr)
+    {
+        Swap(map);
+    }
+
+    /// Aggregate initialization constructor.
+    FlatHashMap(const std::initializer_list<Pair<T, U>>& list) :
+        slots_(nullptr)
+    {
+        Reserve((unsigned)list.size());
+        for (auto it = list.begin(); it != list.end(); it++)
+            Insert(*it);
+    }
+
+    /// Destruct.
+    ~FlatHashMap()
+    {
+        Clear();
+        delete[] ctrl_;
+        delete[] reinterpret_cast<unsigned char*>(slots_);
+    }
+
+    /// Assign a flat hash map.
+    FlatHashMap& operator =(const FlatHashMap<T, U>& rhs)
+    {
+        // In case of self-assignment do nothing
+        if (&rhs != this)
+        {
+            Clear();
+            Reserve(rhs.Size());
+            Insert(rhs);
+        }
+        return *this;
+    }
+
+    /// Move-assign a flat hash map.
+    FlatHashMap& operator =(FlatHashMap<T, U>&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
+
+    /// Add-assign a pair.
+    FlatHashMap& operator +=(const Pair<T, U>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Add-assign a flat hash map.
+    FlatHashMap& operator +=(const FlatHashMap<T, U>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Test for equality with another flat hash map.
+    bool operator ==(const FlatHashMap<T, U>& rhs) const
+    {
+        if (rhs.Size() != Size())
+            return false;
+
+        for (ConstIterator i = Begin(); i != End(); ++i)
+        {
+            ConstIterator j = rhs.Find(i->first_);
+            if (j == rhs.End() || j->second_ != i->second_)
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Test for inequality with another flat hash map.
+    bool operator !=(const FlatHashMap<T, U>& rhs) const { return !(*this == rhs); }
+
+    /// Index the map. Create a new pair if key not found.
+    U& operator [](const T& key)
+    {
+        unsigned hash = MixHash(MakeHash(key));
+        unsigned index = FindIndex(key, hash);
+        if (index == capacity_)
+            index = InsertSlot(key, U(), hash);
+        return slots_[index].second_;
+    }
+
+    /// Index the map. Return null if key is not found, does not create a new pair.
+    U* operator [](const T& key) const
+    {
+        unsigned index = FindIndex(key, MixHash(MakeHash(key)));
+        return index != capacity_ ? &slots_[index].second_ : nullptr;
+    }
+
+    /// Insert a pair. Return an iterator to it.
+    Iterator Insert(const Pair<T, U>& pair)
+    {
+        bool exists;
+        return Insert(pair, exists);
+    }
+
+    /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
+    Iterator Insert(const Pair<T, U>& pair, bool& exists)
+    {
+        unsigned hash = MixHash(MakeHash(pair.first_));
+        unsigned index = FindIndex(pair.first_, hash);
+        exists = index != capacity_;
+        if (exists)
+            slots_[index].second_ = pair.second_;
+        else
+            index = InsertSlot(pair.first_, pair.second_, hash);
+        return Iterator(this, index);
+    }
+
+    /// Insert a flat hash map.
+    void Insert(const FlatHashMap<T, U>& map)
+    {
+        for (ConstIterator it = map.Begin(); it != map.End(); ++it)
+            Insert(Pair<T, U>(it->first_, it->second_));
+    }
+
+    /// Insert a pair by iterator. Return iterator to the value.
+    Iterator Insert(const ConstIterator& it) { return Insert(Pair<T, U>(it->first_, it->second_)); }
+
+    /// Insert a range by iterators.
+    void Insert(const ConstIterator& start, const ConstIterator& end)
+    {
+        ConstIterator it = start;
+        while (it != end)
+            Insert(it++);
+    }
+
+    /// Erase a pair by key. Return true if was found.
+    bool Erase(const T& key)
+    {
+        unsigned index = FindIndex(key, MixHash(MakeHash(key)));
+        if (index == capacity_)
+            return false;
+
+        EraseSlot(index);
+        return true;
+    }
+
+    /// Erase a pair by iterator. Return iterator to the next pair.
+    Iterator Erase(const Iterator& it)
+    {
+        if (it.map_ != this || it.index_ >= capacity_)
+            return End();
+
+        EraseSlot(it.index_);
+        return Iterator(this, NextFull(it.index_ + 1));
+    }
+
+    /// Clear the map. Keeps the allocated slots.
+    void Clear()
+    {
+        if (size_)
+        {
+            for (unsigned i = NextFull(0); i < capacity_; i = NextFull(i + 1))
+                (slots_ + i)->~KeyValue();
+        }
+        ResetCtrl();
+    }
+
+    /// Make room for the number of pairs without rehashing.
+    void Reserve(unsigned size)
+    {
+        unsigned capacity = CapacityFor(size);
+        if (capacity > capacity_)
+            Resize(capacity);
+    }
+
+    /// Swap with another flat hash map.
+    void Swap(FlatHashMap<T, U>& rhs)
+    {
+        FlatHashBase::Swap(rhs);
+        Urho3D::Swap(slots_, rhs.slots_);
+    }
+
+    /// Return iterator to the pair with key, or end iterator if not found.
+    Iterator Find(const T& key)
+    {
+        return Iterator(this, FindIndex(key, MixHash(MakeHash(key))));
+    }
+
+    /// Return const iterator to the pair with key, or end iterator if not found.
+    ConstIterator Find(const T& key) const
+    {
+        return ConstIterator(this, FindIndex(key, MixHash(MakeHash(key))));
+    }
+
+    /// Return whether contains a pair with key.
+    bool Contains(const T& key) const { return FindIndex(key, MixHash(MakeHash(key))) != capacity_; }
+
+    /// Try to copy value to output. Return true if was found.
+    bool TryGetValue(const T& key, U& out) const
+    {
+        unsigned index = FindIndex(key, MixHash(MakeHash(key)));
+        if (index == capacity_)
+            return false;
+
+        out = slots_[index].second_;
+        return true;
+    }
+
+    /// Return all the keys.
+    Vector<T> Keys() const
+    {
+        Vector<T> result;
+        result.Reserve(Size());
+        for (ConstIterator i = Begin(); i != End(); ++i)
+            result.Push(i->first_);
+        return result;
+    }
+
+    /// Return all the values.
+    Vector<U> Values() const
+    {
+        Vector<U> result;
+        result.Reserve(Size());
+        for (ConstIterator i = Begin(); i != End(); ++i)
+            result.Push(i->second_);
+        return result;
+    }
+
+    /// Return iterator to the beginning.
+    Iterator Begin() { return Iterator(this, NextFull(0)); }
+
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(this, NextFull(0)); }
+
+    /// Return iterator to the end.
+    Iterator End() { return Iterator(this, capacity_); }
+
+    /// Return iterator to the end.
+    ConstIterator End() const { return ConstIterator(this, capacity_); }
+
+private:
+    /// Return slot index of the key, or capacity if not found.
+    unsigned FindIndex(const T& key, unsigned hash) const
+    {
+        if (!size_)
+            return capacity_;
+
+        unsigned char h2 = HashToCtrl(hash);
+        unsigned group = FirstGroup(hash);
+        unsigned numGroups = capacity_ / GROUP_SIZE;
+        for (unsigned step = 1; step <= numGroups; ++step)
+        {
+            unsigned mask = MatchByte(ctrl_ + group, h2);
+            while (mask)
+            {
+                unsigned index = group + LowestBit(mask);
+                if (slots_[index].first_ == key)
+                    return index;
+                mask &= mask - 1;
+            }
+            // An empty slot ends the probe sequence, as the key would have been inserted there
+            if (MatchByte(ctrl_ + group, CTRL_EMPTY))
+                break;
+            group = NextGroup(group, step);
+        }
+
+        return capacity_;
+    }
+
+    /// Insert a key that does not exist yet. Return its slot index.
+    unsigned InsertSlot(const T& key, const U& value, unsigned hash)
+    {
+        if (!growthLeft_)
+        {
+            // If erases have left the slots mostly tombstones, rehash in place instead of growing
+            unsigned capacity = capacity_ ? capacity_ : GROUP_SIZE;
+            if (size_ >= (capacity - capacity / 8) / 2)
+                capacity = capacity_ ? capacity_ * 2 : GROUP_SIZE;
+            Resize(capacity);
+        }
+
+        unsigned index = FindFreeSlot(hash);
+        new(slots_ + index) KeyValue(key, value);
+        SetFull(index, hash);
+        return index;
+    }
+
+    /// Destruct the pair in a slot and mark it free.
+    void EraseSlot(unsigned index)
+    {
+        (slots_ + index)->~KeyValue();
+        SetErased(index);
+    }
+
+    /// Reallocate the slots and reinsert the pairs.
+    void Resize(unsigned capacity)
+    {
+        KeyValue* oldSlots = slots_;
+        unsigned oldCapacity = capacity_;
+        unsigned char* oldCtrl = AllocateCtrl(capacity);
+        slots_ = reinterpret_cast<KeyValue*>(new unsigned char[capacity * sizeof(KeyValue)]);
+
+        for (unsigned i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] & 0x80)
+                continue;
+
+            KeyValue* src = oldSlots + i;
+            unsigned hash = MixHash(MakeHash(src->first_));
+            unsigned index = FindFreeSlot(hash);
+            new(slots_ + index) KeyValue(std::move(*src));
+            SetFull(index, hash);
+            src->~KeyValue();
+        }
+
+        delete[] oldCtrl;
+        delete[] reinterpret_cast<unsigned char*>(oldSlots);
+    }
+
+    /// Key-value pair slots. Only slots with a full control byte hold a constructed pair.
+    KeyValue* slots_;
+};
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator begin(const Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator end(const Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator begin(Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator end(Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+}
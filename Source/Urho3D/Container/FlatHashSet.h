@@ -0,0 +1,361 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/FlatHashBase.h"
+#include "../Container/Vector.h"
+
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Flat hash set template class. Stores the keys in one contiguous array with open addressing, see FlatHashMap. Iteration order is the slot order and not the insertion order.
+template <class T> class FlatHashSet : public FlatHashBase
+{
+public:
+    /// Flat hash set iterator. Keys can not be modified through it.
+    struct ConstIterator
+    {
+        /// Construct.
+        ConstIterator() :
+            set_(nullptr),
+            index_(0)
+        {
+        }
+
+        /// Construct with a set and slot index.
+        ConstIterator(const FlatHashSet* set, unsigned index) :
+            set_(set),
+            index_(index)
+        {
+        }
+
+        /// Preincrement the slot index.
+        ConstIterator& operator ++()
+        {
+            index_ = set_->NextFull(index_ + 1);
+            return *this;
+        }
+
+        /// Postincrement the slot index.
+        ConstIterator operator ++(int)
+        {
+            ConstIterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        /// Test for equality with another iterator.
+        bool operator ==(const ConstIterator& rhs) const { return index_ == rhs.index_ && set_ == rhs.set_; }
+        /// Test for inequality with another iterator.
+        bool operator !=(const ConstIterator& rhs) const { return index_ != rhs.index_ || set_ != rhs.set_; }
+
+        /// Point to the key.
+        const T* operator ->() const { return set_->slots_ + index_; }
+
+        /// Dereference the key.
+        const T& operator *() const { return set_->slots_[index_]; }
+
+        /// Set.
+        const FlatHashSet* set_;
+        /// Slot index.
+        unsigned index_;
+    };
+
+    /// Keys can not be modified in place, so the non-const iterator is the same as the const iterator.
+    using Iterator = ConstIterator;
+
+    /// Construct empty.
+    FlatHashSet() :
+        slots_(nullptr)
+    {
+    }
+
+    /// Construct from another flat hash set.
+    FlatHashSet(const FlatHashSet<T>& set) :
+        slots_(nullptr)
+    {
+        *this = set;
+    }
+
+    /// Move-construct from another flat hash set.
+    FlatHashSet(FlatHashSet<T>&& set) noexcept :
+        slots_(nullptr)
+    {
+        Swap(set);
+    }
+
+    /// Aggregate initialization constructor.
+    FlatHashSet(const std::initializer_list<T>& list) :
+        slots_(nullptr)
+    {
+        Reserve((unsigned)list.size());
+        for (auto it = list.begin(); it != list.end(); it++)
+            Insert(*it);
+    }
+
+    /// Destruct.
+    ~FlatHashSet()
+    {
+        Clear();
+        delete[] ctrl_;
+        delete[] reinterpret_cast<unsigned char*>(slots_);
+    }
+
+    /// Assign a flat hash set.
+    FlatHashSet& operator =(const FlatHashSet<T>& rhs)
+    {
+        // In case of self-assignment do nothing
+        if (&rhs != this)
+        {
+            Clear();
+            Reserve(rhs.Size());
+            Insert(rhs);
+        }
+        return *this;
+    }
+
+    /// Move-assign a flat hash set.
+    FlatHashSet& operator =(FlatHashSet<T>&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
+
+    /// Add-assign a key.
+    FlatHashSet& operator +=(const T& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Add-assign a flat hash set.
+    FlatHashSet& operator +=(const FlatHashSet<T>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Test for equality with another flat hash set.
+    bool operator ==(const FlatHashSet<T>& rhs) const
+    {
+        if (rhs.Size() != Size())
+            return false;
+
+        for (ConstIterator it = Begin(); it != End(); ++it)
+        {
+            if (!rhs.Contains(*it))
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Test for inequality with another flat hash set.
+    bool operator !=(const FlatHashSet<T>& rhs) const { return !(*this == rhs); }
+
+    /// Insert a key. Return an iterator to it.
+    Iterator Insert(const T& key)
+    {
+        bool exists;
+        return Insert(key, exists);
+    }
+
+    /// Insert a key. Return an iterator and set exists flag according to whether the key already existed.
+    Iterator Insert(const T& key, bool& exists)
+    {
+        unsigned hash = MixHash(MakeHash(key));
+        unsigned index = FindIndex(key, hash);
+        exists = index != capacity_;
+        if (!exists)
+            index = InsertSlot(key, hash);
+        return Iterator(this, index);
+    }
+
+    /// Insert a set.
+    void Insert(const FlatHashSet<T>& set)
+    {
+        for (ConstIterator it = set.Begin(); it != set.End(); ++it)
+            Insert(*it);
+    }
+
+    /// Erase a key. Return true if was found.
+    bool Erase(const T& key)
+    {
+        unsigned index = FindIndex(key, MixHash(MakeHash(key)));
+        if (index == capacity_)
+            return false;
+
+        EraseSlot(index);
+        return true;
+    }
+
+    /// Erase a key by iterator. Return iterator to the next key.
+    Iterator Erase(const Iterator& it)
+    {
+        if (it.set_ != this || it.index_ >= capacity_)
+            return End();
+
+        EraseSlot(it.index_);
+        return Iterator(this, NextFull(it.index_ + 1));
+    }
+
+    /// Clear the set. Keeps the allocated slots.
+    void Clear()
+    {
+        if (size_)
+        {
+            for (unsigned i = NextFull(0); i < capacity_; i = NextFull(i + 1))
+                (slots_ + i)->~T();
+        }
+        ResetCtrl();
+    }
+
+    /// Make room for the number of keys without rehashing.
+    void Reserve(unsigned size)
+    {
+        unsigned capacity = CapacityFor(size);
+        if (capacity > capacity_)
+            Resize(capacity);
+    }
+
+    /// Swap with another flat hash set.
+    void Swap(FlatHashSet<T>& rhs)
+    {
+        FlatHashBase::Swap(rhs);
+        Urho3D::Swap(slots_, rhs.slots_);
+    }
+
+    /// Return iterator to the key, or end iterator if not found.
+    ConstIterator Find(const T& key) const { return ConstIterator(this, FindIndex(key, MixHash(MakeHash(key)))); }
+
+    /// Return whether contains a key.
+    bool Contains(const T& key) const { return FindIndex(key, MixHash(MakeHash(key))) != capacity_; }
+
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(this, NextFull(0)); }
+
+    /// Return iterator to the end.
+    ConstIterator End() const { return ConstIterator(this, capacity_); }
+
+    /// Return all the keys.
+    Vector<T> Keys() const
+    {
+        Vector<T> result;
+        result.Reserve(Size());
+        for (ConstIterator it = Begin(); it != End(); ++it)
+            result.Push(*it);
+        return result;
+    }
+
+private:
+    /// Return slot index of the key, or capacity if not found.
+    unsigned FindIndex(const T& key, unsigned hash) const
+    {
+        if (!size_)
+            return capacity_;
+
+        unsigned char h2 = HashToCtrl(hash);
+        unsigned group = FirstGroup(hash);
+        unsigned numGroups = capacity_ / GROUP_SIZE;
+        for (unsigned step = 1; step <= numGroups; ++step)
+        {
+            unsigned mask = MatchByte(ctrl_ + group, h2);
+            while (mask)
+            {
+                unsigned index = group + LowestBit(mask);
+                if (slots_[index] == key)
+                    return index;
+                mask &= mask - 1;
+            }
+            // An empty slot ends the probe sequence, as the key would have been inserted there
+            if (MatchByte(ctrl_ + group, CTRL_EMPTY))
+                break;
+            group = NextGroup(group, step);
+        }
+
+        return capacity_;
+    }
+
+    /// Insert a key that does not exist yet. Return its slot index.
+    unsigned InsertSlot(const T& key, unsigned hash)
+    {
+        if (!growthLeft_)
+        {
+            // If erases have left the slots mostly tombstones, rehash in place instead of growing
+            unsigned capacity = capacity_ ? capacity_ : GROUP_SIZE;
+            if (size_ >= (capacity - capacity / 8) / 2)
+                capacity = capacity_ ? capacity_ * 2 : GROUP_SIZE;
+            Resize(capacity);
+        }
+
+        unsigned index = FindFreeSlot(hash);
+        new(slots_ + index) T(key);
+        SetFull(index, hash);
+        return index;
+    }
+
+    /// Destruct the key in a slot and mark it free.
+    void EraseSlot(unsigned index)
+    {
+        (slots_ + index)->~T();
+        SetErased(index);
+    }
+
+    /// Reallocate the slots and reinsert the keys.
+    void Resize(unsigned capacity)
+    {
+        T* oldSlots = slots_;
+        unsigned oldCapacity = capacity_;
+        unsigned char* oldCtrl = AllocateCtrl(capacity);
+        slots_ = reinterpret_cast<T*>(new unsigned char[capacity * sizeof(T)]);
+
+        for (unsigned i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] & 0x80)
+                continue;
+
+            T* src = oldSlots + i;
+            unsigned hash = MixHash(MakeHash(*src));
+            unsigned index = FindFreeSlot(hash);
+            new(slots_ + index) T(std::move(*src));
+            SetFull(index, hash);
+            src->~T();
+        }
+
+        delete[] oldCtrl;
+        delete[] reinterpret_cast<unsigned char*>(oldSlots);
+    }
+
+    /// Key slots. Only slots with a full control byte hold a constructed key.
+    T* slots_;
+};
+
+template <class T> typename Urho3D::FlatHashSet<T>::ConstIterator begin(const Urho3D::FlatHashSet<T>& v) { return v.Begin(); }
+
+template <class T> typename Urho3D::FlatHashSet<T>::ConstIterator end(const Urho3D::FlatHashSet<T>& v) { return v.End(); }
+
+}
@@ -35,23 +35,21 @@
 namespace Urho3D
 {
 
-char String::endZero = 0;
-
 const String String::EMPTY;
 
 String::String(const WString& str) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     SetUTF8FromWChar(str.CString());
 }
 
 String::String(int value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
     *this = tempBuffer;
@@ -59,9 +57,9 @@ String::String(int value) :
 
 String::String(short value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
     *this = tempBuffer;
@@ -69,9 +67,9 @@ String::String(short value) :
 
 String::String(long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%ld", value);
     *this = tempBuffer;
@@ -79,9 +77,9 @@ String::String(long value) :
 
 String::String(long long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lld", value);
     *this = tempBuffer;
@@ -89,9 +87,9 @@ String::String(long long value) :
 
 String::String(unsigned value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
     *this = tempBuffer;
@@ -99,9 +97,9 @@ String::String(unsigned value) :
 
 String::String(unsigned short value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
     *this = tempBuffer;
@@ -109,9 +107,9 @@ String::String(unsigned short value) :
 
 String::String(unsigned long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lu", value);
     *this = tempBuffer;
@@ -119,9 +117,9 @@ String::String(unsigned long value) :
 
 String::String(unsigned long long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%llu", value);
     *this = tempBuffer;
@@ -129,9 +127,9 @@ String::String(unsigned long long value) :
 
 String::String(float value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%g", value);
     *this = tempBuffer;
@@ -139,9 +137,9 @@ String::String(float value) :
 
 String::String(double value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%.15g", value);
     *this = tempBuffer;
@@ -149,9 +147,9 @@ String::String(double value) :
 
 String::String(bool value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     if (value)
         *this = "true";
     else
@@ -160,21 +158,21 @@ String::String(bool value) :
 
 String::String(char value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     Resize(1);
-    buffer_[0] = value;
+    Buffer()[0] = value;
 }
 
 String::String(char value, unsigned length) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(INLINE_CAPACITY)
 {
+    data_.inline_[0] = 0;
     Resize(length);
     for (unsigned i = 0; i < length; ++i)
-        buffer_[i] = value;
+        Buffer()[i] = value;
 }
 
 String& String::operator +=(int rhs)
@@ -233,8 +231,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
     {
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (buffer_[i] == replaceThis)
-                buffer_[i] = replaceWith;
+            if (Buffer()[i] == replaceThis)
+                Buffer()[i] = replaceWith;
         }
     }
     else
@@ -242,8 +240,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
         replaceThis = (char)tolower(replaceThis);
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == replaceThis)
-                buffer_[i] = replaceWith;
+            if (tolower(Buffer()[i]) == replaceThis)
+                Buffer()[i] = replaceWith;
         }
     }
 }
@@ -268,7 +266,7 @@ void String::Replace(unsigned pos, unsigned length, const String& replaceWith)
     if (pos + length > length_)
         return;
 
-    Replace(pos, length, replaceWith.buffer_, replaceWith.length_);
+    Replace(pos, length, replaceWith.Buffer(), replaceWith.length_);
 }
 
 void String::Replace(unsigned pos, unsigned length, const char* replaceWith)
@@ -326,7 +324,7 @@ String& String::Append(const char* str, unsigned length)
     {
         unsigned oldLength = length_;
         Resize(oldLength + length);
-        CopyChars(&buffer_[oldLength], str, length);
+        CopyChars(&Buffer()[oldLength], str, length);
     }
     return *this;
 }
@@ -354,7 +352,7 @@ void String::Insert(unsigned pos, char c)
         unsigned oldLength = length_;
         Resize(length_ + 1);
         MoveRange(pos + 1, pos, oldLength - pos);
-        buffer_[pos] = c;
+        Buffer()[pos] = c;
     }
 }
 
@@ -417,38 +415,36 @@ String::Iterator String::Erase(const String::Iterator& start, const String::Iter
 
 void String::Resize(unsigned newLength)
 {
-    if (!capacity_)
-    {
-        // If zero length requested, do not allocate buffer yet
-        if (!newLength)
-            return;
-
-        // Calculate initial capacity
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
-
-        buffer_ = new char[capacity_];
-    }
-    else
+    if (capacity_ < newLength + 1)
     {
-        if (newLength && capacity_ < newLength + 1)
+        unsigned newCapacity;
+        if (capacity_ == INLINE_CAPACITY)
+        {
+            // Calculate initial capacity when outgrowing the inline buffer
+            newCapacity = newLength + 1;
+            if (newCapacity < MIN_CAPACITY)
+                newCapacity = MIN_CAPACITY;
+        }
+        else
         {
             // Increase the capacity with half each time it is exceeded
-            while (capacity_ < newLength + 1)
-                capacity_ += (capacity_ + 1) >> 1;
+            newCapacity = capacity_;
+            while (newCapacity < newLength + 1)
+                newCapacity += (newCapacity + 1) >> 1;
+        }
 
-            auto* newBuffer = new char[capacity_];
-            // Move the existing data to the new buffer, then delete the old buffer
-            if (length_)
-                CopyChars(newBuffer, buffer_, length_);
-            delete[] buffer_;
+        auto* newBuffer = new char[newCapacity];
+        // Move the existing data to the new buffer, then delete the old buffer
+        if (length_)
+            CopyChars(newBuffer, Buffer(), length_);
+        if (capacity_ > INLINE_CAPACITY)
+            delete[] data_.heap_;
 
-            buffer_ = newBuffer;
-        }
+        capacity_ = newCapacity;
+        data_.heap_ = newBuffer;
     }
 
-    buffer_[newLength] = 0;
+    Buffer()[newLength] = 0;
     length_ = newLength;
 }
 
@@ -456,22 +452,35 @@ void String::Reserve(unsigned newCapacity)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
+    if (newCapacity < INLINE_CAPACITY)
+        newCapacity = INLINE_CAPACITY;
     if (newCapacity == capacity_)
         return;
 
-    auto* newBuffer = new char[newCapacity];
-    // Move the existing data to the new buffer, then delete the old buffer
-    CopyChars(newBuffer, buffer_, length_ + 1);
-    if (capacity_)
-        delete[] buffer_;
+    if (newCapacity == INLINE_CAPACITY)
+    {
+        // Move back to the inline buffer
+        char* oldBuffer = data_.heap_;
+        CopyChars(data_.inline_, oldBuffer, length_ + 1);
+        delete[] oldBuffer;
+    }
+    else
+    {
+        auto* newBuffer = new char[newCapacity];
+        // Move the existing data to the new buffer, then delete the old buffer
+        CopyChars(newBuffer, Buffer(), length_ + 1);
+        if (capacity_ > INLINE_CAPACITY)
+            delete[] data_.heap_;
+
+        data_.heap_ = newBuffer;
+    }
 
     capacity_ = newCapacity;
-    buffer_ = newBuffer;
 }
 
 void String::Compact()
 {
-    if (capacity_)
+    if (capacity_ > INLINE_CAPACITY)
         Reserve(length_ + 1);
 }
 
@@ -484,7 +493,8 @@ void String::Swap(String& str)
 {
     Urho3D::Swap(length_, str.length_);
     Urho3D::Swap(capacity_, str.capacity_);
-    Urho3D::Swap(buffer_, str.buffer_);
+    // The union holds either the allocated pointer or the inline characters, so swapping it by value is enough
+    Urho3D::Swap(data_, str.data_);
 }
 
 String String::Substring(unsigned pos) const
@@ -493,7 +503,7 @@ String String::Substring(unsigned pos) const
     {
         String ret;
         ret.Resize(length_ - pos);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -509,7 +519,7 @@ String String::Substring(unsigned pos, unsigned length) const
         if (pos + length > length_)
             length = length_ - pos;
         ret.Resize(length);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.Buffer(), Buffer() + pos, ret.length_);
 
         return ret;
     }
@@ -524,14 +534,14 @@ String String::Trimmed() const
 
     while (trimStart < trimEnd)
     {
-        char c = buffer_[trimStart];
+        char c = Buffer()[trimStart];
         if (c != ' ' && c != 9)
             break;
         ++trimStart;
     }
     while (trimEnd > trimStart)
     {
-        char c = buffer_[trimEnd - 1];
+        char c = Buffer()[trimEnd - 1];
         if (c != ' ' && c != 9)
             break;
         --trimEnd;
@@ -544,7 +554,7 @@ String String::ToLower() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)tolower(buffer_[i]);
+        ret[i] = (char)tolower(Buffer()[i]);
 
     return ret;
 }
@@ -553,7 +563,7 @@ String String::ToUpper() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)toupper(buffer_[i]);
+        ret[i] = (char)toupper(Buffer()[i]);
 
     return ret;
 }
@@ -574,7 +584,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -583,7 +593,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -596,13 +606,13 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
     if (!str.length_ || str.length_ > length_)
         return NPOS;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i <= length_ - str.length_; ++i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -612,8 +622,8 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -648,7 +658,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (buffer_[i] == c)
+            if (Buffer()[i] == c)
                 return i;
         }
     }
@@ -657,7 +667,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(Buffer()[i]) == c)
                 return i;
         }
     }
@@ -672,13 +682,13 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
     if (startPos > length_ - str.length_)
         startPos = length_ - str.length_;
 
-    char first = str.buffer_[0];
+    char first = str.Buffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i < length_; --i)
     {
-        char c = buffer_[i];
+        char c = Buffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -687,8 +697,8 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = Buffer()[i + j];
+                char d = str.Buffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -781,10 +791,10 @@ unsigned String::LengthUTF8() const
 {
     unsigned ret = 0;
 
-    const char* src = buffer_;
+    const char* src = Buffer();
     if (!src)
         return ret;
-    const char* end = buffer_ + length_;
+    const char* end = Buffer() + length_;
 
     while (src < end)
     {
@@ -811,12 +821,12 @@ unsigned String::ByteOffsetUTF8(unsigned index) const
 
 unsigned String::NextUTF8Char(unsigned& byteOffset) const
 {
-    if (!buffer_)
+    if (!Buffer())
         return 0;
 
-    const char* src = buffer_ + byteOffset;
+    const char* src = Buffer() + byteOffset;
     unsigned ret = DecodeUTF8(src);
-    byteOffset = (unsigned)(src - buffer_);
+    byteOffset = (unsigned)(src - Buffer());
 
     return ret;
 }
@@ -1231,7 +1241,7 @@ void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsign
     else
         Resize(length_ + delta);
 
-    CopyChars(buffer_ + pos, srcStart, srcLength);
+    CopyChars(Buffer() + pos, srcStart, srcLength);
 }
 
 WString::WString() :
@@ -46,63 +46,72 @@ public:
     /// Construct empty.
     String() noexcept :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
     }
 
     /// Construct from another string.
     String(const String& str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         *this = str;
     }
 
+    /// Move-construct from another string.
+    String(String&& str) noexcept :
+        length_(0),
+        capacity_(INLINE_CAPACITY)
+    {
+        data_.inline_[0] = 0;
+        Swap(str);
+    }
+
     /// Construct from a C string.
     String(const char* str) :   // NOLINT(google-explicit-constructor)
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         *this = str;
     }
 
     /// Construct from a C string.
     String(char* str) :         // NOLINT(google-explicit-constructor)
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         *this = (const char*)str;
     }
 
     /// Construct from a char array and length.
     String(const char* str, unsigned length) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         Resize(length);
-        CopyChars(buffer_, str, length);
+        CopyChars(Buffer(), str, length);
     }
 
     /// Construct from a null-terminated wide character array.
     explicit String(const wchar_t* str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         SetUTF8FromWChar(str);
     }
 
     /// Construct from a null-terminated wide character array.
     explicit String(wchar_t* str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         SetUTF8FromWChar(str);
     }
 
@@ -139,34 +148,41 @@ public:
     /// Construct from a convertable value.
     template <class T> explicit String(const T& value) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(INLINE_CAPACITY)
     {
+        data_.inline_[0] = 0;
         *this = value.ToString();
     }
 
     /// Destruct.
     ~String()
     {
-        if (capacity_)
-            delete[] buffer_;
+        if (capacity_ > INLINE_CAPACITY)
+            delete[] data_.heap_;
     }
 
     /// Assign a string.
     String& operator =(const String& rhs)
     {
         Resize(rhs.length_);
-        CopyChars(buffer_, rhs.buffer_, rhs.length_);
+        CopyChars(Buffer(), rhs.Buffer(), rhs.length_);
 
         return *this;
     }
 
+    /// Move-assign a string.
+    String& operator =(String&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
+
     /// Assign a C string.
     String& operator =(const char* rhs)
     {
         unsigned rhsLength = CStringLength(rhs);
         Resize(rhsLength);
-        CopyChars(buffer_, rhs, rhsLength);
+        CopyChars(Buffer(), rhs, rhsLength);
 
         return *this;
     }
@@ -176,7 +192,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + rhs.length_);
-        CopyChars(buffer_ + oldLength, rhs.buffer_, rhs.length_);
+        CopyChars(Buffer() + oldLength, rhs.Buffer(), rhs.length_);
 
         return *this;
     }
@@ -187,7 +203,7 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         unsigned oldLength = length_;
         Resize(length_ + rhsLength);
-        CopyChars(buffer_ + oldLength, rhs, rhsLength);
+        CopyChars(Buffer() + oldLength, rhs, rhsLength);
 
         return *this;
     }
@@ -197,7 +213,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + 1);
-        buffer_[oldLength] = rhs;
+        Buffer()[oldLength] = rhs;
 
         return *this;
     }
@@ -231,8 +247,8 @@ public:
     {
         String ret;
         ret.Resize(length_ + rhs.length_);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs.buffer_, rhs.length_);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs.Buffer(), rhs.length_);
 
         return ret;
     }
@@ -243,8 +259,8 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         String ret;
         ret.Resize(length_ + rhsLength);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs, rhsLength);
+        CopyChars(ret.Buffer(), Buffer(), length_);
+        CopyChars(ret.Buffer() + length_, rhs, rhsLength);
 
         return ret;
     }
@@ -277,28 +293,28 @@ public:
     char& operator [](unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return const char at index.
     const char& operator [](unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return char at index.
     char& At(unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Return const char at index.
     const char& At(unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return Buffer()[index];
     }
 
     /// Replace all occurrences of a character.
@@ -351,22 +367,22 @@ public:
     void Swap(String& str);
 
     /// Return iterator to the beginning.
-    Iterator Begin() { return Iterator(buffer_); }
+    Iterator Begin() { return Iterator(Buffer()); }
 
     /// Return const iterator to the beginning.
-    ConstIterator Begin() const { return ConstIterator(buffer_); }
+    ConstIterator Begin() const { return ConstIterator(Buffer()); }
 
     /// Return iterator to the end.
-    Iterator End() { return Iterator(buffer_ + length_); }
+    Iterator End() { return Iterator(Buffer() + length_); }
 
     /// Return const iterator to the end.
-    ConstIterator End() const { return ConstIterator(buffer_ + length_); }
+    ConstIterator End() const { return ConstIterator(Buffer() + length_); }
 
     /// Return first char, or 0 if empty.
-    char Front() const { return buffer_[0]; }
+    char Front() const { return Buffer()[0]; }
 
     /// Return last char, or 0 if empty.
-    char Back() const { return length_ ? buffer_[length_ - 1] : buffer_[0]; }
+    char Back() const { return length_ ? Buffer()[length_ - 1] : Buffer()[0]; }
 
     /// Return a substring from position to end.
     String Substring(unsigned pos) const;
@@ -396,7 +412,7 @@ public:
     bool EndsWith(const String& str, bool caseSensitive = true) const;
 
     /// Return the C string.
-    const char* CString() const { return buffer_; }
+    const char* CString() const { return Buffer(); }
 
     /// Return length.
     unsigned Length() const { return length_; }
@@ -443,7 +459,7 @@ public:
     unsigned ToHash() const
     {
         unsigned hash = 0;
-        const char* ptr = buffer_;
+        const char* ptr = Buffer();
         while (*ptr)
         {
             hash = *ptr + (hash << 6) + (hash << 16) - hash;
@@ -483,15 +499,20 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size.
     static const unsigned MIN_CAPACITY = 8;
+    /// Size of the inline buffer used for short strings, including the terminating zero. 16 bytes on 64-bit platform, so that the string still fits in a Variant.
+    static const unsigned INLINE_CAPACITY = (unsigned)(sizeof(char*) * 3 - sizeof(unsigned) * 2);
     /// Empty string.
     static const String EMPTY;
 
 private:
+    /// Return the character buffer, which is the inline buffer until the string outgrows it.
+    char* Buffer() const { return capacity_ > INLINE_CAPACITY ? data_.heap_ : const_cast<char*>(data_.inline_); }
+
     /// Move a range of characters within the string.
     void MoveRange(unsigned dest, unsigned src, unsigned count)
     {
         if (count)
-            memmove(buffer_ + dest, buffer_ + src, count);
+            memmove(Buffer() + dest, Buffer() + src, count);
     }
 
     /// Copy chars from one buffer to another.
@@ -516,13 +537,16 @@ private:
 
     /// String length.
     unsigned length_;
-    /// Capacity, zero if buffer not allocated.
+    /// Capacity. Equal to INLINE_CAPACITY when the inline buffer is in use, larger when the buffer is allocated.
     unsigned capacity_;
-    /// String buffer, null if not allocated.
-    char* buffer_;
-
-    /// End zero for empty strings.
-    static char endZero;
+    /// String buffer.
+    union
+    {
+        /// Allocated buffer.
+        char* heap_;
+        /// Inline buffer for short strings.
+        char inline_[INLINE_CAPACITY];
+    } data_;
 };
 
 /// Add a string to a C string.
@@ -98,6 +98,49 @@ void EventReceiverGroup::Remove(Object* object)
         receivers_.Remove(object);
 }
 
+void TypedEventReceiverGroup::BeginSendEvent()
+{
+    ++inSend_;
+}
+
+void TypedEventReceiverGroup::EndSendEvent()
+{
+    assert(inSend_ > 0);
+    --inSend_;
+
+    if (inSend_ == 0 && dirty_)
+    {
+        for (unsigned i = handlers_.Size() - 1; i < handlers_.Size(); --i)
+        {
+            if (!handlers_[i])
+                handlers_.Erase(i);
+        }
+
+        dirty_ = false;
+    }
+}
+
+void TypedEventReceiverGroup::Add(TypedEventHandler* handler)
+{
+    if (handler)
+        handlers_.Push(handler);
+}
+
+void TypedEventReceiverGroup::Remove(TypedEventHandler* handler)
+{
+    if (inSend_ > 0)
+    {
+        PODVector<TypedEventHandler*>::Iterator i = handlers_.Find(handler);
+        if (i != handlers_.End())
+        {
+            (*i) = nullptr;
+            dirty_ = true;
+        }
+    }
+    else
+        handlers_.Remove(handler);
+}
+
 void RemoveNamedAttribute(HashMap<StringHash, Vector<AttributeInfo> >& attributes, StringHash objectType, const char* name)
 {
     HashMap<StringHash, Vector<AttributeInfo> >::Iterator i = attributes.Find(objectType);
@@ -421,10 +464,10 @@ void Context::AddEventReceiver(Object* receiver, Object* sender, StringHash even
 
 void Context::RemoveEventSender(Object* sender)
 {
-    HashMap<Object*, HashMap<StringHash, SharedPtr<EventReceiverGroup> > >::Iterator i = specificEventReceivers_.Find(sender);
+    FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> > >::Iterator i = specificEventReceivers_.Find(sender);
     if (i != specificEventReceivers_.End())
     {
-        for (HashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator j = i->second_.Begin(); j != i->second_.End(); ++j)
+        for (FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator j = i->second_.Begin(); j != i->second_.End(); ++j)
         {
             for (PODVector<Object*>::Iterator k = j->second_->receivers_.Begin(); k != j->second_->receivers_.End(); ++k)
             {
@@ -435,6 +478,28 @@ void Context::RemoveEventSender(Object* sender)
         }
         specificEventReceivers_.Erase(i);
     }
+
+    FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> > >::Iterator j =
+        specificTypedEventReceivers_.Find(sender);
+    if (j != specificTypedEventReceivers_.End())
+    {
+        // Collect the receivers first, as removing the handlers modifies the groups
+        PODVector<Object*> receivers;
+        for (FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> >::Iterator k = j->second_.Begin(); k != j->second_.End(); ++k)
+        {
+            for (PODVector<TypedEventHandler*>::Iterator l = k->second_->handlers_.Begin(); l != k->second_->handlers_.End(); ++l)
+            {
+                TypedEventHandler* handler = *l;
+                if (handler && !receivers.Contains(handler->GetReceiver()))
+                    receivers.Push(handler->GetReceiver());
+            }
+        }
+
+        for (PODVector<Object*>::Iterator k = receivers.Begin(); k != receivers.End(); ++k)
+            (*k)->RemoveTypedEventHandlers(StringHash::ZERO, sender);
+
+        specificTypedEventReceivers_.Erase(sender);
+    }
 }
 
 void Context::RemoveEventReceiver(Object* receiver, StringHash eventType)
@@ -451,6 +516,23 @@ void Context::RemoveEventReceiver(Object* receiver, Object* sender, StringHash e
         group->Remove(receiver);
 }
 
+void Context::AddTypedEventReceiver(TypedEventHandler* handler, TypedEventDispatchFunction dispatchFunction)
+{
+    SharedPtr<TypedEventReceiverGroup>& group = handler->GetSender() ?
+        specificTypedEventReceivers_[handler->GetSender()][handler->GetEventType()] : typedEventReceivers_[handler->GetEventType()];
+    if (!group)
+        group = new TypedEventReceiverGroup(dispatchFunction);
+    group->Add(handler);
+}
+
+void Context::RemoveTypedEventReceiver(TypedEventHandler* handler)
+{
+    TypedEventReceiverGroup* group = handler->GetSender() ? GetTypedEventReceivers(handler->GetSender(), handler->GetEventType()) :
+        GetTypedEventReceivers(handler->GetEventType());
+    if (group)
+        group->Remove(handler);
+}
+
 void Context::BeginSendEvent(Object* sender, StringHash eventType)
 {
 #ifdef URHO3D_PROFILING
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/HashSet.h"
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
@@ -62,6 +63,42 @@ private:
     bool dirty_;
 };
 
+/// Tracking structure for typed event receivers.
+class URHO3D_API TypedEventReceiverGroup : public RefCounted
+{
+public:
+    /// Construct with the function that sends VariantMap event data to the typed handlers of the event type.
+    explicit TypedEventReceiverGroup(TypedEventDispatchFunction dispatchFunction) :
+        dispatchFunction_(dispatchFunction),
+        inSend_(0),
+        dirty_(false)
+    {
+    }
+
+    /// Begin event send. When handlers are removed during send, group has to be cleaned up afterward.
+    void BeginSendEvent();
+
+    /// End event send. Clean up if necessary.
+    void EndSendEvent();
+
+    /// Add handler.
+    void Add(TypedEventHandler* handler);
+
+    /// Remove handler. Leave holes during send, which requires later cleanup.
+    void Remove(TypedEventHandler* handler);
+
+    /// Handlers in subscription order. May contain holes during sending.
+    PODVector<TypedEventHandler*> handlers_;
+    /// Function that sends VariantMap event data to the handlers.
+    TypedEventDispatchFunction dispatchFunction_;
+
+private:
+    /// "In send" recursion counter.
+    unsigned inSend_;
+    /// Cleanup required flag.
+    bool dirty_;
+};
+
 /// Urho3D execution context. Provides access to subsystems, object factories and attributes, and event receivers.
 class URHO3D_API Context : public RefCounted
 {
@@ -186,10 +223,10 @@ public:
     /// Return event receivers for a sender and event type, or null if they do not exist.
     EventReceiverGroup* GetEventReceivers(Object* sender, StringHash eventType)
     {
-        HashMap<Object*, HashMap<StringHash, SharedPtr<EventReceiverGroup> > >::Iterator i = specificEventReceivers_.Find(sender);
+        FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> > >::Iterator i = specificEventReceivers_.Find(sender);
         if (i != specificEventReceivers_.End())
         {
-            HashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator j = i->second_.Find(eventType);
+            FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator j = i->second_.Find(eventType);
             return j != i->second_.End() ? j->second_ : nullptr;
         }
         else
@@ -199,10 +236,30 @@ public:
     /// Return event receivers for an event type, or null if they do not exist.
     EventReceiverGroup* GetEventReceivers(StringHash eventType)
     {
-        HashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator i = eventReceivers_.Find(eventType);
+        FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> >::Iterator i = eventReceivers_.Find(eventType);
         return i != eventReceivers_.End() ? i->second_ : nullptr;
     }
 
+    /// Return typed event receivers for a sender and event type, or null if they do not exist.
+    TypedEventReceiverGroup* GetTypedEventReceivers(Object* sender, StringHash eventType)
+    {
+        FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> > >::Iterator i = specificTypedEventReceivers_.Find(sender);
+        if (i != specificTypedEventReceivers_.End())
+        {
+            FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> >::Iterator j = i->second_.Find(eventType);
+            return j != i->second_.End() ? j->second_ : nullptr;
+        }
+        else
+            return nullptr;
+    }
+
+    /// Return typed event receivers for an event type, or null if they do not exist.
+    TypedEventReceiverGroup* GetTypedEventReceivers(StringHash eventType)
+    {
+        FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> >::Iterator i = typedEventReceivers_.Find(eventType);
+        return i != typedEventReceivers_.End() ? i->second_ : nullptr;
+    }
+
 private:
     /// Add event receiver.
     void AddEventReceiver(Object* receiver, StringHash eventType);
@@ -214,6 +271,10 @@ private:
     void RemoveEventReceiver(Object* receiver, Object* sender, StringHash eventType);
     /// Remove event receiver from non-specific events.
     void RemoveEventReceiver(Object* receiver, StringHash eventType);
+    /// Add typed event handler.
+    void AddTypedEventReceiver(TypedEventHandler* handler, TypedEventDispatchFunction dispatchFunction);
+    /// Remove typed event handler.
+    void RemoveTypedEventReceiver(TypedEventHandler* handler);
     /// Begin event send.
     void BeginSendEvent(Object* sender, StringHash eventType);
     /// End event send. Clean up event receivers removed in the meanwhile.
@@ -231,9 +292,13 @@ private:
     /// Network replication attribute descriptions per object type.
     HashMap<StringHash, Vector<AttributeInfo> > networkAttributes_;
     /// Event receivers for non-specific events.
-    HashMap<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
+    FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
     /// Event receivers for specific senders' events.
-    HashMap<Object*, HashMap<StringHash, SharedPtr<EventReceiverGroup> > > specificEventReceivers_;
+    FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<EventReceiverGroup> > > specificEventReceivers_;
+    /// Typed event handlers for non-specific events.
+    FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> > typedEventReceivers_;
+    /// Typed event handlers for specific senders' events.
+    FlatHashMap<Object*, FlatHashMap<StringHash, SharedPtr<TypedEventReceiverGroup> > > specificTypedEventReceivers_;
     /// Event sender stack.
     PODVector<Object*> eventSenders_;
     /// Event data stack.
@@ -58,6 +58,46 @@ URHO3D_EVENT(E_POSTRENDERUPDATE, PostRenderUpdate)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Typed event data with a timestep parameter only.
+struct TimeStepEventData
+{
+    /// Convert to VariantMap event data.
+    void ToVariantMap(VariantMap& eventData) const { eventData[Update::P_TIMESTEP] = timeStep_; }
+    /// Convert from VariantMap event data.
+    void FromVariantMap(const VariantMap& eventData) { timeStep_ = GetEventParam(eventData, Update::P_TIMESTEP).GetFloat(); }
+
+    /// Timestep in seconds.
+    float timeStep_;
+};
+
+/// Typed application-wide logic update event.
+struct UpdateEvent : public TimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_UPDATE; }
+};
+
+/// Typed application-wide logic post-update event.
+struct PostUpdateEvent : public TimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_POSTUPDATE; }
+};
+
+/// Typed render update event.
+struct RenderUpdateEvent : public TimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_RENDERUPDATE; }
+};
+
+/// Typed post-render update event.
+struct PostRenderUpdateEvent : public TimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_POSTRENDERUPDATE; }
+};
+
 /// Frame end event.
 URHO3D_EVENT(E_ENDFRAME, EndFrame)
 {
@@ -209,6 +209,8 @@ void Object::UnsubscribeFromEvent(StringHash eventType)
         else
             break;
     }
+
+    RemoveTypedEventHandlers(eventType, nullptr);
 }
 
 void Object::UnsubscribeFromEvent(Object* sender, StringHash eventType)
@@ -223,6 +225,8 @@ void Object::UnsubscribeFromEvent(Object* sender, StringHash eventType)
         context_->RemoveEventReceiver(this, handler->GetSender(), eventType);
         eventHandlers_.Erase(handler, previous);
     }
+
+    RemoveTypedEventHandler(eventType, sender);
 }
 
 void Object::UnsubscribeFromEvents(Object* sender)
@@ -242,6 +246,8 @@ void Object::UnsubscribeFromEvents(Object* sender)
         else
             break;
     }
+
+    RemoveTypedEventHandlers(StringHash::ZERO, sender);
 }
 
 void Object::UnsubscribeFromAllEvents()
@@ -260,6 +266,8 @@ void Object::UnsubscribeFromAllEvents()
         else
             break;
     }
+
+    RemoveTypedEventHandlers(StringHash::ZERO, nullptr);
 }
 
 void Object::UnsubscribeFromAllEventsExcept(const PODVector<StringHash>& exceptions, bool onlyUserData)
@@ -285,6 +293,28 @@ void Object::UnsubscribeFromAllEventsExcept(const PODVector<StringHash>& excepti
 
         handler = next;
     }
+
+    // Typed event handlers have no userdata
+    if (!onlyUserData)
+    {
+        TypedEventHandler* typedHandler = typedEventHandlers_.First();
+        TypedEventHandler* typedPrevious = nullptr;
+
+        while (typedHandler)
+        {
+            TypedEventHandler* next = typedEventHandlers_.Next(typedHandler);
+
+            if (!exceptions.Contains(typedHandler->GetEventType()))
+            {
+                context_->RemoveTypedEventReceiver(typedHandler);
+                typedEventHandlers_.Erase(typedHandler, typedPrevious);
+            }
+            else
+                typedPrevious = typedHandler;
+
+            typedHandler = next;
+        }
+    }
 }
 
 void Object::SendEvent(StringHash eventType)
@@ -308,10 +338,33 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
     Context* context = context_;
-    HashSet<Object*> processed;
 
     context->BeginSendEvent(this, eventType);
 
+    // Check first the typed event receivers, which get the data converted from the VariantMap
+    TypedEventReceiverGroup* typedGroup = context->GetTypedEventReceivers(this, eventType);
+    if (!typedGroup || typedGroup->handlers_.Empty())
+        typedGroup = context->GetTypedEventReceivers(eventType);
+    if (typedGroup && !typedGroup->handlers_.Empty())
+    {
+        if (!typedGroup->dispatchFunction_(this, eventData))
+        {
+            context->EndSendEvent();
+            return;
+        }
+    }
+
+    SendToEventReceivers(eventType, eventData);
+
+    context->EndSendEvent();
+}
+
+void Object::SendToEventReceivers(StringHash eventType, VariantMap& eventData)
+{
+    WeakPtr<Object> self(this);
+    Context* context = context_;
+    HashSet<Object*> processed;
+
     // Check first the specific event receivers
     // Note: group is held alive with a shared ptr, as it may get destroyed along with the sender
     SharedPtr<EventReceiverGroup> group(context->GetEventReceivers(this, eventType));
@@ -333,7 +386,6 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
             if (self.Expired())
             {
                 group->EndSendEvent();
-                context->EndSendEvent();
                 return;
             }
 
@@ -363,7 +415,6 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
                 if (self.Expired())
                 {
                     group->EndSendEvent();
-                    context->EndSendEvent();
                     return;
                 }
             }
@@ -383,7 +434,6 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
                 if (self.Expired())
                 {
                     group->EndSendEvent();
-                    context->EndSendEvent();
                     return;
                 }
             }
@@ -391,10 +441,89 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
 
         group->EndSendEvent();
     }
+}
+
+void Object::SendTypedEvent(StringHash eventType, void* eventData, void (*toVariantMap)(const void*, VariantMap&))
+{
+    if (!Thread::IsMainThread())
+    {
+        URHO3D_LOGERROR("Sending events is only supported from the main thread");
+        return;
+    }
+
+    if (blockEvents_)
+        return;
+
+    Context* context = context_;
+
+    // Take the event data map of the sender's nesting level before beginning the send, as SendEvent() callers do.
+    // The maps of the deeper levels are used by the handlers to send nested events
+    VariantMap& eventDataMap = context->GetEventDataMap();
+
+    context->BeginSendEvent(this, eventType);
+
+    if (!SendToTypedEventReceivers(eventType, eventData))
+    {
+        context->EndSendEvent();
+        return;
+    }
+
+    // Convert to a VariantMap only if there are receivers for it, such as script event handlers
+    if (context->GetEventReceivers(this, eventType) || context->GetEventReceivers(eventType))
+    {
+        toVariantMap(eventData, eventDataMap);
+        SendToEventReceivers(eventType, eventDataMap);
+    }
 
     context->EndSendEvent();
 }
 
+bool Object::SendToTypedEventReceivers(StringHash eventType, void* eventData)
+{
+    Context* context = context_;
+
+    // Check first the specific typed event receivers
+    // Note: group is held alive with a shared ptr, as it may get destroyed along with the sender
+    SharedPtr<TypedEventReceiverGroup> group(context->GetTypedEventReceivers(this, eventType));
+    if (group && !InvokeTypedEventHandlers(group, eventData))
+        return false;
+
+    // Then the non-specific ones
+    group = context->GetTypedEventReceivers(eventType);
+    return !group || InvokeTypedEventHandlers(group, eventData);
+}
+
+bool Object::InvokeTypedEventHandlers(TypedEventReceiverGroup* group, void* eventData)
+{
+    if (group->handlers_.Empty())
+        return true;
+
+    WeakPtr<Object> self(this);
+
+    group->BeginSendEvent();
+
+    const unsigned numHandlers = group->handlers_.Size();
+    for (unsigned i = 0; i < numHandlers; ++i)
+    {
+        TypedEventHandler* handler = group->handlers_[i];
+        // Holes may exist if handlers removed during send
+        if (!handler || handler->GetReceiver()->GetBlockEvents())
+            continue;
+
+        handler->Invoke(eventData);
+
+        // If self has been destroyed as a result of event handling, exit
+        if (self.Expired())
+        {
+            group->EndSendEvent();
+            return false;
+        }
+    }
+
+    group->EndSendEvent();
+    return true;
+}
+
 VariantMap& Object::GetEventDataMap() const
 {
     return context_->GetEventDataMap();
@@ -509,6 +638,55 @@ EventHandler* Object::FindSpecificEventHandler(Object* sender, StringHash eventT
     return nullptr;
 }
 
+void Object::AddTypedEventHandler(TypedEventHandler* handler, TypedEventDispatchFunction dispatchFunction)
+{
+    // Remove old event handler for the same sender first
+    RemoveTypedEventHandler(handler->GetEventType(), handler->GetSender());
+
+    typedEventHandlers_.InsertFront(handler);
+    context_->AddTypedEventReceiver(handler, dispatchFunction);
+}
+
+void Object::RemoveTypedEventHandler(StringHash eventType, Object* sender)
+{
+    TypedEventHandler* handler = typedEventHandlers_.First();
+    TypedEventHandler* previous = nullptr;
+
+    while (handler)
+    {
+        if (handler->GetEventType() == eventType && handler->GetSender() == sender)
+        {
+            context_->RemoveTypedEventReceiver(handler);
+            typedEventHandlers_.Erase(handler, previous);
+            return;
+        }
+
+        previous = handler;
+        handler = typedEventHandlers_.Next(handler);
+    }
+}
+
+void Object::RemoveTypedEventHandlers(StringHash eventType, Object* sender)
+{
+    TypedEventHandler* handler = typedEventHandlers_.First();
+    TypedEventHandler* previous = nullptr;
+
+    while (handler)
+    {
+        TypedEventHandler* next = typedEventHandlers_.Next(handler);
+
+        if ((!eventType || handler->GetEventType() == eventType) && (!sender || handler->GetSender() == sender))
+        {
+            context_->RemoveTypedEventReceiver(handler);
+            typedEventHandlers_.Erase(handler, previous);
+        }
+        else
+            previous = handler;
+
+        handler = next;
+    }
+}
+
 void Object::RemoveEventSender(Object* sender)
 {
     EventHandler* handler = eventHandlers_.First();
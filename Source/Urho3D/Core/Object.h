@@ -32,6 +32,12 @@ namespace Urho3D
 
 class Context;
 class EventHandler;
+class Object;
+class TypedEventHandler;
+class TypedEventReceiverGroup;
+
+/// Function for sending VariantMap event data to the typed event handlers of an event type. Return false if the sender was destroyed during event handling.
+typedef bool (*TypedEventDispatchFunction)(Object* sender, VariantMap& eventData);
 
 /// Type info.
 class URHO3D_API TypeInfo
@@ -138,6 +144,16 @@ public:
     {
         SendEvent(eventType, GetEventDataMap().Populate(args...));
     }
+    /// Subscribe to a typed event that can be sent by any sender. Replaces an earlier non-specific typed subscription to the same event.
+    template <class T, class U> void SubscribeToTypedEvent(void (U::*function)(T&));
+    /// Subscribe to a specific sender's typed event. Replaces an earlier typed subscription to the same event from the same sender.
+    template <class T, class U> void SubscribeToTypedEvent(Object* sender, void (U::*function)(T&));
+    /// Unsubscribe from a typed event, both non-specific and from all senders.
+    template <class T> void UnsubscribeFromTypedEvent() { RemoveTypedEventHandlers(T::GetEventType(), nullptr); }
+    /// Unsubscribe from a specific sender's typed event.
+    template <class T> void UnsubscribeFromTypedEvent(Object* sender) { RemoveTypedEventHandler(T::GetEventType(), sender); }
+    /// Send typed event to all subscribers without using a VariantMap. Subscribers of the VariantMap form of the event, such as script event handlers, receive the data converted to a VariantMap.
+    template <class T> void SendTypedEvent(T& eventData) { SendTypedEvent(T::GetEventType(), &eventData, &TypedEventToVariantMap<T>); }
 
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -159,7 +175,7 @@ public:
     bool HasSubscribedToEvent(Object* sender, StringHash eventType) const;
 
     /// Return whether has subscribed to any event.
-    bool HasEventHandlers() const { return !eventHandlers_.Empty(); }
+    bool HasEventHandlers() const { return !eventHandlers_.Empty() || !typedEventHandlers_.Empty(); }
 
     /// Template version of returning a subsystem.
     template <class T> T* GetSubsystem() const;
@@ -184,9 +200,41 @@ private:
     EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous = nullptr) const;
     /// Remove event handlers related to a specific sender.
     void RemoveEventSender(Object* sender);
+    /// Send event to the VariantMap event receivers.
+    void SendToEventReceivers(StringHash eventType, VariantMap& eventData);
+    /// Add a typed event handler, replacing an earlier one for the same event.
+    void AddTypedEventHandler(TypedEventHandler* handler, TypedEventDispatchFunction dispatchFunction);
+    /// Remove the typed event handler for an event type and sender. A null sender matches only the non-specific handler.
+    void RemoveTypedEventHandler(StringHash eventType, Object* sender);
+    /// Remove typed event handlers. A zero event type or null sender matches all.
+    void RemoveTypedEventHandlers(StringHash eventType, Object* sender);
+    /// Send typed event data to typed event receivers, and converted to a VariantMap to the other event receivers.
+    void SendTypedEvent(StringHash eventType, void* eventData, void (*toVariantMap)(const void*, VariantMap&));
+    /// Send typed event data to the typed event receivers of self as the sender and the non-specific ones. Return false if self was destroyed during event handling.
+    bool SendToTypedEventReceivers(StringHash eventType, void* eventData);
+    /// Invoke the typed event handlers of a group. Return false if self was destroyed during event handling.
+    bool InvokeTypedEventHandlers(TypedEventReceiverGroup* group, void* eventData);
+
+    /// Convert typed event data to a VariantMap.
+    template <class T> static void TypedEventToVariantMap(const void* eventData, VariantMap& dest)
+    {
+        static_cast<const T*>(eventData)->ToVariantMap(dest);
+    }
+    /// Convert VariantMap event data to typed event data, invoke the typed event handlers and write the results back.
+    template <class T> static bool DispatchVariantMapToTypedEvent(Object* sender, VariantMap& eventData)
+    {
+        T typedEventData;
+        typedEventData.FromVariantMap(eventData);
+        if (!sender->SendToTypedEventReceivers(T::GetEventType(), &typedEventData))
+            return false;
+        typedEventData.ToVariantMap(eventData);
+        return true;
+    }
 
     /// Event handlers. Sender is null for non-specific handlers.
     LinkedList<EventHandler> eventHandlers_;
+    /// Typed event handlers. Sender is null for non-specific handlers.
+    LinkedList<TypedEventHandler> typedEventHandlers_;
 
     /// Block object from sending and receiving any events.
     bool blockEvents_;
@@ -354,6 +402,89 @@ private:
     std::function<void(StringHash, VariantMap&)> function_;
 };
 
+/// Internal helper class for invoking typed event handler functions.
+class URHO3D_API TypedEventHandler : public LinkedListNode
+{
+public:
+    /// Construct with specified receiver, sender and event type.
+    TypedEventHandler(Object* receiver, Object* sender, StringHash eventType) :
+        receiver_(receiver),
+        sender_(sender),
+        eventType_(eventType)
+    {
+    }
+
+    /// Destruct.
+    virtual ~TypedEventHandler() = default;
+
+    /// Invoke event handler function with typed event data.
+    virtual void Invoke(void* eventData) = 0;
+
+    /// Return event receiver.
+    Object* GetReceiver() const { return receiver_; }
+
+    /// Return event sender. Null if the handler is non-specific.
+    Object* GetSender() const { return sender_; }
+
+    /// Return event type.
+    const StringHash& GetEventType() const { return eventType_; }
+
+protected:
+    /// Event receiver.
+    Object* receiver_;
+    /// Event sender.
+    Object* sender_;
+    /// Event type.
+    StringHash eventType_;
+};
+
+/// Template implementation of the typed event handler invoke helper (stores a function pointer of specific class.)
+template <class T, class U> class TypedEventHandlerImpl : public TypedEventHandler
+{
+public:
+    using HandlerFunctionPtr = void (U::*)(T&);
+
+    /// Construct with receiver, sender and function pointer.
+    TypedEventHandlerImpl(U* receiver, Object* sender, HandlerFunctionPtr function) :
+        TypedEventHandler(receiver, sender, T::GetEventType()),
+        function_(function)
+    {
+        assert(function_);
+    }
+
+    /// Invoke event handler function.
+    void Invoke(void* eventData) override
+    {
+        auto* receiver = static_cast<U*>(receiver_);
+        (receiver->*function_)(*static_cast<T*>(eventData));
+    }
+
+private:
+    /// Class-specific pointer to handler function.
+    HandlerFunctionPtr function_;
+};
+
+template <class T, class U> void Object::SubscribeToTypedEvent(void (U::*function)(T&))
+{
+    AddTypedEventHandler(new TypedEventHandlerImpl<T, U>(static_cast<U*>(this), nullptr, function), &DispatchVariantMapToTypedEvent<T>);
+}
+
+template <class T, class U> void Object::SubscribeToTypedEvent(Object* sender, void (U::*function)(T&))
+{
+    // If a null sender was specified, the event can not be subscribed to
+    if (!sender)
+        return;
+
+    AddTypedEventHandler(new TypedEventHandlerImpl<T, U>(static_cast<U*>(this), sender, function), &DispatchVariantMapToTypedEvent<T>);
+}
+
+/// Return an event parameter from VariantMap event data, or an empty variant if not found. Used in converting typed event data.
+inline const Variant& GetEventParam(const VariantMap& eventData, StringHash param)
+{
+    const Variant* value = eventData[param];
+    return value ? *value : Variant::EMPTY;
+}
+
 /// Register event names.
 struct URHO3D_API EventNameRegistrar
 {
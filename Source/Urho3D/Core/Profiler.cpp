@@ -23,6 +23,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Profiler.h"
+#include "../Core/StringUtils.h"
+#include "../IO/Serializer.h"
 
 #include <cstdio>
 
@@ -31,17 +33,85 @@
 namespace Urho3D
 {
 
+/// Capacity of a thread's block instance ring buffer. Must be a power of two.
+static const unsigned THREAD_EVENT_CAPACITY = 8192;
+
+/// Profiling state of a thread other than the main thread. Only the owning thread writes to it, except for the name and the read position of the ring buffer.
+struct ProfilerThread
+{
+    /// Construct.
+    ProfilerThread(ThreadID id, unsigned index) :
+        id_(id),
+        index_(index),
+        root_(new ProfilerBlock(nullptr, "Thread")),
+        written_(0),
+        read_(0)
+    {
+        current_ = root_;
+        events_.Resize(THREAD_EVENT_CAPACITY);
+    }
+
+    /// Destruct.
+    ~ProfilerThread()
+    {
+        delete root_;
+    }
+
+    /// Thread ID.
+    ThreadID id_;
+    /// Thread index in trace exports.
+    unsigned index_;
+    /// Thread name in trace exports.
+    String name_;
+    /// Root of the thread's block tree, which stores the block names. Timing statistics are not collected.
+    ProfilerBlock* root_;
+    /// Current block.
+    ProfilerBlock* current_;
+    /// Begin times of the open blocks, or -1 for blocks begun while not capturing.
+    PODVector<long long> beginTimes_;
+    /// Ring buffer of ended block instances.
+    PODVector<ProfilerEvent> events_;
+    /// Total number of block instances written to the ring buffer.
+    std::atomic<unsigned> written_;
+    /// Total number of block instances read from the ring buffer by the main thread.
+    unsigned read_;
+};
+
+/// Thread-local cache of the thread state in the last used profiler.
+struct ProfilerThreadCache
+{
+    /// Profiler ID.
+    unsigned profilerID_;
+    /// Thread state.
+    ProfilerThread* thread_;
+};
+
+static thread_local ProfilerThreadCache threadCache = { 0, nullptr };
+static std::atomic<unsigned> nextProfilerID(1);
+
 Profiler::Profiler(Context* context) :
     Object(context),
     current_(nullptr),
     root_(nullptr),
-    intervalFrames_(0)
+    intervalFrames_(0),
+    captureFrames_(0),
+    id_(nextProfilerID++),
+    capturing_(false),
+    mainThreadName_("Main thread"),
+    nextCapturedFrame_(0),
+    numCapturedFrames_(0),
+    frameNumber_(0),
+    frameBegin_(0)
 {
     current_ = root_ = new ProfilerBlock(nullptr, "RunFrame");
 }
 
 Profiler::~Profiler()
 {
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        delete *i;
+    threads_.Clear();
+
     delete root_;
     root_ = nullptr;
 }
@@ -53,6 +123,7 @@ void Profiler::BeginFrame()
         EndFrame();
 
     root_->Begin();
+    frameBegin_ = traceTimer_.GetUSec(false);
 }
 
 void Profiler::EndFrame()
@@ -61,6 +132,10 @@ void Profiler::EndFrame()
     ++intervalFrames_;
     root_->EndFrame();
     current_ = root_;
+
+    if (captureFrames_)
+        CaptureFrame();
+    ++frameNumber_;
 }
 
 void Profiler::BeginInterval()
@@ -69,6 +144,202 @@ void Profiler::BeginInterval()
     intervalFrames_ = 0;
 }
 
+void Profiler::SetCaptureFrames(unsigned frames)
+{
+    captureFrames_ = frames;
+    capturedFrames_.Clear();
+    capturedFrames_.Resize(frames);
+    nextCapturedFrame_ = 0;
+    numCapturedFrames_ = 0;
+    mainThreadEvents_.Clear();
+
+    // Discard block instances the other threads recorded before, then let them start recording again
+    MutexLock lock(threadsMutex_);
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        (*i)->read_ = (*i)->written_.load(std::memory_order_acquire);
+    capturing_ = frames > 0;
+}
+
+void Profiler::SetThreadName(const String& name)
+{
+    if (Thread::IsMainThread())
+    {
+        mainThreadName_ = name;
+        return;
+    }
+
+    ProfilerThread* thread = GetThread();
+    MutexLock lock(threadsMutex_);
+    thread->name_ = name;
+}
+
+bool Profiler::SaveTrace(Serializer& dest) const
+{
+    String output = "{\"traceEvents\":[\n";
+
+    // Thread names as metadata events
+    output += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":";
+    AppendJSONString(output, mainThreadName_.CString());
+    output += "}}";
+    {
+        MutexLock lock(threadsMutex_);
+        for (PODVector<ProfilerThread*>::ConstIterator i = threads_.Begin(); i != threads_.End(); ++i)
+        {
+            String name = (*i)->name_.Empty() ? "Thread " + String((*i)->index_) : (*i)->name_;
+            output.AppendWithFormat(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":",
+                (*i)->index_);
+            AppendJSONString(output, name.CString());
+            output += "}}";
+        }
+    }
+
+    // Block instances as complete events, written out one frame at a time
+    for (unsigned i = 0; i < numCapturedFrames_; ++i)
+    {
+        const ProfilerFrame* frame = GetCapturedFrame(i);
+        for (PODVector<ProfilerEvent>::ConstIterator j = frame->events_.Begin(); j != frame->events_.End(); ++j)
+        {
+            output += ",\n{\"name\":";
+            AppendJSONString(output, j->block_->name_ ? j->block_->name_ : "");
+            output.AppendWithFormat(",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%lld,\"dur\":%lld,\"args\":{\"frame\":%u}}",
+                j->threadIndex_, j->begin_, j->end_ - j->begin_, frame->frameNumber_);
+        }
+
+        if (dest.Write(output.CString(), output.Length()) != output.Length())
+            return false;
+        output.Clear();
+    }
+
+    output += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return dest.Write(output.CString(), output.Length()) == output.Length();
+}
+
+const ProfilerFrame* Profiler::GetCapturedFrame(unsigned index) const
+{
+    if (index >= numCapturedFrames_)
+        return nullptr;
+
+    // The oldest frame is the next one to be overwritten once the capture is full
+    unsigned oldest = numCapturedFrames_ < captureFrames_ ? 0 : nextCapturedFrame_;
+    return &capturedFrames_[(oldest + index) % captureFrames_];
+}
+
+void Profiler::CaptureMainThreadBlock(const ProfilerBlock* block, long long time)
+{
+    long long end = traceTimer_.GetUSec(false);
+
+    ProfilerEvent event;
+    event.block_ = block;
+    event.begin_ = end - time;
+    event.end_ = end;
+    event.threadIndex_ = 0;
+    mainThreadEvents_.Push(event);
+}
+
+void Profiler::BeginThreadBlock(const char* name)
+{
+    ProfilerThread* thread = GetThread();
+
+    // Blocks begun while not capturing are only tracked to keep the block stack balanced
+    if (!capturing_.load(std::memory_order_relaxed))
+    {
+        thread->beginTimes_.Push(-1);
+        return;
+    }
+
+    thread->current_ = thread->current_->GetChild(name);
+    thread->beginTimes_.Push(traceTimer_.GetUSec(false));
+}
+
+void Profiler::EndThreadBlock()
+{
+    ProfilerThread* thread = GetThread();
+    if (thread->beginTimes_.Empty())
+        return;
+
+    long long begin = thread->beginTimes_.Back();
+    thread->beginTimes_.Pop();
+    if (begin < 0)
+        return;
+
+    ProfilerBlock* block = thread->current_;
+    if (block->parent_)
+        thread->current_ = block->parent_;
+
+    // Publish the block instance to the main thread. If the main thread has fallen a whole buffer behind, the oldest are overwritten
+    unsigned written = thread->written_.load(std::memory_order_relaxed);
+    ProfilerEvent& event = thread->events_[written & (THREAD_EVENT_CAPACITY - 1)];
+    event.block_ = block;
+    event.begin_ = begin;
+    event.end_ = traceTimer_.GetUSec(false);
+    event.threadIndex_ = thread->index_;
+    thread->written_.store(written + 1, std::memory_order_release);
+}
+
+ProfilerThread* Profiler::GetThread()
+{
+    if (threadCache.profilerID_ == id_)
+        return threadCache.thread_;
+
+    ThreadID threadID = Thread::GetCurrentThreadID();
+    ProfilerThread* thread = nullptr;
+
+    MutexLock lock(threadsMutex_);
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+    {
+        if ((*i)->id_ == threadID)
+        {
+            thread = *i;
+            break;
+        }
+    }
+
+    if (!thread)
+    {
+        thread = new ProfilerThread(threadID, threads_.Size() + 1);
+        threads_.Push(thread);
+    }
+
+    threadCache.profilerID_ = id_;
+    threadCache.thread_ = thread;
+    return thread;
+}
+
+void Profiler::CaptureFrame()
+{
+    ProfilerFrame& frame = capturedFrames_[nextCapturedFrame_];
+    frame.frameNumber_ = frameNumber_;
+    frame.begin_ = frameBegin_;
+    frame.end_ = traceTimer_.GetUSec(false);
+    frame.events_ = mainThreadEvents_;
+    mainThreadEvents_.Clear();
+
+    MutexLock lock(threadsMutex_);
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+    {
+        ProfilerThread* thread = *i;
+        unsigned written = thread->written_.load(std::memory_order_acquire);
+        unsigned read = thread->read_;
+        if (written - read > THREAD_EVENT_CAPACITY)
+            read = written - THREAD_EVENT_CAPACITY;
+
+        unsigned start = frame.events_.Size();
+        for (unsigned j = read; j != written; ++j)
+            frame.events_.Push(thread->events_[j & (THREAD_EVENT_CAPACITY - 1)]);
+
+        // Discard instances the thread may have overwritten while they were being copied
+        unsigned after = thread->written_.load(std::memory_order_acquire);
+        if (after - read > THREAD_EVENT_CAPACITY)
+            frame.events_.Erase(start, Min(after - read - THREAD_EVENT_CAPACITY, written - read));
+
+        thread->read_ = written;
+    }
+
+    nextCapturedFrame_ = (nextCapturedFrame_ + 1) % captureFrames_;
+    if (numCapturedFrames_ < captureFrames_)
+        ++numCapturedFrames_;
+}
+
 const String& Profiler::PrintData(bool showUnused, bool showTotal, unsigned maxDepth) const
 {
     static String output;
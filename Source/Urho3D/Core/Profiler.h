@@ -23,12 +23,18 @@
 #pragma once
 
 #include "../Container/Str.h"
+#include "../Core/Mutex.h"
 #include "../Core/Thread.h"
 #include "../Core/Timer.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+class Serializer;
+struct ProfilerThread;
+
 /// Profiling data for one block in the profiling tree.
 class URHO3D_API ProfilerBlock
 {
@@ -77,13 +83,14 @@ public:
         ++count_;
     }
 
-    /// End timing.
-    void End()
+    /// End timing. Return the elapsed time in microseconds.
+    long long End()
     {
         long long time = timer_.GetUSec(false);
         if (time > maxTime_)
             maxTime_ = time;
         time_ += time;
+        return time;
     }
 
     /// End profiling frame and update interval and total values.
@@ -168,7 +175,41 @@ public:
     unsigned totalCount_;
 };
 
-/// Hierarchical performance profiler subsystem.
+/// Timestamped profiling block instance in a trace capture.
+struct ProfilerEvent
+{
+    /// Profiling block, which holds the name.
+    const ProfilerBlock* block_;
+    /// Begin time in microseconds since the profiler was created.
+    long long begin_;
+    /// End time in microseconds since the profiler was created.
+    long long end_;
+    /// Index of the thread that executed the block. The main thread has index 0.
+    unsigned threadIndex_;
+};
+
+/// Profiling block instances of all threads captured during one frame.
+struct ProfilerFrame
+{
+    /// Construct.
+    ProfilerFrame() :
+        frameNumber_(0),
+        begin_(0),
+        end_(0)
+    {
+    }
+
+    /// Frame number counted from the profiler's creation.
+    unsigned frameNumber_;
+    /// Frame begin time in microseconds since the profiler was created.
+    long long begin_;
+    /// Frame end time in microseconds since the profiler was created.
+    long long end_;
+    /// Block instances, which ended during the frame.
+    PODVector<ProfilerEvent> events_;
+};
+
+/// Hierarchical performance profiler subsystem. Aggregated block statistics are collected from the main thread. When trace capture is enabled, the timestamps of each block instance are also recorded from all threads into per-thread lock-free buffers, and the most recent frames are kept for export.
 class URHO3D_API Profiler : public Object
 {
     URHO3D_OBJECT(Profiler, Object);
@@ -182,9 +223,12 @@ public:
     /// Begin timing a profiling block.
     void BeginBlock(const char* name)
     {
-        // Profiler supports only the main thread currently
+        // Other threads only record timestamped blocks for trace capture
         if (!Thread::IsMainThread())
+        {
+            BeginThreadBlock(name);
             return;
+        }
 
         current_ = current_->GetChild(name);
         current_->Begin();
@@ -194,9 +238,14 @@ public:
     void EndBlock()
     {
         if (!Thread::IsMainThread())
+        {
+            EndThreadBlock();
             return;
+        }
 
-        current_->End();
+        long long time = current_->End();
+        if (captureFrames_)
+            CaptureMainThreadBlock(current_, time);
         if (current_->parent_)
             current_ = current_->parent_;
     }
@@ -207,6 +256,12 @@ public:
     void EndFrame();
     /// Begin a new interval.
     void BeginInterval();
+    /// Set number of most recent frames to keep in the trace capture. 0 disables capturing, which is the default.
+    void SetCaptureFrames(unsigned frames);
+    /// Set the name of the calling thread in trace exports.
+    void SetThreadName(const String& name);
+    /// Write the captured frames as Chrome trace event JSON, which can be viewed in chrome://tracing or Perfetto. Return true if successful.
+    bool SaveTrace(Serializer& dest) const;
 
     /// Return profiling data as text output. This method is not thread-safe.
     const String& PrintData(bool showUnused = false, bool showTotal = false, unsigned maxDepth = M_MAX_UNSIGNED) const;
@@ -214,10 +269,18 @@ public:
     const ProfilerBlock* GetCurrentBlock() { return current_; }
     /// Return the root profiling block.
     const ProfilerBlock* GetRootBlock() { return root_; }
+    /// Return number of most recent frames to keep in the trace capture.
+    unsigned GetCaptureFrames() const { return captureFrames_; }
+    /// Return number of frames currently in the trace capture.
+    unsigned GetNumCapturedFrames() const { return numCapturedFrames_; }
+    /// Return a captured frame by index, 0 being the oldest, or null if out of range.
+    const ProfilerFrame* GetCapturedFrame(unsigned index) const;
 
 protected:
     /// Return profiling data as text output for a specified profiling block.
     void PrintData(ProfilerBlock* block, String& output, unsigned depth, unsigned maxDepth, bool showUnused, bool showTotal) const;
+    /// Record a main thread block instance that just ended.
+    void CaptureMainThreadBlock(const ProfilerBlock* block, long long time);
 
     /// Current profiling block.
     ProfilerBlock* current_;
@@ -225,6 +288,43 @@ protected:
     ProfilerBlock* root_;
     /// Frames in the current interval.
     unsigned intervalFrames_;
+    /// Number of frames to keep in the trace capture.
+    unsigned captureFrames_;
+
+private:
+    /// Begin a profiling block in a thread other than the main thread.
+    void BeginThreadBlock(const char* name);
+    /// End a profiling block in a thread other than the main thread.
+    void EndThreadBlock();
+    /// Return the calling thread's profiling state, which is created on first use.
+    ProfilerThread* GetThread();
+    /// Collect the block instances of the frame that just ended into the trace capture.
+    void CaptureFrame();
+
+    /// Unique ID of the profiler, for identifying it in the thread-local cache.
+    unsigned id_;
+    /// Timer for trace timestamps.
+    HiresTimer traceTimer_;
+    /// Trace capture enabled flag, checked by other threads.
+    std::atomic<bool> capturing_;
+    /// Profiling states of the threads other than the main thread.
+    PODVector<ProfilerThread*> threads_;
+    /// Mutex for adding threads and accessing their names.
+    mutable Mutex threadsMutex_;
+    /// Name of the main thread in trace exports.
+    String mainThreadName_;
+    /// Main thread block instances of the current frame.
+    PODVector<ProfilerEvent> mainThreadEvents_;
+    /// Captured frames as a ring buffer.
+    Vector<ProfilerFrame> capturedFrames_;
+    /// Ring buffer index of the next frame to capture.
+    unsigned nextCapturedFrame_;
+    /// Number of frames in the capture.
+    unsigned numCapturedFrames_;
+    /// Current frame number.
+    unsigned frameNumber_;
+    /// Current frame begin time.
+    long long frameBegin_;
 };
 
 /// Helper class for automatically beginning and ending a profiling block
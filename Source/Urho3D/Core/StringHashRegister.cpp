@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/StringHashRegister.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+StringHashRegister::StringHashRegister() :
+    numCollisions_(0)
+{
+    for (unsigned i = 0; i < CACHE_SIZE; ++i)
+        cache_[i].store(0, std::memory_order_relaxed);
+}
+
+StringHashRegister::~StringHashRegister() = default;
+
+void StringHashRegister::RegisterString(StringHash hash, const char* string)
+{
+    if (!string || !hash)
+        return;
+
+    // Most strings are hashed many times, so check first without locking whether the hash was registered recently
+    std::atomic<unsigned>& cached = cache_[hash.Value() & (CACHE_SIZE - 1)];
+    if (cached.load(std::memory_order_acquire) == hash.Value())
+        return;
+
+    Shard& shard = GetShard(hash);
+    {
+        MutexLock lock(shard.mutex_);
+
+        FlatHashMap<StringHash, String>::ConstIterator i = shard.strings_.Find(hash);
+        if (i == shard.strings_.End())
+            shard.strings_.Insert(MakePair(hash, String(string)));
+        else if (i->second_.Compare(string, false) != 0)
+            numCollisions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The string is in the table before the hash is cached, so a cache hit never skips an unregistered string
+    cached.store(hash.Value(), std::memory_order_release);
+}
+
+String StringHashRegister::GetString(StringHash hash) const
+{
+    Shard& shard = GetShard(hash);
+    MutexLock lock(shard.mutex_);
+
+    FlatHashMap<StringHash, String>::ConstIterator i = shard.strings_.Find(hash);
+    return i != shard.strings_.End() ? i->second_ : String::EMPTY;
+}
+
+bool StringHashRegister::Contains(StringHash hash) const
+{
+    Shard& shard = GetShard(hash);
+    MutexLock lock(shard.mutex_);
+    return shard.strings_.Contains(hash);
+}
+
+unsigned StringHashRegister::GetNumStrings() const
+{
+    unsigned numStrings = 0;
+    for (unsigned i = 0; i < (1u << SHARD_BITS); ++i)
+    {
+        MutexLock lock(shards_[i].mutex_);
+        numStrings += shards_[i].strings_.Size();
+    }
+    return numStrings;
+}
+
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/FlatHashMap.h"
+#include "../Core/Mutex.h"
+#include "../Math/StringHash.h"
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+/// Thread-safe table of the strings that string hashes have been calculated from, used for reversing a hash back to its text. The table is split into shards by hash, each with its own mutex, and a lock-free cache of recently registered hashes lets repeated registrations of the same string return without locking.
+class URHO3D_API StringHashRegister
+{
+public:
+    /// Construct.
+    StringHashRegister();
+    /// Destruct.
+    ~StringHashRegister();
+
+    /// Register the string a hash was calculated from. If a different string with the same hash is already registered, it is kept. Returns without locking if the hash is in the recently registered cache.
+    void RegisterString(StringHash hash, const char* string);
+    /// Return the string for a hash, or empty if not registered.
+    String GetString(StringHash hash) const;
+    /// Return whether a string is registered for the hash.
+    bool Contains(StringHash hash) const;
+    /// Return number of registered strings.
+    unsigned GetNumStrings() const;
+    /// Return number of hash collisions detected, where a different string had the same hash as an already registered one. Only strings whose hash is not in the recently registered cache are compared.
+    unsigned GetNumCollisions() const { return numCollisions_.load(std::memory_order_relaxed); }
+
+private:
+    /// Number of shards as a power of two.
+    static const unsigned SHARD_BITS = 4;
+    /// Number of entries in the recently registered cache. Must be a power of two.
+    static const unsigned CACHE_SIZE = 4096;
+
+    /// Part of the table with its own mutex.
+    struct Shard
+    {
+        /// Hash to string map.
+        FlatHashMap<StringHash, String> strings_;
+        /// Mutex for accessing the map from multiple threads.
+        Mutex mutex_;
+    };
+
+    /// Return the shard for a hash.
+    Shard& GetShard(StringHash hash) const { return shards_[hash.Value() >> (32 - SHARD_BITS)]; }
+
+    /// Table shards, selected by the high bits of the hash.
+    mutable Shard shards_[1u << SHARD_BITS];
+    /// Recently registered hashes, indexed by the low bits of the hash. Zero when empty, as zero hashes are not registered.
+    std::atomic<unsigned> cache_[CACHE_SIZE];
+    /// Number of hash collisions detected.
+    std::atomic<unsigned> numCollisions_;
+};
+
+}
@@ -670,6 +670,25 @@ void StringToBuffer(PODVector<unsigned char>& dest, const char* source)
         dest[index] = (unsigned char)value;
 }
 
+void AppendJSONString(String& dest, const char* source)
+{
+    dest += '"';
+    for (; *source; ++source)
+    {
+        char c = *source;
+        if (c == '"' || c == '\\')
+        {
+            dest += '\\';
+            dest += c;
+        }
+        else if ((unsigned char)c < 0x20)
+            dest.AppendWithFormat("\\u%04x", (unsigned)c);
+        else
+            dest += c;
+    }
+    dest += '"';
+}
+
 unsigned GetStringListIndex(const String& value, const String* strings, unsigned defaultIndex, bool caseSensitive)
 {
     return GetStringListIndex(value.CString(), strings, defaultIndex, caseSensitive);
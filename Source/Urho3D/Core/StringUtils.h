@@ -117,6 +117,8 @@ URHO3D_API void BufferToString(String& dest, const void* data, unsigned size);
 URHO3D_API void StringToBuffer(PODVector<unsigned char>& dest, const String& source);
 /// Convert a C string to a byte buffer.
 URHO3D_API void StringToBuffer(PODVector<unsigned char>& dest, const char* source);
+/// Append a C string to JSON output as a quoted and escaped string value.
+URHO3D_API void AppendJSONString(String& dest, const char* source);
 /// Return an index to a string list corresponding to the given string, or a default value if not found. The string list must be empty-terminated.
 URHO3D_API unsigned GetStringListIndex(const String& value, const String* strings, unsigned defaultIndex, bool caseSensitive = false);
 /// Return an index to a string list corresponding to the given C string, or a default value if not found. The string list must be empty-terminated.
@@ -28,9 +28,193 @@
 #include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+/// Target execution time of an automatically sized parallel loop chunk in microseconds.
+static const float PARALLELFOR_CHUNK_USEC = 50.0f;
+/// Maximum number of automatically sized parallel loop chunks per thread.
+static const unsigned PARALLELFOR_MAX_CHUNKS_PER_THREAD = 4;
+
+/// Shared state of a parallel loop.
+struct ParallelForTask
+{
+    /// Loop function.
+    const std::function<void(unsigned, unsigned, unsigned)>* function_;
+    /// Accumulated execution time per thread in microseconds, or empty if not measured.
+    PODVector<long long> threadUSec_;
+};
+
+void ParallelForWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* task = reinterpret_cast<ParallelForTask*>(item->aux_);
+    // The chunk index range is stored directly in the data pointers
+    auto begin = (unsigned)reinterpret_cast<size_t>(item->start_);
+    auto end = (unsigned)reinterpret_cast<size_t>(item->end_);
+
+    if (task->threadUSec_.Empty())
+        (*task->function_)(begin, end, threadIndex);
+    else
+    {
+        HiresTimer timer;
+        (*task->function_)(begin, end, threadIndex);
+        task->threadUSec_[threadIndex] += timer.GetUSec(false);
+    }
+}
+
+/// Work items of one priority level in a worker deque, in submission order.
+struct WorkBucket
+{
+    /// Construct with priority.
+    explicit WorkBucket(unsigned priority = 0) :
+        priority_(priority),
+        head_(0)
+    {
+    }
+
+    /// Priority of the items.
+    unsigned priority_;
+    /// Items. Those before the head index have already been taken.
+    PODVector<WorkItem*> items_;
+    /// Index of the first item not yet taken.
+    unsigned head_;
+};
+
+/// Prioritized work item deque of a worker thread. The owning thread takes items from the front, while other threads steal from the back.
+class WorkerDeque : public RefCounted
+{
+public:
+    /// Construct.
+    WorkerDeque() :
+        numItems_(0)
+    {
+    }
+
+    /// Add an item to its priority bucket.
+    void Push(WorkItem* item)
+    {
+        MutexLock lock(mutex_);
+
+        // Buckets are sorted from highest to lowest priority. There are usually only a few distinct priorities in use
+        unsigned i = 0;
+        while (i < buckets_.Size() && buckets_[i].priority_ > item->priority_)
+            ++i;
+
+        if (i == buckets_.Size() || buckets_[i].priority_ != item->priority_)
+        {
+            // Get rid of empty buckets before adding a new one, so that arbitrary user priorities do not accumulate
+            for (unsigned j = buckets_.Size() - 1; j < buckets_.Size(); --j)
+            {
+                if (buckets_[j].items_.Empty())
+                {
+                    buckets_.Erase(j);
+                    if (j < i)
+                        --i;
+                }
+            }
+            buckets_.Insert(i, WorkBucket(item->priority_));
+        }
+
+        buckets_[i].items_.Push(item);
+        ++numItems_;
+    }
+
+    /// Take the oldest item of the highest priority bucket, if it has at least the specified priority. Return null if none.
+    WorkItem* PopFront(unsigned priority)
+    {
+        if (!numItems_)
+            return nullptr;
+
+        MutexLock lock(mutex_);
+
+        for (Vector<WorkBucket>::Iterator i = buckets_.Begin(); i != buckets_.End() && i->priority_ >= priority; ++i)
+        {
+            if (i->head_ < i->items_.Size())
+            {
+                WorkItem* item = i->items_[i->head_++];
+                if (i->head_ == i->items_.Size())
+                {
+                    i->items_.Clear();
+                    i->head_ = 0;
+                }
+                --numItems_;
+                return item;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// Steal the newest item of the highest priority bucket, if it has at least the specified priority. Return null if none.
+    WorkItem* PopBack(unsigned priority)
+    {
+        if (!numItems_)
+            return nullptr;
+
+        MutexLock lock(mutex_);
+
+        for (Vector<WorkBucket>::Iterator i = buckets_.Begin(); i != buckets_.End() && i->priority_ >= priority; ++i)
+        {
+            if (i->head_ < i->items_.Size())
+            {
+                WorkItem* item = i->items_.Back();
+                i->items_.Pop();
+                if (i->head_ == i->items_.Size())
+                {
+                    i->items_.Clear();
+                    i->head_ = 0;
+                }
+                --numItems_;
+                return item;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// Remove an item which has not been taken yet. Return true if found.
+    bool Remove(WorkItem* item)
+    {
+        if (!numItems_)
+            return false;
+
+        MutexLock lock(mutex_);
+
+        for (Vector<WorkBucket>::Iterator i = buckets_.Begin(); i != buckets_.End(); ++i)
+        {
+            for (unsigned j = i->head_; j < i->items_.Size(); ++j)
+            {
+                if (i->items_[j] == item)
+                {
+                    i->items_.Erase(j);
+                    if (i->head_ == i->items_.Size())
+                    {
+                        i->items_.Clear();
+                        i->head_ = 0;
+                    }
+                    --numItems_;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /// Return number of items not yet taken.
+    unsigned GetNumItems() const { return numItems_; }
+
+private:
+    /// Priority buckets, sorted from highest to lowest priority.
+    Vector<WorkBucket> buckets_;
+    /// Mutex for the buckets.
+    Mutex mutex_;
+    /// Number of items not yet taken. Can be checked without locking.
+    std::atomic<unsigned> numItems_;
+};
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -62,22 +246,26 @@ private:
 
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    nextDeque_(0),
     shutDown_(false),
-    pausing_(false),
     paused_(false),
     completing_(false),
     tolerance_(10),
     lastSize_(0),
-    maxNonThreadedWorkMs_(5)
+    maxNonThreadedWorkMs_(5),
+    profiler_(nullptr)
 {
+    // Without worker threads all work goes to a single deque, which is processed by the main thread
+    deques_.Push(SharedPtr<WorkerDeque>(new WorkerDeque()));
+
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
 }
 
 WorkQueue::~WorkQueue()
 {
-    // Stop the worker threads. First make sure they are not waiting for work items
+    // Stop the worker threads. First make sure they are not waiting for work items. Each exiting thread wakes up the next
     shutDown_ = true;
-    Resume();
+    wakeCondition_.Set();
 
     for (unsigned i = 0; i < threads_.Size(); ++i)
         threads_[i]->Stop();
@@ -94,6 +282,14 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     // Start threads in paused mode
     Pause();
 
+    // Subsystems may still be registered while the threads run, so do not look up the profiler from them
+    profiler_ = GetSubsystem<Profiler>();
+
+    // Create the deques before any thread runs, as the deque vector may not be modified afterward. Items already queued
+    // in the first deque will be stolen by the other threads
+    for (unsigned i = 1; i < numThreads; ++i)
+        deques_.Push(SharedPtr<WorkerDeque>(new WorkerDeque()));
+
     for (unsigned i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
@@ -138,35 +334,90 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
     workItems_.Push(item);
     item->completed_ = false;
 
-    // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
-        queueMutex_.Acquire();
+    // Adding work resumes the worker threads
+    paused_ = false;
 
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(item);
-    else
+    // Queue now unless still waiting for dependencies, in which case the last finished dependency queues the item
+    if (--item->pendingDependencies_ == 0)
+        QueueWorkItem(item, 0);
+}
+
+void WorkQueue::AddDependency(const SharedPtr<WorkItem>& item, const SharedPtr<WorkItem>& dependency)
+{
+    if (!item || !dependency || item == dependency)
+    {
+        URHO3D_LOGERROR("Invalid work item dependency");
+        return;
+    }
+
+    // Check that neither item has been added yet
+    assert(!workItems_.Contains(item) && !workItems_.Contains(dependency));
+
+    ++item->pendingDependencies_;
+    dependency->dependents_.Push(item.Get());
+}
+
+void WorkQueue::ParallelFor(unsigned count, unsigned grainSize, const std::function<void(unsigned, unsigned, unsigned)>& function,
+    ParallelForCost* cost, unsigned priority)
+{
+    if (!count)
+        return;
+
+    unsigned numThreads = threads_.Size() + 1; // Worker threads + main thread
+
+    if (!grainSize)
     {
-        bool inserted = false;
+        unsigned numChunks = numThreads;
+        if (cost && cost->usecPerIndex_ > 0.0f)
+        {
+            // Make the chunks long enough to amortize the scheduling overhead. Cheap loops are not split at all
+            auto chunksByCost = (unsigned)(cost->usecPerIndex_ * count / PARALLELFOR_CHUNK_USEC);
+            numChunks = Clamp(chunksByCost, 1U, numThreads * PARALLELFOR_MAX_CHUNKS_PER_THREAD);
+        }
+        grainSize = (count + numChunks - 1) / numChunks;
+    }
 
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
+    ParallelForTask task;
+    task.function_ = &function;
+    if (cost)
+    {
+        task.threadUSec_.Resize(numThreads);
+        for (unsigned i = 0; i < numThreads; ++i)
+            task.threadUSec_[i] = 0;
+    }
+
+    if (grainSize >= count || threads_.Empty())
+    {
+        // Only one chunk or no worker threads: execute directly in the main thread
+        HiresTimer timer;
+        function(0, count, 0);
+        if (cost)
+            task.threadUSec_[0] = timer.GetUSec(false);
+    }
+    else
+    {
+        for (unsigned begin = 0; begin < count; begin += grainSize)
         {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.Insert(i, item);
-                inserted = true;
-                break;
-            }
+            SharedPtr<WorkItem> item = GetFreeItem();
+            item->priority_ = priority;
+            item->workFunction_ = ParallelForWork;
+            item->aux_ = &task;
+            item->start_ = reinterpret_cast<void*>((size_t)begin);
+            item->end_ = reinterpret_cast<void*>((size_t)Min(begin + grainSize, count));
+            AddWorkItem(item);
         }
 
-        if (!inserted)
-            queue_.Push(item);
+        Complete(priority);
     }
 
-    if (threads_.Size())
+    if (cost)
     {
-        queueMutex_.Release();
-        paused_ = false;
+        long long totalUSec = 0;
+        for (unsigned i = 0; i < task.threadUSec_.Size(); ++i)
+            totalUSec += task.threadUSec_[i];
+
+        float usecPerIndex = (float)totalUSec / (float)count;
+        cost->usecPerIndex_ = cost->usecPerIndex_ > 0.0f ? Lerp(cost->usecPerIndex_, usecPerIndex, 0.25f) : usecPerIndex;
     }
 }
 
@@ -175,18 +426,17 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
     if (!item)
         return false;
 
-    MutexLock lock(queueMutex_);
+    List<SharedPtr<WorkItem> >::Iterator i = workItems_.Find(item);
+    if (i == workItems_.End())
+        return false;
 
     // Can only remove successfully if the item was not yet taken by threads for execution
-    List<WorkItem*>::Iterator i = queue_.Find(item.Get());
-    if (i != queue_.End())
+    for (unsigned j = 0; j < deques_.Size(); ++j)
     {
-        List<SharedPtr<WorkItem> >::Iterator j = workItems_.Find(item);
-        if (j != workItems_.End())
+        if (deques_[j]->Remove(item.Get()))
         {
-            queue_.Erase(i);
             ReturnToPool(item);
-            workItems_.Erase(j);
+            workItems_.Erase(i);
             return true;
         }
     }
@@ -196,23 +446,12 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 
 unsigned WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items)
 {
-    MutexLock lock(queueMutex_);
     unsigned removed = 0;
 
     for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
     {
-        List<WorkItem*>::Iterator j = queue_.Find(i->Get());
-        if (j != queue_.End())
-        {
-            List<SharedPtr<WorkItem> >::Iterator k = workItems_.Find(*i);
-            if (k != workItems_.End())
-            {
-                queue_.Erase(j);
-                ReturnToPool(*k);
-                workItems_.Erase(k);
-                ++removed;
-            }
-        }
+        if (RemoveWorkItem(*i))
+            ++removed;
     }
 
     return removed;
@@ -220,23 +459,16 @@ unsigned WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items)
 
 void WorkQueue::Pause()
 {
-    if (!paused_)
-    {
-        pausing_ = true;
-
-        queueMutex_.Acquire();
-        paused_ = true;
-
-        pausing_ = false;
-    }
+    // Worker threads finish their current item, then go to sleep
+    paused_ = true;
 }
 
 void WorkQueue::Resume()
 {
     if (paused_)
     {
-        queueMutex_.Release();
         paused_ = false;
+        wakeCondition_.Set();
     }
 }
 
@@ -249,43 +481,21 @@ void WorkQueue::Complete(unsigned priority)
     {
         Resume();
 
-        // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.Empty())
-        {
-            queueMutex_.Acquire();
-            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
-                break;
-            }
-        }
-
-        // Wait for threaded work to complete
+        // Take work items also in the main thread until all high-priority work has completed. Keep stealing while
+        // waiting, as items with dependencies get queued only as the work progresses. Worker threads go to sleep by
+        // themselves once out of work
         while (!IsCompleted(priority))
         {
+            if (WorkItem* item = TakeWorkItem(0, priority))
+                ExecuteWorkItem(item, 0);
         }
-
-        // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.Empty())
-            Pause();
     }
     else
     {
         // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
+        while (WorkItem* item = deques_[0]->PopFront(priority))
         {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            ExecuteWorkItem(item, 0);
         }
     }
 
@@ -306,37 +516,106 @@ bool WorkQueue::IsCompleted(unsigned priority) const
 
 void WorkQueue::ProcessItems(unsigned threadIndex)
 {
-    bool wasActive = false;
+#ifdef URHO3D_PROFILING
+    if (profiler_)
+        profiler_->SetThreadName("Worker " + String(threadIndex));
+#endif
 
     for (;;)
     {
         if (shutDown_)
+        {
+            // Pass the wakeup on to the next sleeping thread so that all threads exit
+            wakeCondition_.Set();
             return;
+        }
+
+        WorkItem* item = paused_ ? nullptr : TakeWorkItem(threadIndex, 0);
+        if (item)
+        {
+            // If more work remains, wake up another sleeping thread to help
+            if (GetNumQueuedItems())
+                wakeCondition_.Set();
 
-        if (pausing_ && !wasActive)
-            Time::Sleep(0);
+#ifdef URHO3D_PROFILING
+            AutoProfileBlock profileBlock(profiler_, "ExecuteWorkItem");
+#endif
+            ExecuteWorkItem(item, threadIndex);
+        }
         else
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
-            {
-                wasActive = true;
+            // Sleep until work is added or the queue is resumed. If that happened after the check above, the condition
+            // is already set and the wait returns immediately
+            wakeCondition_.Wait();
+        }
+    }
+}
 
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
-            }
-            else
-            {
-                wasActive = false;
+void WorkQueue::QueueWorkItem(WorkItem* item, unsigned threadIndex)
+{
+    if (threadIndex)
+        deques_[threadIndex - 1]->Push(item);
+    else
+    {
+        // Distribute the items evenly to the worker threads' deques
+        deques_[nextDeque_]->Push(item);
+        if (++nextDeque_ >= deques_.Size())
+            nextDeque_ = 0;
+    }
 
-                queueMutex_.Release();
-                Time::Sleep(0);
-            }
-        }
+    if (threads_.Size() && !paused_)
+        wakeCondition_.Set();
+}
+
+void WorkQueue::ExecuteWorkItem(WorkItem* item, unsigned threadIndex)
+{
+    item->workFunction_(item, threadIndex);
+
+    // Queue dependents before marking the item completed, as after that the main thread may return it to the pool
+    for (PODVector<WorkItem*>::ConstIterator i = item->dependents_.Begin(); i != item->dependents_.End(); ++i)
+    {
+        if (--(*i)->pendingDependencies_ == 0)
+            QueueWorkItem(*i, threadIndex);
+    }
+    item->dependents_.Clear();
+    item->pendingDependencies_ = 1;
+
+    item->completed_ = true;
+}
+
+WorkItem* WorkQueue::TakeWorkItem(unsigned threadIndex, unsigned priority)
+{
+    unsigned numDeques = deques_.Size();
+    unsigned start = 0;
+
+    // Worker threads prefer their own deque
+    if (threadIndex)
+    {
+        unsigned own = threadIndex - 1;
+        if (WorkItem* item = deques_[own]->PopFront(priority))
+            return item;
+        start = own + 1;
+    }
+
+    // Steal from the other deques
+    for (unsigned i = 0; i < numDeques; ++i)
+    {
+        unsigned victim = (start + i) % numDeques;
+        if (threadIndex && victim == threadIndex - 1)
+            continue;
+        if (WorkItem* item = deques_[victim]->PopBack(priority))
+            return item;
     }
+
+    return nullptr;
+}
+
+unsigned WorkQueue::GetNumQueuedItems() const
+{
+    unsigned numItems = 0;
+    for (unsigned i = 0; i < deques_.Size(); ++i)
+        numItems += deques_[i]->GetNumItems();
+    return numItems;
 }
 
 void WorkQueue::PurgeCompleted(unsigned priority)
@@ -393,6 +672,8 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
         item->priority_ = M_MAX_UNSIGNED;
         item->sendEvent_ = false;
         item->completed_ = false;
+        item->dependents_.Clear();
+        item->pendingDependencies_ = 1;
 
         poolItems_.Push(item);
     }
@@ -401,18 +682,18 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.Empty() && !queue_.Empty())
+    if (threads_.Empty() && GetNumQueuedItems())
     {
         URHO3D_PROFILE(CompleteWorkNonthreaded);
 
         HiresTimer timer;
 
-        while (!queue_.Empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            WorkItem* item = deques_[0]->PopFront(0);
+            if (!item)
+                break;
+            ExecuteWorkItem(item, 0);
         }
     }
 
@@ -23,9 +23,12 @@
 #pragma once
 
 #include "../Container/List.h"
+#include "../Core/Condition.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -35,6 +38,8 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
     URHO3D_PARAM(P_ITEM, Item);                        // WorkItem ptr
 }
 
+class Profiler;
+class WorkerDeque;
 class WorkerThread;
 
 /// Work queue item.
@@ -48,7 +53,8 @@ public:
         priority_(0),
         sendEvent_(false),
         completed_(false),
-        pooled_(false)
+        pooled_(false),
+        pendingDependencies_(1)
     {
     }
 
@@ -69,9 +75,26 @@ public:
 
 private:
     bool pooled_;
+    /// Items which depend on this item and are queued when it completes.
+    PODVector<WorkItem*> dependents_;
+    /// Number of unfinished dependencies, plus one until the item has been added to the queue.
+    std::atomic<unsigned> pendingDependencies_;
+};
+
+/// Measured cost of a parallel loop. Keep it between calls to let the automatic chunk size adapt.
+struct ParallelForCost
+{
+    /// Construct.
+    ParallelForCost() :
+        usecPerIndex_(0.0f)
+    {
+    }
+
+    /// Moving average of execution time per loop index in microseconds. Zero until measured.
+    float usecPerIndex_;
 };
 
-/// Work queue subsystem for multithreading.
+/// Work queue subsystem for multithreading. Each worker thread has its own prioritized deque of work items and steals from the others when it runs out of work. Idle worker threads sleep until new work is added.
 class URHO3D_API WorkQueue : public Object
 {
     URHO3D_OBJECT(WorkQueue, Object);
@@ -88,8 +111,13 @@ public:
     void CreateThreads(unsigned numThreads);
     /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items.
     SharedPtr<WorkItem> GetFreeItem();
-    /// Add a work item and resume worker threads.
+    /// Add a work item and resume worker threads. If the item has dependencies, it is executed only after they have completed.
     void AddWorkItem(const SharedPtr<WorkItem>& item);
+    /// Make a work item wait for another item to complete before executing. Must be called before either item is added. The dependency should have at least the priority of the dependent item.
+    void AddDependency(const SharedPtr<WorkItem>& item, const SharedPtr<WorkItem>& dependency);
+    /// Execute a function over the index range [0, count) in chunks of grainSize indices, in worker threads and the main thread, and wait for all work of at least the specified priority to complete. The function is called with the chunk's begin and end index and the thread index. Grain size 0 chooses the chunk size automatically, adapting to the optional measured cost.
+    void ParallelFor(unsigned count, unsigned grainSize, const std::function<void(unsigned, unsigned, unsigned)>& function,
+        ParallelForCost* cost = nullptr, unsigned priority = M_MAX_UNSIGNED);
     /// Remove a work item before it has started executing. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
@@ -124,6 +152,14 @@ public:
 private:
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Queue a work item whose dependencies have completed. Worker threads push to their own deque.
+    void QueueWorkItem(WorkItem* item, unsigned threadIndex);
+    /// Execute a work item, then queue its dependents which have no unfinished dependencies left, and mark it completed.
+    void ExecuteWorkItem(WorkItem* item, unsigned threadIndex);
+    /// Take the next work item which has at least the specified priority. Pop from the thread's own deque first, then steal from the others. Main thread (index 0) only steals. Return null if no work is available.
+    WorkItem* TakeWorkItem(unsigned threadIndex, unsigned priority);
+    /// Return number of work items queued but not yet started.
+    unsigned GetNumQueuedItems() const;
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
     /// Purge the pool to reduce allocation where its unneeded.
@@ -139,16 +175,16 @@ private:
     List<SharedPtr<WorkItem> > poolItems_;
     /// Work item collection. Accessed only by the main thread.
     List<SharedPtr<WorkItem> > workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems.)
-    List<WorkItem*> queue_;
-    /// Worker queue mutex.
-    Mutex queueMutex_;
+    /// Prioritized work item deques, one per worker thread, or a single deque when there are no worker threads. Item pointers are guaranteed to be valid (point to workItems.)
+    Vector<SharedPtr<WorkerDeque> > deques_;
+    /// Condition for waking up sleeping worker threads.
+    Condition wakeCondition_;
+    /// Deque to push the next work item to.
+    unsigned nextDeque_;
     /// Shutting down flag.
     volatile bool shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-    volatile bool pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    /// Paused flag. Indicates the worker threads should sleep instead of taking work items.
+    volatile bool paused_;
     /// Completing work in the main thread flag.
     bool completing_;
     /// Tolerance for the shared pool before it begins to deallocate.
@@ -157,6 +193,8 @@ private:
     unsigned lastSize_;
     /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
     int maxNonThreadedWorkMs_;
+    /// Profiler for the worker threads, looked up before they start.
+    Profiler* profiler_;
 };
 
 }
@@ -194,7 +194,9 @@ bool Engine::Initialize(const VariantMap& parameters)
         if (HasParameter(parameters, EP_LOG_LEVEL))
             log->SetLevel(GetParameter(parameters, EP_LOG_LEVEL).GetInt());
         log->SetQuiet(GetParameter(parameters, EP_LOG_QUIET, false).GetBool());
+        log->SetAsync(GetParameter(parameters, EP_LOG_ASYNC, false).GetBool());
         log->Open(GetParameter(parameters, EP_LOG_NAME, "Urho3D.log").GetString());
+        log->OpenJSON(GetParameter(parameters, EP_LOG_JSON_NAME, String::EMPTY).GetString());
     }
 
     // Set maximally accurate low res timer
@@ -686,20 +688,24 @@ void Engine::Update()
     URHO3D_PROFILE(Update);
 
     // Logic update event
-    using namespace Update;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_TIMESTEP] = timeStep_;
-    SendEvent(E_UPDATE, eventData);
+    UpdateEvent updateEvent;
+    updateEvent.timeStep_ = timeStep_;
+    SendTypedEvent(updateEvent);
 
     // Logic post-update event
-    SendEvent(E_POSTUPDATE, eventData);
+    PostUpdateEvent postUpdateEvent;
+    postUpdateEvent.timeStep_ = timeStep_;
+    SendTypedEvent(postUpdateEvent);
 
     // Rendering update event
-    SendEvent(E_RENDERUPDATE, eventData);
+    RenderUpdateEvent renderUpdateEvent;
+    renderUpdateEvent.timeStep_ = timeStep_;
+    SendTypedEvent(renderUpdateEvent);
 
     // Post-render update event
-    SendEvent(E_POSTRENDERUPDATE, eventData);
+    PostRenderUpdateEvent postRenderUpdateEvent;
+    postRenderUpdateEvent.timeStep_ = timeStep_;
+    SendTypedEvent(postRenderUpdateEvent);
 }
 
 void Engine::Render()
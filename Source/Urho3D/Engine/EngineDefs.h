@@ -37,6 +37,8 @@ static const String EP_FRAME_LIMITER = "FrameLimiter";
 static const String EP_FULL_SCREEN = "FullScreen";
 static const String EP_HEADLESS = "Headless";
 static const String EP_HIGH_DPI = "HighDPI";
+static const String EP_LOG_ASYNC = "LogAsync";
+static const String EP_LOG_JSON_NAME = "LogJSONName";
 static const String EP_LOG_LEVEL = "LogLevel";
 static const String EP_LOG_NAME = "LogName";
 static const String EP_LOG_QUIET = "LogQuiet";
@@ -83,7 +83,14 @@ AnimatedModel::AnimatedModel(Context* context) :
     isMaster_(true),
     loading_(false),
     assignBonesPending_(false),
-    forceAnimationUpdate_(false)
+    forceAnimationUpdate_(false),
+    boneLodDistance_(0.0f),
+    animationLodInterpolation_(false),
+    updateBoneNodes_(true),
+    poseValid_(false),
+    poseDirty_(false),
+    poseWrittenToNodes_(false),
+    applyingPose_(false)
 {
 }
 
@@ -548,6 +555,28 @@ void AnimatedModel::SetUpdateInvisible(bool enable)
     MarkNetworkUpdate();
 }
 
+void AnimatedModel::SetAnimationLodInterpolation(bool enable)
+{
+    animationLodInterpolation_ = enable;
+    ResetPoseInterpolation();
+}
+
+void AnimatedModel::SetBoneLodDistance(float distance)
+{
+    boneLodDistance_ = Max(distance, 0.0f);
+    MarkAnimationDirty();
+}
+
+void AnimatedModel::SetUpdateBoneNodes(bool enable)
+{
+    if (enable != updateBoneNodes_)
+    {
+        updateBoneNodes_ = enable;
+        // Re-evaluate so that the bone nodes receive the current pose
+        MarkAnimationDirty();
+    }
+}
+
 
 void AnimatedModel::SetMorphWeight(unsigned index, float weight)
 {
@@ -699,6 +728,11 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
         return;
     }
 
+    // Bone order and the evaluated pose must be rebuilt for the new skeleton
+    poseBoneOrder_.Clear();
+    poseValid_ = false;
+    ResetPoseInterpolation();
+
     if (isMaster_)
     {
         // Check if bone structure has stayed compatible (reloading the model.) In that case retain the old bones and animations
@@ -905,7 +939,22 @@ const PODVector<unsigned char>& AnimatedModel::GetMorphsAttr() const
 
 void AnimatedModel::UpdateBoneBoundingBox()
 {
-    if (skeleton_.GetNumBones())
+    if (skeleton_.GetNumBones() && RefreshPose())
+    {
+        // The pose transforms are already in local space
+        boneBoundingBox_.Clear();
+
+        const Vector<Bone>& bones = skeleton_.GetBones();
+        for (unsigned i = 0; i < bones.Size(); ++i)
+        {
+            const Bone& bone = bones[i];
+            if (bone.collisionMask_ & BONECOLLISION_BOX)
+                boneBoundingBox_.Merge(bone.boundingBox_.Transformed(poseTransforms_[i]));
+            else if (bone.collisionMask_ & BONECOLLISION_SPHERE)
+                boneBoundingBox_.Merge(Sphere(poseTransforms_[i].Translation(), bone.radius_ * 0.5f));
+        }
+    }
+    else if (skeleton_.GetNumBones())
     {
         // The bone bounding box is in local space, so need the node's inverse transform
         boneBoundingBox_.Clear();
@@ -928,7 +977,7 @@ void AnimatedModel::UpdateBoneBoundingBox()
     }
 
     boneBoundingBoxDirty_ = false;
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 void AnimatedModel::OnNodeSet(Node* node)
@@ -952,7 +1001,12 @@ void AnimatedModel::OnMarkedDirty(Node* node)
         skinningDirty_ = true;
         // Bone bounding box doesn't need to be marked dirty when only the base scene node moves
         if (node != node_)
+        {
             boneBoundingBoxDirty_ = true;
+            // A bone node modified by something else than animation invalidates the evaluated pose
+            if (!applyingPose_)
+                poseDirty_ = true;
+        }
     }
 }
 
@@ -1002,6 +1056,10 @@ void AnimatedModel::AssignBoneNodes()
     if (!boneFound && model_)
         SetSkeleton(model_->GetSkeleton(), true);
 
+    poseBoneOrder_.Clear();
+    poseValid_ = false;
+    ResetPoseInterpolation();
+
     // Re-assign the same start bone to animations to get the proper bone node this time
     for (Vector<SharedPtr<AnimationState> >::Iterator i = animationStates_.Begin(); i != animationStates_.End(); ++i)
     {
@@ -1264,10 +1322,20 @@ void AnimatedModel::UpdateAnimation(const FrameInfo& frame)
             if (animationLodTimer_ >= animationLodDistance_)
                 animationLodTimer_ = fmodf(animationLodTimer_, animationLodDistance_);
             else
+            {
+                // Between updates, move the displayed pose toward the last evaluated pose if interpolating
+                if (animationLodInterpolation_ && isMaster_ && poseValid_ && !lodTargetPositions_.Empty())
+                    InterpolatePose(animationLodTimer_ / animationLodDistance_);
                 return;
+            }
         }
         else
-            animationLodTimer_ = 0.0f;
+        {
+            // Start from a per-model phase of the update interval, so that models which come into view on the same frame
+            // spread their following updates across frames instead of updating all at once
+            animationLodTimer_ = GetAnimationLodPhase() * animationLodDistance_;
+            ResetPoseInterpolation();
+        }
     }
 
     ApplyAnimation();
@@ -1283,9 +1351,13 @@ void AnimatedModel::ApplyAnimation()
     }
 
     // Reset skeleton, apply all animations, calculate bones' bounding box. Make sure this is only done for the master model
-    // (first AnimatedModel in a node)
-    if (isMaster_)
+    // (first AnimatedModel in a node). If the bone nodes match the skeleton hierarchy, evaluate into the flat bone pose
+    // instead of going through the bone nodes
+    if (isMaster_ && CheckPoseHierarchy())
+        ApplyAnimationToPose();
+    else if (isMaster_)
     {
+        poseValid_ = false;
         skeleton_.ResetSilent();
         for (Vector<SharedPtr<AnimationState> >::Iterator i = animationStates_.Begin(); i != animationStates_.End(); ++i)
             (*i)->Apply();
@@ -1307,19 +1379,12 @@ void AnimatedModel::UpdateSkinning()
     // Use model's world transform in case a bone is missing
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
 
-    // Skinning with global matrices only
-    if (!geometrySkinMatrices_.Size())
+    // Use the evaluated pose if available, so that the bone nodes' world transforms do not need to be resolved one by one
+    if (RefreshPose())
     {
         for (unsigned i = 0; i < bones.Size(); ++i)
-        {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
-        }
+            skinMatrices_[i] = worldTransform * poseTransforms_[i] * bones[i].offsetMatrix_;
     }
-    // Skinning with per-geometry matrices
     else
     {
         for (unsigned i = 0; i < bones.Size(); ++i)
@@ -1329,8 +1394,14 @@ void AnimatedModel::UpdateSkinning()
                 skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
             else
                 skinMatrices_[i] = worldTransform;
+        }
+    }
 
-            // Copy the skin matrix to per-geometry matrices as needed
+    // Skinning with per-geometry matrices: copy the skin matrices as needed
+    if (geometrySkinMatrices_.Size())
+    {
+        for (unsigned i = 0; i < bones.Size(); ++i)
+        {
             for (unsigned j = 0; j < geometrySkinMatrixPtrs_[i].Size(); ++j)
                 *geometrySkinMatrixPtrs_[i][j] = skinMatrices_[i];
         }
@@ -1339,6 +1410,272 @@ void AnimatedModel::UpdateSkinning()
     skinningDirty_ = false;
 }
 
+bool AnimatedModel::CheckPoseHierarchy()
+{
+    const Vector<Bone>& bones = skeleton_.GetBones();
+    unsigned numBones = bones.Size();
+    if (!numBones || !node_)
+        return false;
+
+    if (poseBoneOrder_.Size() != numBones)
+    {
+        // Sort the bones by hierarchy depth, so that parents are always processed before their children
+        PODVector<unsigned> depths(numBones);
+        unsigned maxDepth = 0;
+        for (unsigned i = 0; i < numBones; ++i)
+        {
+            unsigned depth = 0;
+            unsigned index = i;
+            while (bones[index].parentIndex_ != index && bones[index].parentIndex_ < numBones)
+            {
+                index = bones[index].parentIndex_;
+                // Guard against a cyclic hierarchy
+                if (++depth >= numBones)
+                {
+                    poseBoneOrder_.Clear();
+                    return false;
+                }
+            }
+            depths[i] = depth;
+            maxDepth = Max(maxDepth, depth);
+        }
+
+        poseBoneOrder_.Clear();
+        poseBoneOrder_.Reserve(numBones);
+        for (unsigned depth = 0; depth <= maxDepth; ++depth)
+        {
+            for (unsigned i = 0; i < numBones; ++i)
+            {
+                if (depths[i] == depth)
+                    poseBoneOrder_.Push(i);
+            }
+        }
+
+        // Mark the leaf bones, which may be skipped by bone LOD
+        poseLeafBones_.Resize(numBones);
+        for (unsigned i = 0; i < numBones; ++i)
+            poseLeafBones_[i] = 1;
+        for (unsigned i = 0; i < numBones; ++i)
+        {
+            unsigned parentIndex = bones[i].parentIndex_;
+            if (parentIndex != i && parentIndex < numBones)
+                poseLeafBones_[parentIndex] = 0;
+        }
+    }
+
+    // The bone nodes may have been removed or reparented, for example to attach them elsewhere
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        Node* boneNode = bones[i].node_;
+        if (!boneNode)
+            return false;
+        unsigned parentIndex = bones[i].parentIndex_;
+        Node* parentNode = (parentIndex != i && parentIndex < numBones) ? bones[parentIndex].node_.Get() : node_;
+        if (boneNode->GetParent() != parentNode)
+            return false;
+    }
+
+    return true;
+}
+
+void AnimatedModel::ApplyAnimationToPose()
+{
+    const Vector<Bone>& bones = skeleton_.GetBones();
+    unsigned numBones = bones.Size();
+
+    posePositions_.Resize(numBones);
+    poseRotations_.Resize(numBones);
+    poseScales_.Resize(numBones);
+    poseTransforms_.Resize(numBones);
+
+    // Reset animated bones to the initial pose. Bones with animation disabled keep the transform of their node
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        const Bone& bone = bones[i];
+        if (bone.animated_)
+        {
+            posePositions_[i] = bone.initialPosition_;
+            poseRotations_[i] = bone.initialRotation_;
+            poseScales_[i] = bone.initialScale_;
+        }
+        else
+        {
+            posePositions_[i] = bone.node_->GetPosition();
+            poseRotations_[i] = bone.node_->GetRotation();
+            poseScales_[i] = bone.node_->GetScale();
+        }
+    }
+
+    // Skip the leaf bones when the model is small enough on screen
+    bool skipLeafBones = boneLodDistance_ > 0.0f && animationLodDistance_ > boneLodDistance_;
+    const unsigned char* skipBones = skipLeafBones ? &poseLeafBones_[0] : nullptr;
+    for (Vector<SharedPtr<AnimationState> >::Iterator i = animationStates_.Begin(); i != animationStates_.End(); ++i)
+        (*i)->ApplyToPose(&posePositions_[0], &poseRotations_[0], &poseScales_[0], skipBones);
+
+    // When interpolating between animation LOD updates, the newly evaluated pose becomes the interpolation target, and the
+    // displayed pose restarts from the previous target
+    if (animationLodInterpolation_ && IsAnimationLodActive())
+    {
+        if (lodTargetPositions_.Size() != numBones)
+        {
+            lodTargetPositions_ = posePositions_;
+            lodTargetRotations_ = poseRotations_;
+            lodTargetScales_ = poseScales_;
+        }
+
+        lodSourcePositions_ = lodTargetPositions_;
+        lodSourceRotations_ = lodTargetRotations_;
+        lodSourceScales_ = lodTargetScales_;
+        lodTargetPositions_ = posePositions_;
+        lodTargetRotations_ = poseRotations_;
+        lodTargetScales_ = poseScales_;
+        InterpolatePose(0.0f);
+        return;
+    }
+
+    ResetPoseInterpolation();
+    CommitPose();
+}
+
+void AnimatedModel::CommitPose()
+{
+    const Vector<Bone>& bones = skeleton_.GetBones();
+    unsigned numBones = bones.Size();
+
+    UpdatePoseTransforms();
+    poseValid_ = true;
+    poseDirty_ = false;
+
+    // Non-master models in the same node skin from the bone nodes, so they must be kept up to date in that case
+    poseWrittenToNodes_ = updateBoneNodes_;
+    if (!poseWrittenToNodes_)
+    {
+        const Vector<SharedPtr<Component> >& components = node_->GetComponents();
+        for (Vector<SharedPtr<Component> >::ConstIterator i = components.Begin(); i != components.End(); ++i)
+        {
+            if (*i != this && (*i)->GetType() == AnimatedModel::GetTypeStatic())
+            {
+                poseWrittenToNodes_ = true;
+                break;
+            }
+        }
+    }
+
+    if (poseWrittenToNodes_)
+    {
+        for (unsigned i = 0; i < numBones; ++i)
+        {
+            if (bones[i].animated_)
+                bones[i].node_->SetTransformSilent(posePositions_[i], poseRotations_[i], poseScales_[i]);
+        }
+
+        // Transforms were applied silently to avoid repeated marking dirty. Mark dirty now, but keep the evaluated pose
+        applyingPose_ = true;
+        node_->MarkDirty();
+        applyingPose_ = false;
+    }
+    else
+    {
+        // The bone nodes are not touched, so only this drawable needs to be notified of the change
+        OnMarkedDirty(node_);
+    }
+
+    UpdateBoneBoundingBox();
+}
+
+void AnimatedModel::UpdatePoseTransforms()
+{
+    const Vector<Bone>& bones = skeleton_.GetBones();
+    unsigned numBones = bones.Size();
+
+    for (PODVector<unsigned>::ConstIterator i = poseBoneOrder_.Begin(); i != poseBoneOrder_.End(); ++i)
+    {
+        unsigned index = *i;
+        unsigned parentIndex = bones[index].parentIndex_;
+        Matrix3x4 localTransform(posePositions_[index], poseRotations_[index], poseScales_[index]);
+        if (parentIndex != index && parentIndex < numBones)
+            poseTransforms_[index] = poseTransforms_[parentIndex] * localTransform;
+        else
+            poseTransforms_[index] = localTransform;
+    }
+}
+
+void AnimatedModel::InterpolatePose(float t)
+{
+    const Vector<Bone>& bones = skeleton_.GetBones();
+    unsigned numBones = bones.Size();
+    if (lodSourcePositions_.Size() != numBones || lodTargetPositions_.Size() != numBones || poseBoneOrder_.Size() != numBones)
+        return;
+
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        const Bone& bone = bones[i];
+        // Bones with animation disabled are not interpolated, but follow their nodes
+        if (!bone.animated_)
+        {
+            if (!bone.node_)
+                return;
+            posePositions_[i] = bone.node_->GetPosition();
+            poseRotations_[i] = bone.node_->GetRotation();
+            poseScales_[i] = bone.node_->GetScale();
+        }
+        else
+        {
+            posePositions_[i] = lodSourcePositions_[i].Lerp(lodTargetPositions_[i], t);
+            poseRotations_[i] = lodSourceRotations_[i].Nlerp(lodTargetRotations_[i], t, true);
+            poseScales_[i] = lodSourceScales_[i].Lerp(lodTargetScales_[i], t);
+        }
+    }
+
+    CommitPose();
+}
+
+float AnimatedModel::GetAnimationLodPhase() const
+{
+    // Scatter the component IDs evenly over the 0-1 range
+    return (float)((GetID() * 2654435761U) >> 16U) / 65536.0f;
+}
+
+void AnimatedModel::ResetPoseInterpolation()
+{
+    lodSourcePositions_.Clear();
+    lodSourceRotations_.Clear();
+    lodSourceScales_.Clear();
+    lodTargetPositions_.Clear();
+    lodTargetRotations_.Clear();
+    lodTargetScales_.Clear();
+}
+
+bool AnimatedModel::RefreshPose()
+{
+    if (!poseValid_ || poseTransforms_.Size() != skeleton_.GetNumBones())
+        return false;
+
+    if (poseDirty_)
+    {
+        // If the pose was written to the bone nodes, they hold the authoritative transforms including any later
+        // modifications, such as inverse kinematics. Otherwise only bones with animation disabled are read
+        const Vector<Bone>& bones = skeleton_.GetBones();
+        for (unsigned i = 0; i < bones.Size(); ++i)
+        {
+            const Bone& bone = bones[i];
+            if (!bone.node_)
+                return false;
+            if (poseWrittenToNodes_ || !bone.animated_)
+            {
+                posePositions_[i] = bone.node_->GetPosition();
+                poseRotations_[i] = bone.node_->GetRotation();
+                poseScales_[i] = bone.node_->GetScale();
+            }
+        }
+
+        UpdatePoseTransforms();
+        poseDirty_ = false;
+    }
+
+    return true;
+}
+
 void AnimatedModel::UpdateMorphs()
 {
     auto* graphics = GetSubsystem<Graphics>();
@@ -88,6 +88,12 @@ public:
     void SetAnimationLodBias(float bias);
     /// Set whether to update animation and the bounding box when not visible. Recommended to enable for physically controlled models like ragdolls.
     void SetUpdateInvisible(bool enable);
+    /// Set whether to interpolate the bone pose on frames skipped by animation LOD. This smooths out distant models' motion at the cost of lagging one animation LOD update interval behind.
+    void SetAnimationLodInterpolation(bool enable);
+    /// Set animation LOD distance beyond which the leaf bones, for example fingers, are not animated. 0 (default) disables.
+    void SetBoneLodDistance(float distance);
+    /// Set whether to write the animated pose back to the bone scene nodes. Default true. When disabled, skinning uses only the internally evaluated pose, and the animated bone nodes keep their transforms. Disable only if nothing reads the bone nodes, for example no attachments, ragdolls or bone raycasts.
+    void SetUpdateBoneNodes(bool enable);
     /// Set vertex morph weight by index.
     void SetMorphWeight(unsigned index, float weight);
     /// Set vertex morph weight by name.
@@ -123,6 +129,15 @@ public:
     /// Return whether to update animation when not visible.
     bool GetUpdateInvisible() const { return updateInvisible_; }
 
+    /// Return whether the bone pose is interpolated on frames skipped by animation LOD.
+    bool GetAnimationLodInterpolation() const { return animationLodInterpolation_; }
+
+    /// Return animation LOD distance beyond which the leaf bones are not animated.
+    float GetBoneLodDistance() const { return boneLodDistance_; }
+
+    /// Return whether the animated pose is written back to the bone scene nodes.
+    bool GetUpdateBoneNodes() const { return updateBoneNodes_; }
+
     /// Return all vertex morphs.
     const Vector<ModelMorph>& GetMorphs() const { return morphs_; }
 
@@ -201,6 +216,24 @@ private:
     void UpdateAnimation(const FrameInfo& frame);
     /// Recalculate skinning.
     void UpdateSkinning();
+    /// Check that the bone nodes match the skeleton hierarchy, so that the pose can be evaluated without reading the bone nodes. Build the parent-first bone order if necessary.
+    bool CheckPoseHierarchy();
+    /// Evaluate all animation states into the local bone pose, calculate the bone transforms and optionally write the pose to the bone nodes.
+    void ApplyAnimationToPose();
+    /// Calculate bone transforms, write the pose to the bone nodes if necessary and update the bone bounding box.
+    void CommitPose();
+    /// Calculate bone transforms relative to the model's scene node from the local bone pose.
+    void UpdatePoseTransforms();
+    /// Interpolate the displayed pose between the last two evaluated poses and commit it.
+    void InterpolatePose(float t);
+    /// Discard the poses used for interpolation.
+    void ResetPoseInterpolation();
+    /// Return per-model phase of the animation LOD update interval, in the range 0-1.
+    float GetAnimationLodPhase() const;
+    /// Return whether animation LOD is currently skipping updates.
+    bool IsAnimationLodActive() const { return animationLodBias_ > 0.0f && animationLodDistance_ > 0.0f; }
+    /// Re-read the pose from the bone nodes if they have been modified outside of animation. Return true if the pose is in use.
+    bool RefreshPose();
     /// Reapply all vertex morphs.
     void UpdateMorphs();
     /// Apply a vertex morph.
@@ -259,6 +292,44 @@ private:
     bool assignBonesPending_;
     /// Force animation update after becoming visible flag.
     bool forceAnimationUpdate_;
+    /// Local bone positions of the evaluated pose.
+    PODVector<Vector3> posePositions_;
+    /// Local bone rotations of the evaluated pose.
+    PODVector<Quaternion> poseRotations_;
+    /// Local bone scales of the evaluated pose.
+    PODVector<Vector3> poseScales_;
+    /// Bone transforms relative to the model's scene node, calculated from the evaluated pose.
+    PODVector<Matrix3x4> poseTransforms_;
+    /// Bone indices sorted so that parents come before their children.
+    PODVector<unsigned> poseBoneOrder_;
+    /// Leaf bone flags, nonzero for bones that have no child bones.
+    PODVector<unsigned char> poseLeafBones_;
+    /// Previously evaluated local bone positions to interpolate from.
+    PODVector<Vector3> lodSourcePositions_;
+    /// Previously evaluated local bone rotations to interpolate from.
+    PODVector<Quaternion> lodSourceRotations_;
+    /// Previously evaluated local bone scales to interpolate from.
+    PODVector<Vector3> lodSourceScales_;
+    /// Last evaluated local bone positions to interpolate to.
+    PODVector<Vector3> lodTargetPositions_;
+    /// Last evaluated local bone rotations to interpolate to.
+    PODVector<Quaternion> lodTargetRotations_;
+    /// Last evaluated local bone scales to interpolate to.
+    PODVector<Vector3> lodTargetScales_;
+    /// Animation LOD distance beyond which leaf bones are not animated.
+    float boneLodDistance_;
+    /// Interpolate the pose between animation LOD updates flag.
+    bool animationLodInterpolation_;
+    /// Write animated pose to bone nodes flag.
+    bool updateBoneNodes_;
+    /// Evaluated pose in use flag. False if the bone nodes do not match the skeleton hierarchy.
+    bool poseValid_;
+    /// Bone nodes modified outside of animation flag.
+    bool poseDirty_;
+    /// Pose was written to the bone nodes on the last animation update flag.
+    bool poseWrittenToNodes_;
+    /// Writing the pose to the bone nodes flag, to ignore the resulting dirty notifications.
+    bool applyingPose_;
 };
 
 }
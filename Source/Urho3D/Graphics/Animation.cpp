@@ -49,8 +49,215 @@ inline bool CompareKeyFrames(AnimationKeyFrame& lhs, AnimationKeyFrame& rhs)
     return lhs.time_ < rhs.time_;
 }
 
+/// Flag for compressed track in the UAN2 format.
+static const unsigned char TRACK_COMPRESSED = 0x1;
+/// Largest component of a smallest-three quaternion. The other components are within +/- this value.
+static const float QUATERNION_COMPONENT_MAX = 0.70710678f;
+/// Maximum value of a 15-bit quantized quaternion component.
+static const float QUATERNION_QUANTIZE_MAX = 32767.0f;
+/// Maximum value of a 16-bit quantized position or scale component.
+static const float VECTOR_QUANTIZE_MAX = 65535.0f;
+
+/// Quantize a quaternion as its three smallest components. The index of the omitted largest component is stored in the high bits.
+static void QuantizeQuaternion(const Quaternion& rotation, unsigned short* dest)
+{
+    Quaternion q = rotation.Normalized();
+    float components[4] = {q.w_, q.x_, q.y_, q.z_};
+
+    unsigned largest = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largest]))
+            largest = i;
+    }
+
+    // q and -q are the same rotation, so make the omitted component positive
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    unsigned j = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        float normalized = Clamp(components[i] * sign / QUATERNION_COMPONENT_MAX, -1.0f, 1.0f);
+        dest[j++] = (unsigned short)((normalized * 0.5f + 0.5f) * QUATERNION_QUANTIZE_MAX + 0.5f);
+    }
+
+    dest[0] |= (unsigned short)((largest & 1) << 15);
+    dest[1] |= (unsigned short)((largest & 2) << 14);
+}
+
+/// Restore a quaternion quantized with QuantizeQuaternion().
+static Quaternion DequantizeQuaternion(const unsigned short* src)
+{
+    unsigned largest = (unsigned)(src[0] >> 15) | (unsigned)((src[1] >> 15) << 1);
+    float components[4];
+    float sumSquares = 0.0f;
+
+    unsigned j = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        float value = ((src[j++] & 0x7fff) / QUATERNION_QUANTIZE_MAX * 2.0f - 1.0f) * QUATERNION_COMPONENT_MAX;
+        components[i] = value;
+        sumSquares += value * value;
+    }
+    components[largest] = sqrtf(Max(1.0f - sumSquares, 0.0f));
+
+    return Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+/// Quantize vectors to 16 bits per component within their bounding range. Return the origin and step of the quantization.
+static void QuantizeVectors(const PODVector<Vector3>& src, PODVector<unsigned short>& dest, Vector3& min, Vector3& step)
+{
+    min = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
+    Vector3 max(-M_INFINITY, -M_INFINITY, -M_INFINITY);
+    for (unsigned i = 0; i < src.Size(); ++i)
+    {
+        min = VectorMin(min, src[i]);
+        max = VectorMax(max, src[i]);
+    }
+
+    step = (max - min) / VECTOR_QUANTIZE_MAX;
+    Vector3 invStep(step.x_ > 0.0f ? 1.0f / step.x_ : 0.0f, step.y_ > 0.0f ? 1.0f / step.y_ : 0.0f,
+        step.z_ > 0.0f ? 1.0f / step.z_ : 0.0f);
+
+    dest.Resize(src.Size() * 3);
+    for (unsigned i = 0; i < src.Size(); ++i)
+    {
+        Vector3 quantized = (src[i] - min) * invStep;
+        dest[i * 3] = (unsigned short)Clamp((int)(quantized.x_ + 0.5f), 0, 65535);
+        dest[i * 3 + 1] = (unsigned short)Clamp((int)(quantized.y_ + 0.5f), 0, 65535);
+        dest[i * 3 + 2] = (unsigned short)Clamp((int)(quantized.z_ + 0.5f), 0, 65535);
+    }
+}
+
+/// Restore a vector quantized with QuantizeVectors().
+inline Vector3 DequantizeVector(const unsigned short* src, const Vector3& min, const Vector3& step)
+{
+    return Vector3(min.x_ + src[0] * step.x_, min.y_ + src[1] * step.y_, min.z_ + src[2] * step.z_);
+}
+
+/// Store only the first keyframe of quantized data if all keyframes are the same.
+static void CollapseConstantChannel(PODVector<unsigned short>& data)
+{
+    for (unsigned i = 3; i < data.Size(); i += 3)
+    {
+        if (data[i] != data[0] || data[i + 1] != data[1] || data[i + 2] != data[2])
+            return;
+    }
+    data.Resize(3);
+}
+
+/// Write a quantized channel with its keyframe count.
+static void WriteChannel(Serializer& dest, const PODVector<unsigned short>& data)
+{
+    dest.WriteUInt(data.Size() / 3);
+    dest.Write(data.Buffer(), data.Size() * sizeof(unsigned short));
+}
+
+/// Read a quantized channel with its keyframe count. Return false if the count is invalid.
+static bool ReadChannel(Deserializer& source, PODVector<unsigned short>& data, unsigned numKeyFrames)
+{
+    unsigned count = source.ReadUInt();
+    if (count != 1 && count != numKeyFrames)
+        return false;
+    data.Resize(count * 3);
+    source.Read(data.Buffer(), data.Size() * sizeof(unsigned short));
+    return true;
+}
+
+void AnimationTrack::Compress()
+{
+    if (compressed_)
+        return;
+
+    unsigned numKeyFrames = keyFrames_.Size();
+
+    // Check for uniform sampling, in which case the keyframe times do not need to be stored
+    sampleInterval_ = 0.0f;
+    startTime_ = numKeyFrames ? keyFrames_[0].time_ : 0.0f;
+    keyTimes_.Clear();
+    if (numKeyFrames > 1)
+    {
+        float interval = (keyFrames_.Back().time_ - startTime_) / (numKeyFrames - 1);
+        bool uniform = interval > 0.0f;
+        for (unsigned i = 1; i < numKeyFrames - 1 && uniform; ++i)
+        {
+            if (Abs(keyFrames_[i].time_ - (startTime_ + i * interval)) > interval * 0.001f)
+                uniform = false;
+        }
+        if (uniform)
+            sampleInterval_ = interval;
+    }
+    if (sampleInterval_ == 0.0f)
+    {
+        keyTimes_.Resize(numKeyFrames);
+        for (unsigned i = 0; i < numKeyFrames; ++i)
+            keyTimes_[i] = keyFrames_[i].time_;
+    }
+
+    positions_.Clear();
+    rotations_.Clear();
+    scales_.Clear();
+
+    if (numKeyFrames)
+    {
+        PODVector<Vector3> vectors(numKeyFrames);
+
+        if (channelMask_ & CHANNEL_POSITION)
+        {
+            for (unsigned i = 0; i < numKeyFrames; ++i)
+                vectors[i] = keyFrames_[i].position_;
+            QuantizeVectors(vectors, positions_, positionMin_, positionStep_);
+            CollapseConstantChannel(positions_);
+        }
+
+        if (channelMask_ & CHANNEL_ROTATION)
+        {
+            rotations_.Resize(numKeyFrames * 3);
+            for (unsigned i = 0; i < numKeyFrames; ++i)
+                QuantizeQuaternion(keyFrames_[i].rotation_, &rotations_[i * 3]);
+            CollapseConstantChannel(rotations_);
+        }
+
+        if (channelMask_ & CHANNEL_SCALE)
+        {
+            for (unsigned i = 0; i < numKeyFrames; ++i)
+                vectors[i] = keyFrames_[i].scale_;
+            QuantizeVectors(vectors, scales_, scaleMin_, scaleStep_);
+            CollapseConstantChannel(scales_);
+        }
+    }
+
+    numCompressedKeyFrames_ = numKeyFrames;
+    keyFrames_.Clear();
+    keyFrames_.Compact();
+    compressed_ = true;
+}
+
+void AnimationTrack::Decompress()
+{
+    if (!compressed_)
+        return;
+
+    keyFrames_.Resize(numCompressedKeyFrames_);
+    for (unsigned i = 0; i < numCompressedKeyFrames_; ++i)
+        GetKeyFrame(i, keyFrames_[i]);
+
+    compressed_ = false;
+    numCompressedKeyFrames_ = 0;
+    sampleInterval_ = 0.0f;
+    keyTimes_.Clear();
+    positions_.Clear();
+    rotations_.Clear();
+    scales_.Clear();
+}
+
 void AnimationTrack::SetKeyFrame(unsigned index, const AnimationKeyFrame& keyFrame)
 {
+    Decompress();
+
     if (index < keyFrames_.Size())
     {
         keyFrames_[index] = keyFrame;
@@ -62,6 +269,8 @@ void AnimationTrack::SetKeyFrame(unsigned index, const AnimationKeyFrame& keyFra
 
 void AnimationTrack::AddKeyFrame(const AnimationKeyFrame& keyFrame)
 {
+    Decompress();
+
     bool needSort = keyFrames_.Size() ? keyFrames_.Back().time_ > keyFrame.time_ : false;
     keyFrames_.Push(keyFrame);
     if (needSort)
@@ -70,40 +279,106 @@ void AnimationTrack::AddKeyFrame(const AnimationKeyFrame& keyFrame)
 
 void AnimationTrack::InsertKeyFrame(unsigned index, const AnimationKeyFrame& keyFrame)
 {
+    Decompress();
+
     keyFrames_.Insert(index, keyFrame);
     Urho3D::Sort(keyFrames_.Begin(), keyFrames_.End(), CompareKeyFrames);
 }
 
 void AnimationTrack::RemoveKeyFrame(unsigned index)
 {
+    Decompress();
+
     keyFrames_.Erase(index);
 }
 
 void AnimationTrack::RemoveAllKeyFrames()
 {
+    Decompress();
+
     keyFrames_.Clear();
 }
 
 AnimationKeyFrame* AnimationTrack::GetKeyFrame(unsigned index)
 {
+    Decompress();
+
     return index < keyFrames_.Size() ? &keyFrames_[index] : nullptr;
 }
 
+void AnimationTrack::GetKeyFrame(unsigned index, AnimationKeyFrame& dest) const
+{
+    if (!compressed_)
+    {
+        dest = keyFrames_[index];
+        return;
+    }
+
+    dest.time_ = GetKeyFrameTime(index);
+    if (!positions_.Empty())
+        dest.position_ = DequantizeVector(&positions_[positions_.Size() > 3 ? index * 3 : 0], positionMin_, positionStep_);
+    if (!rotations_.Empty())
+        dest.rotation_ = DequantizeQuaternion(&rotations_[rotations_.Size() > 3 ? index * 3 : 0]);
+    if (!scales_.Empty())
+        dest.scale_ = DequantizeVector(&scales_[scales_.Size() > 3 ? index * 3 : 0], scaleMin_, scaleStep_);
+}
+
 void AnimationTrack::GetKeyFrameIndex(float time, unsigned& index) const
 {
+    unsigned numKeyFrames = GetNumKeyFrames();
+    if (!numKeyFrames)
+    {
+        index = 0;
+        return;
+    }
+
     if (time < 0.0f)
         time = 0.0f;
 
-    if (index >= keyFrames_.Size())
-        index = keyFrames_.Size() - 1;
+    // Uniformly sampled keyframes can be indexed directly
+    if (compressed_ && sampleInterval_ > 0.0f)
+    {
+        auto sampleIndex = (int)((time - startTime_) / sampleInterval_);
+        index = (unsigned)Clamp(sampleIndex, 0, (int)numKeyFrames - 1);
+        return;
+    }
+
+    if (index >= numKeyFrames)
+        index = numKeyFrames - 1;
+
+    // During playback the time usually stays within the previous keyframe or advances to the next one
+    if (time >= GetKeyFrameTime(index))
+    {
+        if (index + 1 >= numKeyFrames || time < GetKeyFrameTime(index + 1))
+            return;
+        if (index + 2 >= numKeyFrames || time < GetKeyFrameTime(index + 2))
+        {
+            ++index;
+            return;
+        }
+    }
+
+    // Otherwise binary search for the last keyframe at or before the time
+    unsigned low = 0;
+    unsigned high = numKeyFrames;
+    while (low < high)
+    {
+        unsigned middle = (low + high) / 2;
+        if (GetKeyFrameTime(middle) <= time)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    index = low ? low - 1 : 0;
+}
 
-    // Check for being too far ahead
-    while (index && time < keyFrames_[index].time_)
-        --index;
+unsigned AnimationTrack::GetKeyFrameMemoryUse() const
+{
+    if (!compressed_)
+        return keyFrames_.Size() * sizeof(AnimationKeyFrame);
 
-    // Check for being too far behind
-    while (index < keyFrames_.Size() - 1 && time >= keyFrames_[index + 1].time_)
-        ++index;
+    return (keyTimes_.Size() * sizeof(float)) +
+           (positions_.Size() + rotations_.Size() + scales_.Size()) * sizeof(unsigned short);
 }
 
 Animation::Animation(Context* context) :
@@ -123,12 +398,14 @@ bool Animation::BeginLoad(Deserializer& source)
 {
     unsigned memoryUse = sizeof(Animation);
 
-    // Check ID
-    if (source.ReadFileID() != "UANI")
+    // Check ID. UAN2 adds per-track flags for compressed keyframes
+    String fileID = source.ReadFileID();
+    if (fileID != "UANI" && fileID != "UAN2")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid animation file");
         return false;
     }
+    bool hasTrackFlags = fileID == "UAN2";
 
     // Read name and length
     animationName_ = source.ReadString();
@@ -144,8 +421,49 @@ bool Animation::BeginLoad(Deserializer& source)
     {
         AnimationTrack* newTrack = CreateTrack(source.ReadString());
         newTrack->channelMask_ = source.ReadUByte();
+        unsigned char trackFlags = hasTrackFlags ? source.ReadUByte() : (unsigned char)0;
 
         unsigned keyFrames = source.ReadUInt();
+
+        if (trackFlags & TRACK_COMPRESSED)
+        {
+            newTrack->compressed_ = true;
+            newTrack->numCompressedKeyFrames_ = keyFrames;
+            newTrack->startTime_ = source.ReadFloat();
+            newTrack->sampleInterval_ = source.ReadFloat();
+            if (newTrack->sampleInterval_ <= 0.0f)
+            {
+                newTrack->sampleInterval_ = 0.0f;
+                newTrack->keyTimes_.Resize(keyFrames);
+                source.Read(newTrack->keyTimes_.Buffer(), keyFrames * sizeof(float));
+            }
+
+            bool valid = true;
+            if (newTrack->channelMask_ & CHANNEL_POSITION)
+            {
+                newTrack->positionMin_ = source.ReadVector3();
+                newTrack->positionStep_ = source.ReadVector3();
+                valid &= ReadChannel(source, newTrack->positions_, keyFrames);
+            }
+            if (newTrack->channelMask_ & CHANNEL_ROTATION)
+                valid &= ReadChannel(source, newTrack->rotations_, keyFrames);
+            if (newTrack->channelMask_ & CHANNEL_SCALE)
+            {
+                newTrack->scaleMin_ = source.ReadVector3();
+                newTrack->scaleStep_ = source.ReadVector3();
+                valid &= ReadChannel(source, newTrack->scales_, keyFrames);
+            }
+
+            if (!valid || (keyFrames && !newTrack->channelMask_))
+            {
+                URHO3D_LOGERROR(source.GetName() + " has invalid compressed animation track " + newTrack->name_);
+                return false;
+            }
+
+            memoryUse += newTrack->GetKeyFrameMemoryUse();
+            continue;
+        }
+
         newTrack->keyFrames_.Resize(keyFrames);
         memoryUse += keyFrames * sizeof(AnimationKeyFrame);
 
@@ -223,8 +541,16 @@ bool Animation::BeginLoad(Deserializer& source)
 
 bool Animation::Save(Serializer& dest) const
 {
+    // Use the UAN2 format only when needed for compressed tracks, so that uncompressed animations stay readable by older versions
+    bool hasCompressedTracks = false;
+    for (HashMap<StringHash, AnimationTrack>::ConstIterator i = tracks_.Begin(); i != tracks_.End(); ++i)
+    {
+        if (i->second_.IsCompressed())
+            hasCompressedTracks = true;
+    }
+
     // Write ID, name and length
-    dest.WriteFileID("UANI");
+    dest.WriteFileID(hasCompressedTracks ? "UAN2" : "UANI");
     dest.WriteString(animationName_);
     dest.WriteFloat(length_);
 
@@ -235,6 +561,35 @@ bool Animation::Save(Serializer& dest) const
         const AnimationTrack& track = i->second_;
         dest.WriteString(track.name_);
         dest.WriteUByte(track.channelMask_);
+
+        if (hasCompressedTracks)
+            dest.WriteUByte(track.IsCompressed() ? TRACK_COMPRESSED : (unsigned char)0);
+
+        if (track.IsCompressed())
+        {
+            dest.WriteUInt(track.numCompressedKeyFrames_);
+            dest.WriteFloat(track.startTime_);
+            dest.WriteFloat(track.sampleInterval_);
+            if (track.sampleInterval_ <= 0.0f)
+                dest.Write(track.keyTimes_.Buffer(), track.keyTimes_.Size() * sizeof(float));
+
+            if (track.channelMask_ & CHANNEL_POSITION)
+            {
+                dest.WriteVector3(track.positionMin_);
+                dest.WriteVector3(track.positionStep_);
+                WriteChannel(dest, track.positions_);
+            }
+            if (track.channelMask_ & CHANNEL_ROTATION)
+                WriteChannel(dest, track.rotations_);
+            if (track.channelMask_ & CHANNEL_SCALE)
+            {
+                dest.WriteVector3(track.scaleMin_);
+                dest.WriteVector3(track.scaleStep_);
+                WriteChannel(dest, track.scales_);
+            }
+            continue;
+        }
+
         dest.WriteUInt(track.keyFrames_.Size());
 
         // Write keyframes of the track
@@ -381,6 +736,21 @@ SharedPtr<Animation> Animation::Clone(const String& cloneName) const
     return ret;
 }
 
+void Animation::Compress()
+{
+    unsigned memoryUse = GetMemoryUse();
+
+    for (HashMap<StringHash, AnimationTrack>::Iterator i = tracks_.Begin(); i != tracks_.End(); ++i)
+    {
+        AnimationTrack& track = i->second_;
+        unsigned oldMemoryUse = track.GetKeyFrameMemoryUse();
+        track.Compress();
+        memoryUse = memoryUse - Min(oldMemoryUse, memoryUse) + track.GetKeyFrameMemoryUse();
+    }
+
+    SetMemoryUse(memoryUse);
+}
+
 AnimationTrack* Animation::GetTrack(unsigned index)
 {
     if (index >= GetNumTracks())
@@ -55,7 +55,11 @@ struct URHO3D_API AnimationTrack
 {
     /// Construct.
     AnimationTrack() :
-        channelMask_(0)
+        channelMask_(0),
+        compressed_(false),
+        numCompressedKeyFrames_(0),
+        startTime_(0.0f),
+        sampleInterval_(0.0f)
     {
     }
 
@@ -70,12 +74,30 @@ struct URHO3D_API AnimationTrack
     /// Remove all keyframes.
     void RemoveAllKeyFrames();
 
-    /// Return keyframe at index, or null if not found.
+    /// Compress the keyframes. Rotations are quantized to 48-bit smallest-three quaternions, positions and scales to 16 bits per component within the track's range, channels that do not change are stored once and uniformly sampled keyframe times are not stored at all. The keyframe vector is cleared.
+    void Compress();
+    /// Decompress the keyframes back into the keyframe vector, for example for editing.
+    void Decompress();
+
+    /// Return keyframe at index, or null if not found. Decompresses the track if necessary.
     AnimationKeyFrame* GetKeyFrame(unsigned index);
+    /// Return keyframe at index from either compressed or uncompressed storage. The index must be valid.
+    void GetKeyFrame(unsigned index, AnimationKeyFrame& dest) const;
+    /// Return keyframe time at index. The index must be valid.
+    float GetKeyFrameTime(unsigned index) const
+    {
+        if (!compressed_)
+            return keyFrames_[index].time_;
+        return sampleInterval_ > 0.0f ? startTime_ + index * sampleInterval_ : keyTimes_[index];
+    }
     /// Return number of keyframes.
-    unsigned GetNumKeyFrames() const { return keyFrames_.Size(); }
-    /// Return keyframe index based on time and previous index.
+    unsigned GetNumKeyFrames() const { return compressed_ ? numCompressedKeyFrames_ : keyFrames_.Size(); }
+    /// Return keyframe index based on time and previous index. Uniformly sampled compressed tracks are indexed directly, otherwise the previous index and its successor are checked before falling back to a binary search.
     void GetKeyFrameIndex(float time, unsigned& index) const;
+    /// Return whether the keyframes are compressed.
+    bool IsCompressed() const { return compressed_; }
+    /// Return memory use of the keyframes in bytes.
+    unsigned GetKeyFrameMemoryUse() const;
 
     /// Bone or scene node name.
     String name_;
@@ -83,8 +105,32 @@ struct URHO3D_API AnimationTrack
     StringHash nameHash_;
     /// Bitmask of included data (position, rotation, scale.)
     unsigned char channelMask_;
-    /// Keyframes.
+    /// Keyframes. Empty when the track is compressed.
     Vector<AnimationKeyFrame> keyFrames_;
+    /// Compressed flag.
+    bool compressed_;
+    /// Number of compressed keyframes.
+    unsigned numCompressedKeyFrames_;
+    /// First keyframe time of uniformly sampled compressed keyframes.
+    float startTime_;
+    /// Time between uniformly sampled compressed keyframes, or zero if the times are stored.
+    float sampleInterval_;
+    /// Compressed keyframe times if not uniformly sampled.
+    PODVector<float> keyTimes_;
+    /// Quantized compressed positions, three components per keyframe or only one keyframe if constant.
+    PODVector<unsigned short> positions_;
+    /// Quantized compressed rotations, three components per keyframe or only one keyframe if constant.
+    PODVector<unsigned short> rotations_;
+    /// Quantized compressed scales, three components per keyframe or only one keyframe if constant.
+    PODVector<unsigned short> scales_;
+    /// Position quantization origin.
+    Vector3 positionMin_;
+    /// Position quantization step.
+    Vector3 positionStep_;
+    /// Scale quantization origin.
+    Vector3 scaleMin_;
+    /// Scale quantization step.
+    Vector3 scaleStep_;
 };
 
 /// %Animation trigger point.
@@ -148,6 +194,8 @@ public:
     void SetNumTriggers(unsigned num);
     /// Clone the animation.
     SharedPtr<Animation> Clone(const String& cloneName = String::EMPTY) const;
+    /// Compress the keyframes of all tracks. Compressed animations are saved in the UAN2 format.
+    void Compress();
 
     /// Return animation name.
     const String& GetAnimationName() const { return animationName_; }
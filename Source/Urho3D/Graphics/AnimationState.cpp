@@ -467,6 +467,31 @@ void AnimationState::ApplyToModel()
     }
 }
 
+void AnimationState::ApplyToPose(Vector3* positions, Quaternion* rotations, Vector3* scales, const unsigned char* skipBones)
+{
+    if (!animation_ || !IsEnabled() || !model_)
+        return;
+
+    const Vector<Bone>& bones = model_->GetSkeleton().GetBones();
+    if (bones.Empty())
+        return;
+
+    for (Vector<AnimationStateTrack>::Iterator i = stateTracks_.Begin(); i != stateTracks_.End(); ++i)
+    {
+        AnimationStateTrack& stateTrack = *i;
+        float finalWeight = weight_ * stateTrack.weight_;
+
+        if (Equals(finalWeight, 0.0f) || !stateTrack.bone_->animated_)
+            continue;
+
+        auto boneIndex = (unsigned)(stateTrack.bone_ - &bones[0]);
+        if (skipBones && skipBones[boneIndex])
+            continue;
+
+        BlendTrack(stateTrack, finalWeight, positions[boneIndex], rotations[boneIndex], scales[boneIndex]);
+    }
+}
+
 void AnimationState::ApplyToNodes()
 {
     // When applying to a node hierarchy, can only use full weight (nothing to blend to)
@@ -476,19 +501,53 @@ void AnimationState::ApplyToNodes()
 
 void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent)
 {
-    const AnimationTrack* track = stateTrack.track_;
     Node* node = stateTrack.node_;
+    if (!node)
+        return;
 
-    if (track->keyFrames_.Empty() || !node)
+    Vector3 newPosition = node->GetPosition();
+    Quaternion newRotation = node->GetRotation();
+    Vector3 newScale = node->GetScale();
+    if (!BlendTrack(stateTrack, weight, newPosition, newRotation, newScale))
         return;
 
+    unsigned char channelMask = stateTrack.track_->channelMask_;
+    if (silent)
+    {
+        if (channelMask & CHANNEL_POSITION)
+            node->SetPositionSilent(newPosition);
+        if (channelMask & CHANNEL_ROTATION)
+            node->SetRotationSilent(newRotation);
+        if (channelMask & CHANNEL_SCALE)
+            node->SetScaleSilent(newScale);
+    }
+    else
+    {
+        if (channelMask & CHANNEL_POSITION)
+            node->SetPosition(newPosition);
+        if (channelMask & CHANNEL_ROTATION)
+            node->SetRotation(newRotation);
+        if (channelMask & CHANNEL_SCALE)
+            node->SetScale(newScale);
+    }
+}
+
+bool AnimationState::BlendTrack(AnimationStateTrack& stateTrack, float weight, Vector3& position, Quaternion& rotation,
+    Vector3& scale)
+{
+    const AnimationTrack* track = stateTrack.track_;
+
+    unsigned numKeyFrames = track->GetNumKeyFrames();
+    if (!numKeyFrames)
+        return false;
+
     unsigned& frame = stateTrack.keyFrame_;
     track->GetKeyFrameIndex(time_, frame);
 
     // Check if next frame to interpolate to is valid, or if wrapping is needed (looping animation only)
     unsigned nextFrame = frame + 1;
     bool interpolate = true;
-    if (nextFrame >= track->keyFrames_.Size())
+    if (nextFrame >= numKeyFrames)
     {
         if (!looped_)
         {
@@ -499,7 +558,16 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
             nextFrame = 0;
     }
 
-    const AnimationKeyFrame* keyFrame = &track->keyFrames_[frame];
+    // Compressed tracks are decoded into temporary keyframes
+    AnimationKeyFrame decodedKeyFrames[2];
+    const AnimationKeyFrame* keyFrame;
+    if (track->IsCompressed())
+    {
+        track->GetKeyFrame(frame, decodedKeyFrames[0]);
+        keyFrame = &decodedKeyFrames[0];
+    }
+    else
+        keyFrame = &track->keyFrames_[frame];
     unsigned char channelMask = track->channelMask_;
 
     Vector3 newPosition;
@@ -508,7 +576,14 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
 
     if (interpolate)
     {
-        const AnimationKeyFrame* nextKeyFrame = &track->keyFrames_[nextFrame];
+        const AnimationKeyFrame* nextKeyFrame;
+        if (track->IsCompressed())
+        {
+            track->GetKeyFrame(nextFrame, decodedKeyFrames[1]);
+            nextKeyFrame = &decodedKeyFrames[1];
+        }
+        else
+            nextKeyFrame = &track->keyFrames_[nextFrame];
         float timeInterval = nextKeyFrame->time_ - keyFrame->time_;
         if (timeInterval < 0.0f)
             timeInterval += animation_->GetLength();
@@ -536,19 +611,19 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
         if (channelMask & CHANNEL_POSITION)
         {
             Vector3 delta = newPosition - stateTrack.bone_->initialPosition_;
-            newPosition = node->GetPosition() + delta * weight;
+            newPosition = position + delta * weight;
         }
         if (channelMask & CHANNEL_ROTATION)
         {
             Quaternion delta = newRotation * stateTrack.bone_->initialRotation_.Inverse();
-            newRotation = (delta * node->GetRotation()).Normalized();
+            newRotation = (delta * rotation).Normalized();
             if (!Equals(weight, 1.0f))
-                newRotation = node->GetRotation().Slerp(newRotation, weight);
+                newRotation = rotation.Slerp(newRotation, weight);
         }
         if (channelMask & CHANNEL_SCALE)
         {
             Vector3 delta = newScale - stateTrack.bone_->initialScale_;
-            newScale = node->GetScale() + delta * weight;
+            newScale = scale + delta * weight;
         }
     }
     else
@@ -556,32 +631,22 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
         if (!Equals(weight, 1.0f)) // not full weight
         {
             if (channelMask & CHANNEL_POSITION)
-                newPosition = node->GetPosition().Lerp(newPosition, weight);
+                newPosition = position.Lerp(newPosition, weight);
             if (channelMask & CHANNEL_ROTATION)
-                newRotation = node->GetRotation().Slerp(newRotation, weight);
+                newRotation = rotation.Slerp(newRotation, weight);
             if (channelMask & CHANNEL_SCALE)
-                newScale = node->GetScale().Lerp(newScale, weight);
+                newScale = scale.Lerp(newScale, weight);
         }
     }
 
-    if (silent)
-    {
-        if (channelMask & CHANNEL_POSITION)
-            node->SetPositionSilent(newPosition);
-        if (channelMask & CHANNEL_ROTATION)
-            node->SetRotationSilent(newRotation);
-        if (channelMask & CHANNEL_SCALE)
-            node->SetScaleSilent(newScale);
-    }
-    else
-    {
-        if (channelMask & CHANNEL_POSITION)
-            node->SetPosition(newPosition);
-        if (channelMask & CHANNEL_ROTATION)
-            node->SetRotation(newRotation);
-        if (channelMask & CHANNEL_SCALE)
-            node->SetScale(newScale);
-    }
+    if (channelMask & CHANNEL_POSITION)
+        position = newPosition;
+    if (channelMask & CHANNEL_ROTATION)
+        rotation = newRotation;
+    if (channelMask & CHANNEL_SCALE)
+        scale = newScale;
+
+    return true;
 }
 
 }
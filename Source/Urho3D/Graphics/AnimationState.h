@@ -144,6 +144,8 @@ public:
 
     /// Apply the animation at the current time position.
     void Apply();
+    /// Blend the animation at the current time position into a flat local pose of the model's skeleton, indexed by bone. Bones with a nonzero value in the optional skip mask are left untouched. Does not touch the bone nodes. Model mode only.
+    void ApplyToPose(Vector3* positions, Quaternion* rotations, Vector3* scales, const unsigned char* skipBones = nullptr);
 
 private:
     /// Apply animation to a skeleton. Transform changes are applied silently, so the model needs to dirty its root model afterward.
@@ -152,6 +154,8 @@ private:
     void ApplyToNodes();
     /// Apply track.
     void ApplyTrack(AnimationStateTrack& stateTrack, float weight, bool silent);
+    /// Sample track and blend the result into the given local transform. Return false if the track has no keyframes.
+    bool BlendTrack(AnimationStateTrack& stateTrack, float weight, Vector3& position, Quaternion& rotation, Vector3& scale);
 
     /// Animated model (model mode.)
     WeakPtr<AnimatedModel> model_;
@@ -35,39 +35,39 @@
 #include "../Graphics/View.h"
 #include "../Scene/Scene.h"
 
+#include <cstring>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
-inline bool CompareBatchesState(Batch* lhs, Batch* rhs)
-{
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->sortKey_ != rhs->sortKey_)
-        return lhs->sortKey_ < rhs->sortKey_;
-    else
-        return lhs->distance_ < rhs->distance_;
-}
+/// Sentinel for a sort ID that has not been remapped yet.
+static const unsigned UNMAPPED_SORT_ID = M_MAX_UNSIGNED;
 
-inline bool CompareBatchesFrontToBack(Batch* lhs, Batch* rhs)
+/// Convert a float to an unsigned integer which sorts in the same order.
+inline unsigned FloatToSortableBits(float value)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ < rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    unsigned bits;
+    memcpy(&bits, &value, sizeof bits);
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
 }
 
-inline bool CompareBatchesBackToFront(Batch* lhs, Batch* rhs)
+/// Remap a sort ID to its order of first appearance, assigning the next free rank if not seen yet.
+inline unsigned RemapSortID(PODVector<unsigned>& remapping, unsigned id, unsigned& freeRank)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    if (id >= remapping.Size())
+    {
+        unsigned oldSize = remapping.Size();
+        remapping.Resize(id + 1);
+        for (unsigned i = oldSize; i < remapping.Size(); ++i)
+            remapping[i] = UNMAPPED_SORT_ID;
+    }
+
+    unsigned& rank = remapping[id];
+    if (rank == UNMAPPED_SORT_ID)
+        rank = freeRank++;
+    return rank;
 }
 
 inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
@@ -161,18 +161,30 @@ void CalculateSpotMatrix(Matrix4& dest, Light* light)
 
 void Batch::CalculateSortKey()
 {
-    auto shaderID = (unsigned)(
-        ((*((unsigned*)&vertexShader_) / sizeof(ShaderVariation)) + (*((unsigned*)&pixelShader_) / sizeof(ShaderVariation))) &
-        0x7fff);
-    if (!isBase_)
-        shaderID |= 0x8000;
+    unsigned vertexShaderID = 0;
+    unsigned pixelShaderID = 0;
+    if (vertexShader_ && pixelShader_)
+    {
+        vertexShaderID = vertexShader_->GetSortID();
+        pixelShaderID = pixelShader_->GetSortID();
+    }
+
+    // Per-pixel light queues are identified by their light, vertex light queues by their first vertex light
+    unsigned lightQueueID = 0;
+    if (lightQueue_)
+    {
+        Light* light = lightQueue_->light_ ? lightQueue_->light_ :
+            (lightQueue_->vertexLights_.Size() ? lightQueue_->vertexLights_[0] : nullptr);
+        if (light)
+            lightQueueID = (light->GetID() + 1) & 0xffff;
+    }
 
-    auto lightQueueID = (unsigned)((*((unsigned*)&lightQueue_) / sizeof(LightBatchQueue)) & 0xffff);
-    auto materialID = (unsigned)((*((unsigned*)&material_) / sizeof(Material)) & 0xffff);
-    auto geometryID = (unsigned)((*((unsigned*)&geometry_) / sizeof(Geometry)) & 0xffff);
+    unsigned materialID = material_ ? material_->GetSortID() : 0;
+    unsigned geometryID = geometry_ ? geometry_->GetSortID() : 0;
 
-    sortKey_ = (((unsigned long long)shaderID) << 48) | (((unsigned long long)lightQueueID) << 32) |
+    sortKey_ = (((unsigned long long)vertexShaderID) << 48) | (((unsigned long long)pixelShaderID) << 32) |
                (((unsigned long long)materialID) << 16) | geometryID;
+    lightSortKey_ = (isBase_ ? 0 : 0x10000) | lightQueueID;
 }
 
 void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool allowDepthWrite) const
@@ -728,16 +740,35 @@ void BatchQueue::Clear(int maxSortedInstances)
 void BatchQueue::SortBackToFront()
 {
     sortedBatches_.Resize(batches_.Size());
+    sortKeys_.Resize(batches_.Size());
 
+    // Sort by state first, then stably by render order and descending distance, so that state breaks distance ties.
+    // The state is sorted by light, material and geometry, then by base pass flag and shaders
     for (unsigned i = 0; i < batches_.Size(); ++i)
+    {
         sortedBatches_[i] = &batches_[i];
+        sortKeys_[i] = ((unsigned long long)(batches_[i].lightSortKey_ & 0xffff) << 32) | (batches_[i].sortKey_ & 0xffffffff);
+    }
+    RadixSort(sortedBatches_);
+
+    for (unsigned i = 0; i < sortedBatches_.Size(); ++i)
+    {
+        Batch* batch = sortedBatches_[i];
+        sortKeys_[i] = ((unsigned long long)(batch->lightSortKey_ >> 16) << 32) | (batch->sortKey_ >> 32);
+    }
+    RadixSort(sortedBatches_);
 
-    Sort(sortedBatches_.Begin(), sortedBatches_.End(), CompareBatchesBackToFront);
+    for (unsigned i = 0; i < sortedBatches_.Size(); ++i)
+    {
+        Batch* batch = sortedBatches_[i];
+        sortKeys_[i] = ((unsigned long long)batch->renderOrder_ << 32) | (unsigned)~FloatToSortableBits(batch->distance_);
+    }
+    RadixSort(sortedBatches_);
 
     sortedBatchGroups_.Resize(batchGroups_.Size());
 
     unsigned index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         sortedBatchGroups_[index++] = &i->second_;
 
     Sort(sortedBatchGroups_.Begin(), sortedBatchGroups_.End(), CompareBatchGroupOrder);
@@ -753,7 +784,7 @@ void BatchQueue::SortFrontToBack()
     SortFrontToBack2Pass(sortedBatches_);
 
     // Sort each group front to back
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
     {
         if (i->second_.instances_.Size() <= maxSortedInstances_)
         {
@@ -773,7 +804,7 @@ void BatchQueue::SortFrontToBack()
     sortedBatchGroups_.Resize(batchGroups_.Size());
 
     unsigned index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         sortedBatchGroups_[index++] = &i->second_;
 
     SortFrontToBack2Pass(reinterpret_cast<PODVector<Batch*>& >(sortedBatchGroups_));
@@ -783,65 +814,140 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
 {
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
     // method is also time consuming, so just sort with state having priority
+    // All passes are stable LSD radix sorts, so each pass keeps the order of the previous one among its equal keys
+    sortKeys_.Resize(batches.Size());
+
 #ifdef GL_ES_VERSION_2_0
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = FloatToSortableBits(batches[i]->distance_);
+    RadixSort(batches);
+
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = batches[i]->sortKey_;
+    RadixSort(batches);
+
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = batches[i]->lightSortKey_;
+    RadixSort(batches);
+
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = batches[i]->renderOrder_;
+    RadixSort(batches);
 #else
-    // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+    // For desktop, first sort by distance, then rank the state IDs in their order of first appearance
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = ((unsigned long long)batches[i]->renderOrder_ << 32) | FloatToSortableBits(batches[i]->distance_);
+    RadixSort(batches);
+
+    unsigned freeVertexShaderRank = 0;
+    unsigned freePixelShaderRank = 0;
+    unsigned freeLightQueueRank = 0;
+    unsigned freeMaterialRank = 0;
+    unsigned freeGeometryRank = 0;
+
+    // Materials and geometries go into the least significant bits, which are sorted first
+    for (unsigned i = 0; i < batches.Size(); ++i)
+    {
+        unsigned long long key = batches[i]->sortKey_;
+        unsigned materialRank = RemapSortID(materialRemapping_, (unsigned)(key >> 16) & 0xffff, freeMaterialRank);
+        unsigned geometryRank = RemapSortID(geometryRemapping_, (unsigned)key & 0xffff, freeGeometryRank);
+        sortKeys_[i] = ((unsigned long long)materialRank << 32) | geometryRank;
+    }
+    RadixSort(batches);
 
-    unsigned freeShaderID = 0;
-    unsigned short freeMaterialID = 0;
-    unsigned short freeGeometryID = 0;
+    // Then sort by light queue
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        sortKeys_[i] = RemapSortID(lightQueueRemapping_, batches[i]->lightSortKey_ & 0xffff, freeLightQueueRank);
+    RadixSort(batches);
 
-    for (PODVector<Batch*>::Iterator i = batches.Begin(); i != batches.End(); ++i)
+    // Finally sort by render order, base pass flag and shaders. The ranks are below the number of batches, so the vertex
+    // and pixel shader ranks fit in their own 27 bits without colliding. The original sort keys are left intact
+    for (unsigned i = 0; i < batches.Size(); ++i)
     {
-        Batch* batch = *i;
+        Batch* batch = batches[i];
+        unsigned long long key = batch->sortKey_;
+        unsigned vertexShaderRank = RemapSortID(vertexShaderRemapping_, (unsigned)(key >> 48), freeVertexShaderRank);
+        unsigned pixelShaderRank = RemapSortID(pixelShaderRemapping_, (unsigned)(key >> 32) & 0xffff, freePixelShaderRank);
+        sortKeys_[i] = ((unsigned long long)batch->renderOrder_ << 55) | ((unsigned long long)(batch->lightSortKey_ >> 16) << 54) |
+            ((unsigned long long)vertexShaderRank << 27) | pixelShaderRank;
+    }
+    RadixSort(batches);
 
-        auto shaderID = (unsigned)(batch->sortKey_ >> 32);
-        HashMap<unsigned, unsigned>::ConstIterator j = shaderRemapping_.Find(shaderID);
-        if (j != shaderRemapping_.End())
-            shaderID = j->second_;
-        else
-        {
-            shaderID = shaderRemapping_[shaderID] = freeShaderID | (shaderID & 0x80000000);
-            ++freeShaderID;
-        }
+    // Reset only the touched remapping entries for the next sort
+    for (unsigned i = 0; i < batches.Size(); ++i)
+    {
+        unsigned long long key = batches[i]->sortKey_;
+        vertexShaderRemapping_[(unsigned)(key >> 48)] = UNMAPPED_SORT_ID;
+        pixelShaderRemapping_[(unsigned)(key >> 32) & 0xffff] = UNMAPPED_SORT_ID;
+        lightQueueRemapping_[batches[i]->lightSortKey_ & 0xffff] = UNMAPPED_SORT_ID;
+        materialRemapping_[(unsigned)(key >> 16) & 0xffff] = UNMAPPED_SORT_ID;
+        geometryRemapping_[(unsigned)key & 0xffff] = UNMAPPED_SORT_ID;
+    }
+#endif
+}
 
-        auto materialID = (unsigned short)(batch->sortKey_ & 0xffff0000);
-        HashMap<unsigned short, unsigned short>::ConstIterator k = materialRemapping_.Find(materialID);
-        if (k != materialRemapping_.End())
-            materialID = k->second_;
-        else
+void BatchQueue::RadixSort(PODVector<Batch*>& batches)
+{
+    static const unsigned NUM_PASSES = sizeof(unsigned long long);
+
+    unsigned count = batches.Size();
+    if (count < 2)
+        return;
+
+    // Build the histograms of all passes in one read of the keys
+    unsigned histograms[NUM_PASSES][256];
+    memset(histograms, 0, sizeof histograms);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned long long key = sortKeys_[i];
+        for (unsigned pass = 0; pass < NUM_PASSES; ++pass)
+            ++histograms[pass][(key >> (pass * 8)) & 0xff];
+    }
+
+    tempSortKeys_.Resize(count);
+    tempBatches_.Resize(count);
+
+    unsigned long long* srcKeys = &sortKeys_[0];
+    unsigned long long* destKeys = &tempSortKeys_[0];
+    Batch** srcBatches = &batches[0];
+    Batch** destBatches = &tempBatches_[0];
+
+    for (unsigned pass = 0; pass < NUM_PASSES; ++pass)
+    {
+        unsigned* histogram = histograms[pass];
+        unsigned shift = pass * 8;
+
+        // Skip the pass if all keys share the same byte
+        if (histogram[(srcKeys[0] >> shift) & 0xff] == count)
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned i = 0; i < 256; ++i)
         {
-            materialID = materialRemapping_[materialID] = freeMaterialID;
-            ++freeMaterialID;
+            unsigned num = histogram[i];
+            histogram[i] = offset;
+            offset += num;
         }
 
-        auto geometryID = (unsigned short)(batch->sortKey_ & 0xffff);
-        HashMap<unsigned short, unsigned short>::ConstIterator l = geometryRemapping_.Find(geometryID);
-        if (l != geometryRemapping_.End())
-            geometryID = l->second_;
-        else
+        for (unsigned i = 0; i < count; ++i)
         {
-            geometryID = geometryRemapping_[geometryID] = freeGeometryID;
-            ++freeGeometryID;
+            unsigned index = histogram[(srcKeys[i] >> shift) & 0xff]++;
+            destKeys[index] = srcKeys[i];
+            destBatches[index] = srcBatches[i];
         }
 
-        batch->sortKey_ = (((unsigned long long)shaderID) << 32) | (((unsigned long long)materialID) << 16) | geometryID;
+        Swap(srcKeys, destKeys);
+        Swap(srcBatches, destBatches);
     }
 
-    shaderRemapping_.Clear();
-    materialRemapping_.Clear();
-    geometryRemapping_.Clear();
-
-    // Finally sort again with the rewritten ID's
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
-#endif
+    // If the sorted result ended up in the scratch buffer, copy it back
+    if (srcBatches != &batches[0])
+        memcpy(&batches[0], srcBatches, count * sizeof(Batch*));
 }
 
 void BatchQueue::SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex)
 {
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         i->second_.SetInstancingData(lockedData, stride, freeIndex);
 }
 
@@ -892,7 +998,7 @@ unsigned BatchQueue::GetNumInstances() const
 {
     unsigned total = 0;
 
-    for (HashMap<BatchGroupKey, BatchGroup>::ConstIterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::ConstIterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
     {
         if (i->second_.geometryType_ == GEOM_INSTANCED)
             total += i->second_.instances_.Size();
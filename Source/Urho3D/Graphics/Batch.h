@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/Ptr.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Material.h"
@@ -71,15 +72,17 @@ struct Batch
     {
     }
 
-    /// Calculate state sorting key, which consists of base pass flag, light, pass and geometry.
+    /// Calculate state sorting keys from stable sort IDs, which consist of base pass flag, shaders, light, material and geometry.
     void CalculateSortKey();
     /// Prepare for rendering.
     void Prepare(View* view, Camera* camera, bool setModelTransform, bool allowDepthWrite) const;
     /// Prepare and draw.
     void Draw(View* view, Camera* camera, bool allowDepthWrite) const;
 
-    /// State sorting key.
+    /// Shader, material and geometry part of the state sorting key. Each sort ID has its own 16 bits.
     unsigned long long sortKey_;
+    /// Base pass flag and light queue part of the state sorting key.
+    unsigned lightSortKey_;
     /// Distance from camera.
     float distance_;
     /// 8-bit render order modifier from material.
@@ -238,6 +241,8 @@ public:
     void SortFrontToBack();
     /// Sort batches front to back while also maintaining state sorting.
     void SortFrontToBack2Pass(PODVector<Batch*>& batches);
+    /// Stable radix sort batches by the 64-bit keys in sortKeys_, which must have been filled in the same order.
+    void RadixSort(PODVector<Batch*>& batches);
     /// Pre-set instance data of all groups. The vertex buffer must be big enough to hold all data.
     void SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex);
     /// Draw.
@@ -249,13 +254,23 @@ public:
     bool IsEmpty() const { return batches_.Empty() && batchGroups_.Empty(); }
 
     /// Instanced draw calls.
-    HashMap<BatchGroupKey, BatchGroup> batchGroups_;
-    /// Shader remapping table for 2-pass state and distance sort.
-    HashMap<unsigned, unsigned> shaderRemapping_;
-    /// Material remapping table for 2-pass state and distance sort.
-    HashMap<unsigned short, unsigned short> materialRemapping_;
-    /// Geometry remapping table for 2-pass state and distance sort.
-    HashMap<unsigned short, unsigned short> geometryRemapping_;
+    FlatHashMap<BatchGroupKey, BatchGroup> batchGroups_;
+    /// Vertex shader remapping table for 2-pass state and distance sort, indexed by shader sort ID.
+    PODVector<unsigned> vertexShaderRemapping_;
+    /// Pixel shader remapping table for 2-pass state and distance sort, indexed by shader sort ID.
+    PODVector<unsigned> pixelShaderRemapping_;
+    /// Light queue remapping table for 2-pass state and distance sort, indexed by light sort ID.
+    PODVector<unsigned> lightQueueRemapping_;
+    /// Material remapping table for 2-pass state and distance sort, indexed by material sort ID.
+    PODVector<unsigned> materialRemapping_;
+    /// Geometry remapping table for 2-pass state and distance sort, indexed by geometry sort ID.
+    PODVector<unsigned> geometryRemapping_;
+    /// Radix sort keys.
+    PODVector<unsigned long long> sortKeys_;
+    /// Radix sort keys scratch buffer.
+    PODVector<unsigned long long> tempSortKeys_;
+    /// Radix sort batches scratch buffer.
+    PODVector<Batch*> tempBatches_;
 
     /// Unsorted non-instanced draw calls.
     PODVector<Batch> batches_;
@@ -308,6 +308,8 @@ void BillboardSet::SetSorted(bool enable)
 void BillboardSet::SetFixedScreenSize(bool enable)
 {
     fixedScreenSize_ = enable;
+    // The bounding box is recalculated for each camera during rendering
+    SetCameraDependentBounds(enable);
     Commit();
 }
 
@@ -810,7 +812,7 @@ void BillboardSet::CalculateFixedScreenSize(const FrameInfo& frame)
     {
         bufferDirty_ = true;
         forceUpdate_ = true;
-        worldBoundingBoxDirty_ = true;
+        MarkWorldBoundingBoxDirty();
     }
 }
 
@@ -77,7 +77,11 @@ Drawable::Drawable(Context* context, unsigned char drawableFlags) :
     occludee_(true),
     updateQueued_(false),
     zoneDirty_(false),
+    cameraDependentBounds_(false),
     octant_(nullptr),
+    octantIndex_(0),
+    bvhLeaf_(BVH_NULL_NODE),
+    bvhNonOccludeeIndex_(M_MAX_UNSIGNED),
     zone_(nullptr),
     viewMask_(DEFAULT_VIEWMASK),
     lightMask_(DEFAULT_LIGHTMASK),
@@ -110,7 +114,7 @@ Drawable::~Drawable()
 void Drawable::RegisterObject(Context* context)
 {
     URHO3D_ATTRIBUTE("Max Lights", int, maxLights_, 0, AM_DEFAULT);
-    URHO3D_ATTRIBUTE("View Mask", int, viewMask_, DEFAULT_VIEWMASK, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("View Mask", GetViewMask, SetViewMask, unsigned, DEFAULT_VIEWMASK, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Light Mask", int, lightMask_, DEFAULT_LIGHTMASK, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Shadow Mask", int, shadowMask_, DEFAULT_SHADOWMASK, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Zone Mask", GetZoneMask, SetZoneMask, unsigned, DEFAULT_ZONEMASK, AM_DEFAULT);
@@ -202,6 +206,9 @@ void Drawable::SetLodBias(float bias)
 void Drawable::SetViewMask(unsigned mask)
 {
     viewMask_ = mask;
+    // The octant's packed view mask is refreshed on the next reinsertion
+    if (octant_)
+        octant_->MarkDrawableBoundsDirty(this);
     MarkNetworkUpdate();
 }
 
@@ -393,6 +400,22 @@ void Drawable::OnMarkedDirty(Node* node)
         zoneDirty_ = true;
 }
 
+void Drawable::MarkWorldBoundingBoxDirty()
+{
+    worldBoundingBoxDirty_ = true;
+    // Camera-dependent bounds are always outdated in the octant, so other threads' queries do not race with this write
+    if (octant_ && !cameraDependentBounds_)
+        octant_->MarkDrawableBoundsDirty(this);
+}
+
+void Drawable::SetCameraDependentBounds(bool enable)
+{
+    cameraDependentBounds_ = enable;
+    // When disabled, the packed bounds are taken into use again on the next reinsertion
+    if (octant_)
+        octant_->MarkDrawableBoundsDirty(this);
+}
+
 void Drawable::AddToOctree()
 {
     // Do not add to octree when disabled
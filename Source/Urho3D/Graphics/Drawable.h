@@ -52,7 +52,6 @@ class Octant;
 class RayOctreeQuery;
 class Zone;
 struct RayQueryResult;
-struct WorkItem;
 
 /// Geometry update type.
 enum UpdateGeometryType
@@ -111,7 +110,6 @@ class URHO3D_API Drawable : public Component
 
     friend class Octant;
     friend class Octree;
-    friend void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex);
 
 public:
     /// Construct.
@@ -322,6 +320,10 @@ protected:
 
     /// Move into another octree octant.
     void SetOctant(Octant* octant) { octant_ = octant; }
+    /// Mark the world-space bounding box dirty when it changes without the drawable being queued for reinsertion, for example during rendering.
+    void MarkWorldBoundingBoxDirty();
+    /// Set whether the world-space bounding box depends on the camera and can change during rendering, while worker threads query the octree. The octant then never uses the drawable's packed bounds, and marking the bounding box dirty does not write to them.
+    void SetCameraDependentBounds(bool enable);
 
     /// World-space bounding box.
     BoundingBox worldBoundingBox_;
@@ -343,8 +345,16 @@ protected:
     bool updateQueued_;
     /// Zone inconclusive or dirtied flag.
     bool zoneDirty_;
+    /// Camera-dependent bounding box flag.
+    bool cameraDependentBounds_;
     /// Octree octant.
     Octant* octant_;
+    /// Index in the octant's drawable objects.
+    unsigned octantIndex_;
+    /// Leaf node in the octree's bounding volume hierarchy.
+    unsigned bvhLeaf_;
+    /// Index in the octree's non-occludee drawable objects when using the bounding volume hierarchy, or M_MAX_UNSIGNED if not in them.
+    unsigned bvhNonOccludeeIndex_;
     /// Current zone.
     Zone* zone_;
     /// View mask.
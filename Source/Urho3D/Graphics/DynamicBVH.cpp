@@ -0,0 +1,492 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Graphics/DebugRenderer.h"
+#include "../Graphics/DynamicBVH.h"
+#include "../Graphics/OctreeQuery.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned BVH_STACK_SIZE = 256;
+static const unsigned BVH_QUERY_BATCH = 64;
+
+/// Return half of the surface area of a bounding box, used as the insertion cost.
+static inline float HalfArea(const BoundingBox& box)
+{
+    Vector3 size = box.max_ - box.min_;
+    return size.x_ * size.y_ + size.y_ * size.z_ + size.z_ * size.x_;
+}
+
+/// Return the union of two bounding boxes.
+static inline BoundingBox Union(const BoundingBox& lhs, const BoundingBox& rhs)
+{
+    BoundingBox ret(lhs);
+    ret.Merge(rhs);
+    return ret;
+}
+
+DynamicBVH::DynamicBVH() :
+    root_(BVH_NULL_NODE),
+    freeList_(BVH_NULL_NODE),
+    numLeaves_(0),
+    margin_(DEFAULT_BVH_MARGIN)
+{
+}
+
+void DynamicBVH::SetMargin(float margin)
+{
+    margin_ = Max(margin, 0.0f);
+}
+
+unsigned DynamicBVH::CreateLeaf(Drawable* drawable, const BoundingBox& box)
+{
+    unsigned leaf = AllocateNode();
+    BVHNode& node = nodes_[leaf];
+    node.box_ = GetEnlargedBox(box, margin_);
+    node.center_ = box.Center();
+    node.drawable_ = drawable;
+    node.height_ = 0;
+
+    InsertLeaf(leaf);
+    ++numLeaves_;
+    return leaf;
+}
+
+void DynamicBVH::DestroyLeaf(unsigned leaf)
+{
+    assert(leaf < nodes_.Size() && nodes_[leaf].IsLeaf());
+
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    --numLeaves_;
+}
+
+bool DynamicBVH::MoveLeaf(unsigned leaf, const BoundingBox& box)
+{
+    assert(leaf < nodes_.Size() && nodes_[leaf].IsLeaf());
+
+    BVHNode& node = nodes_[leaf];
+    Vector3 center = box.Center();
+    Vector3 displacement = center - node.center_;
+    node.center_ = center;
+
+    // Keep the leaf if the drawable is still inside the enlarged box, unless the box has become much too large, for example
+    // after a resize or when the drawable stops or turns. The allowed size accounts for the leaf having been extended by the
+    // displacement in either direction
+    const BoundingBox& leafBox = node.box_;
+    Vector3 slack = displacement.Abs() * BVH_DISPLACEMENT_MULTIPLIER;
+    BoundingBox maxBox = GetEnlargedBox(box, 4.0f * margin_);
+    maxBox.min_ -= slack;
+    maxBox.max_ += slack;
+    if (leafBox.IsInside(box) == INSIDE && maxBox.IsInside(leafBox) == INSIDE)
+        return false;
+
+    // Extend the new leaf box in the direction of movement, so that a drawable moving steadily is not reinserted every frame
+    RemoveLeaf(leaf);
+    node.box_ = GetPredictedBox(box, displacement * BVH_DISPLACEMENT_MULTIPLIER, margin_);
+    InsertLeaf(leaf);
+    return true;
+}
+
+void DynamicBVH::Clear()
+{
+    nodes_.Clear();
+    root_ = BVH_NULL_NODE;
+    freeList_ = BVH_NULL_NODE;
+    numLeaves_ = 0;
+}
+
+void DynamicBVH::GetDrawables(OctreeQuery& query) const
+{
+    if (root_ == BVH_NULL_NODE)
+        return;
+
+    // Each stack entry holds a node index and whether it is known to be fully inside the query volume
+    Pair<unsigned, bool> stack[BVH_STACK_SIZE];
+    Drawable* inside[BVH_QUERY_BATCH];
+    Drawable* intersecting[BVH_QUERY_BATCH];
+    unsigned stackSize = 0;
+    unsigned numInside = 0;
+    unsigned numIntersecting = 0;
+
+    stack[stackSize++] = MakePair(root_, false);
+    while (stackSize)
+    {
+        Pair<unsigned, bool> entry = stack[--stackSize];
+        const BVHNode& node = nodes_[entry.first_];
+
+        Intersection res = query.TestOctant(node.box_, entry.second_);
+        if (res == OUTSIDE)
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (res == INSIDE)
+            {
+                inside[numInside++] = node.drawable_;
+                if (numInside == BVH_QUERY_BATCH)
+                {
+                    query.TestDrawables(inside, inside + numInside, true);
+                    numInside = 0;
+                }
+            }
+            else
+            {
+                intersecting[numIntersecting++] = node.drawable_;
+                if (numIntersecting == BVH_QUERY_BATCH)
+                {
+                    query.TestDrawables(intersecting, intersecting + numIntersecting, false);
+                    numIntersecting = 0;
+                }
+            }
+        }
+        else
+        {
+            assert(stackSize + 2 <= BVH_STACK_SIZE);
+            stack[stackSize++] = MakePair(node.child2_, res == INSIDE);
+            stack[stackSize++] = MakePair(node.child1_, res == INSIDE);
+        }
+    }
+
+    if (numInside)
+        query.TestDrawables(inside, inside + numInside, true);
+    if (numIntersecting)
+        query.TestDrawables(intersecting, intersecting + numIntersecting, false);
+}
+
+void DynamicBVH::GetDrawables(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const
+{
+    if (root_ == BVH_NULL_NODE)
+        return;
+
+    unsigned stack[BVH_STACK_SIZE];
+    unsigned stackSize = 0;
+
+    stack[stackSize++] = root_;
+    while (stackSize)
+    {
+        const BVHNode& node = nodes_[stack[--stackSize]];
+        if (query.ray_.HitDistance(node.box_) >= query.maxDistance_)
+            continue;
+
+        if (node.IsLeaf())
+        {
+            Drawable* drawable = node.drawable_;
+            if ((drawable->GetDrawableFlags() & query.drawableFlags_) && (drawable->GetViewMask() & query.viewMask_))
+                drawables.Push(drawable);
+        }
+        else
+        {
+            assert(stackSize + 2 <= BVH_STACK_SIZE);
+            stack[stackSize++] = node.child2_;
+            stack[stackSize++] = node.child1_;
+        }
+    }
+}
+
+void DynamicBVH::DrawDebugGeometry(DebugRenderer* debug, bool depthTest) const
+{
+    for (PODVector<BVHNode>::ConstIterator i = nodes_.Begin(); i != nodes_.End(); ++i)
+    {
+        if (i->height_ > 0 && debug->IsInside(i->box_))
+            debug->AddBoundingBox(i->box_, Color(0.25f, 0.25f, 0.25f), depthTest);
+    }
+}
+
+unsigned DynamicBVH::AllocateNode()
+{
+    unsigned index;
+    if (freeList_ != BVH_NULL_NODE)
+    {
+        index = freeList_;
+        freeList_ = nodes_[index].parent_;
+    }
+    else
+    {
+        index = nodes_.Size();
+        nodes_.Resize(index + 1);
+    }
+
+    BVHNode& node = nodes_[index];
+    node.drawable_ = nullptr;
+    node.parent_ = BVH_NULL_NODE;
+    node.child1_ = BVH_NULL_NODE;
+    node.child2_ = BVH_NULL_NODE;
+    node.height_ = 0;
+    return index;
+}
+
+void DynamicBVH::FreeNode(unsigned index)
+{
+    BVHNode& node = nodes_[index];
+    node.drawable_ = nullptr;
+    node.parent_ = freeList_;
+    node.height_ = -1;
+    freeList_ = index;
+}
+
+void DynamicBVH::InsertLeaf(unsigned leaf)
+{
+    if (root_ == BVH_NULL_NODE)
+    {
+        root_ = leaf;
+        nodes_[leaf].parent_ = BVH_NULL_NODE;
+        return;
+    }
+
+    // Descend to the sibling with the lowest cost of the new parent and the enlargement of its ancestors
+    BoundingBox leafBox = nodes_[leaf].box_;
+    unsigned index = root_;
+    while (!nodes_[index].IsLeaf())
+    {
+        const BVHNode& node = nodes_[index];
+        float area = HalfArea(node.box_);
+        float combinedArea = HalfArea(Union(node.box_, leafBox));
+
+        // Cost of creating a new parent for this node and the leaf, and the minimum cost of pushing the leaf further down
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        const BVHNode& child1 = nodes_[node.child1_];
+        float cost1 = HalfArea(Union(child1.box_, leafBox)) + inheritanceCost;
+        if (!child1.IsLeaf())
+            cost1 -= HalfArea(child1.box_);
+
+        const BVHNode& child2 = nodes_[node.child2_];
+        float cost2 = HalfArea(Union(child2.box_, leafBox)) + inheritanceCost;
+        if (!child2.IsLeaf())
+            cost2 -= HalfArea(child2.box_);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1_ : node.child2_;
+    }
+
+    unsigned sibling = index;
+    unsigned oldParent = nodes_[sibling].parent_;
+    unsigned newParent = AllocateNode();
+    BVHNode& parent = nodes_[newParent];
+    parent.parent_ = oldParent;
+    parent.box_ = Union(leafBox, nodes_[sibling].box_);
+    parent.height_ = nodes_[sibling].height_ + 1;
+    parent.child1_ = sibling;
+    parent.child2_ = leaf;
+    nodes_[sibling].parent_ = newParent;
+    nodes_[leaf].parent_ = newParent;
+
+    if (oldParent != BVH_NULL_NODE)
+    {
+        if (nodes_[oldParent].child1_ == sibling)
+            nodes_[oldParent].child1_ = newParent;
+        else
+            nodes_[oldParent].child2_ = newParent;
+    }
+    else
+        root_ = newParent;
+
+    Refit(newParent);
+}
+
+void DynamicBVH::RemoveLeaf(unsigned leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = BVH_NULL_NODE;
+        return;
+    }
+
+    unsigned parent = nodes_[leaf].parent_;
+    unsigned grandParent = nodes_[parent].parent_;
+    unsigned sibling = nodes_[parent].child1_ == leaf ? nodes_[parent].child2_ : nodes_[parent].child1_;
+
+    if (grandParent != BVH_NULL_NODE)
+    {
+        // Replace the parent with the sibling
+        if (nodes_[grandParent].child1_ == parent)
+            nodes_[grandParent].child1_ = sibling;
+        else
+            nodes_[grandParent].child2_ = sibling;
+        nodes_[sibling].parent_ = grandParent;
+        FreeNode(parent);
+        Refit(grandParent);
+    }
+    else
+    {
+        root_ = sibling;
+        nodes_[sibling].parent_ = BVH_NULL_NODE;
+        FreeNode(parent);
+    }
+}
+
+unsigned DynamicBVH::Balance(unsigned iA)
+{
+    BVHNode& a = nodes_[iA];
+    if (a.IsLeaf() || a.height_ < 2)
+        return iA;
+
+    unsigned iB = a.child1_;
+    unsigned iC = a.child2_;
+    BVHNode& b = nodes_[iB];
+    BVHNode& c = nodes_[iC];
+    int balance = c.height_ - b.height_;
+
+    // Rotate C up
+    if (balance > 1)
+    {
+        unsigned iF = c.child1_;
+        unsigned iG = c.child2_;
+        BVHNode& f = nodes_[iF];
+        BVHNode& g = nodes_[iG];
+
+        c.child1_ = iA;
+        c.parent_ = a.parent_;
+        a.parent_ = iC;
+
+        if (c.parent_ != BVH_NULL_NODE)
+        {
+            if (nodes_[c.parent_].child1_ == iA)
+                nodes_[c.parent_].child1_ = iC;
+            else
+                nodes_[c.parent_].child2_ = iC;
+        }
+        else
+            root_ = iC;
+
+        // Keep the taller grandchild under C
+        if (f.height_ > g.height_)
+        {
+            c.child2_ = iF;
+            a.child2_ = iG;
+            g.parent_ = iA;
+            a.box_ = Union(b.box_, g.box_);
+            c.box_ = Union(a.box_, f.box_);
+            a.height_ = 1 + Max(b.height_, g.height_);
+            c.height_ = 1 + Max(a.height_, f.height_);
+        }
+        else
+        {
+            c.child2_ = iG;
+            a.child2_ = iF;
+            f.parent_ = iA;
+            a.box_ = Union(b.box_, f.box_);
+            c.box_ = Union(a.box_, g.box_);
+            a.height_ = 1 + Max(b.height_, f.height_);
+            c.height_ = 1 + Max(a.height_, g.height_);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1)
+    {
+        unsigned iD = b.child1_;
+        unsigned iE = b.child2_;
+        BVHNode& d = nodes_[iD];
+        BVHNode& e = nodes_[iE];
+
+        b.child1_ = iA;
+        b.parent_ = a.parent_;
+        a.parent_ = iB;
+
+        if (b.parent_ != BVH_NULL_NODE)
+        {
+            if (nodes_[b.parent_].child1_ == iA)
+                nodes_[b.parent_].child1_ = iB;
+            else
+                nodes_[b.parent_].child2_ = iB;
+        }
+        else
+            root_ = iB;
+
+        // Keep the taller grandchild under B
+        if (d.height_ > e.height_)
+        {
+            b.child2_ = iD;
+            a.child1_ = iE;
+            e.parent_ = iA;
+            a.box_ = Union(c.box_, e.box_);
+            b.box_ = Union(a.box_, d.box_);
+            a.height_ = 1 + Max(c.height_, e.height_);
+            b.height_ = 1 + Max(a.height_, d.height_);
+        }
+        else
+        {
+            b.child2_ = iE;
+            a.child1_ = iD;
+            d.parent_ = iA;
+            a.box_ = Union(c.box_, d.box_);
+            b.box_ = Union(a.box_, e.box_);
+            a.height_ = 1 + Max(c.height_, d.height_);
+            b.height_ = 1 + Max(a.height_, e.height_);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicBVH::Refit(unsigned index)
+{
+    // Stop once a node is neither rotated nor changed, as its ancestors then stay the same. The first node is always refitted,
+    // as the caller has changed its children
+    for (bool first = true; index != BVH_NULL_NODE; first = false)
+    {
+        unsigned balanced = Balance(index);
+
+        BVHNode& node = nodes_[balanced];
+        const BVHNode& child1 = nodes_[node.child1_];
+        const BVHNode& child2 = nodes_[node.child2_];
+        int height = 1 + Max(child1.height_, child2.height_);
+        BoundingBox box = Union(child1.box_, child2.box_);
+        if (!first && balanced == index && height == node.height_ && box == node.box_)
+            break;
+
+        node.height_ = height;
+        node.box_ = box;
+        index = node.parent_;
+    }
+}
+
+BoundingBox DynamicBVH::GetEnlargedBox(const BoundingBox& box, float margin) const
+{
+    Vector3 enlarge(margin, margin, margin);
+    return BoundingBox(box.min_ - enlarge, box.max_ + enlarge);
+}
+
+BoundingBox DynamicBVH::GetPredictedBox(const BoundingBox& box, const Vector3& displacement, float margin) const
+{
+    BoundingBox ret = GetEnlargedBox(box, margin);
+    ret.min_ += VectorMin(displacement, Vector3::ZERO);
+    ret.max_ += VectorMax(displacement, Vector3::ZERO);
+    return ret;
+}
+
+}
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Vector.h"
+#include "../Math/BoundingBox.h"
+
+namespace Urho3D
+{
+
+class DebugRenderer;
+class Drawable;
+class OctreeQuery;
+class RayOctreeQuery;
+
+static const unsigned BVH_NULL_NODE = M_MAX_UNSIGNED;
+static const float DEFAULT_BVH_MARGIN = 0.5f;
+static const float BVH_DISPLACEMENT_MULTIPLIER = 8.0f;
+
+/// Dynamic bounding volume hierarchy node.
+struct BVHNode
+{
+    /// Return whether is a leaf.
+    bool IsLeaf() const { return child1_ == BVH_NULL_NODE; }
+
+    /// Enlarged bounding box of the leaf, or union of the child bounding boxes.
+    BoundingBox box_;
+    /// Center of the drawable's bounding box at the last leaf update, for predicting movement.
+    Vector3 center_;
+    /// Drawable object for leaves.
+    Drawable* drawable_;
+    /// Parent node, or the next free node for unused nodes.
+    unsigned parent_;
+    /// First child node.
+    unsigned child1_;
+    /// Second child node.
+    unsigned child2_;
+    /// Height of the subtree, zero for leaves and -1 for unused nodes.
+    int height_;
+};
+
+/// Dynamic bounding volume hierarchy of drawable objects. Leaves store bounding boxes enlarged by a margin and extended in the direction of movement, so that small or steady movements do not require reinsertion, and the tree is kept balanced with rotations.
+class URHO3D_API DynamicBVH
+{
+public:
+    /// Construct.
+    DynamicBVH();
+
+    /// Set the amount of world units the leaf bounding boxes are enlarged by.
+    void SetMargin(float margin);
+    /// Insert a drawable object and return its leaf node.
+    unsigned CreateLeaf(Drawable* drawable, const BoundingBox& box);
+    /// Remove a leaf node.
+    void DestroyLeaf(unsigned leaf);
+    /// Update the bounding box of a leaf node. The leaf is reinserted only if the new bounding box is not inside the enlarged one, or the enlarged one has become much too large. A reinserted leaf is extended by the displacement since the previous update times BVH_DISPLACEMENT_MULTIPLIER. Return true if reinserted.
+    bool MoveLeaf(unsigned leaf, const BoundingBox& box);
+    /// Remove all nodes.
+    void Clear();
+
+    /// Return drawable objects by a query.
+    void GetDrawables(OctreeQuery& query) const;
+    /// Return drawable objects whose leaf bounding box is hit by a ray query.
+    void GetDrawables(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const;
+    /// Draw the node bounding boxes to the debug graphics.
+    void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) const;
+
+    /// Return the margin of the leaf bounding boxes.
+    float GetMargin() const { return margin_; }
+    /// Return the number of leaf nodes.
+    unsigned GetNumLeaves() const { return numLeaves_; }
+    /// Return the height of the tree.
+    int GetHeight() const { return root_ != BVH_NULL_NODE ? nodes_[root_].height_ : 0; }
+    /// Return the enlarged bounding box of a leaf node.
+    const BoundingBox& GetLeafBoundingBox(unsigned leaf) const { return nodes_[leaf].box_; }
+
+private:
+    /// Allocate a node from the free list.
+    unsigned AllocateNode();
+    /// Return a node to the free list.
+    void FreeNode(unsigned index);
+    /// Insert a leaf into the tree, choosing the sibling by the surface area heuristic.
+    void InsertLeaf(unsigned leaf);
+    /// Remove a leaf from the tree without freeing it.
+    void RemoveLeaf(unsigned leaf);
+    /// Rotate a subtree if it is imbalanced. Return the new subtree root.
+    unsigned Balance(unsigned index);
+    /// Refit the bounding boxes and heights from a node towards the root until they no longer change, balancing along the way.
+    void Refit(unsigned index);
+    /// Return an enlarged bounding box for a leaf.
+    BoundingBox GetEnlargedBox(const BoundingBox& box, float margin) const;
+    /// Return an enlarged bounding box for a leaf, extended by a predicted displacement.
+    BoundingBox GetPredictedBox(const BoundingBox& box, const Vector3& displacement, float margin) const;
+
+    /// Nodes.
+    PODVector<BVHNode> nodes_;
+    /// Root node.
+    unsigned root_;
+    /// First free node.
+    unsigned freeList_;
+    /// Number of leaf nodes.
+    unsigned numLeaves_;
+    /// Leaf bounding box margin.
+    float margin_;
+};
+
+}
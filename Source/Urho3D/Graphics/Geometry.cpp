@@ -25,6 +25,7 @@
 #include "../Graphics/Geometry.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/IndexBuffer.h"
+#include "../Graphics/SortIDAllocator.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../Math/Ray.h"
@@ -34,6 +35,12 @@
 namespace Urho3D
 {
 
+static SortIDAllocator& GetGeometrySortIDs()
+{
+    static SortIDAllocator allocator;
+    return allocator;
+}
+
 Geometry::Geometry(Context* context) :
     Object(context),
     primitiveType_(TRIANGLE_LIST),
@@ -43,12 +50,16 @@ Geometry::Geometry(Context* context) :
     vertexCount_(0),
     rawVertexSize_(0),
     rawIndexSize_(0),
-    lodDistance_(0.0f)
+    lodDistance_(0.0f),
+    sortID_(GetGeometrySortIDs().Allocate())
 {
     SetNumVertexBuffers(1);
 }
 
-Geometry::~Geometry() = default;
+Geometry::~Geometry()
+{
+    GetGeometrySortIDs().Free(sortID_);
+}
 
 bool Geometry::SetNumVertexBuffers(unsigned num)
 {
@@ -28,6 +28,7 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/Renderer.h"
+#include "../Graphics/SortIDAllocator.h"
 #include "../Graphics/Technique.h"
 #include "../Graphics/Texture2D.h"
 #include "../Graphics/Texture2DArray.h"
@@ -157,6 +158,12 @@ StringHash ParseTextureTypeXml(ResourceCache* cache, const String& filename)
 
 static TechniqueEntry noEntry;
 
+static SortIDAllocator& GetMaterialSortIDs()
+{
+    static SortIDAllocator allocator;
+    return allocator;
+}
+
 bool CompareTechniqueEntries(const TechniqueEntry& lhs, const TechniqueEntry& rhs)
 {
     if (lhs.lodDistance_ != rhs.lodDistance_)
@@ -199,6 +206,7 @@ Material::Material(Context* context) :
     Resource(context),
     auxViewFrameNumber_(0),
     shaderParameterHash_(0),
+    sortID_(GetMaterialSortIDs().Allocate()),
     alphaToCoverage_(false),
     lineAntiAlias_(false),
     occlusion_(true),
@@ -209,7 +217,10 @@ Material::Material(Context* context) :
     ResetToDefaults();
 }
 
-Material::~Material() = default;
+Material::~Material()
+{
+    GetMaterialSortIDs().Free(sortID_);
+}
 
 void Material::RegisterObject(Context* context)
 {
@@ -40,13 +40,6 @@ static const unsigned CLIPMASK_Y_NEG = 0x8;
 static const unsigned CLIPMASK_Z_POS = 0x10;
 static const unsigned CLIPMASK_Z_NEG = 0x20;
 
-void DrawOcclusionBatchWork(const WorkItem* item, unsigned threadIndex)
-{
-    auto* buffer = reinterpret_cast<OcclusionBuffer*>(item->aux_);
-    OcclusionBatch& batch = *reinterpret_cast<OcclusionBatch*>(item->start_);
-    buffer->DrawBatch(batch, threadIndex);
-}
-
 OcclusionBuffer::OcclusionBuffer(Context* context) :
     Object(context),
     width_(0),
@@ -214,20 +207,12 @@ void OcclusionBuffer::DrawTriangles()
     }
     else if (buffers_.Size() > 1)
     {
-        // Threaded
-        auto* queue = GetSubsystem<WorkQueue>();
-
-        for (Vector<OcclusionBatch>::Iterator i = batches_.Begin(); i != batches_.End(); ++i)
+        // Threaded. Each batch is a separate chunk, as batches are large and need to be spread evenly
+        GetSubsystem<WorkQueue>()->ParallelFor(batches_.Size(), 1, [&](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = DrawOcclusionBatchWork;
-            item->aux_ = this;
-            item->start_ = &(*i);
-            queue->AddWorkItem(item);
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+            for (unsigned i = begin; i < end; ++i)
+                DrawBatch(batches_[i], threadIndex);
+        });
 
         MergeBuffers();
         depthHierarchyDirty_ = true;
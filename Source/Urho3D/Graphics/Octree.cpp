@@ -34,6 +34,10 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -45,23 +49,16 @@ namespace Urho3D
 
 static const float DEFAULT_OCTREE_SIZE = 1000.0f;
 static const int DEFAULT_OCTREE_LEVELS = 8;
+static const unsigned PACKED_QUERY_GROUPS = 32;
 
-extern const char* SUBSYSTEM_CATEGORY;
-
-void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex)
+static const char* spatialIndexNames[] =
 {
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
+    "Octree",
+    "BVH",
+    nullptr
+};
 
-    while (start != end)
-    {
-        Drawable* drawable = *start;
-        if (drawable)
-            drawable->Update(frame);
-        ++start;
-    }
-}
+extern const char* SUBSYSTEM_CATEGORY;
 
 inline bool CompareRayQueryResults(const RayQueryResult& lhs, const RayQueryResult& rhs)
 {
@@ -89,10 +86,11 @@ Octant::~Octant()
         for (PODVector<Drawable*>::Iterator i = drawables_.Begin(); i != drawables_.End(); ++i)
         {
             (*i)->SetOctant(root_);
-            root_->drawables_.Push(*i);
+            root_->PushDrawable(*i);
             root_->QueueUpdate(*i);
         }
         drawables_.Clear();
+        packedBounds_.Clear();
         numDrawables_ = 0;
     }
 
@@ -137,6 +135,13 @@ void Octant::DeleteChild(unsigned index)
 
 void Octant::InsertDrawable(Drawable* drawable)
 {
+    // With the bounding volume hierarchy all drawables are kept in the root octant
+    if (this == root_ && root_->GetSpatialIndex() == SPATIAL_INDEX_BVH)
+    {
+        root_->InsertBVHDrawable(drawable);
+        return;
+    }
+
     const BoundingBox& box = drawable->GetWorldBoundingBox();
 
     // If root octant, insert all non-occludees here, so that octant occlusion does not hide the drawable.
@@ -153,10 +158,16 @@ void Octant::InsertDrawable(Drawable* drawable)
         if (oldOctant != this)
         {
             // Add first, then remove, because drawable count going to zero deletes the octree branch in question
+            unsigned oldIndex = drawable->octantIndex_;
             AddDrawable(drawable);
             if (oldOctant)
-                oldOctant->RemoveDrawable(drawable, false);
+            {
+                oldOctant->EraseDrawable(oldIndex);
+                oldOctant->DecDrawableCount();
+            }
         }
+
+        UpdateDrawableBounds(drawable, box);
     }
     else
     {
@@ -169,6 +180,22 @@ void Octant::InsertDrawable(Drawable* drawable)
     }
 }
 
+void Octant::UpdateDrawableBounds(Drawable* drawable, const BoundingBox& box)
+{
+    unsigned index = drawable->octantIndex_;
+    PackedDrawableBounds& group = packedBounds_[index >> 2];
+    index &= 3;
+
+    group.minX_[index] = box.min_.x_;
+    group.minY_[index] = box.min_.y_;
+    group.minZ_[index] = box.min_.z_;
+    group.maxX_[index] = box.max_.x_;
+    group.maxY_[index] = box.max_.y_;
+    group.maxZ_[index] = box.max_.z_;
+    group.flags_[index] = drawable->drawableFlags_ | (drawable->cameraDependentBounds_ ? PACKED_BOUNDS_DIRTY : 0);
+    group.viewMasks_[index] = drawable->viewMask_;
+}
+
 bool Octant::CheckDrawableFit(const BoundingBox& box) const
 {
     Vector3 boxSize = box.Size();
@@ -244,7 +271,7 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
         }
     }
 
-    if (drawables_.Size())
+    if (drawables_.Size() && !TestPackedDrawables(query, inside))
     {
         auto** start = const_cast<Drawable**>(&drawables_[0]);
         Drawable** end = start + drawables_.Size();
@@ -258,6 +285,142 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
     }
 }
 
+bool Octant::TestPackedDrawables(OctreeQuery& query, bool inside) const
+{
+    // Queries without a packed bounds test get all drawables, also when the octant is fully inside
+    if (!query.HasPackedBoundsTest())
+        return false;
+
+    unsigned char masks[PACKED_QUERY_GROUPS];
+    Drawable* visible[PACKED_QUERY_GROUPS * 4];
+    Drawable* dirty[PACKED_QUERY_GROUPS * 4];
+
+    auto** drawables = const_cast<Drawable**>(&drawables_[0]);
+    const PackedDrawableBounds* groups = &packedBounds_[0];
+    unsigned numGroups = packedBounds_.Size();
+
+#ifdef URHO3D_SSE
+    __m128i drawableFlags = _mm_set1_epi32(query.drawableFlags_);
+    __m128i viewMask = _mm_set1_epi32(query.viewMask_);
+    __m128i zero = _mm_setzero_si128();
+#endif
+
+    for (unsigned first = 0; first < numGroups; first += PACKED_QUERY_GROUPS)
+    {
+        unsigned count = Min(numGroups - first, PACKED_QUERY_GROUPS);
+        const PackedDrawableBounds* start = groups + first;
+
+        // If the octant is fully inside, only the flags and view masks need to be tested
+        if (!inside)
+            query.TestPackedBounds(start, start + count, masks);
+
+        unsigned numVisible = 0;
+        unsigned numDirty = 0;
+
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const PackedDrawableBounds& group = start[i];
+            Drawable** groupDrawables = drawables + ((first + i) << 2);
+
+#ifdef URHO3D_SSE
+            __m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group.flags_));
+            __m128i viewMasks = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group.viewMasks_));
+            __m128i rejected = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(flags, drawableFlags), zero),
+                _mm_cmpeq_epi32(_mm_and_si128(viewMasks, viewMask), zero));
+            unsigned accepted = ~(unsigned)_mm_movemask_ps(_mm_castsi128_ps(rejected)) & 0xf;
+            // The dirty flag is the sign bit
+            unsigned outdated = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(flags));
+#else
+            unsigned accepted = 0;
+            unsigned outdated = 0;
+            for (unsigned j = 0; j < 4; ++j)
+            {
+                if ((group.flags_[j] & query.drawableFlags_) && (group.viewMasks_[j] & query.viewMask_))
+                    accepted |= 1u << j;
+                if (group.flags_[j] & PACKED_BOUNDS_DIRTY)
+                    outdated |= 1u << j;
+            }
+#endif
+
+            // Drawables with outdated bounds or view mask are tested individually without the packed data
+            unsigned visibleMask = (inside ? accepted : accepted & masks[i]) & ~outdated;
+            unsigned dirtyMask = outdated;
+            if (inside)
+            {
+                visibleMask |= dirtyMask;
+                dirtyMask = 0;
+            }
+
+            for (unsigned j = 0; j < 4; ++j)
+            {
+                if (visibleMask & (1u << j))
+                    visible[numVisible++] = groupDrawables[j];
+                else if (dirtyMask & (1u << j))
+                    dirty[numDirty++] = groupDrawables[j];
+            }
+        }
+
+        if (numVisible)
+            query.TestDrawables(visible, visible + numVisible, true);
+        if (numDirty)
+            query.TestDrawables(dirty, dirty + numDirty, false);
+    }
+
+    return true;
+}
+
+void Octant::PushDrawable(Drawable* drawable)
+{
+    unsigned index = drawables_.Size();
+    drawables_.Push(drawable);
+    drawable->octantIndex_ = index;
+
+    if (!(index & 3))
+    {
+        PackedDrawableBounds group;
+        memset(&group, 0, sizeof group);
+        packedBounds_.Push(group);
+    }
+
+    // The bounding box is not known yet, so test individually until updated
+    PackedDrawableBounds& group = packedBounds_[index >> 2];
+    group.flags_[index & 3] = drawable->drawableFlags_ | PACKED_BOUNDS_DIRTY;
+    group.viewMasks_[index & 3] = drawable->viewMask_;
+}
+
+void Octant::EraseDrawable(unsigned index)
+{
+    if (this == root_)
+        root_->RemoveBVHDrawable(drawables_[index]);
+
+    unsigned last = drawables_.Size() - 1;
+    if (index != last)
+    {
+        Drawable* moved = drawables_[last];
+        drawables_[index] = moved;
+        moved->octantIndex_ = index;
+
+        const PackedDrawableBounds& src = packedBounds_[last >> 2];
+        PackedDrawableBounds& dest = packedBounds_[index >> 2];
+        unsigned i = last & 3;
+        unsigned j = index & 3;
+        dest.minX_[j] = src.minX_[i];
+        dest.minY_[j] = src.minY_[i];
+        dest.minZ_[j] = src.minZ_[i];
+        dest.maxX_[j] = src.maxX_[i];
+        dest.maxY_[j] = src.maxY_[i];
+        dest.maxZ_[j] = src.maxZ_[i];
+        dest.flags_[j] = src.flags_[i];
+        dest.viewMasks_[j] = src.viewMasks_[i];
+    }
+
+    drawables_.Pop();
+    if (!(last & 3))
+        packedBounds_.Pop();
+    else
+        packedBounds_[last >> 2].flags_[last & 3] = 0;
+}
+
 void Octant::GetDrawablesInternal(RayOctreeQuery& query) const
 {
     float octantDist = query.ray_.HitDistance(cullingBox_);
@@ -315,7 +478,8 @@ void Octant::GetDrawablesOnlyInternal(RayOctreeQuery& query, PODVector<Drawable*
 Octree::Octree(Context* context) :
     Component(context),
     Octant(BoundingBox(-DEFAULT_OCTREE_SIZE, DEFAULT_OCTREE_SIZE), 0, nullptr, this),
-    numLevels_(DEFAULT_OCTREE_LEVELS)
+    numLevels_(DEFAULT_OCTREE_LEVELS),
+    spatialIndex_(SPATIAL_INDEX_OCTREE)
 {
     // If the engine is running headless, subscribe to RenderUpdate events for manually updating the octree
     // to allow raycasts and animation update
@@ -327,6 +491,11 @@ Octree::~Octree()
 {
     // Reset root pointer from all child octants now so that they do not move their drawables to root
     drawableUpdates_.Clear();
+    for (PODVector<Drawable*>::Iterator i = drawables_.Begin(); i != drawables_.End(); ++i)
+    {
+        (*i)->bvhLeaf_ = BVH_NULL_NODE;
+        (*i)->bvhNonOccludeeIndex_ = M_MAX_UNSIGNED;
+    }
     ResetRoot();
 }
 
@@ -340,6 +509,9 @@ void Octree::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Bounding Box Min", Vector3, worldBoundingBox_.min_, UpdateOctreeSize, defaultBoundsMin, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Bounding Box Max", Vector3, worldBoundingBox_.max_, UpdateOctreeSize, defaultBoundsMax, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Number of Levels", int, numLevels_, UpdateOctreeSize, DEFAULT_OCTREE_LEVELS, AM_DEFAULT);
+    URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Spatial Index", GetSpatialIndex, SetSpatialIndex, SpatialIndex, spatialIndexNames,
+        SPATIAL_INDEX_OCTREE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("BVH Margin", GetBVHMargin, SetBVHMargin, float, DEFAULT_BVH_MARGIN, AM_DEFAULT);
 }
 
 void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -348,7 +520,10 @@ void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         URHO3D_PROFILE(OctreeDrawDebug);
 
-        Octant::DrawDebugGeometry(debug, depthTest);
+        if (spatialIndex_ == SPATIAL_INDEX_BVH)
+            bvh_.DrawDebugGeometry(debug, depthTest);
+        else
+            Octant::DrawDebugGeometry(debug, depthTest);
     }
 }
 
@@ -365,6 +540,46 @@ void Octree::SetSize(const BoundingBox& box, unsigned numLevels)
     numLevels_ = Max(numLevels, 1U);
 }
 
+void Octree::SetSpatialIndex(SpatialIndex type)
+{
+    if (type == spatialIndex_)
+        return;
+
+    URHO3D_PROFILE(ChangeSpatialIndex);
+
+    // Move all drawables to the root. This also queues them for reinsertion
+    for (unsigned i = 0; i < NUM_OCTANTS; ++i)
+        DeleteChild(i);
+
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+    {
+        for (PODVector<Drawable*>::Iterator i = drawables_.Begin(); i != drawables_.End(); ++i)
+        {
+            Drawable* drawable = *i;
+            drawable->bvhLeaf_ = BVH_NULL_NODE;
+            drawable->bvhNonOccludeeIndex_ = M_MAX_UNSIGNED;
+            if (!drawable->updateQueued_)
+                QueueUpdate(drawable);
+        }
+        bvh_.Clear();
+        bvhNonOccludees_.Clear();
+    }
+
+    spatialIndex_ = type;
+
+    // Build the bounding volume hierarchy immediately so that queries before the next update find the drawables
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+    {
+        for (PODVector<Drawable*>::Iterator i = drawables_.Begin(); i != drawables_.End(); ++i)
+            InsertBVHDrawable(*i);
+    }
+}
+
+void Octree::SetBVHMargin(float margin)
+{
+    bvh_.SetMargin(margin);
+}
+
 void Octree::Update(const FrameInfo& frame)
 {
     if (!Thread::IsMainThread())
@@ -373,6 +588,11 @@ void Octree::Update(const FrameInfo& frame)
         return;
     }
 
+    // If the scene uses batched transform updates, resolve dirty world transforms before the drawables read them
+    Scene* scene = GetScene();
+    if (scene)
+        scene->UpdateTransforms();
+
     // Let drawables update themselves before reinsertion. This can be used for animation
     if (!drawableUpdates_.Empty())
     {
@@ -380,34 +600,19 @@ void Octree::Update(const FrameInfo& frame)
 
         // Perform updates in worker threads. Notify the scene that a threaded update is going on and components
         // (for example physics objects) should not perform non-threadsafe work when marked dirty
-        Scene* scene = GetScene();
         auto* queue = GetSubsystem<WorkQueue>();
         scene->BeginThreadedUpdate();
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = Max((int)(drawableUpdates_.Size() / numWorkItems), 1);
-
-        PODVector<Drawable*>::Iterator start = drawableUpdates_.Begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
+        queue->ParallelFor(drawableUpdates_.Size(), 0, [&](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = UpdateDrawablesWork;
-            item->aux_ = const_cast<FrameInfo*>(&frame);
-
-            PODVector<Drawable*>::Iterator end = drawableUpdates_.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable* drawable = drawableUpdates_[i];
+                if (drawable)
+                    drawable->Update(frame);
+            }
+        }, &drawableUpdateCost_);
 
-        queue->Complete(M_MAX_UNSIGNED);
         scene->EndThreadedUpdate();
     }
 
@@ -430,7 +635,6 @@ void Octree::Update(const FrameInfo& frame)
     }
 
     // Notify drawable update being finished. Custom animation (eg. IK) can be done at this point
-    Scene* scene = GetScene();
     if (scene)
     {
         using namespace SceneDrawableUpdateFinished;
@@ -439,6 +643,9 @@ void Octree::Update(const FrameInfo& frame)
         eventData[P_SCENE] = scene;
         eventData[P_TIMESTEP] = frame.timeStep_;
         scene->SendEvent(E_SCENEDRAWABLEUPDATEFINISHED, eventData);
+
+        // Resolve transforms moved by the drawable updates, such as animated bones, before reading the bounding boxes
+        scene->UpdateTransforms();
     }
 
     // Reinsert drawables that have been moved or resized, or that have been newly added to the octree and do not sit inside
@@ -457,9 +664,18 @@ void Octree::Update(const FrameInfo& frame)
             // Skip if no octant or does not belong to this octree anymore
             if (!octant || octant->GetRoot() != this)
                 continue;
-            // Skip if still fits the current octant
+            // Update the bounding volume hierarchy leaf, which is reinserted only if the drawable moved outside it
+            if (spatialIndex_ == SPATIAL_INDEX_BVH)
+            {
+                InsertBVHDrawable(drawable);
+                continue;
+            }
+            // Skip if still fits the current octant, only refreshing the packed bounding box
             if (drawable->IsOccludee() && octant->GetCullingBox().IsInside(box) == INSIDE && octant->CheckDrawableFit(box))
+            {
+                octant->UpdateDrawableBounds(drawable, box);
                 continue;
+            }
 
             InsertDrawable(drawable);
 
@@ -484,6 +700,8 @@ void Octree::AddManualDrawable(Drawable* drawable)
         return;
 
     AddDrawable(drawable);
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+        InsertBVHDrawable(drawable);
 }
 
 void Octree::RemoveManualDrawable(Drawable* drawable)
@@ -499,7 +717,18 @@ void Octree::RemoveManualDrawable(Drawable* drawable)
 void Octree::GetDrawables(OctreeQuery& query) const
 {
     query.result_.Clear();
-    GetDrawablesInternal(query, false);
+
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+    {
+        bvh_.GetDrawables(query);
+        if (bvhNonOccludees_.Size())
+        {
+            auto** start = const_cast<Drawable**>(&bvhNonOccludees_[0]);
+            query.TestDrawables(start, start + bvhNonOccludees_.Size(), false);
+        }
+    }
+    else
+        GetDrawablesInternal(query, false);
 }
 
 void Octree::Raycast(RayOctreeQuery& query) const
@@ -507,7 +736,17 @@ void Octree::Raycast(RayOctreeQuery& query) const
     URHO3D_PROFILE(Raycast);
 
     query.result_.Clear();
-    GetDrawablesInternal(query);
+
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+    {
+        rayQueryDrawables_.Clear();
+        GetBVHDrawables(query, rayQueryDrawables_);
+        for (PODVector<Drawable*>::Iterator i = rayQueryDrawables_.Begin(); i != rayQueryDrawables_.End(); ++i)
+            (*i)->ProcessRayQuery(query, query.result_);
+    }
+    else
+        GetDrawablesInternal(query);
+
     Sort(query.result_.Begin(), query.result_.End(), CompareRayQueryResults);
 }
 
@@ -517,7 +756,10 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
 
     query.result_.Clear();
     rayQueryDrawables_.Clear();
-    GetDrawablesOnlyInternal(query, rayQueryDrawables_);
+    if (spatialIndex_ == SPATIAL_INDEX_BVH)
+        GetBVHDrawables(query, rayQueryDrawables_);
+    else
+        GetDrawablesOnlyInternal(query, rayQueryDrawables_);
 
     // Sort by increasing hit distance to AABB
     for (PODVector<Drawable*>::Iterator i = rayQueryDrawables_.Begin(); i != rayQueryDrawables_.End(); ++i)
@@ -551,6 +793,52 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
     }
 }
 
+void Octree::InsertBVHDrawable(Drawable* drawable)
+{
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+
+    Octant* oldOctant = drawable->octant_;
+    if (oldOctant != this)
+    {
+        if (oldOctant)
+            oldOctant->RemoveDrawable(drawable, false);
+        AddDrawable(drawable);
+    }
+
+    UpdateDrawableBounds(drawable, box);
+
+    if (drawable->IsOccludee())
+    {
+        if (drawable->bvhLeaf_ == BVH_NULL_NODE)
+        {
+            RemoveBVHNonOccludee(drawable);
+            drawable->bvhLeaf_ = bvh_.CreateLeaf(drawable, box);
+        }
+        else
+            bvh_.MoveLeaf(drawable->bvhLeaf_, box);
+    }
+    else
+    {
+        if (drawable->bvhLeaf_ != BVH_NULL_NODE)
+        {
+            bvh_.DestroyLeaf(drawable->bvhLeaf_);
+            drawable->bvhLeaf_ = BVH_NULL_NODE;
+        }
+        AddBVHNonOccludee(drawable);
+    }
+}
+
+void Octree::RemoveBVHDrawable(Drawable* drawable)
+{
+    if (drawable->bvhLeaf_ != BVH_NULL_NODE)
+    {
+        bvh_.DestroyLeaf(drawable->bvhLeaf_);
+        drawable->bvhLeaf_ = BVH_NULL_NODE;
+    }
+    else if (spatialIndex_ == SPATIAL_INDEX_BVH)
+        RemoveBVHNonOccludee(drawable);
+}
+
 void Octree::QueueUpdate(Drawable* drawable)
 {
     Scene* scene = GetScene();
@@ -563,6 +851,10 @@ void Octree::QueueUpdate(Drawable* drawable)
         drawableUpdates_.Push(drawable);
 
     drawable->updateQueued_ = true;
+
+    // Queries before the reinsertion must use the current bounding box
+    if (drawable->octant_)
+        drawable->octant_->MarkDrawableBoundsDirty(drawable);
 }
 
 void Octree::CancelUpdate(Drawable* drawable)
@@ -573,6 +865,41 @@ void Octree::CancelUpdate(Drawable* drawable)
     drawable->updateQueued_ = false;
 }
 
+void Octree::GetBVHDrawables(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const
+{
+    bvh_.GetDrawables(query, drawables);
+
+    for (PODVector<Drawable*>::ConstIterator i = bvhNonOccludees_.Begin(); i != bvhNonOccludees_.End(); ++i)
+    {
+        Drawable* drawable = *i;
+        if ((drawable->GetDrawableFlags() & query.drawableFlags_) && (drawable->GetViewMask() & query.viewMask_))
+            drawables.Push(drawable);
+    }
+}
+
+void Octree::AddBVHNonOccludee(Drawable* drawable)
+{
+    if (drawable->bvhNonOccludeeIndex_ == M_MAX_UNSIGNED)
+    {
+        drawable->bvhNonOccludeeIndex_ = bvhNonOccludees_.Size();
+        bvhNonOccludees_.Push(drawable);
+    }
+}
+
+void Octree::RemoveBVHNonOccludee(Drawable* drawable)
+{
+    unsigned index = drawable->bvhNonOccludeeIndex_;
+    if (index == M_MAX_UNSIGNED)
+        return;
+
+    // The order does not matter, so move the last drawable into the removed one's place
+    Drawable* last = bvhNonOccludees_.Back();
+    bvhNonOccludees_[index] = last;
+    last->bvhNonOccludeeIndex_ = index;
+    bvhNonOccludees_.Pop();
+    drawable->bvhNonOccludeeIndex_ = M_MAX_UNSIGNED;
+}
+
 void Octree::DrawDebugGeometry(bool depthTest)
 {
     auto* debug = GetComponent<DebugRenderer>();
@@ -24,7 +24,9 @@
 
 #include "../Container/List.h"
 #include "../Core/Mutex.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Drawable.h"
+#include "../Graphics/DynamicBVH.h"
 #include "../Graphics/OctreeQuery.h"
 
 namespace Urho3D
@@ -35,6 +37,13 @@ class Octree;
 static const int NUM_OCTANTS = 8;
 static const unsigned ROOT_INDEX = M_MAX_UNSIGNED;
 
+/// Spatial index used by the octree component for the drawable objects.
+enum SpatialIndex
+{
+    SPATIAL_INDEX_OCTREE = 0,
+    SPATIAL_INDEX_BVH
+};
+
 /// %Octree octant
 class URHO3D_API Octant
 {
@@ -57,21 +66,33 @@ public:
     void AddDrawable(Drawable* drawable)
     {
         drawable->SetOctant(this);
-        drawables_.Push(drawable);
+        PushDrawable(drawable);
         IncDrawableCount();
     }
 
     /// Remove a drawable object from this octant.
     void RemoveDrawable(Drawable* drawable, bool resetOctant = true)
     {
-        if (drawables_.Remove(drawable))
+        unsigned index = drawable->octant_ == this ? drawable->octantIndex_ : drawables_.IndexOf(drawable);
+        if (index < drawables_.Size())
         {
+            EraseDrawable(index);
             if (resetOctant)
                 drawable->SetOctant(nullptr);
             DecDrawableCount();
         }
     }
 
+    /// Update a drawable object's packed bounding box and view mask. Called after reinsertion.
+    void UpdateDrawableBounds(Drawable* drawable, const BoundingBox& box);
+
+    /// Mark a drawable object's packed bounding box outdated, so that queries test the drawable individually until the next reinsertion. Not atomic: it only writes the drawable's own flag byte, so worker threads may mark different drawables concurrently during the threaded scene update, but not the same drawable, and not while the octree is being queried or updated. Drawables whose bounds change during rendering use Drawable::SetCameraDependentBounds() instead.
+    void MarkDrawableBoundsDirty(Drawable* drawable)
+    {
+        unsigned index = drawable->octantIndex_;
+        packedBounds_[index >> 2].flags_[index & 3] |= PACKED_BOUNDS_DIRTY;
+    }
+
     /// Return world-space bounding box.
     const BoundingBox& GetWorldBoundingBox() const { return worldBoundingBox_; }
 
@@ -107,6 +128,12 @@ protected:
     void GetDrawablesInternal(RayOctreeQuery& query) const;
     /// Return drawable objects only for a threaded ray query, called internally.
     void GetDrawablesOnlyInternal(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const;
+    /// Test this octant's drawable objects using the packed bounding boxes. Return false if not supported by the query.
+    bool TestPackedDrawables(OctreeQuery& query, bool inside) const;
+    /// Append a drawable object to the drawable and packed bounding box arrays.
+    void PushDrawable(Drawable* drawable);
+    /// Remove a drawable object from the drawable and packed bounding box arrays by moving the last one in its place.
+    void EraseDrawable(unsigned index);
 
     /// Increase drawable object count recursively.
     void IncDrawableCount()
@@ -138,6 +165,8 @@ protected:
     BoundingBox cullingBox_;
     /// Drawable objects.
     PODVector<Drawable*> drawables_;
+    /// Packed bounding boxes of the drawable objects, in groups of four in the same order.
+    PODVector<PackedDrawableBounds> packedBounds_;
     /// Child octants.
     Octant* children_[NUM_OCTANTS];
     /// World bounding box center.
@@ -176,6 +205,10 @@ public:
 
     /// Set size and maximum subdivision levels. If octree is not empty, drawable objects will be temporarily moved to the root.
     void SetSize(const BoundingBox& box, unsigned numLevels);
+    /// Set spatial index type. The octree uses a fixed size and subdivision levels, while the dynamic bounding volume hierarchy adapts to any world size.
+    void SetSpatialIndex(SpatialIndex type);
+    /// Set the amount of world units the bounding volume hierarchy leaves are enlarged by, to avoid reinserting slowly moving drawable objects every frame.
+    void SetBVHMargin(float margin);
     /// Update and reinsert drawable objects.
     void Update(const FrameInfo& frame);
     /// Add a drawable manually.
@@ -192,6 +225,17 @@ public:
 
     /// Return subdivision levels.
     unsigned GetNumLevels() const { return numLevels_; }
+    /// Return spatial index type.
+    SpatialIndex GetSpatialIndex() const { return spatialIndex_; }
+    /// Return bounding volume hierarchy leaf margin.
+    float GetBVHMargin() const { return bvh_.GetMargin(); }
+    /// Return the bounding volume hierarchy. Empty unless used as the spatial index.
+    const DynamicBVH& GetBVH() const { return bvh_; }
+
+    /// Insert or update a drawable object in the bounding volume hierarchy. Called internally.
+    void InsertBVHDrawable(Drawable* drawable);
+    /// Remove a drawable object from the bounding volume hierarchy. Called internally.
+    void RemoveBVHDrawable(Drawable* drawable);
 
     /// Mark drawable object as requiring an update and a reinsertion.
     void QueueUpdate(Drawable* drawable);
@@ -205,17 +249,31 @@ private:
     void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
     /// Update octree size.
     void UpdateOctreeSize() { SetSize(worldBoundingBox_, numLevels_); }
+    /// Return drawable objects from the bounding volume hierarchy for a ray query.
+    void GetBVHDrawables(RayOctreeQuery& query, PODVector<Drawable*>& drawables) const;
+    /// Add a drawable object to the non-occludees if not already there.
+    void AddBVHNonOccludee(Drawable* drawable);
+    /// Remove a drawable object from the non-occludees by swapping the last one into its place.
+    void RemoveBVHNonOccludee(Drawable* drawable);
 
     /// Drawable objects that require update.
     PODVector<Drawable*> drawableUpdates_;
     /// Drawable objects that were inserted during threaded update phase.
     PODVector<Drawable*> threadedDrawableUpdates_;
+    /// Measured cost of the threaded drawable update.
+    ParallelForCost drawableUpdateCost_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
     /// Ray query temporary list of drawables.
     mutable PODVector<Drawable*> rayQueryDrawables_;
+    /// Bounding volume hierarchy.
+    DynamicBVH bvh_;
+    /// Drawable objects that are not occludees, kept outside the bounding volume hierarchy so that occlusion can not hide them.
+    PODVector<Drawable*> bvhNonOccludees_;
     /// Subdivision level.
     unsigned numLevels_;
+    /// Spatial index type.
+    SpatialIndex spatialIndex_;
 };
 
 }
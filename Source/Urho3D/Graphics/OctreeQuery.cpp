@@ -24,11 +24,24 @@
 
 #include "../Graphics/OctreeQuery.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+#ifndef URHO3D_SSE
+/// Return a drawable's bounding box from a packed group.
+static inline BoundingBox UnpackBounds(const PackedDrawableBounds& group, unsigned index)
+{
+    return BoundingBox(Vector3(group.minX_[index], group.minY_[index], group.minZ_[index]),
+        Vector3(group.maxX_[index], group.maxY_[index], group.maxZ_[index]));
+}
+#endif
+
 Intersection PointOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -73,6 +86,49 @@ void SphereOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool ins
     }
 }
 
+void SphereOctreeQuery::TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks)
+{
+#ifdef URHO3D_SSE
+    __m128 centerX = _mm_set1_ps(sphere_.center_.x_);
+    __m128 centerY = _mm_set1_ps(sphere_.center_.y_);
+    __m128 centerZ = _mm_set1_ps(sphere_.center_.z_);
+    __m128 radiusSquared = _mm_set1_ps(sphere_.radius_ * sphere_.radius_);
+
+    while (start != end)
+    {
+        // Distance to the closest point of each box, zero on axes where the center is within the box
+        __m128 minX = _mm_loadu_ps(start->minX_);
+        __m128 maxX = _mm_loadu_ps(start->maxX_);
+        __m128 dX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(centerX, minX), _mm_sub_ps(centerX, minX)),
+            _mm_and_ps(_mm_cmpgt_ps(centerX, maxX), _mm_sub_ps(centerX, maxX)));
+        __m128 minY = _mm_loadu_ps(start->minY_);
+        __m128 maxY = _mm_loadu_ps(start->maxY_);
+        __m128 dY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(centerY, minY), _mm_sub_ps(centerY, minY)),
+            _mm_and_ps(_mm_cmpgt_ps(centerY, maxY), _mm_sub_ps(centerY, maxY)));
+        __m128 minZ = _mm_loadu_ps(start->minZ_);
+        __m128 maxZ = _mm_loadu_ps(start->maxZ_);
+        __m128 dZ = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(centerZ, minZ), _mm_sub_ps(centerZ, minZ)),
+            _mm_and_ps(_mm_cmpgt_ps(centerZ, maxZ), _mm_sub_ps(centerZ, maxZ)));
+
+        __m128 distSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, dX), _mm_mul_ps(dY, dY)), _mm_mul_ps(dZ, dZ));
+        *masks++ = (unsigned char)_mm_movemask_ps(_mm_cmplt_ps(distSquared, radiusSquared));
+        ++start;
+    }
+#else
+    while (start != end)
+    {
+        unsigned char mask = 0;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (sphere_.IsInsideFast(UnpackBounds(*start, i)))
+                mask |= 1u << i;
+        }
+        *masks++ = mask;
+        ++start;
+    }
+#endif
+}
+
 Intersection BoxOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -95,6 +151,43 @@ void BoxOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside
     }
 }
 
+void BoxOctreeQuery::TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks)
+{
+#ifdef URHO3D_SSE
+    __m128 boxMinX = _mm_set1_ps(box_.min_.x_);
+    __m128 boxMinY = _mm_set1_ps(box_.min_.y_);
+    __m128 boxMinZ = _mm_set1_ps(box_.min_.z_);
+    __m128 boxMaxX = _mm_set1_ps(box_.max_.x_);
+    __m128 boxMaxY = _mm_set1_ps(box_.max_.y_);
+    __m128 boxMaxZ = _mm_set1_ps(box_.max_.z_);
+
+    while (start != end)
+    {
+        __m128 outside = _mm_or_ps(_mm_cmplt_ps(_mm_loadu_ps(start->maxX_), boxMinX),
+            _mm_cmpgt_ps(_mm_loadu_ps(start->minX_), boxMaxX));
+        outside = _mm_or_ps(outside, _mm_or_ps(_mm_cmplt_ps(_mm_loadu_ps(start->maxY_), boxMinY),
+            _mm_cmpgt_ps(_mm_loadu_ps(start->minY_), boxMaxY)));
+        outside = _mm_or_ps(outside, _mm_or_ps(_mm_cmplt_ps(_mm_loadu_ps(start->maxZ_), boxMinZ),
+            _mm_cmpgt_ps(_mm_loadu_ps(start->minZ_), boxMaxZ)));
+
+        *masks++ = (unsigned char)(~_mm_movemask_ps(outside) & 0xf);
+        ++start;
+    }
+#else
+    while (start != end)
+    {
+        unsigned char mask = 0;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (box_.IsInsideFast(UnpackBounds(*start, i)))
+                mask |= 1u << i;
+        }
+        *masks++ = mask;
+        ++start;
+    }
+#endif
+}
+
 Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -117,6 +210,67 @@ void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool in
     }
 }
 
+void FrustumOctreeQuery::TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks)
+{
+#ifdef URHO3D_SSE
+    // Splat the plane normals and distances once for all groups
+    __m128 planes[NUM_FRUSTUM_PLANES][7];
+    for (unsigned i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+    {
+        const Plane& plane = frustum_.planes_[i];
+        planes[i][0] = _mm_set1_ps(plane.normal_.x_);
+        planes[i][1] = _mm_set1_ps(plane.normal_.y_);
+        planes[i][2] = _mm_set1_ps(plane.normal_.z_);
+        planes[i][3] = _mm_set1_ps(plane.d_);
+        planes[i][4] = _mm_set1_ps(plane.absNormal_.x_);
+        planes[i][5] = _mm_set1_ps(plane.absNormal_.y_);
+        planes[i][6] = _mm_set1_ps(plane.absNormal_.z_);
+    }
+
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 signMask = _mm_set1_ps(-0.0f);
+
+    while (start != end)
+    {
+        // Same arithmetic as Frustum::IsInsideFast(), four boxes at a time
+        __m128 minX = _mm_loadu_ps(start->minX_);
+        __m128 minY = _mm_loadu_ps(start->minY_);
+        __m128 minZ = _mm_loadu_ps(start->minZ_);
+        __m128 centerX = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(start->maxX_), minX), half);
+        __m128 centerY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(start->maxY_), minY), half);
+        __m128 centerZ = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(start->maxZ_), minZ), half);
+        __m128 edgeX = _mm_sub_ps(centerX, minX);
+        __m128 edgeY = _mm_sub_ps(centerY, minY);
+        __m128 edgeZ = _mm_sub_ps(centerZ, minZ);
+
+        __m128 outside = _mm_setzero_ps();
+        for (unsigned i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        {
+            const __m128* plane = planes[i];
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], centerX), _mm_mul_ps(plane[1], centerY)),
+                _mm_mul_ps(plane[2], centerZ)), plane[3]);
+            __m128 absDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[4], edgeX), _mm_mul_ps(plane[5], edgeY)),
+                _mm_mul_ps(plane[6], edgeZ));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_xor_ps(absDist, signMask)));
+        }
+
+        *masks++ = (unsigned char)(~_mm_movemask_ps(outside) & 0xf);
+        ++start;
+    }
+#else
+    while (start != end)
+    {
+        unsigned char mask = 0;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (frustum_.IsInsideFast(UnpackBounds(*start, i)))
+                mask |= 1u << i;
+        }
+        *masks++ = mask;
+        ++start;
+    }
+#endif
+}
 
 Intersection AllContentOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
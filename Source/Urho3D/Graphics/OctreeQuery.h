@@ -34,6 +34,30 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Packed drawable flag: the bounding box is outdated and the drawable must be tested individually.
+static const unsigned PACKED_BOUNDS_DIRTY = 0x80000000;
+
+/// Bounding boxes, drawable flags and view masks of four drawables in an octree octant, stored as structure of arrays for SIMD culling.
+struct PackedDrawableBounds
+{
+    /// Bounding box minimum X coordinates.
+    float minX_[4];
+    /// Bounding box minimum Y coordinates.
+    float minY_[4];
+    /// Bounding box minimum Z coordinates.
+    float minZ_[4];
+    /// Bounding box maximum X coordinates.
+    float maxX_[4];
+    /// Bounding box maximum Y coordinates.
+    float maxY_[4];
+    /// Bounding box maximum Z coordinates.
+    float maxZ_[4];
+    /// Drawable flags, combined with PACKED_BOUNDS_DIRTY. Zero for unused slots.
+    unsigned flags_[4];
+    /// View masks.
+    unsigned viewMasks_[4];
+};
+
 /// Base class for octree queries.
 class URHO3D_API OctreeQuery
 {
@@ -58,6 +82,10 @@ public:
     virtual Intersection TestOctant(const BoundingBox& box, bool inside) = 0;
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside) = 0;
+    /// Return whether the query implements TestPackedBounds(). If not, TestDrawables() receives all drawables of an octant without pre-filtering by the packed bounds, flags or view masks.
+    virtual bool HasPackedBoundsTest() const { return false; }
+    /// Intersection test for packed drawable bounding boxes. Write a bitmask of the intersecting drawables for each group of four. Called only if HasPackedBoundsTest() returns true.
+    virtual void TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks) { }
 
     /// Result vector reference.
     PODVector<Drawable*>& result_;
@@ -104,6 +132,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Return whether the query implements TestPackedBounds().
+    bool HasPackedBoundsTest() const override { return true; }
+    /// Intersection test for packed drawable bounding boxes.
+    void TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks) override;
 
     /// Sphere.
     Sphere sphere_;
@@ -125,6 +157,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Return whether the query implements TestPackedBounds().
+    bool HasPackedBoundsTest() const override { return true; }
+    /// Intersection test for packed drawable bounding boxes.
+    void TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks) override;
 
     /// Bounding box.
     BoundingBox box_;
@@ -146,6 +182,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Return whether the query implements TestPackedBounds().
+    bool HasPackedBoundsTest() const override { return true; }
+    /// Intersection test for packed drawable bounding boxes.
+    void TestPackedBounds(const PackedDrawableBounds* start, const PackedDrawableBounds* end, unsigned char* masks) override;
 
     /// Frustum.
     Frustum frustum_;
@@ -298,6 +298,7 @@ Renderer::Renderer(Context* context) :
     dynamicInstancing_(true),
     numExtraInstancingBufferElements_(0),
     threadedOcclusion_(false),
+    batchCaching_(false),
     shadersDirty_(true),
     initialized_(false),
     resetViews_(false)
@@ -556,6 +557,11 @@ void Renderer::SetThreadedOcclusion(bool enable)
     }
 }
 
+void Renderer::SetBatchCaching(bool enable)
+{
+    batchCaching_ = enable;
+}
+
 void Renderer::ReloadShaders()
 {
     shadersDirty_ = true;
@@ -677,6 +683,40 @@ unsigned Renderer::GetNumOccluders(bool allViews) const
     return numOccluders;
 }
 
+unsigned Renderer::GetNumBatchCacheHits(bool allViews) const
+{
+    unsigned numHits = 0;
+    unsigned lastView = allViews ? views_.Size() : 1;
+
+    for (unsigned i = 0; i < lastView; ++i)
+    {
+        View* view = GetActualView(views_[i]);
+        if (!view)
+            continue;
+
+        numHits += view->GetNumBatchCacheHits();
+    }
+
+    return numHits;
+}
+
+unsigned Renderer::GetNumBatchCacheMisses(bool allViews) const
+{
+    unsigned numMisses = 0;
+    unsigned lastView = allViews ? views_.Size() : 1;
+
+    for (unsigned i = 0; i < lastView; ++i)
+    {
+        View* view = GetActualView(views_[i]);
+        if (!view)
+            continue;
+
+        numMisses += view->GetNumBatchCacheMisses();
+    }
+
+    return numMisses;
+}
+
 void Renderer::Update(float timeStep)
 {
     URHO3D_PROFILE(UpdateViews);
@@ -238,6 +238,8 @@ public:
     void SetOccluderSizeThreshold(float screenSize);
     /// Set whether to thread occluder rendering. Default false.
     void SetThreadedOcclusion(bool enable);
+    /// Set whether views cache the base pass batches of drawables between frames and only rebuild them when their inputs change. Default false.
+    void SetBatchCaching(bool enable);
     /// Set shadow depth bias multiplier for mobile platforms to counteract possible worse shadow map precision. Default 1.0 (no effect.)
     void SetMobileShadowBiasMul(float mul);
     /// Set shadow depth bias addition for mobile platforms to counteract possible worse shadow map precision. Default 0.0 (no effect.)
@@ -328,6 +330,12 @@ public:
     /// Return whether occlusion rendering is threaded.
     bool GetThreadedOcclusion() const { return threadedOcclusion_; }
 
+    /// Return whether base pass batches are cached between frames.
+    bool GetBatchCaching() const { return batchCaching_; }
+
+    /// Return frame number on which shaders last changed.
+    unsigned GetShadersChangedFrameNumber() const { return shadersChangedFrameNumber_; }
+
     /// Return shadow depth bias multiplier for mobile platforms.
     float GetMobileShadowBiasMul() const { return mobileShadowBiasMul_; }
 
@@ -354,6 +362,10 @@ public:
     unsigned GetNumShadowMaps(bool allViews = false) const;
     /// Return number of occluders rendered.
     unsigned GetNumOccluders(bool allViews = false) const;
+    /// Return number of drawables whose base pass batches were reused from the batch cache.
+    unsigned GetNumBatchCacheHits(bool allViews = false) const;
+    /// Return number of drawables whose base pass batches had to be rebuilt while batch caching is enabled.
+    unsigned GetNumBatchCacheMisses(bool allViews = false) const;
 
     /// Return the default zone.
     Zone* GetDefaultZone() const { return defaultZone_; }
@@ -596,6 +608,8 @@ private:
     int numExtraInstancingBufferElements_;
     /// Threaded occlusion rendering flag.
     bool threadedOcclusion_;
+    /// Batch caching flag.
+    bool batchCaching_;
     /// Shaders need reloading flag.
     bool shadersDirty_;
     /// Initialized flag.
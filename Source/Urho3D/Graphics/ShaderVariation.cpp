@@ -25,12 +25,19 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/ShaderVariation.h"
+#include "../Graphics/SortIDAllocator.h"
 
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+static SortIDAllocator& GetShaderVariationSortIDs()
+{
+    static SortIDAllocator allocator;
+    return allocator;
+}
+
 ShaderParameter::ShaderParameter(const String& name, unsigned glType, int location) :
     name_{name},
     glType_{glType},
@@ -59,7 +66,8 @@ ShaderVariation::ShaderVariation(Shader* owner, ShaderType type) :
     GPUObject(owner->GetSubsystem<Graphics>()),
     owner_(owner),
     type_(type),
-    elementHash_(0)
+    elementHash_(0),
+    sortID_(GetShaderVariationSortIDs().Allocate())
 {
     for (bool& useTextureUnit : useTextureUnits_)
         useTextureUnit = false;
@@ -70,6 +78,7 @@ ShaderVariation::ShaderVariation(Shader* owner, ShaderType type) :
 ShaderVariation::~ShaderVariation()
 {
     Release();
+    GetShaderVariationSortIDs().Free(sortID_);
 }
 
 void ShaderVariation::SetName(const String& name)
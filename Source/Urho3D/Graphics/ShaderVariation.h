@@ -122,6 +122,9 @@ public:
     /// Return vertex element hash.
     unsigned long long GetElementHash() const { return elementHash_; }
 
+    /// Return persistent ID for batch state sorting.
+    unsigned short GetSortID() const { return sortID_; }
+
     /// Return shader bytecode. Stored persistently on Direct3D11 only.
     const PODVector<unsigned char>& GetByteCode() const { return byteCode_; }
 
@@ -158,6 +161,8 @@ private:
     ShaderType type_;
     /// Vertex element hash for vertex shaders. Zero for pixel shaders. Note that hashing is different than vertex buffers.
     unsigned long long elementHash_;
+    /// Persistent ID for batch state sorting.
+    unsigned short sortID_;
     /// Shader parameters.
     HashMap<StringHash, ShaderParameter> parameters_;
     /// Texture unit use flags.
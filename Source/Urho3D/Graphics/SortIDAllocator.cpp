@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Graphics/SortIDAllocator.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+SortIDAllocator::SortIDAllocator() :
+    nextID_(0)
+{
+}
+
+unsigned short SortIDAllocator::Allocate()
+{
+    MutexLock lock(mutex_);
+
+    if (!freeIDs_.Empty())
+    {
+        unsigned short id = freeIDs_.Back();
+        freeIDs_.Pop();
+        return id;
+    }
+    else
+        return (unsigned short)(nextID_++ & 0xffff);
+}
+
+void SortIDAllocator::Free(unsigned short id)
+{
+    MutexLock lock(mutex_);
+
+    // After a wraparound the same ID may be in use several times. Do not make it available again in that case
+    if (nextID_ <= 0xffff)
+        freeIDs_.Push(id);
+}
+
+}
@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Vector.h"
+#include "../Core/Mutex.h"
+
+namespace Urho3D
+{
+
+/// Allocator for small persistent IDs of objects which take part in batch sorting, such as materials, geometries and shader variations. Freed IDs are reused so that the IDs stay dense. Thread-safe.
+class URHO3D_API SortIDAllocator
+{
+public:
+    /// Construct.
+    SortIDAllocator();
+
+    /// Allocate an ID. If more than 65536 IDs are in use, the IDs wrap around and are no longer unique.
+    unsigned short Allocate();
+    /// Free an ID for reuse.
+    void Free(unsigned short id);
+
+private:
+    /// Freed IDs available for reuse.
+    PODVector<unsigned short> freeIDs_;
+    /// Next never used ID.
+    unsigned nextID_;
+    /// Mutex for allocation from multiple threads, as resources may be created in the background loading thread.
+    Mutex mutex_;
+};
+
+}
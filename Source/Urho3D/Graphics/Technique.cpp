@@ -79,6 +79,7 @@ Pass::Pass(const String& name) :
     depthTestMode_(CMP_LESSEQUAL),
     lightingMode_(LIGHTING_UNLIT),
     shadersLoadedFrameNumber_(0),
+    shadersVersion_(0),
     alphaToCoverage_(false),
     depthWrite_(true),
     isDesktop_(false)
@@ -174,6 +175,7 @@ void Pass::ReleaseShaders()
     pixelShaders_.Clear();
     extraVertexShaders_.Clear();
     extraPixelShaders_.Clear();
+    ++shadersVersion_;
 }
 
 void Pass::MarkShadersLoaded(unsigned frameNumber)
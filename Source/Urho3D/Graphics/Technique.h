@@ -99,6 +99,9 @@ public:
     /// Return last shaders loaded frame number.
     unsigned GetShadersLoadedFrameNumber() const { return shadersLoadedFrameNumber_; }
 
+    /// Return shader version, which is incremented whenever shader pointers are reset. Used to validate cached batches.
+    unsigned GetShadersVersion() const { return shadersVersion_; }
+
     /// Return depth write mode.
     bool GetDepthWrite() const { return depthWrite_; }
 
@@ -154,6 +157,8 @@ private:
     PassLightingMode lightingMode_;
     /// Last shaders loaded frame number.
     unsigned shadersLoadedFrameNumber_;
+    /// Shader version.
+    unsigned shadersVersion_;
     /// Depth write mode.
     bool depthWrite_;
     /// Alpha-to-coverage mode.
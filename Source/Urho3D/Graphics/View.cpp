@@ -157,11 +157,8 @@ public:
     OcclusionBuffer* buffer_;
 };
 
-void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
+void CheckVisibilityWork(View* view, Drawable** start, Drawable** end, unsigned threadIndex)
 {
-    auto* view = reinterpret_cast<View*>(item->aux_);
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
     OcclusionBuffer* buffer = view->occlusionBuffer_;
     const Matrix3x4& viewMatrix = view->cullCamera_->GetView();
     Vector3 viewZ = Vector3(viewMatrix.m20_, viewMatrix.m21_, viewMatrix.m22_);
@@ -234,19 +231,16 @@ void ProcessLightWork(const WorkItem* item, unsigned threadIndex)
     view->ProcessLight(*query, threadIndex);
 }
 
-void UpdateDrawableGeometriesWork(const WorkItem* item, unsigned threadIndex)
+void ProcessShadowSplitWork(const WorkItem* item, unsigned threadIndex)
 {
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
+    auto* view = reinterpret_cast<View*>(item->aux_);
+    auto* query = reinterpret_cast<LightQueryResult*>(item->start_);
+    // The end pointer points to the split's shadow caster list, which gives the split index
+    auto splitIndex = (unsigned)(reinterpret_cast<PODVector<Drawable*>*>(item->end_) - query->shadowCasters_);
 
-    while (start != end)
-    {
-        Drawable* drawable = *start++;
-        // We may leave null pointer holes in the queue if a drawable is found out to require a main thread update
-        if (drawable)
-            drawable->UpdateGeometry(frame);
-    }
+    // The light may have ended up with less splits than work items were queued for, or none at all if not shadowed
+    if (splitIndex < query->numSplits_)
+        view->ProcessShadowSplit(*query, splitIndex, threadIndex);
 }
 
 void SortBatchQueueFrontToBackWork(const WorkItem* item, unsigned threadIndex)
@@ -299,6 +293,9 @@ View::View(Context* context) :
     tempDrawables_.Resize(numThreads);
     sceneResults_.Resize(numThreads);
     frame_.camera_ = nullptr;
+    activeOccluders_ = 0;
+    numBatchCacheHits_ = 0;
+    numBatchCacheMisses_ = 0;
 }
 
 View::~View() = default;
@@ -552,6 +549,8 @@ void View::Update(const FrameInfo& frame)
     zones_.Clear();
     occluders_.Clear();
     activeOccluders_ = 0;
+    numBatchCacheHits_ = 0;
+    numBatchCacheMisses_ = 0;
     vertexLightQueues_.Clear();
     for (HashMap<unsigned, BatchQueue>::Iterator i = batchQueues_.Begin(); i != batchQueues_.End(); ++i)
         i->second_.Clear(maxSortedInstances);
@@ -899,30 +898,10 @@ void View::GetDrawables()
             result.maxZ_ = 0.0f;
         }
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = tempDrawables.Size() / numWorkItems;
-
-        PODVector<Drawable*>::Iterator start = tempDrawables.Begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
+        queue->ParallelFor(tempDrawables.Size(), 0, [&](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckVisibilityWork;
-            item->aux_ = this;
-
-            PODVector<Drawable*>::Iterator end = tempDrawables.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+            CheckVisibilityWork(this, tempDrawables.Buffer() + begin, tempDrawables.Buffer() + end, threadIndex);
+        }, &visibilityCost_);
     }
 
     // Combine lights, geometries & scene Z range from the threads
@@ -995,14 +974,45 @@ void View::ProcessLights()
         item->aux_ = this;
 
         LightQueryResult& query = lightQueryResults_[i];
-        query.light_ = lights_[i];
+        Light* light = lights_[i];
+        query.light_ = light;
 
         item->start_ = &query;
+
+        // Query the shadow casters of each directional light split in parallel. The split items depend on the light item,
+        // which sets up the shadow cameras, so they start as soon as it finishes
+        if (drawShadows_ && light->GetCastShadows() && light->GetLightType() == LIGHT_DIRECTIONAL)
+        {
+            auto numSplits = (unsigned)light->GetNumShadowSplits();
+            for (unsigned j = 0; j < numSplits; ++j)
+            {
+                SharedPtr<WorkItem> splitItem = queue->GetFreeItem();
+                splitItem->priority_ = M_MAX_UNSIGNED;
+                splitItem->workFunction_ = ProcessShadowSplitWork;
+                splitItem->aux_ = this;
+                splitItem->start_ = &query;
+                splitItem->end_ = &query.shadowCasters_[j];
+                queue->AddDependency(splitItem, item);
+                queue->AddWorkItem(splitItem);
+            }
+        }
+
         queue->AddWorkItem(item);
     }
 
     // Ensure all lights have been processed before proceeding
     queue->Complete(M_MAX_UNSIGNED);
+
+    // If no shadow casters, the light can be rendered unshadowed. At this point we have not allocated a shadow map yet, so the
+    // only cost has been the shadow camera setup & queries
+    for (Vector<LightQueryResult>::Iterator i = lightQueryResults_.Begin(); i != lightQueryResults_.End(); ++i)
+    {
+        bool hasShadowCasters = false;
+        for (unsigned j = 0; j < i->numSplits_ && !hasShadowCasters; ++j)
+            hasShadowCasters = !i->shadowCasters_[j].Empty();
+        if (!hasShadowCasters)
+            i->numSplits_ = 0;
+    }
 }
 
 void View::GetLightBatches()
@@ -1086,8 +1096,7 @@ void View::GetLightBatches()
                     FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
 
                     // Loop through shadow casters
-                    for (PODVector<Drawable*>::ConstIterator k = query.shadowCasters_.Begin() + query.shadowCasterBegin_[j];
-                         k < query.shadowCasters_.Begin() + query.shadowCasterEnd_[j]; ++k)
+                    for (PODVector<Drawable*>::ConstIterator k = query.shadowCasters_[j].Begin(); k != query.shadowCasters_[j].End(); ++k)
                     {
                         Drawable* drawable = *k;
                         // If drawable is not in actual view frustum, mark it in view here and check its geometry update type
@@ -1198,6 +1207,10 @@ void View::GetBaseBatches()
 {
     URHO3D_PROFILE(GetBaseBatches);
 
+    bool batchCaching = renderer_->GetBatchCaching();
+    if (!batchCaching && !batchCache_.Empty())
+        batchCache_.Clear();
+
     for (PODVector<Drawable*>::ConstIterator i = geometries_.Begin(); i != geometries_.End(); ++i)
     {
         Drawable* drawable = *i;
@@ -1207,81 +1220,242 @@ void View::GetBaseBatches()
         else if (type == UPDATE_WORKER_THREAD)
             threadedGeometries_.Push(drawable);
 
-        const Vector<SourceBatch>& batches = drawable->GetBatches();
-        bool vertexLightsProcessed = false;
+        // Vertex lit drawables refer to the per-frame vertex light queues, so they are not cached
+        if (batchCaching && drawable->GetVertexLights().Empty())
+        {
+            DrawableBatchCache& cache = batchCache_[drawable];
+            if (CheckBatchCache(drawable, cache))
+            {
+                AddCachedBatches(drawable, cache);
+                ++numBatchCacheHits_;
+            }
+            else
+            {
+                GetDrawableBaseBatches(drawable, &cache);
+                ++numBatchCacheMisses_;
+            }
+            cache.frameNumber_ = frame_.frameNumber_;
+        }
+        else
+            GetDrawableBaseBatches(drawable, nullptr);
+    }
+
+    // Evict drawables that were not visible this frame, so that they will be fully processed when visible again
+    if (batchCaching)
+    {
+        for (HashMap<Drawable*, DrawableBatchCache>::Iterator i = batchCache_.Begin(); i != batchCache_.End();)
+        {
+            if (i->second_.frameNumber_ != frame_.frameNumber_)
+                i = batchCache_.Erase(i);
+            else
+                ++i;
+        }
+    }
+}
+
+void View::GetDrawableBaseBatches(Drawable* drawable, DrawableBatchCache* cache)
+{
+    const Vector<SourceBatch>& batches = drawable->GetBatches();
+    bool vertexLightsProcessed = false;
 
-        for (unsigned j = 0; j < batches.Size(); ++j)
+    if (cache)
+    {
+        Zone* zone = GetZone(drawable);
+        cache->drawable_ = drawable;
+        cache->zone_ = zone;
+        cache->heightFog_ = zone->GetHeightFog();
+        cache->lightMask_ = GetLightMask(drawable);
+        cache->basePassFlags_ = 0;
+        cache->sourceBatches_ = batches;
+        cache->techniques_.Resize(batches.Size());
+        cache->batches_.Clear();
+    }
+
+    for (unsigned j = 0; j < batches.Size(); ++j)
+    {
+        const SourceBatch& srcBatch = batches[j];
+
+        // Check here if the material refers to a rendertarget texture with camera(s) attached
+        // Only check this for backbuffer views (null rendertarget)
+        if (srcBatch.material_ && srcBatch.material_->GetAuxViewFrameNumber() != frame_.frameNumber_ && !renderTarget_)
+            CheckMaterialForAuxView(srcBatch.material_);
+
+        Technique* tech = GetTechnique(drawable, srcBatch.material_);
+        if (cache)
         {
-            const SourceBatch& srcBatch = batches[j];
+            cache->techniques_[j] = tech;
+            if (j < 32 && drawable->HasBasePass(j))
+                cache->basePassFlags_ |= 1u << j;
+        }
 
-            // Check here if the material refers to a rendertarget texture with camera(s) attached
-            // Only check this for backbuffer views (null rendertarget)
-            if (srcBatch.material_ && srcBatch.material_->GetAuxViewFrameNumber() != frame_.frameNumber_ && !renderTarget_)
-                CheckMaterialForAuxView(srcBatch.material_);
+        if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
+            continue;
 
-            Technique* tech = GetTechnique(drawable, srcBatch.material_);
-            if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
+        // Check each of the scene passes
+        for (unsigned k = 0; k < scenePasses_.Size(); ++k)
+        {
+            ScenePassInfo& info = scenePasses_[k];
+            // Skip forward base pass if the corresponding litbase pass already exists
+            if (info.passIndex_ == basePassIndex_ && j < 32 && drawable->HasBasePass(j))
                 continue;
 
-            // Check each of the scene passes
-            for (unsigned k = 0; k < scenePasses_.Size(); ++k)
-            {
-                ScenePassInfo& info = scenePasses_[k];
-                // Skip forward base pass if the corresponding litbase pass already exists
-                if (info.passIndex_ == basePassIndex_ && j < 32 && drawable->HasBasePass(j))
-                    continue;
+            Pass* pass = tech->GetSupportedPass(info.passIndex_);
+            if (!pass)
+                continue;
 
-                Pass* pass = tech->GetSupportedPass(info.passIndex_);
-                if (!pass)
-                    continue;
+            Batch destBatch(srcBatch);
+            destBatch.pass_ = pass;
+            destBatch.zone_ = GetZone(drawable);
+            destBatch.isBase_ = true;
+            destBatch.lightMask_ = (unsigned char)GetLightMask(drawable);
 
-                Batch destBatch(srcBatch);
-                destBatch.pass_ = pass;
-                destBatch.zone_ = GetZone(drawable);
-                destBatch.isBase_ = true;
-                destBatch.lightMask_ = (unsigned char)GetLightMask(drawable);
+            if (info.vertexLights_)
+            {
+                const PODVector<Light*>& drawableVertexLights = drawable->GetVertexLights();
+                if (drawableVertexLights.Size() && !vertexLightsProcessed)
+                {
+                    // Limit vertex lights. If this is a deferred opaque batch, remove converted per-pixel lights,
+                    // as they will be rendered as light volumes in any case, and drawing them also as vertex lights
+                    // would result in double lighting
+                    drawable->LimitVertexLights(deferred_ && destBatch.pass_->GetBlendMode() == BLEND_REPLACE);
+                    vertexLightsProcessed = true;
+                }
 
-                if (info.vertexLights_)
+                if (drawableVertexLights.Size())
                 {
-                    const PODVector<Light*>& drawableVertexLights = drawable->GetVertexLights();
-                    if (drawableVertexLights.Size() && !vertexLightsProcessed)
+                    // Find a vertex light queue. If not found, create new
+                    unsigned long long hash = GetVertexLightQueueHash(drawableVertexLights);
+                    HashMap<unsigned long long, LightBatchQueue>::Iterator i = vertexLightQueues_.Find(hash);
+                    if (i == vertexLightQueues_.End())
                     {
-                        // Limit vertex lights. If this is a deferred opaque batch, remove converted per-pixel lights,
-                        // as they will be rendered as light volumes in any case, and drawing them also as vertex lights
-                        // would result in double lighting
-                        drawable->LimitVertexLights(deferred_ && destBatch.pass_->GetBlendMode() == BLEND_REPLACE);
-                        vertexLightsProcessed = true;
+                        i = vertexLightQueues_.Insert(MakePair(hash, LightBatchQueue()));
+                        i->second_.light_ = nullptr;
+                        i->second_.shadowMap_ = nullptr;
+                        i->second_.vertexLights_ = drawableVertexLights;
                     }
 
-                    if (drawableVertexLights.Size())
-                    {
-                        // Find a vertex light queue. If not found, create new
-                        unsigned long long hash = GetVertexLightQueueHash(drawableVertexLights);
-                        HashMap<unsigned long long, LightBatchQueue>::Iterator i = vertexLightQueues_.Find(hash);
-                        if (i == vertexLightQueues_.End())
-                        {
-                            i = vertexLightQueues_.Insert(MakePair(hash, LightBatchQueue()));
-                            i->second_.light_ = nullptr;
-                            i->second_.shadowMap_ = nullptr;
-                            i->second_.vertexLights_ = drawableVertexLights;
-                        }
-
-                        destBatch.lightQueue_ = &(i->second_);
-                    }
+                    destBatch.lightQueue_ = &(i->second_);
                 }
-                else
-                    destBatch.lightQueue_ = nullptr;
+            }
+            else
+                destBatch.lightQueue_ = nullptr;
+
+            bool allowInstancing = info.allowInstancing_;
+            if (allowInstancing && info.markToStencil_ && destBatch.lightMask_ != (destBatch.zone_->GetLightMask() & 0xff))
+                allowInstancing = false;
 
-                bool allowInstancing = info.allowInstancing_;
-                if (allowInstancing && info.markToStencil_ && destBatch.lightMask_ != (destBatch.zone_->GetLightMask() & 0xff))
-                    allowInstancing = false;
+            AddBatchToQueue(*info.batchQueue_, destBatch, tech, allowInstancing);
 
-                AddBatchToQueue(*info.batchQueue_, destBatch, tech, allowInstancing);
+            if (cache)
+            {
+                CachedBatch cached;
+                cached.batch_ = destBatch;
+                cached.queue_ = info.batchQueue_;
+                cached.vsExtraDefinesHash_ = info.batchQueue_->vsExtraDefinesHash_;
+                cached.psExtraDefinesHash_ = info.batchQueue_->psExtraDefinesHash_;
+                cached.shadersVersion_ = pass->GetShadersVersion();
+                cached.sourceIndex_ = j;
+                cached.allowInstancing_ = allowInstancing;
+                cache->batches_.Push(cached);
             }
         }
     }
 }
 
+bool View::CheckBatchCache(Drawable* drawable, const DrawableBatchCache& cache)
+{
+    // A default-constructed entry, or a destroyed drawable whose address was reused, never matches
+    if (cache.drawable_.Get() != drawable)
+        return false;
+
+    Zone* zone = GetZone(drawable);
+    if (zone != cache.zone_ || zone->GetHeightFog() != cache.heightFog_ || GetLightMask(drawable) != cache.lightMask_)
+        return false;
+
+    const Vector<SourceBatch>& batches = drawable->GetBatches();
+    if (batches.Size() != cache.sourceBatches_.Size())
+        return false;
+
+    unsigned shadersChangedFrameNumber = renderer_->GetShadersChangedFrameNumber();
+    unsigned cachedIndex = 0;
+
+    for (unsigned j = 0; j < batches.Size(); ++j)
+    {
+        const SourceBatch& srcBatch = batches[j];
+        const SourceBatch& cachedSrcBatch = cache.sourceBatches_[j];
+        if (srcBatch.geometry_ != cachedSrcBatch.geometry_ || srcBatch.material_ != cachedSrcBatch.material_ ||
+            srcBatch.worldTransform_ != cachedSrcBatch.worldTransform_ ||
+            srcBatch.numWorldTransforms_ != cachedSrcBatch.numWorldTransforms_ ||
+            srcBatch.instancingData_ != cachedSrcBatch.instancingData_ || srcBatch.geometryType_ != cachedSrcBatch.geometryType_)
+            return false;
+
+        if (j < 32 && drawable->HasBasePass(j) != ((cache.basePassFlags_ & (1u << j)) != 0))
+            return false;
+
+        if (srcBatch.material_ && srcBatch.material_->GetAuxViewFrameNumber() != frame_.frameNumber_ && !renderTarget_)
+            CheckMaterialForAuxView(srcBatch.material_);
+
+        // Technique selection depends on the LOD distance, so it is always re-evaluated
+        Technique* tech = GetTechnique(drawable, srcBatch.material_);
+        if (tech != cache.techniques_[j])
+            return false;
+
+        if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
+            continue;
+
+        unsigned char renderOrder = srcBatch.material_ ? srcBatch.material_->GetRenderOrder() : DEFAULT_RENDER_ORDER;
+
+        for (unsigned k = 0; k < scenePasses_.Size(); ++k)
+        {
+            const ScenePassInfo& info = scenePasses_[k];
+            if (info.passIndex_ == basePassIndex_ && j < 32 && drawable->HasBasePass(j))
+                continue;
+
+            Pass* pass = tech->GetSupportedPass(info.passIndex_);
+            if (!pass)
+                continue;
+
+            if (cachedIndex >= cache.batches_.Size())
+                return false;
+
+            const CachedBatch& cached = cache.batches_[cachedIndex++];
+            if (cached.batch_.pass_ != pass || cached.queue_ != info.batchQueue_ || cached.batch_.renderOrder_ != renderOrder)
+                return false;
+
+            // The shaders must not have been released or reloaded since they were chosen
+            if (cached.shadersVersion_ != pass->GetShadersVersion() || pass->GetShadersLoadedFrameNumber() != shadersChangedFrameNumber ||
+                cached.vsExtraDefinesHash_ != info.batchQueue_->vsExtraDefinesHash_ ||
+                cached.psExtraDefinesHash_ != info.batchQueue_->psExtraDefinesHash_)
+                return false;
+
+            bool allowInstancing = info.allowInstancing_;
+            if (allowInstancing && info.markToStencil_ && cache.lightMask_ != (zone->GetLightMask() & 0xff))
+                allowInstancing = false;
+            if (allowInstancing != cached.allowInstancing_)
+                return false;
+        }
+    }
+
+    return cachedIndex == cache.batches_.Size();
+}
+
+void View::AddCachedBatches(Drawable* drawable, const DrawableBatchCache& cache)
+{
+    const Vector<SourceBatch>& batches = drawable->GetBatches();
+
+    for (PODVector<CachedBatch>::ConstIterator i = cache.batches_.Begin(); i != cache.batches_.End(); ++i)
+    {
+        Batch batch(i->batch_);
+        batch.distance_ = batches[i->sourceIndex_].distance_;
+
+        // Instanced batches still need to be grouped, which happens per frame
+        if (batch.geometryType_ == GEOM_INSTANCED)
+            AddBatchToQueue(*i->queue_, batch, cache.techniques_[i->sourceIndex_], true);
+        else
+            PushBatchToQueue(*i->queue_, batch);
+    }
+}
+
 void View::UpdateGeometries()
 {
     // Update geometries in the source view if necessary (prepare order may differ from render order)
@@ -1348,32 +1522,23 @@ void View::UpdateGeometries()
                     *i = nullptr;
                 }
             }
-
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = threadedGeometries_.Size() / numWorkItems;
-
-            PODVector<Drawable*>::Iterator start = threadedGeometries_.Begin();
-            for (int i = 0; i < numWorkItems; ++i)
-            {
-                PODVector<Drawable*>::Iterator end = threadedGeometries_.End();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = UpdateDrawableGeometriesWork;
-                item->aux_ = const_cast<FrameInfo*>(&frame_);
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
         }
 
-        // While the work queue is processed, update non-threaded geometries
+        // While the batch queues are sorted, update non-threaded geometries
         for (PODVector<Drawable*>::ConstIterator i = nonThreadedGeometries_.Begin(); i != nonThreadedGeometries_.End(); ++i)
             (*i)->UpdateGeometry(frame_);
+
+        // Update threaded geometries. This also ensures that the sorting has completed
+        queue->ParallelFor(threadedGeometries_.Size(), 0, [&](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable* drawable = threadedGeometries_[i];
+                // We may leave null pointer holes in the queue if a drawable is found out to require a main thread update
+                if (drawable)
+                    drawable->UpdateGeometry(frame_);
+            }
+        }, &geometryUpdateCost_);
     }
 
     // Finally ensure all threaded work has completed
@@ -2283,7 +2448,6 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     Light* light = query.light_;
     LightType type = light->GetLightType();
     unsigned lightMask = light->GetLightMask();
-    const Frustum& frustum = cullCamera_->GetFrustum();
 
     // Check if light should be shadowed
     bool isShadowed = drawShadows_ && light->GetCastShadows() && !light->GetPerVertex() && light->GetShadowIntensity() < 1.0f;
@@ -2346,39 +2510,44 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     // Determine number of shadow cameras and setup their initial positions
     SetupShadowCameras(query);
 
-    // Process each split for shadow casters
-    query.shadowCasters_.Clear();
-    for (unsigned i = 0; i < query.numSplits_; ++i)
+    // Process each split for shadow casters. Directional light splits have their own work items, which run once this
+    // light is done. Other lights reuse the lit geometry query, which is only available in this thread
+    if (type != LIGHT_DIRECTIONAL)
     {
-        Camera* shadowCamera = query.shadowCameras_[i];
-        const Frustum& shadowCameraFrustum = shadowCamera->GetFrustum();
-        query.shadowCasterBegin_[i] = query.shadowCasterEnd_[i] = query.shadowCasters_.Size();
+        for (unsigned i = 0; i < query.numSplits_; ++i)
+            ProcessShadowSplit(query, i, threadIndex);
+    }
+}
 
-        // For point light check that the face is visible: if not, can skip the split
-        if (type == LIGHT_POINT && frustum.IsInsideFast(BoundingBox(shadowCameraFrustum)) == OUTSIDE)
-            continue;
+void View::ProcessShadowSplit(LightQueryResult& query, unsigned splitIndex, unsigned threadIndex)
+{
+    LightType type = query.light_->GetLightType();
+    const Frustum& frustum = cullCamera_->GetFrustum();
+    PODVector<Drawable*>& tempDrawables = tempDrawables_[threadIndex];
 
-        // For directional light check that the split is inside the visible scene: if not, can skip the split
-        if (type == LIGHT_DIRECTIONAL)
-        {
-            if (minZ_ > query.shadowFarSplits_[i])
-                continue;
-            if (maxZ_ < query.shadowNearSplits_[i])
-                continue;
+    Camera* shadowCamera = query.shadowCameras_[splitIndex];
+    const Frustum& shadowCameraFrustum = shadowCamera->GetFrustum();
+    query.shadowCasters_[splitIndex].Clear();
 
-            // Reuse lit geometry query for all except directional lights
-            ShadowCasterOctreeQuery query(tempDrawables, shadowCameraFrustum, DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
-            octree_->GetDrawables(query);
-        }
+    // For point light check that the face is visible: if not, can skip the split
+    if (type == LIGHT_POINT && frustum.IsInsideFast(BoundingBox(shadowCameraFrustum)) == OUTSIDE)
+        return;
 
-        // Check which shadow casters actually contribute to the shadowing
-        ProcessShadowCasters(query, tempDrawables, i);
+    // For directional light check that the split is inside the visible scene: if not, can skip the split
+    if (type == LIGHT_DIRECTIONAL)
+    {
+        if (minZ_ > query.shadowFarSplits_[splitIndex])
+            return;
+        if (maxZ_ < query.shadowNearSplits_[splitIndex])
+            return;
+
+        // Reuse lit geometry query for all except directional lights
+        ShadowCasterOctreeQuery octreeQuery(tempDrawables, shadowCameraFrustum, DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
+        octree_->GetDrawables(octreeQuery);
     }
 
-    // If no shadow casters, the light can be rendered unshadowed. At this point we have not allocated a shadow map yet, so the
-    // only cost has been the shadow camera setup & queries
-    if (query.shadowCasters_.Empty())
-        query.numSplits_ = 0;
+    // Check which shadow casters actually contribute to the shadowing
+    ProcessShadowCasters(query, tempDrawables, splitIndex);
 }
 
 void View::ProcessShadowCasters(LightQueryResult& query, const PODVector<Drawable*>& drawables, unsigned splitIndex)
@@ -2450,11 +2619,9 @@ void View::ProcessShadowCasters(LightQueryResult& query, const PODVector<Drawabl
                 lightProjBox = lightViewBox.Projected(lightProj);
                 query.shadowCasterBox_[splitIndex].Merge(lightProjBox);
             }
-            query.shadowCasters_.Push(drawable);
+            query.shadowCasters_[splitIndex].Push(drawable);
         }
     }
-
-    query.shadowCasterEnd_[splitIndex] = query.shadowCasters_.Size();
 }
 
 bool View::IsShadowCasterVisible(Drawable* drawable, BoundingBox lightViewBox, Camera* shadowCamera, const Matrix3x4& lightView,
@@ -2912,7 +3079,7 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
     {
         BatchGroupKey key(batch);
 
-        HashMap<BatchGroupKey, BatchGroup>::Iterator i = queue.batchGroups_.Find(key);
+        FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = queue.batchGroups_.Find(key);
         if (i == queue.batchGroups_.End())
         {
             // Create a new group based on the batch
@@ -2938,22 +3105,26 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
     {
         renderer_->SetBatchShaders(batch, tech, allowShadows, queue);
         batch.CalculateSortKey();
+        PushBatchToQueue(queue, batch);
+    }
+}
 
-        // If batch is static with multiple world transforms and cannot instance, we must push copies of the batch individually
-        if (batch.geometryType_ == GEOM_STATIC && batch.numWorldTransforms_ > 1)
+void View::PushBatchToQueue(BatchQueue& queue, const Batch& batch)
+{
+    // If batch is static with multiple world transforms and cannot instance, we must push copies of the batch individually
+    if (batch.geometryType_ == GEOM_STATIC && batch.numWorldTransforms_ > 1)
+    {
+        Batch transformBatch(batch);
+        transformBatch.numWorldTransforms_ = 1;
+        for (unsigned i = 0; i < batch.numWorldTransforms_; ++i)
         {
-            unsigned numTransforms = batch.numWorldTransforms_;
-            batch.numWorldTransforms_ = 1;
-            for (unsigned i = 0; i < numTransforms; ++i)
-            {
-                // Move the transform pointer to generate copies of the batch which only refer to 1 world transform
-                queue.batches_.Push(batch);
-                ++batch.worldTransform_;
-            }
+            // Move the transform pointer to generate copies of the batch which only refer to 1 world transform
+            queue.batches_.Push(transformBatch);
+            ++transformBatch.worldTransform_;
         }
-        else
-            queue.batches_.Push(batch);
     }
+    else
+        queue.batches_.Push(batch);
 }
 
 void View::PrepareInstancingBuffer()
@@ -25,6 +25,7 @@
 #include "../Container/HashSet.h"
 #include "../Container/List.h"
 #include "../Core/Object.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Light.h"
 #include "../Graphics/Zone.h"
@@ -49,7 +50,6 @@ class Texture2D;
 class Viewport;
 class Zone;
 struct RenderPathCommand;
-struct WorkItem;
 
 /// Intermediate light processing result.
 struct LightQueryResult
@@ -58,14 +58,10 @@ struct LightQueryResult
     Light* light_;
     /// Lit geometries.
     PODVector<Drawable*> litGeometries_;
-    /// Shadow casters.
-    PODVector<Drawable*> shadowCasters_;
+    /// Shadow casters per split.
+    PODVector<Drawable*> shadowCasters_[MAX_LIGHT_SPLITS];
     /// Shadow cameras.
     Camera* shadowCameras_[MAX_LIGHT_SPLITS];
-    /// Shadow caster start indices.
-    unsigned shadowCasterBegin_[MAX_LIGHT_SPLITS];
-    /// Shadow caster end indices.
-    unsigned shadowCasterEnd_[MAX_LIGHT_SPLITS];
     /// Combined bounding box of shadow casters in light projection space. Only used for focused spot lights.
     BoundingBox shadowCasterBox_[MAX_LIGHT_SPLITS];
     /// Shadow camera near splits (directional lights only.)
@@ -104,13 +100,56 @@ struct PerThreadSceneResult
     float maxZ_;
 };
 
+/// Base pass batch cached by a view, along with the per-pass inputs it was built from.
+struct CachedBatch
+{
+    /// Batch as added to the queue. Shaders and sort key are resolved unless the batch was converted to instanced.
+    Batch batch_;
+    /// Batch queue the batch was added to.
+    BatchQueue* queue_;
+    /// Vertex shader extra defines hash of the queue.
+    StringHash vsExtraDefinesHash_;
+    /// Pixel shader extra defines hash of the queue.
+    StringHash psExtraDefinesHash_;
+    /// Shader version of the pass when the shaders were chosen.
+    unsigned shadersVersion_;
+    /// Index of the source batch.
+    unsigned sourceIndex_;
+    /// Whether instancing was allowed.
+    bool allowInstancing_;
+};
+
+/// Base pass batches of a drawable cached by a view. Reused on the next frame if the drawable's batch inputs are unchanged.
+struct DrawableBatchCache
+{
+    /// Drawable, used to detect destruction and reuse of the memory address.
+    WeakPtr<Drawable> drawable_;
+    /// Frame number on which the cache was last used.
+    unsigned frameNumber_;
+    /// Zone used for the batches.
+    Zone* zone_;
+    /// Zone height fog flag.
+    bool heightFog_;
+    /// Light mask.
+    unsigned lightMask_;
+    /// Litbase pass flags of the source batches.
+    unsigned basePassFlags_;
+    /// Source batches the cache was built from.
+    Vector<SourceBatch> sourceBatches_;
+    /// Techniques chosen for the source batches.
+    Vector<SharedPtr<Technique> > techniques_;
+    /// Resulting batches.
+    PODVector<CachedBatch> batches_;
+};
+
 static const unsigned MAX_VIEWPORT_TEXTURES = 2;
 
 /// Internal structure for 3D rendering work. Created for each backbuffer and texture viewport, but not for shadow cameras.
 class URHO3D_API View : public Object
 {
-    friend void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex);
+    friend void CheckVisibilityWork(View* view, Drawable** start, Drawable** end, unsigned threadIndex);
     friend void ProcessLightWork(const WorkItem* item, unsigned threadIndex);
+    friend void ProcessShadowSplitWork(const WorkItem* item, unsigned threadIndex);
 
     URHO3D_OBJECT(View, Object);
 
@@ -177,6 +216,12 @@ public:
     /// Return number of occluders that were actually rendered. Occluders may be rejected if running out of triangles or if behind other occluders.
     unsigned GetNumActiveOccluders() const { return activeOccluders_; }
 
+    /// Return number of drawables whose base pass batches were reused from the batch cache.
+    unsigned GetNumBatchCacheHits() const { return numBatchCacheHits_; }
+
+    /// Return number of drawables whose base pass batches were rebuilt while batch caching is enabled.
+    unsigned GetNumBatchCacheMisses() const { return numBatchCacheMisses_; }
+
     /// Return the source view that was already prepared. Used when viewports specify the same culling camera.
     View* GetSourceView() const;
 
@@ -206,6 +251,12 @@ private:
     void GetLightBatches();
     /// Get unlit batches.
     void GetBaseBatches();
+    /// Get unlit batches for a drawable, and record them into the batch cache if given.
+    void GetDrawableBaseBatches(Drawable* drawable, DrawableBatchCache* cache);
+    /// Check whether a drawable's cached unlit batches are still valid.
+    bool CheckBatchCache(Drawable* drawable, const DrawableBatchCache& cache);
+    /// Add a drawable's cached unlit batches to the batch queues.
+    void AddCachedBatches(Drawable* drawable, const DrawableBatchCache& cache);
     /// Update geometries and sort batches.
     void UpdateGeometries();
     /// Get pixel lit batches for a certain light and drawable.
@@ -234,8 +285,10 @@ private:
     void UpdateOccluders(PODVector<Drawable*>& occluders, Camera* camera);
     /// Draw occluders to occlusion buffer.
     void DrawOccluders(OcclusionBuffer* buffer, const PODVector<Drawable*>& occluders);
-    /// Query for lit geometries and shadow casters for a light.
+    /// Query for lit geometries and shadow casters for a light. Directional light shadow splits are left to ProcessShadowSplit() in separate work items.
     void ProcessLight(LightQueryResult& query, unsigned threadIndex);
+    /// Query for shadow casters of a light's shadow split.
+    void ProcessShadowSplit(LightQueryResult& query, unsigned splitIndex, unsigned threadIndex);
     /// Process shadow casters' visibilities and build their combined view- or projection-space bounding box.
     void ProcessShadowCasters(LightQueryResult& query, const PODVector<Drawable*>& drawables, unsigned splitIndex);
     /// Set up initial shadow camera view(s).
@@ -263,6 +316,8 @@ private:
     void SetQueueShaderDefines(BatchQueue& queue, const RenderPathCommand& command);
     /// Choose shaders for a batch and add it to queue.
     void AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, bool allowInstancing = true, bool allowShadows = true);
+    /// Add a non-instanced batch with shaders already chosen to queue. Static batches with multiple world transforms are split.
+    void PushBatchToQueue(BatchQueue& queue, const Batch& batch);
     /// Prepare instancing buffer by filling it with all instance transforms.
     void PrepareInstancingBuffer();
     /// Set up a light volume rendering batch.
@@ -388,6 +443,10 @@ private:
     Vector<PODVector<Drawable*> > tempDrawables_;
     /// Per-thread geometries, lights and Z range collection results.
     Vector<PerThreadSceneResult> sceneResults_;
+    /// Measured cost of the threaded visibility check.
+    ParallelForCost visibilityCost_;
+    /// Measured cost of the threaded geometry update.
+    ParallelForCost geometryUpdateCost_;
     /// Visible zones.
     PODVector<Zone*> zones_;
     /// Visible geometry objects.
@@ -402,6 +461,12 @@ private:
     PODVector<Light*> lights_;
     /// Number of active occluders.
     unsigned activeOccluders_;
+    /// Number of drawables reused from the batch cache.
+    unsigned numBatchCacheHits_;
+    /// Number of drawables rebuilt into the batch cache.
+    unsigned numBatchCacheMisses_;
+    /// Cached base pass batches of drawables visible on the last frame.
+    HashMap<Drawable*, DrawableBatchCache> batchCache_;
 
     /// Drawables that limit their maximum light count.
     HashSet<Drawable*> maxLightsDrawables_;
@@ -50,6 +50,8 @@ public:
     virtual unsigned GetChecksum();
     /// Return whether the end of stream has been reached.
     virtual bool IsEof() const { return position_ >= size_; }
+    /// Return pointer to the stream data at the current position if the whole stream is in memory that stays valid while the stream exists, otherwise null. Allows parsing without copying the data first.
+    virtual const unsigned char* GetContiguousData() const { return nullptr; }
 
     /// Set position relative to current position. Return actual new position.
     unsigned SeekRelative(int delta);
@@ -23,6 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#ifndef MINI_URHO
+#include "../Core/WorkQueue.h"
+#endif
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -33,6 +37,7 @@
 #include <SDL/SDL_rwops.h>
 #endif
 
+#include <atomic>
 #include <cstdio>
 #include <LZ4/lz4.h>
 
@@ -64,6 +69,10 @@ const char* APK = "/apk/";
 static const unsigned READ_BUFFER_SIZE = 32768;
 #endif
 static const unsigned SKIP_BUFFER_SIZE = 1024;
+/// Minimum number of compressed blocks in one read to decompress them in parallel.
+static const unsigned PARALLEL_DECOMPRESS_MIN_BLOCKS = 8;
+/// Number of compressed blocks per parallel decompression work item.
+static const unsigned PARALLEL_DECOMPRESS_GRAIN = 4;
 
 File::File(Context* context) :
     Object(context),
@@ -74,11 +83,15 @@ File::File(Context* context) :
 #endif
     readBufferOffset_(0),
     readBufferSize_(0),
+    inputBufferSize_(0),
+    blockSize_(0),
+    readBufferBlock_(0),
     offset_(0),
     checksum_(0),
     compressed_(false),
     readSyncNeeded_(false),
-    writeSyncNeeded_(false)
+    writeSyncNeeded_(false),
+    mappedData_(nullptr)
 {
 }
 
@@ -91,11 +104,15 @@ File::File(Context* context, const String& fileName, FileMode mode) :
 #endif
     readBufferOffset_(0),
     readBufferSize_(0),
+    inputBufferSize_(0),
+    blockSize_(0),
+    readBufferBlock_(0),
     offset_(0),
     checksum_(0),
     compressed_(false),
     readSyncNeeded_(false),
-    writeSyncNeeded_(false)
+    writeSyncNeeded_(false),
+    mappedData_(nullptr)
 {
     Open(fileName, mode);
 }
@@ -109,11 +126,15 @@ File::File(Context* context, PackageFile* package, const String& fileName) :
 #endif
     readBufferOffset_(0),
     readBufferSize_(0),
+    inputBufferSize_(0),
+    blockSize_(0),
+    readBufferBlock_(0),
     offset_(0),
     checksum_(0),
     compressed_(false),
     readSyncNeeded_(false),
-    writeSyncNeeded_(false)
+    writeSyncNeeded_(false),
+    mappedData_(nullptr)
 {
     Open(package, fileName);
 }
@@ -137,6 +158,25 @@ bool File::Open(PackageFile* package, const String& fileName)
     if (!entry)
         return false;
 
+    // Read straight from the mapped package contents if available, without opening a file handle
+    if (package->IsMemoryMapped())
+    {
+        Close();
+
+        fileName_ = fileName;
+        mode_ = FILE_READ;
+        offset_ = entry->offset_;
+        checksum_ = entry->checksum_;
+        size_ = entry->size_;
+        position_ = 0;
+        compressed_ = false;
+        readSyncNeeded_ = false;
+        writeSyncNeeded_ = false;
+        mappedData_ = package->GetMappedData() + entry->offset_;
+        mappedPackage_ = package;
+        return true;
+    }
+
     bool success = OpenInternal(package->GetName(), FILE_READ, true);
     if (!success)
     {
@@ -152,6 +192,27 @@ bool File::Open(PackageFile* package, const String& fileName)
 
     // Seek to beginning of package entry's file data
     SeekInternal(offset_);
+
+    // Read the block index of a block-indexed compressed file. The compressed blocks follow the index
+    blockSize_ = package->GetBlockSize();
+    if (blockSize_)
+    {
+        unsigned numBlocks = (size_ + blockSize_ - 1) / blockSize_;
+        blockEnds_.Resize(numBlocks);
+        readBufferSize_ = 0;
+        bool validIndex = !numBlocks || ReadInternal(&blockEnds_[0], numBlocks * sizeof(unsigned));
+        offset_ += numBlocks * sizeof(unsigned);
+        for (unsigned i = 0; i < numBlocks && validIndex; ++i)
+            validIndex = blockEnds_[i] >= (i ? blockEnds_[i - 1] : 0) && offset_ + blockEnds_[i] <= package->GetTotalSize();
+
+        if (!validIndex)
+        {
+            URHO3D_LOGERROR("Could not read block index of package file " + fileName);
+            Close();
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -174,6 +235,13 @@ unsigned File::Read(void* dest, unsigned size)
     if (!size)
         return 0;
 
+    if (mappedData_)
+    {
+        memcpy(dest, mappedData_ + position_, size);
+        position_ += size;
+        return size;
+    }
+
 #ifdef __ANDROID__
     if (assetHandle_ && !compressed_)
     {
@@ -209,6 +277,9 @@ unsigned File::Read(void* dest, unsigned size)
     }
 #endif
 
+    if (blockSize_)
+        return ReadBlocks((unsigned char*)dest, size);
+
     if (compressed_)
     {
         unsigned sizeLeft = size;
@@ -282,25 +353,28 @@ unsigned File::Seek(unsigned position)
     if (mode_ == FILE_READ && position > size_)
         position = size_;
 
+    // Memory-mapped and block-indexed compressed files are read from the position on demand
+    if (mappedData_ || blockSize_)
+    {
+        position_ = position;
+        return position_;
+    }
+
     if (compressed_)
     {
-        // Start over from the beginning
-        if (position == 0)
+        // Start over from the beginning when seeking backward, as the blocks can only be decompressed in sequence
+        if (position < position_)
         {
             position_ = 0;
             readBufferOffset_ = 0;
             readBufferSize_ = 0;
             SeekInternal(offset_);
         }
+
         // Skip bytes
-        else if (position >= position_)
-        {
-            unsigned char skipBuffer[SKIP_BUFFER_SIZE];
-            while (position > position_)
-                Read(skipBuffer, Min(position - position_, SKIP_BUFFER_SIZE));
-        }
-        else
-            URHO3D_LOGERROR("Seeking backward in a compressed file is not supported");
+        unsigned char skipBuffer[SKIP_BUFFER_SIZE];
+        while (position > position_)
+            Read(skipBuffer, Min(position - position_, SKIP_BUFFER_SIZE));
 
         return position_;
     }
@@ -393,6 +467,19 @@ void File::Close()
 
     readBuffer_.Reset();
     inputBuffer_.Reset();
+    inputBufferSize_ = 0;
+    blockSize_ = 0;
+    blockEnds_.Clear();
+
+    if (mappedData_)
+    {
+        mappedData_ = nullptr;
+        mappedPackage_.Reset();
+        position_ = 0;
+        size_ = 0;
+        offset_ = 0;
+        checksum_ = 0;
+    }
 
     if (handle_)
     {
@@ -419,9 +506,9 @@ void File::SetName(const String& name)
 bool File::IsOpen() const
 {
 #ifdef __ANDROID__
-    return handle_ != 0 || assetHandle_ != 0;
+    return handle_ != 0 || assetHandle_ != 0 || mappedData_ != 0;
 #else
-    return handle_ != nullptr;
+    return handle_ != nullptr || mappedData_ != nullptr;
 #endif
 }
 
@@ -550,4 +637,108 @@ void File::SeekInternal(unsigned newPosition)
         fseek((FILE*)handle_, newPosition, SEEK_SET);
 }
 
+unsigned File::ReadBlocks(unsigned char* dest, unsigned size)
+{
+    unsigned sizeLeft = size;
+
+    while (sizeLeft)
+    {
+        unsigned block = position_ / blockSize_;
+        unsigned blockOffset = position_ - block * blockSize_;
+        unsigned copySize;
+
+        // Decompress whole blocks, including a shorter last block, directly to the destination
+        unsigned numWholeBlocks = sizeLeft / blockSize_;
+        if (position_ + sizeLeft == size_ && sizeLeft % blockSize_)
+            ++numWholeBlocks;
+
+        if (!blockOffset && numWholeBlocks)
+        {
+            if (!DecompressBlocks(block, numWholeBlocks, dest))
+                break;
+            copySize = Min(numWholeBlocks * blockSize_, sizeLeft);
+        }
+        else
+        {
+            // Partial block: decompress it into the read buffer, unless already there from the previous read
+            if (!readBufferSize_ || readBufferBlock_ != block)
+            {
+                if (!readBuffer_)
+                    readBuffer_ = new unsigned char[blockSize_];
+
+                readBufferSize_ = 0;
+                if (!DecompressBlocks(block, 1, readBuffer_.Get()))
+                    break;
+                readBufferSize_ = Min(blockSize_, size_ - block * blockSize_);
+                readBufferBlock_ = block;
+            }
+
+            copySize = Min(readBufferSize_ - blockOffset, sizeLeft);
+            memcpy(dest, readBuffer_.Get() + blockOffset, copySize);
+        }
+
+        dest += copySize;
+        sizeLeft -= copySize;
+        position_ += copySize;
+    }
+
+    if (sizeLeft)
+        URHO3D_LOGERROR("Error while decompressing file " + GetName());
+
+    return size - sizeLeft;
+}
+
+bool File::DecompressBlocks(unsigned firstBlock, unsigned numBlocks, unsigned char* dest)
+{
+    // Read the compressed data of all the blocks at once
+    unsigned packedStart = firstBlock ? blockEnds_[firstBlock - 1] : 0;
+    unsigned packedEnd = blockEnds_[firstBlock + numBlocks - 1];
+    if (packedEnd < packedStart)
+        return false;
+
+    unsigned packedSize = packedEnd - packedStart;
+    if (inputBufferSize_ < packedSize)
+    {
+        inputBuffer_ = new unsigned char[packedSize];
+        inputBufferSize_ = packedSize;
+    }
+
+    SeekInternal(offset_ + packedStart);
+    if (!ReadInternal(inputBuffer_.Get(), packedSize))
+        return false;
+
+    std::atomic<bool> success(true);
+
+    auto decompress = [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            unsigned block = firstBlock + i;
+            unsigned blockStart = block ? blockEnds_[block - 1] : 0;
+            unsigned blockPackedSize = blockEnds_[block] - blockStart;
+            unsigned blockSize = Min(blockSize_, size_ - block * blockSize_);
+            const char* src = (const char*)inputBuffer_.Get() + (blockStart - packedStart);
+            char* blockDest = (char*)dest + i * blockSize_;
+
+            // Blocks which did not compress are stored as is
+            if (blockPackedSize == blockSize)
+                memcpy(blockDest, src, blockSize);
+            else if (blockPackedSize > blockSize || LZ4_decompress_safe(src, blockDest, blockPackedSize, blockSize) != (int)blockSize)
+                success = false;
+        }
+    };
+
+#ifndef MINI_URHO
+    // The work queue can only be waited on in the main thread. Background loader threads decompress serially,
+    // which still overlaps with other resources being loaded
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (numBlocks >= PARALLEL_DECOMPRESS_MIN_BLOCKS && queue && queue->GetNumThreads() && Thread::IsMainThread())
+        queue->ParallelFor(numBlocks, PARALLEL_DECOMPRESS_GRAIN, decompress);
+    else
+#endif
+        decompress(0, numBlocks, 0);
+
+    return success.load();
+}
+
 }
@@ -107,6 +107,12 @@ public:
     /// Return whether the file originates from a package.
     bool IsPackaged() const { return offset_ != 0; }
 
+    /// Return whether the file is read directly from a memory-mapped package file.
+    bool IsMemoryMapped() const { return mappedData_ != nullptr; }
+
+    /// Return pointer to the file contents at the current position if read from a memory-mapped package file, otherwise null.
+    const unsigned char* GetContiguousData() const override { return mappedData_ ? mappedData_ + position_ : nullptr; }
+
 private:
     /// Open file internally using either C standard IO functions or SDL RWops for Android asset files. Return true if successful.
     bool OpenInternal(const String& fileName, FileMode mode, bool fromPackage = false);
@@ -114,6 +120,10 @@ private:
     bool ReadInternal(void* dest, unsigned size);
     /// Seek in file internally using either C standard IO functions or SDL RWops for Android asset files.
     void SeekInternal(unsigned newPosition);
+    /// Read from a block-indexed compressed package file at the current position. Return number of bytes actually read.
+    unsigned ReadBlocks(unsigned char* dest, unsigned size);
+    /// Decompress consecutive whole blocks of a block-indexed compressed package file. Large ranges are decompressed in parallel on the work queue when called from the main thread. Return true if successful.
+    bool DecompressBlocks(unsigned firstBlock, unsigned numBlocks, unsigned char* dest);
 
     /// File name.
     String fileName_;
@@ -133,6 +143,14 @@ private:
     unsigned readBufferOffset_;
     /// Bytes in the current read buffer.
     unsigned readBufferSize_;
+    /// Allocated size of the decompression input buffer.
+    unsigned inputBufferSize_;
+    /// Uncompressed block size of a block-indexed compressed package file, 0 if the file can only be read sequentially.
+    unsigned blockSize_;
+    /// Index of the block in the read buffer of a block-indexed compressed package file.
+    unsigned readBufferBlock_;
+    /// End offsets of the compressed blocks, relative to the end of the block index.
+    PODVector<unsigned> blockEnds_;
     /// Start position within a package file, 0 for regular files.
     unsigned offset_;
     /// Content checksum.
@@ -143,6 +161,10 @@ private:
     bool readSyncNeeded_;
     /// Synchronization needed before write -flag.
     bool writeSyncNeeded_;
+    /// File contents within a memory-mapped package file.
+    const unsigned char* mappedData_;
+    /// Memory-mapped package file, held to keep the mapping valid while the file is open.
+    SharedPtr<PackageFile> mappedPackage_;
 };
 
 }
@@ -22,6 +22,8 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/ArrayPtr.h"
+#include "../Core/Condition.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
@@ -32,6 +34,7 @@
 #include "../IO/Log.h"
 
 #include <cstdio>
+#include <ctime>
 
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -58,6 +61,190 @@ const char* logLevelPrefixes[] =
 static Log* logInstance = nullptr;
 static bool threadErrorDisplayed = false;
 
+/// Capacity of the writer thread's message queue. Must be a power of two.
+static const unsigned LOG_QUEUE_CAPACITY = 4096;
+
+/// Log message on its way to the output.
+struct LogOutputMessage
+{
+    /// Construct.
+    LogOutputMessage() :
+        time_(0),
+        level_(LOG_INFO),
+        error_(false),
+        mainThread_(true)
+    {
+    }
+
+    /// Message text.
+    String message_;
+    /// Message with the level prefix and timestamp, or the message text for raw messages.
+    String formattedMessage_;
+    /// Time of writing the message.
+    time_t time_;
+    /// Message level. -1 for raw messages.
+    int level_;
+    /// Error flag for raw messages.
+    bool error_;
+    /// Whether written from the main thread. Messages from other threads are passed back to the main thread after output for the log message event.
+    bool mainThread_;
+};
+
+/// Return a timestamp in the same format as Time::GetTimeStamp(). Safe to call from any thread.
+static String GetLogTimeStamp(time_t sysTime)
+{
+    char dateTime[32];
+#ifdef _WIN32
+    ctime_s(dateTime, sizeof dateTime, &sysTime);
+#else
+    ctime_r(&sysTime, dateTime);
+#endif
+    return String(dateTime).Replaced("\n", "");
+}
+
+/// Return a UTC timestamp in ISO 8601 format. Safe to call from any thread.
+static String GetISOTimeStamp(time_t sysTime)
+{
+    tm utcTime;
+#ifdef _WIN32
+    gmtime_s(&utcTime, &sysTime);
+#else
+    gmtime_r(&sysTime, &utcTime);
+#endif
+    char dateTime[32];
+    strftime(dateTime, sizeof dateTime, "%Y-%m-%dT%H:%M:%SZ", &utcTime);
+    return String(dateTime);
+}
+
+/// Log writer thread. Messages are passed to it through a bounded lock-free queue with multiple producers.
+class LogWriter : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit LogWriter(Log* owner) :
+        owner_(owner),
+        slots_(new Slot[LOG_QUEUE_CAPACITY]),
+        pushPosition_(0),
+        popPosition_(0),
+        waiting_(false)
+    {
+        for (unsigned i = 0; i < LOG_QUEUE_CAPACITY; ++i)
+            slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    /// Add a message to the queue and wake up the thread if it is waiting. Return false if the queue is full.
+    bool Push(LogOutputMessage& message)
+    {
+        unsigned position = pushPosition_.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;)
+        {
+            slot = &slots_[position & (LOG_QUEUE_CAPACITY - 1)];
+            unsigned sequence = slot->sequence_.load(std::memory_order_acquire);
+            auto difference = (int)(sequence - position);
+
+            // The slot is free for this position: try to claim it
+            if (!difference)
+            {
+                if (pushPosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            // The slot still holds a message one lap behind: the queue is full
+            else if (difference < 0)
+                return false;
+            else
+                position = pushPosition_.load(std::memory_order_relaxed);
+        }
+
+        Swap(slot->message_, message);
+        slot->sequence_.store(position + 1, std::memory_order_release);
+
+        // Pairs with the fence in ThreadFunction(): either this sees the thread waiting, or the thread sees the message
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_relaxed))
+            wakeCondition_.Set();
+        return true;
+    }
+
+    /// Take the next message from the queue. Return false if empty. Called only by the writer thread, or by the main thread after the writer thread has stopped.
+    bool Pop(LogOutputMessage& message)
+    {
+        Slot& slot = slots_[popPosition_ & (LOG_QUEUE_CAPACITY - 1)];
+        if (slot.sequence_.load(std::memory_order_acquire) != popPosition_ + 1)
+            return false;
+
+        Swap(message, slot.message_);
+        slot.sequence_.store(popPosition_ + LOG_QUEUE_CAPACITY, std::memory_order_release);
+        ++popPosition_;
+        return true;
+    }
+
+    /// Output queued messages until stopped.
+    void ThreadFunction() override
+    {
+        for (;;)
+        {
+            LogOutputMessage message;
+            while (Pop(message))
+                owner_->OutputMessage(message);
+
+            if (!shouldRun_)
+                break;
+
+            // Sleep until a message is pushed. Check the queue again after announcing, as a message may have been pushed before
+            waiting_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (slots_[popPosition_ & (LOG_QUEUE_CAPACITY - 1)].sequence_.load(std::memory_order_acquire) != popPosition_ + 1 &&
+                shouldRun_)
+                wakeCondition_.Wait();
+            waiting_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /// Stop the thread after it has output the queued messages.
+    void Shutdown()
+    {
+        shouldRun_ = false;
+        wakeCondition_.Set();
+        Stop();
+    }
+
+private:
+    /// Queue slot.
+    struct Slot
+    {
+        /// Position in the queue at which the slot can be claimed for pushing, or one past it when the slot holds a message.
+        std::atomic<unsigned> sequence_;
+        /// Message.
+        LogOutputMessage message_;
+    };
+
+    /// Swap message contents without allocating.
+    static void Swap(LogOutputMessage& first, LogOutputMessage& second)
+    {
+        first.message_.Swap(second.message_);
+        first.formattedMessage_.Swap(second.formattedMessage_);
+        Urho3D::Swap(first.time_, second.time_);
+        Urho3D::Swap(first.level_, second.level_);
+        Urho3D::Swap(first.error_, second.error_);
+        Urho3D::Swap(first.mainThread_, second.mainThread_);
+    }
+
+    /// Log subsystem.
+    Log* owner_;
+    /// Queue slots.
+    SharedArrayPtr<Slot> slots_;
+    /// Total number of positions claimed by producers.
+    std::atomic<unsigned> pushPosition_;
+    /// Total number of messages taken by the consumer.
+    unsigned popPosition_;
+    /// Flag for the thread waiting for messages.
+    std::atomic<bool> waiting_;
+    /// Condition for waking up the thread.
+    Condition wakeCondition_;
+};
+
 Log::Log(Context* context) :
     Object(context),
 #ifdef _DEBUG
@@ -67,7 +254,13 @@ Log::Log(Context* context) :
 #endif
     timeStamp_(true),
     inWrite_(false),
-    quiet_(false)
+    quiet_(false),
+    lastOutputLevel_(LOG_NONE),
+    numRepeats_(0),
+    maxRepeats_(0),
+    async_(false),
+    numDroppedMessages_(0),
+    numSuppressedMessages_(0)
 {
     logInstance = this;
 
@@ -76,7 +269,11 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    SetAsync(false);
+    OutputQueuedMessages();
+    FlushRepeats();
     logInstance = nullptr;
+    writer_.Reset();
 }
 
 void Log::Open(const String& fileName)
@@ -92,20 +289,24 @@ void Log::Open(const String& fileName)
             Close();
     }
 
-    logFile_ = new File(context_);
-    if (logFile_->Open(fileName, FILE_WRITE))
+    SharedPtr<File> logFile(new File(context_));
+    if (logFile->Open(fileName, FILE_WRITE))
+    {
+        {
+            MutexLock lock(outputMutex_);
+            logFile_ = logFile;
+        }
         Write(LOG_INFO, "Opened log file " + fileName);
+    }
     else
-    {
-        logFile_.Reset();
         Write(LOG_ERROR, "Failed to create log file " + fileName);
-    }
 #endif
 }
 
 void Log::Close()
 {
 #if !defined(__ANDROID__) && !defined(IOS) && !defined(TVOS)
+    MutexLock lock(outputMutex_);
     if (logFile_ && logFile_->IsOpen())
     {
         logFile_->Close();
@@ -114,6 +315,41 @@ void Log::Close()
 #endif
 }
 
+void Log::OpenJSON(const String& fileName)
+{
+    if (fileName.Empty())
+        return;
+    if (jsonFile_ && jsonFile_->IsOpen())
+    {
+        if (jsonFile_->GetName() == fileName)
+            return;
+        else
+            CloseJSON();
+    }
+
+    SharedPtr<File> jsonFile(new File(context_));
+    if (jsonFile->Open(fileName, FILE_WRITE))
+    {
+        {
+            MutexLock lock(outputMutex_);
+            jsonFile_ = jsonFile;
+        }
+        Write(LOG_INFO, "Opened structured log file " + fileName);
+    }
+    else
+        Write(LOG_ERROR, "Failed to create structured log file " + fileName);
+}
+
+void Log::CloseJSON()
+{
+    MutexLock lock(outputMutex_);
+    if (jsonFile_ && jsonFile_->IsOpen())
+    {
+        jsonFile_->Close();
+        jsonFile_.Reset();
+    }
+}
+
 void Log::SetLevel(int level)
 {
     if (level < LOG_TRACE || level > LOG_NONE)
@@ -135,6 +371,46 @@ void Log::SetQuiet(bool quiet)
     quiet_ = quiet;
 }
 
+void Log::SetAsync(bool enable)
+{
+#ifdef URHO3D_THREADING
+    if (enable == IsAsync())
+        return;
+
+    if (enable)
+    {
+        // A previously stopped writer thread is restarted, and outputs any messages still in its queue
+        if (!writer_)
+            writer_ = new LogWriter(this);
+        if (writer_->Run())
+            async_.store(true, std::memory_order_release);
+        else
+            URHO3D_LOGERROR("Failed to start log writer thread");
+    }
+    else
+    {
+        // Other threads may still push messages after the flag is cleared. The writer is not destroyed, and whatever they
+        // managed to queue after the writer thread stopped is output here, or at the end of the next frame
+        async_.store(false, std::memory_order_release);
+        writer_->Shutdown();
+        OutputQueuedMessages();
+        FlushRepeats();
+    }
+#endif
+}
+
+void Log::SetMaxRepeats(unsigned count)
+{
+    MutexLock lock(outputMutex_);
+    OutputRepeatSummary(time(nullptr), true);
+    maxRepeats_ = count;
+}
+
+bool Log::IsAsync() const
+{
+    return async_.load(std::memory_order_acquire);
+}
+
 void Log::Write(int level, const String& message)
 {
     // Special case for LOG_RAW level
@@ -148,11 +424,27 @@ void Log::Write(int level, const String& message)
     if (level < LOG_TRACE || level >= LOG_NONE)
         return;
 
-    // If not in the main thread, store message for later processing
+    // If not in the main thread, store message for later processing. If there is a writer thread, it outputs the message
+    // right away and then passes it on to the main thread
     if (!Thread::IsMainThread())
     {
         if (logInstance)
         {
+            if (logInstance->IsAsync())
+            {
+                if (logInstance->level_ > level)
+                    return;
+
+                LogOutputMessage outputMessage;
+                outputMessage.message_ = message;
+                outputMessage.time_ = time(nullptr);
+                outputMessage.level_ = level;
+                outputMessage.error_ = false;
+                outputMessage.mainThread_ = false;
+                logInstance->Output(outputMessage);
+                return;
+            }
+
             MutexLock lock(logInstance->logMutex_);
             logInstance->threadMessages_.Push(StoredLogMessage(message, level, false));
         }
@@ -164,45 +456,15 @@ void Log::Write(int level, const String& message)
     if (!logInstance || logInstance->level_ > level || logInstance->inWrite_)
         return;
 
-    String formattedMessage = logLevelPrefixes[level];
-    formattedMessage += ": " + message;
-    logInstance->lastMessage_ = message;
-
-    if (logInstance->timeStamp_)
-        formattedMessage = "[" + Time::GetTimeStamp() + "] " + formattedMessage;
-
-#if defined(__ANDROID__)
-    int androidLevel = ANDROID_LOG_VERBOSE + level;
-    __android_log_print(androidLevel, "Urho3D", "%s", message.CString());
-#elif defined(IOS) || defined(TVOS)
-    SDL_IOS_LogMessage(message.CString());
-#else
-    if (logInstance->quiet_)
-    {
-        // If in quiet mode, still print the error message to the standard error stream
-        if (level == LOG_ERROR)
-            PrintUnicodeLine(formattedMessage, true);
-    }
-    else
-        PrintUnicodeLine(formattedMessage, level == LOG_ERROR);
-#endif
-
-    if (logInstance->logFile_)
-    {
-        logInstance->logFile_->WriteLine(formattedMessage);
-        logInstance->logFile_->Flush();
-    }
-
-    logInstance->inWrite_ = true;
+    LogOutputMessage outputMessage;
+    outputMessage.message_ = message;
+    outputMessage.time_ = time(nullptr);
+    outputMessage.level_ = level;
+    outputMessage.error_ = false;
+    outputMessage.mainThread_ = true;
+    logInstance->Output(outputMessage);
 
-    using namespace LogMessage;
-
-    VariantMap& eventData = logInstance->GetEventDataMap();
-    eventData[P_MESSAGE] = formattedMessage;
-    eventData[P_LEVEL] = level;
-    logInstance->SendEvent(E_LOGMESSAGE, eventData);
-
-    logInstance->inWrite_ = false;
+    logInstance->SendMessageEvent(message, outputMessage.formattedMessage_, level);
 }
 
 void Log::WriteRaw(const String& message, bool error)
@@ -212,6 +474,18 @@ void Log::WriteRaw(const String& message, bool error)
     {
         if (logInstance)
         {
+            if (logInstance->IsAsync())
+            {
+                LogOutputMessage outputMessage;
+                outputMessage.message_ = message;
+                outputMessage.time_ = time(nullptr);
+                outputMessage.level_ = LOG_RAW;
+                outputMessage.error_ = error;
+                outputMessage.mainThread_ = false;
+                logInstance->Output(outputMessage);
+                return;
+            }
+
             MutexLock lock(logInstance->logMutex_);
             logInstance->threadMessages_.Push(StoredLogMessage(message, LOG_RAW, error));
         }
@@ -223,45 +497,194 @@ void Log::WriteRaw(const String& message, bool error)
     if (!logInstance || logInstance->inWrite_)
         return;
 
-    logInstance->lastMessage_ = message;
+    LogOutputMessage outputMessage;
+    outputMessage.message_ = message;
+    outputMessage.time_ = time(nullptr);
+    outputMessage.level_ = LOG_RAW;
+    outputMessage.error_ = error;
+    outputMessage.mainThread_ = true;
+    logInstance->Output(outputMessage);
+
+    logInstance->SendMessageEvent(message, message, error ? LOG_ERROR : LOG_INFO);
+}
+
+bool Log::Output(LogOutputMessage& message)
+{
+    if (message.level_ != LOG_RAW)
+    {
+        message.formattedMessage_ = logLevelPrefixes[message.level_];
+        message.formattedMessage_ += ": " + message.message_;
+        if (timeStamp_)
+            message.formattedMessage_ = "[" + GetLogTimeStamp(message.time_) + "] " + message.formattedMessage_;
+    }
+    else
+        message.formattedMessage_ = message.message_;
+
+    // If asynchronous output was disabled meanwhile, a message from another thread is output directly, which is also safe
+    if (!IsAsync())
+    {
+        OutputMessage(message);
+        return true;
+    }
+
+    // The writer thread takes the message contents, so keep the formatted message for the log event
+    String formattedMessage = message.formattedMessage_;
+    bool success = writer_->Push(message);
+    if (!success)
+        ++numDroppedMessages_;
+    message.formattedMessage_ = formattedMessage;
+    return success;
+}
+
+void Log::OutputMessage(const LogOutputMessage& message)
+{
+    {
+        MutexLock lock(outputMutex_);
+        bool suppressed = false;
+
+        if (maxRepeats_)
+        {
+            if (message.level_ == lastOutputLevel_ && message.message_ == lastOutputMessage_)
+            {
+                if (++numRepeats_ > maxRepeats_)
+                {
+                    ++numSuppressedMessages_;
+                    suppressed = true;
+                }
+            }
+            else
+            {
+                // Summarize the suppressed repeats of the previous message before outputting a different one
+                OutputRepeatSummary(message.time_, message.mainThread_);
+                lastOutputMessage_ = message.message_;
+                lastOutputLevel_ = message.level_;
+                numRepeats_ = 1;
+            }
+        }
+
+        if (!suppressed)
+            OutputToSinks(message);
+    }
+
+    // Messages from other threads are passed on to the main thread for the log message event
+    if (!message.mainThread_)
+    {
+        StoredLogMessage stored(message.message_, message.level_, message.error_);
+        stored.formattedMessage_ = message.formattedMessage_;
+        MutexLock lock(logMutex_);
+        threadMessages_.Push(stored);
+    }
+}
+
+void Log::OutputToSinks(const LogOutputMessage& message)
+{
+    const String& formattedMessage = message.formattedMessage_;
+    bool raw = message.level_ == LOG_RAW;
+    bool error = raw ? message.error_ : message.level_ == LOG_ERROR;
 
 #if defined(__ANDROID__)
-    if (logInstance->quiet_)
+    if (raw)
     {
-        if (error)
-            __android_log_print(ANDROID_LOG_ERROR, "Urho3D", "%s", message.CString());
+        if (quiet_)
+        {
+            if (error)
+                __android_log_print(ANDROID_LOG_ERROR, "Urho3D", "%s", message.message_.CString());
+        }
+        else
+            __android_log_print(error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "Urho3D", "%s", message.message_.CString());
     }
     else
-        __android_log_print(error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "Urho3D", "%s", message.CString());
+    {
+        int androidLevel = ANDROID_LOG_VERBOSE + message.level_;
+        __android_log_print(androidLevel, "Urho3D", "%s", message.message_.CString());
+    }
 #elif defined(IOS) || defined(TVOS)
-    SDL_IOS_LogMessage(message.CString());
+    SDL_IOS_LogMessage(message.message_.CString());
 #else
-    if (logInstance->quiet_)
+    // If in quiet mode, still print the error message to the standard error stream
+    if (!quiet_ || error)
     {
-        // If in quiet mode, still print the error message to the standard error stream
-        if (error)
-            PrintUnicode(message, true);
+        if (raw)
+            PrintUnicode(formattedMessage, error);
+        else
+            PrintUnicodeLine(formattedMessage, error);
     }
-    else
-        PrintUnicode(message, error);
 #endif
 
-    if (logInstance->logFile_)
+    if (logFile_)
+    {
+        if (raw)
+            logFile_->Write(formattedMessage.CString(), formattedMessage.Length());
+        else
+            logFile_->WriteLine(formattedMessage);
+        logFile_->Flush();
+    }
+
+    if (jsonFile_)
     {
-        logInstance->logFile_->Write(message.CString(), message.Length());
-        logInstance->logFile_->Flush();
+        String line = "{\"time\":\"" + GetISOTimeStamp(message.time_) + "\",\"level\":\"";
+        line += raw ? (error ? "ERROR" : "INFO") : logLevelPrefixes[message.level_];
+        line += "\",\"thread\":\"";
+        line += message.mainThread_ ? "main" : "worker";
+        line += "\",\"raw\":";
+        line += raw ? "true" : "false";
+        line += ",\"message\":";
+        AppendJSONString(line, message.message_.CString());
+        line += "}";
+        jsonFile_->WriteLine(line);
+        jsonFile_->Flush();
     }
+}
+
+void Log::OutputRepeatSummary(time_t sysTime, bool mainThread)
+{
+    if (!maxRepeats_ || numRepeats_ <= maxRepeats_)
+        return;
 
-    logInstance->inWrite_ = true;
+    LogOutputMessage summary;
+    summary.message_ = ToString("Previous message repeated %u more times", numRepeats_ - maxRepeats_);
+    summary.time_ = sysTime;
+    summary.level_ = lastOutputLevel_ == LOG_RAW ? LOG_INFO : lastOutputLevel_;
+    summary.error_ = false;
+    summary.mainThread_ = mainThread;
+    summary.formattedMessage_ = String(logLevelPrefixes[summary.level_]) + ": " + summary.message_;
+    if (timeStamp_)
+        summary.formattedMessage_ = "[" + GetLogTimeStamp(summary.time_) + "] " + summary.formattedMessage_;
+    OutputToSinks(summary);
+
+    // Further repeats are counted again from the start
+    numRepeats_ = 1;
+}
+
+void Log::FlushRepeats()
+{
+    MutexLock lock(outputMutex_);
+    OutputRepeatSummary(time(nullptr), true);
+}
+
+void Log::OutputQueuedMessages()
+{
+    if (!writer_)
+        return;
+
+    LogOutputMessage message;
+    while (writer_->Pop(message))
+        OutputMessage(message);
+}
+
+void Log::SendMessageEvent(const String& message, const String& formattedMessage, int level)
+{
+    lastMessage_ = message;
+    inWrite_ = true;
 
     using namespace LogMessage;
 
-    VariantMap& eventData = logInstance->GetEventDataMap();
-    eventData[P_MESSAGE] = message;
-    eventData[P_LEVEL] = error ? LOG_ERROR : LOG_INFO;
-    logInstance->SendEvent(E_LOGMESSAGE, eventData);
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_MESSAGE] = formattedMessage;
+    eventData[P_LEVEL] = level;
+    SendEvent(E_LOGMESSAGE, eventData);
 
-    logInstance->inWrite_ = false;
+    inWrite_ = false;
 }
 
 void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
@@ -277,14 +700,24 @@ void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
         return;
     }
 
+    // Output messages that other threads queued for the writer thread after it was stopped
+    if (!IsAsync())
+        OutputQueuedMessages();
+
     MutexLock lock(logMutex_);
 
-    // Process messages accumulated from other threads (if any)
+    // Process messages accumulated from other threads (if any). Messages already output by the writer thread only need the event
     while (!threadMessages_.Empty())
     {
         const StoredLogMessage& stored = threadMessages_.Front();
 
-        if (stored.level_ != LOG_RAW)
+        if (!stored.formattedMessage_.Empty())
+        {
+            if (!inWrite_)
+                SendMessageEvent(stored.message_, stored.formattedMessage_, stored.level_ != LOG_RAW ? stored.level_ :
+                    (stored.error_ ? LOG_ERROR : LOG_INFO));
+        }
+        else if (stored.level_ != LOG_RAW)
             Write(stored.level_, stored.message_);
         else
             WriteRaw(stored.message_, stored.error_);
@@ -27,6 +27,9 @@
 #include "../Core/Object.h"
 #include "../Core/StringUtils.h"
 
+#include <atomic>
+#include <ctime>
+
 namespace Urho3D
 {
 
@@ -46,6 +49,8 @@ static const int LOG_ERROR = 4;
 static const int LOG_NONE = 5;
 
 class File;
+class LogWriter;
+struct LogOutputMessage;
 
 /// Stored log message from another thread.
 struct StoredLogMessage
@@ -67,6 +72,8 @@ struct StoredLogMessage
     int level_;
     /// Error flag for raw messages.
     bool error_;
+    /// Message as output with the level prefix and timestamp, if already output by the writer thread. Otherwise empty.
+    String formattedMessage_;
 };
 
 /// Logging subsystem.
@@ -90,6 +97,14 @@ public:
     void SetTimeStamp(bool enable);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     void SetQuiet(bool quiet);
+    /// Set whether to output log messages in a dedicated writer thread. Messages are then passed to it through a lock-free queue, so that writing does not stall the calling thread, and messages from other threads are output without waiting for the main thread. Log message events are still sent in the main thread. Has no effect if threading is disabled.
+    void SetAsync(bool enable);
+    /// Open a structured log file, where each message is written as a JSON object on its own line.
+    void OpenJSON(const String& fileName);
+    /// Close the structured log file.
+    void CloseJSON();
+    /// Set maximum number of consecutive identical messages to output. Further repeats are counted and summarized when a different message is output. 0 (default) disables the limit.
+    void SetMaxRepeats(unsigned count);
 
     /// Return logging level.
     int GetLevel() const { return level_; }
@@ -103,21 +118,55 @@ public:
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     bool IsQuiet() const { return quiet_; }
 
+    /// Return whether log messages are output in a dedicated writer thread.
+    bool IsAsync() const;
+
+    /// Return maximum number of consecutive identical messages to output.
+    unsigned GetMaxRepeats() const { return maxRepeats_; }
+
+    /// Return number of messages dropped because the writer thread's queue was full.
+    unsigned GetNumDroppedMessages() const { return numDroppedMessages_; }
+
+    /// Return number of repeated messages suppressed by the repeat limit.
+    unsigned GetNumSuppressedMessages() const { return numSuppressedMessages_; }
+
     /// Write to the log. If logging level is higher than the level of the message, the message is ignored.
     static void Write(int level, const String& message);
     /// Write raw output to the log.
     static void WriteRaw(const String& message, bool error = false);
 
 private:
+    friend class LogWriter;
+
     /// Handle end of frame. Process the threaded log messages.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Pass a message to the writer thread if asynchronous, otherwise output it immediately. Return false if the writer thread's queue was full.
+    bool Output(LogOutputMessage& message);
+    /// Output a message, applying the repeat limit. Called in the main thread, or in the writer thread if asynchronous.
+    void OutputMessage(const LogOutputMessage& message);
+    /// Output a message to the standard output, the log file and the structured log file.
+    void OutputToSinks(const LogOutputMessage& message);
+    /// Output the summary of the suppressed repeats of the last message, if any. Requires the output mutex to be locked.
+    void OutputRepeatSummary(time_t sysTime, bool mainThread);
+    /// Output the summary of the suppressed repeats of the last message, if any.
+    void FlushRepeats();
+    /// Output the messages left in the writer thread's queue. Called in the main thread when the writer thread is not running.
+    void OutputQueuedMessages();
+    /// Send the log message event and remember the last message.
+    void SendMessageEvent(const String& message, const String& formattedMessage, int level);
 
     /// Mutex for threaded operation.
     Mutex logMutex_;
+    /// Mutex for the output sinks, which the writer thread uses while they are opened and closed.
+    Mutex outputMutex_;
     /// Log messages from other threads.
     List<StoredLogMessage> threadMessages_;
     /// Log file.
     SharedPtr<File> logFile_;
+    /// Structured log file.
+    SharedPtr<File> jsonFile_;
+    /// Writer thread. Kept until the log is destroyed once created, so that other threads can push to it while asynchronous output is being disabled.
+    SharedPtr<LogWriter> writer_;
     /// Last log message.
     String lastMessage_;
     /// Logging level.
@@ -128,6 +177,20 @@ private:
     bool inWrite_;
     /// Quiet mode flag.
     bool quiet_;
+    /// Last message text subject to the repeat limit.
+    String lastOutputMessage_;
+    /// Level of the last message subject to the repeat limit.
+    int lastOutputLevel_;
+    /// Consecutive outputs of the last message.
+    unsigned numRepeats_;
+    /// Maximum consecutive identical messages to output.
+    unsigned maxRepeats_;
+    /// Whether messages are passed to the writer thread.
+    std::atomic<bool> async_;
+    /// Messages dropped because the writer thread's queue was full.
+    std::atomic<unsigned> numDroppedMessages_;
+    /// Messages suppressed by the repeat limit.
+    std::atomic<unsigned> numSuppressedMessages_;
 };
 
 #ifdef URHO3D_LOGGING
@@ -53,6 +53,9 @@ public:
     /// Return whether buffer is read-only.
     bool IsReadOnly() { return readOnly_; }
 
+    /// Return pointer to the memory area at the current position.
+    const unsigned char* GetContiguousData() const override { return buffer_ ? buffer_ + position_ : nullptr; }
+
 private:
     /// Pointer to the memory area.
     unsigned char* buffer_;
@@ -23,9 +23,18 @@
 #include "../Precompiled.h"
 
 #include "../IO/File.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/PackageFile.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace Urho3D
 {
 
@@ -34,7 +43,9 @@ PackageFile::PackageFile(Context* context) :
     totalSize_(0),
     totalDataSize_(0),
     checksum_(0),
-    compressed_(false)
+    blockSize_(0),
+    compressed_(false),
+    mappedData_(nullptr)
 {
 }
 
@@ -43,15 +54,22 @@ PackageFile::PackageFile(Context* context, const String& fileName, unsigned star
     totalSize_(0),
     totalDataSize_(0),
     checksum_(0),
-    compressed_(false)
+    blockSize_(0),
+    compressed_(false),
+    mappedData_(nullptr)
 {
     Open(fileName, startOffset);
 }
 
-PackageFile::~PackageFile() = default;
+PackageFile::~PackageFile()
+{
+    Unmap();
+}
 
 bool PackageFile::Open(const String& fileName, unsigned startOffset)
 {
+    Unmap();
+
     SharedPtr<File> file(new File(context_, fileName));
     if (!file->IsOpen())
         return false;
@@ -59,7 +77,7 @@ bool PackageFile::Open(const String& fileName, unsigned startOffset)
     // Check ID, then read the directory
     file->Seek(startOffset);
     String id = file->ReadFileID();
-    if (id != "UPAK" && id != "ULZ4")
+    if (id != "UPAK" && id != "ULZ4" && id != "ULZI")
     {
         // If start offset has not been explicitly specified, also try to read package size from the end of file
         // to know how much we must rewind to find the package start
@@ -76,7 +94,7 @@ bool PackageFile::Open(const String& fileName, unsigned startOffset)
             }
         }
 
-        if (id != "UPAK" && id != "ULZ4")
+        if (id != "UPAK" && id != "ULZ4" && id != "ULZI")
         {
             URHO3D_LOGERROR(fileName + " is not a valid package file");
             return false;
@@ -86,11 +104,19 @@ bool PackageFile::Open(const String& fileName, unsigned startOffset)
     fileName_ = fileName;
     nameHash_ = fileName_;
     totalSize_ = file->GetSize();
-    compressed_ = id == "ULZ4";
+    compressed_ = id != "UPAK";
 
     unsigned numFiles = file->ReadUInt();
     checksum_ = file->ReadUInt();
 
+    // Block-indexed packages store the uncompressed block size in the header, and a block offset index before each file's data
+    blockSize_ = id == "ULZI" ? file->ReadUInt() : 0;
+    if (id == "ULZI" && !blockSize_)
+    {
+        URHO3D_LOGERROR(fileName + " has an invalid compression block size");
+        return false;
+    }
+
     for (unsigned i = 0; i < numFiles; ++i)
     {
         String entryName = file->ReadString();
@@ -107,6 +133,11 @@ bool PackageFile::Open(const String& fileName, unsigned startOffset)
             entries_[entryName] = newEntry;
     }
 
+    // Map uncompressed packages so that files can be read from them without per-file handles and seeks.
+    // If mapping fails, files are opened through the filesystem as before
+    if (!compressed_)
+        Map();
+
     return true;
 }
 
@@ -153,4 +184,60 @@ const PackageEntry* PackageFile::GetEntry(const String& fileName) const
     return nullptr;
 }
 
+bool PackageFile::Map()
+{
+    if (!totalSize_)
+        return false;
+
+#ifdef __ANDROID__
+    // Files inside the APK can not be mapped by name
+    if (URHO3D_IS_ASSET(fileName_))
+        return false;
+#endif
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(GetWideNativePath(fileName_).CString(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+    {
+        mappedData_ = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // The view keeps the file mapped after the handles are closed
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#elif !defined(__EMSCRIPTEN__)
+    int fd = open(GetNativePath(fileName_).CString(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    void* data = mmap(nullptr, totalSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+        mappedData_ = (const unsigned char*)data;
+    // The mapping keeps the file mapped after the descriptor is closed
+    close(fd);
+#endif
+
+    if (!mappedData_)
+        URHO3D_LOGWARNING("Could not memory-map package file " + fileName_ + ", reading files through file handles instead");
+
+    return mappedData_ != nullptr;
+}
+
+void PackageFile::Unmap()
+{
+    if (!mappedData_)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(mappedData_);
+#elif !defined(__EMSCRIPTEN__)
+    munmap(const_cast<unsigned char*>(mappedData_), totalSize_);
+#endif
+    mappedData_ = nullptr;
+}
+
 }
@@ -82,10 +82,24 @@ public:
     /// Return whether the files are compressed.
     bool IsCompressed() const { return compressed_; }
 
+    /// Return the uncompressed block size if the files are compressed in independently seekable blocks, or 0 if compressed files can only be read sequentially.
+    unsigned GetBlockSize() const { return blockSize_; }
+
+    /// Return whether the package file is memory-mapped. Uncompressed packages are mapped when the platform supports it.
+    bool IsMemoryMapped() const { return mappedData_ != nullptr; }
+
+    /// Return the memory-mapped package file contents, or null if not mapped. Entry offsets are relative to this.
+    const unsigned char* GetMappedData() const { return mappedData_; }
+
     /// Return list of file names in the package.
     const Vector<String> GetEntryNames() const { return entries_.Keys(); }
 
 private:
+    /// Map the package file read-only into memory. Return true if successful.
+    bool Map();
+    /// Unmap the package file.
+    void Unmap();
+
     /// File entries.
     HashMap<String, PackageEntry> entries_;
     /// File name.
@@ -98,8 +112,12 @@ private:
     unsigned totalDataSize_;
     /// Package file checksum.
     unsigned checksum_;
+    /// Uncompressed block size of a block-indexed compressed package file.
+    unsigned blockSize_;
     /// Compressed flag.
     bool compressed_;
+    /// Memory-mapped package file contents.
+    const unsigned char* mappedData_;
 };
 
 }
@@ -67,6 +67,9 @@ public:
     /// Return the buffer.
     const PODVector<unsigned char>& GetBuffer() const { return buffer_; }
 
+    /// Return pointer to the data at the current position.
+    const unsigned char* GetContiguousData() const override { return size_ ? &buffer_[0] + position_ : nullptr; }
+
 private:
     /// Dynamic data buffer.
     PODVector<unsigned char> buffer_;
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/StringHashRegister.h"
 #include "../Math/MathDefs.h"
 #include "../Math/StringHash.h"
 
@@ -37,11 +38,13 @@ const StringHash StringHash::ZERO;
 StringHash::StringHash(const char* str) noexcept :
     value_(Calculate(str))
 {
+    GetGlobalStringHashRegister()->RegisterString(*this, str);
 }
 
 StringHash::StringHash(const String& str) noexcept :
     value_(Calculate(str.CString()))
 {
+    GetGlobalStringHashRegister()->RegisterString(*this, str.CString());
 }
 
 unsigned StringHash::Calculate(const char* str, unsigned hash)
@@ -67,4 +70,22 @@ String StringHash::ToString() const
     return String(tempBuffer);
 }
 
+String StringHash::Reverse() const
+{
+    return GetGlobalStringHashRegister()->GetString(*this);
+}
+
+String StringHash::ToDebugString() const
+{
+    String reversed = Reverse();
+    return reversed.Empty() ? "#" + ToString() : "#" + ToString() + " \"" + reversed + "\"";
+}
+
+StringHashRegister* StringHash::GetGlobalStringHashRegister()
+{
+    // Function-local static, so that hashes constructed during static initialization of other modules can register
+    static StringHashRegister stringHashRegister;
+    return &stringHashRegister;
+}
+
 }
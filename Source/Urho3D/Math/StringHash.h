@@ -27,6 +27,8 @@
 namespace Urho3D
 {
 
+class StringHashRegister;
+
 /// 32-bit hash value for a string.
 class URHO3D_API StringHash
 {
@@ -90,12 +92,21 @@ public:
     /// Return as string.
     String ToString() const;
 
+    /// Return the string the hash was calculated from, or empty if the hash was not calculated from a string in this process.
+    String Reverse() const;
+
+    /// Return the hash value and, if known, the string it was calculated from. Intended for log messages.
+    String ToDebugString() const;
+
     /// Return hash value for HashSet & HashMap.
     unsigned ToHash() const { return value_; }
 
     /// Calculate hash value case-insensitively from a C string.
     static unsigned Calculate(const char* str, unsigned hash = 0);
 
+    /// Return the global table of strings that hashes have been calculated from.
+    static StringHashRegister* GetGlobalStringHashRegister();
+
     /// Zero hash.
     static const StringHash ZERO;
 
@@ -59,12 +59,6 @@ extern const char* NAVIGATION_CATEGORY;
 static const int DEFAULT_MAX_OBSTACLES = 1024;
 static const int DEFAULT_MAX_LAYERS = 16;
 
-struct DynamicNavigationMesh::TileCacheData
-{
-    unsigned char* data;
-    int dataSize;
-};
-
 struct TileCompressor : public dtTileCacheCompressor
 {
     int maxCompressedSize(const int bufferSize) override
@@ -429,54 +423,10 @@ bool DynamicNavigationMesh::Build()
             return false;
         }
 
-        // Build each tile
-        unsigned numTiles = 0;
-
-        for (int z = 0; z < numTilesZ_; ++z)
-        {
-            for (int x = 0; x < numTilesX_; ++x)
-            {
-                TileCacheData tiles[TILECACHE_MAXLAYERS];
-                int layerCt = BuildTile(geometryList, x, z, tiles);
-                for (int i = 0; i < layerCt; ++i)
-                {
-                    dtCompressedTileRef tileRef;
-                    int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
-                    if (dtStatusFailed((dtStatus)status))
-                    {
-                        dtFree(tiles[i].data);
-                        tiles[i].data = nullptr;
-                    }
-                }
-                tileCache_->buildNavMeshTilesAt(x, z, navMesh_);
-                ++numTiles;
-            }
-        }
-
-        // For a full build it's necessary to update the nav mesh
-        // not doing so will cause dependent components to crash, like CrowdManager
-        tileCache_->update(0, navMesh_);
-
-        URHO3D_LOGDEBUG("Built navigation mesh with " + String(numTiles) + " tiles");
-
-        // Send a notification event to concerned parties that we've been fully rebuilt
-        {
-            using namespace NavigationMeshRebuilt;
-            VariantMap& buildEventParams = GetContext()->GetEventDataMap();
-            buildEventParams[P_NODE] = node_;
-            buildEventParams[P_MESH] = this;
-            SendEvent(E_NAVIGATION_MESH_REBUILT, buildEventParams);
-        }
-
-        // Scan for obstacles to insert into us
-        PODVector<Node*> obstacles;
-        GetScene()->GetChildrenWithComponent<Obstacle>(obstacles, true);
-        for (unsigned i = 0; i < obstacles.Size(); ++i)
-        {
-            auto* obs = obstacles[i]->GetComponent<Obstacle>();
-            if (obs && obs->IsEnabledEffective())
-                AddObstacle(obs);
-        }
+        // Build each tile. If building in the background, the build is finished once all tiles have been inserted
+        unsigned numTiles = BuildTiles(geometryList, IntVector2::ZERO, GetNumTiles() - IntVector2::ONE, true);
+        if (!IsBuilding())
+            FinishFullBuild(numTiles);
 
         return true;
     }
@@ -512,7 +462,8 @@ bool DynamicNavigationMesh::Build(const BoundingBox& boundingBox)
 
     unsigned numTiles = BuildTiles(geometryList, IntVector2(sx, sz), IntVector2(ex, ez));
 
-    URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
+    if (!IsBuilding())
+        URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
     return true;
 }
 
@@ -537,7 +488,8 @@ bool DynamicNavigationMesh::Build(const IntVector2& from, const IntVector2& to)
 
     unsigned numTiles = BuildTiles(geometryList, from, to);
 
-    URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
+    if (!IsBuilding())
+        URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
     return true;
 }
 
@@ -803,6 +755,7 @@ bool DynamicNavigationMesh::ReadTiles(Deserializer& source, bool silent)
         tileCache_->buildNavMeshTilesAt(tileQueue_[i].x_, tileQueue_[i].y_, navMesh_);
 
     tileCache_->update(0, navMesh_);
+    InvalidatePathRequests();
 
     // Send event
     if (!silent)
@@ -820,61 +773,41 @@ bool DynamicNavigationMesh::ReadTiles(Deserializer& source, bool silent)
     return true;
 }
 
-int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int x, int z, TileCacheData* tiles)
+void DynamicNavigationMesh::BuildTileData(const NavBuildJob& job, NavBuildTile& tile) const
 {
     URHO3D_PROFILE(BuildNavigationMeshTile);
 
-    tileCache_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
-
-    const BoundingBox tileBoundingBox = GetTileBoudningBox(IntVector2(x, z));
-
     DynamicNavBuildData build(allocator_.Get());
 
-    rcConfig cfg;
-    memset(&cfg, 0, sizeof cfg);
-    cfg.cs = cellSize_;
-    cfg.ch = cellHeight_;
-    cfg.walkableSlopeAngle = agentMaxSlope_;
-    cfg.walkableHeight = (int)ceilf(agentHeight_ / cfg.ch);
-    cfg.walkableClimb = (int)floorf(agentMaxClimb_ / cfg.ch);
-    cfg.walkableRadius = (int)ceilf(agentRadius_ / cfg.cs);
-    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
-    cfg.maxSimplificationError = edgeMaxError_;
-    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
-    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
-    cfg.maxVertsPerPoly = 6;
-    cfg.tileSize = tileSize_;
-    cfg.borderSize = cfg.walkableRadius + 3; // Add padding
-    cfg.width = cfg.tileSize + cfg.borderSize * 2;
-    cfg.height = cfg.tileSize + cfg.borderSize * 2;
-    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
-    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
-
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
+    rcConfig cfg = *job.config_;
+    rcVcopy(cfg.bmin, &tile.boundingBox_.min_.x_);
+    rcVcopy(cfg.bmax, &tile.boundingBox_.max_.x_);
     cfg.bmin[0] -= cfg.borderSize * cfg.cs;
     cfg.bmin[2] -= cfg.borderSize * cfg.cs;
     cfg.bmax[0] += cfg.borderSize * cfg.cs;
     cfg.bmax[2] += cfg.borderSize * cfg.cs;
 
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+    job.geometry_.GetTileGeometry(&build, expandedBox);
 
     if (build.vertices_.Empty() || build.indices_.Empty())
-        return 0; // Nothing to do
+    {
+        tile.success_ = true;
+        return; // Nothing to do
+    }
 
     build.heightField_ = rcAllocHeightfield();
     if (!build.heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return 0;
+        return;
     }
 
     if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return 0;
+        return;
     }
 
     unsigned numTriangles = build.indices_.Size() / 3;
@@ -894,18 +827,18 @@ int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryLis
     if (!build.compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return 0;
+        return;
     }
     if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
         *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return 0;
+        return;
     }
     if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return 0;
+        return;
     }
 
     // area volumes
@@ -913,18 +846,18 @@ int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryLis
         rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
             build.navAreas_[i].areaID_, *build.compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (job.watershed_)
     {
         if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return 0;
+            return;
         }
         if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return 0;
+            return;
         }
     }
     else
@@ -932,7 +865,7 @@ int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryLis
         if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return 0;
+            return;
         }
     }
 
@@ -940,24 +873,23 @@ int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryLis
     if (!build.heightFieldLayers_)
     {
         URHO3D_LOGERROR("Could not allocate height field layer set");
-        return 0;
+        return;
     }
 
     if (!rcBuildHeightfieldLayers(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.walkableHeight,
         *build.heightFieldLayers_))
     {
         URHO3D_LOGERROR("Could not build height field layers");
-        return 0;
+        return;
     }
 
-    int retCt = 0;
     for (int i = 0; i < build.heightFieldLayers_->nlayers; ++i)
     {
         dtTileCacheLayerHeader header;
         header.magic = DT_TILECACHE_MAGIC;
         header.version = DT_TILECACHE_VERSION;
-        header.tx = x;
-        header.ty = z;
+        header.tx = tile.tile_.x_;
+        header.ty = tile.tile_.y_;
         header.tlayer = i;
 
         rcHeightfieldLayer* layer = &build.heightFieldLayers_->layers[i];
@@ -974,69 +906,103 @@ int DynamicNavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryLis
         header.hmin = (unsigned short)layer->hmin;
         header.hmax = (unsigned short)layer->hmax;
 
+        // The compressor has no state, so it can be shared by the worker threads
+        unsigned char* data = nullptr;
+        int dataSize = 0;
         if (dtStatusFailed(
             dtBuildTileCacheLayer(compressor_.Get()/*compressor*/, &header, layer->heights, layer->areas/*areas*/, layer->cons,
-                &(tiles[retCt].data), &tiles[retCt].dataSize)))
+                &data, &dataSize)))
         {
             URHO3D_LOGERROR("Failed to build tile cache layers");
-            return 0;
+            return;
         }
-        else
-            ++retCt;
+
+        tile.data_.Push(data);
+        tile.dataSizes_.Push(dataSize);
     }
 
+    tile.success_ = true;
+}
+
+unsigned DynamicNavigationMesh::InsertTile(NavBuildJob& job, NavBuildTile& tile)
+{
+    const int x = tile.tile_.x_;
+    const int z = tile.tile_.y_;
+
+    dtCompressedTileRef existing[TILECACHE_MAXLAYERS];
+    const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
+    for (int i = 0; i < existingCt; ++i)
+    {
+        unsigned char* data = nullptr;
+        if (!dtStatusFailed(tileCache_->removeTile(existing[i], &data, nullptr)) && data != nullptr)
+            dtFree(data);
+    }
+
+    if (!tile.success_)
+        return 0;
+
+    // The tile cache takes ownership of the layer data
+    PODVector<unsigned char*> layers = tile.data_;
+    tile.data_.Clear();
+
+    unsigned numTiles = 0;
+    for (unsigned i = 0; i < layers.Size(); ++i)
+    {
+        dtCompressedTileRef tileRef;
+        int status = tileCache_->addTile(layers[i], tile.dataSizes_[i], DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
+        if (dtStatusFailed((dtStatus)status))
+            dtFree(layers[i]);
+        else if (!job.fullBuild_)
+        {
+            tileCache_->buildNavMeshTile(tileRef, navMesh_);
+            ++numTiles;
+        }
+    }
+
+    if (job.fullBuild_)
+    {
+        tileCache_->buildNavMeshTilesAt(x, z, navMesh_);
+        ++numTiles;
+    }
+
+    if (layers.Empty())
+        return numTiles;
+
     // Send a notification of the rebuild of this tile to anyone interested
     {
         using namespace NavigationAreaRebuilt;
         VariantMap& eventData = GetContext()->GetEventDataMap();
         eventData[P_NODE] = GetNode();
         eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
+        eventData[P_BOUNDSMIN] = Variant(tile.boundingBox_.min_);
+        eventData[P_BOUNDSMAX] = Variant(tile.boundingBox_.max_);
         SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
     }
 
-    return retCt;
+    return numTiles;
 }
 
-unsigned DynamicNavigationMesh::BuildTiles(Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
+void DynamicNavigationMesh::FinishFullBuild(unsigned numTiles)
 {
-    unsigned numTiles = 0;
+    // For a full build it's necessary to update the nav mesh
+    // not doing so will cause dependent components to crash, like CrowdManager
+    tileCache_->update(0, navMesh_);
 
-    for (int z = from.y_; z <= to.y_; ++z)
-    {
-        for (int x = from.x_; x <= to.x_; ++x)
-        {
-            dtCompressedTileRef existing[TILECACHE_MAXLAYERS];
-            const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
-            for (int i = 0; i < existingCt; ++i)
-            {
-                unsigned char* data = nullptr;
-                if (!dtStatusFailed(tileCache_->removeTile(existing[i], &data, nullptr)) && data != nullptr)
-                    dtFree(data);
-            }
+    NavigationMesh::FinishFullBuild(numTiles);
 
-            TileCacheData tiles[TILECACHE_MAXLAYERS];
-            int layerCt = BuildTile(geometryList, x, z, tiles);
-            for (int i = 0; i < layerCt; ++i)
-            {
-                dtCompressedTileRef tileRef;
-                int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
-                if (dtStatusFailed((dtStatus)status))
-                {
-                    dtFree(tiles[i].data);
-                    tiles[i].data = nullptr;
-                }
-                else
-                {
-                    tileCache_->buildNavMeshTile(tileRef, navMesh_);
-                    ++numTiles;
-                }
-            }
-        }
-    }
+    // Scan for obstacles to insert into us
+    Scene* scene = GetScene();
+    if (!scene)
+        return;
 
-    return numTiles;
+    PODVector<Node*> obstacles;
+    scene->GetChildrenWithComponent<Obstacle>(obstacles, true);
+    for (unsigned i = 0; i < obstacles.Size(); ++i)
+    {
+        auto* obs = obstacles[i]->GetComponent<Obstacle>();
+        if (obs && obs->IsEnabledEffective())
+            AddObstacle(obs);
+    }
 }
 
 PODVector<OffMeshConnection*> DynamicNavigationMesh::CollectOffMeshConnections(const BoundingBox& bounds)
@@ -1090,7 +1056,10 @@ void DynamicNavigationMesh::AddObstacle(Obstacle* obstacle, bool silent)
         // Because dtTileCache doesn't process obstacle requests while updating tiles
         // it's necessary update until sufficient request space is available
         while (tileCache_->isObstacleQueueFull())
+        {
             tileCache_->update(1, navMesh_);
+            InvalidatePathRequests();
+        }
 
         if (dtStatusFailed(tileCache_->addObstacle(pos, obstacle->GetRadius(), obstacle->GetHeight(), &refHolder)))
         {
@@ -1130,7 +1099,10 @@ void DynamicNavigationMesh::RemoveObstacle(Obstacle* obstacle, bool silent)
         // Because dtTileCache doesn't process obstacle requests while updating tiles
         // it's necessary update until sufficient request space is available
         while (tileCache_->isObstacleQueueFull())
+        {
             tileCache_->update(1, navMesh_);
+            InvalidatePathRequests();
+        }
 
         if (dtStatusFailed(tileCache_->removeObstacle(obstacle->obstacleId_)))
         {
@@ -1158,7 +1130,13 @@ void DynamicNavigationMesh::HandleSceneSubsystemUpdate(StringHash eventType, Var
     using namespace SceneSubsystemUpdate;
 
     if (tileCache_ && navMesh_ && IsEnabledEffective())
+    {
+        // Applying obstacle changes rebuilds tiles, so the pending path requests need to restart
+        bool upToDate = tileCache_->isUpToDate();
         tileCache_->update(eventData[P_TIMESTEP].GetFloat(), navMesh_);
+        if (!upToDate)
+            InvalidatePathRequests();
+    }
 }
 
 }
@@ -22,8 +22,10 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/WorkQueue.h"
 #include "../Navigation/NavBuildData.h"
 
+#include <Detour/DetourAlloc.h>
 #include <DetourTileCache/DetourTileCacheBuilder.h>
 #include <Recast/Recast.h>
 
@@ -85,4 +87,54 @@ DynamicNavBuildData::~DynamicNavBuildData()
     heightFieldLayers_ = nullptr;
 }
 
+void NavBuildGeometry::GetTileGeometry(NavBuildData* build, const BoundingBox& box) const
+{
+    for (unsigned i = 0; i < sources_.Size(); ++i)
+    {
+        const NavBuildGeometrySource& source = sources_[i];
+        if (box.IsInsideFast(source.boundingBox_) == OUTSIDE)
+            continue;
+
+        unsigned destVertexStart = build->vertices_.Size();
+        for (unsigned j = source.vertexStart_; j < source.vertexStart_ + source.vertexCount_; ++j)
+            build->vertices_.Push(data_.vertices_[j]);
+        for (unsigned j = source.indexStart_; j < source.indexStart_ + source.indexCount_; ++j)
+            build->indices_.Push(data_.indices_[j] - source.vertexStart_ + destVertexStart);
+
+        for (unsigned j = source.offMeshStart_; j < source.offMeshStart_ + source.offMeshCount_; ++j)
+        {
+            build->offMeshVertices_.Push(data_.offMeshVertices_[j * 2]);
+            build->offMeshVertices_.Push(data_.offMeshVertices_[j * 2 + 1]);
+            build->offMeshRadii_.Push(data_.offMeshRadii_[j]);
+            build->offMeshFlags_.Push(data_.offMeshFlags_[j]);
+            build->offMeshAreas_.Push(data_.offMeshAreas_[j]);
+            build->offMeshDir_.Push(data_.offMeshDir_[j]);
+        }
+
+        for (unsigned j = source.areaStart_; j < source.areaStart_ + source.areaCount_; ++j)
+            build->navAreas_.Push(data_.navAreas_[j]);
+    }
+}
+
+NavBuildJob::NavBuildJob() :
+    config_(new rcConfig()),
+    agentHeight_(0.0f),
+    agentRadius_(0.0f),
+    agentMaxClimb_(0.0f),
+    watershed_(false),
+    fullBuild_(false),
+    numInserted_(0),
+    numBuilt_(0)
+{
+}
+
+NavBuildJob::~NavBuildJob()
+{
+    for (unsigned i = 0; i < tiles_.Size(); ++i)
+    {
+        for (unsigned j = 0; j < tiles_[i].data_.Size(); ++j)
+            dtFree(tiles_[i].data_[j]);
+    }
+}
+
 }
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "../Container/Ptr.h"
 #include "../Container/Vector.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 
 class rcContext;
@@ -32,6 +34,7 @@ struct dtTileCacheContourSet;
 struct dtTileCachePolyMesh;
 struct dtTileCacheAlloc;
 struct rcCompactHeightfield;
+struct rcConfig;
 struct rcContourSet;
 struct rcHeightfield;
 struct rcHeightfieldLayerSet;
@@ -41,6 +44,8 @@ struct rcPolyMeshDetail;
 namespace Urho3D
 {
 
+struct WorkItem;
+
 /// Navigation area stub.
 struct URHO3D_API NavAreaStub
 {
@@ -116,4 +121,95 @@ struct DynamicNavBuildData : public NavBuildData
     dtTileCacheAlloc* alloc_;
 };
 
+/// Geometry source within extracted navigation geometry.
+struct URHO3D_API NavBuildGeometrySource
+{
+    /// Bounding box relative to the navigation mesh root node.
+    BoundingBox boundingBox_;
+    /// First vertex.
+    unsigned vertexStart_;
+    /// Number of vertices.
+    unsigned vertexCount_;
+    /// First index.
+    unsigned indexStart_;
+    /// Number of indices.
+    unsigned indexCount_;
+    /// First offmesh connection.
+    unsigned offMeshStart_;
+    /// Number of offmesh connections.
+    unsigned offMeshCount_;
+    /// First navigation area.
+    unsigned areaStart_;
+    /// Number of navigation areas.
+    unsigned areaCount_;
+};
+
+/// Navigation geometry extracted from the scene before building tiles, so that tiles can be built in worker threads.
+struct URHO3D_API NavBuildGeometry
+{
+    /// Append the geometry intersecting a bounding box to tile build data.
+    void GetTileGeometry(NavBuildData* build, const BoundingBox& box) const;
+
+    /// Extracted geometry of all sources.
+    NavBuildData data_;
+    /// Geometry sources.
+    PODVector<NavBuildGeometrySource> sources_;
+};
+
+/// Result of building one navigation mesh tile.
+struct URHO3D_API NavBuildTile
+{
+    /// Construct.
+    NavBuildTile() :
+        success_(false),
+        inserted_(false)
+    {
+    }
+
+    /// Tile index.
+    IntVector2 tile_;
+    /// Tile bounding box relative to the navigation mesh root node.
+    BoundingBox boundingBox_;
+    /// Navigation mesh tile data or compressed tile cache layers. Owned until inserted into the navigation mesh.
+    PODVector<unsigned char*> data_;
+    /// Sizes of the data blocks.
+    PODVector<int> dataSizes_;
+    /// Whether the build succeeded. A tile without geometry succeeds with no data.
+    bool success_;
+    /// Whether inserted into the navigation mesh.
+    bool inserted_;
+};
+
+/// Navigation mesh tile build job. Holds everything the tile builds need so that they never access the scene or the navigation mesh settings.
+struct URHO3D_API NavBuildJob : public RefCounted
+{
+    /// Construct.
+    NavBuildJob();
+    /// Destruct. Free tile data which was not inserted.
+    ~NavBuildJob() override;
+
+    /// Recast configuration without tile bounds.
+    UniquePtr<rcConfig> config_;
+    /// Navigation agent height.
+    float agentHeight_;
+    /// Navigation agent radius.
+    float agentRadius_;
+    /// Navigation agent max vertical climb.
+    float agentMaxClimb_;
+    /// Whether to use watershed partitioning.
+    bool watershed_;
+    /// Whether rebuilding the whole navigation mesh.
+    bool fullBuild_;
+    /// Extracted geometry.
+    NavBuildGeometry geometry_;
+    /// Tiles to build.
+    Vector<NavBuildTile> tiles_;
+    /// Work items of a background build, one per tile.
+    Vector<SharedPtr<WorkItem> > workItems_;
+    /// Number of tiles inserted into the navigation mesh.
+    unsigned numInserted_;
+    /// Number of tiles built successfully.
+    unsigned numBuilt_;
+};
+
 }
@@ -43,6 +43,24 @@ URHO3D_EVENT(E_NAVIGATION_AREA_REBUILT, NavigationAreaRebuilt)
     URHO3D_PARAM(P_BOUNDSMAX, BoundsMax); // Vector3
 }
 
+/// Background build of navigation mesh tiles has progressed. Sent after inserting built tiles into the navigation mesh.
+URHO3D_EVENT(E_NAVIGATION_BUILD_PROGRESS, NavigationBuildProgress)
+{
+    URHO3D_PARAM(P_NODE, Node); // Node pointer
+    URHO3D_PARAM(P_MESH, Mesh); // NavigationMesh pointer
+    URHO3D_PARAM(P_PROGRESS, Progress); // float
+}
+
+/// Asynchronous path request has finished.
+URHO3D_EVENT(E_NAVIGATION_PATH_FOUND, NavigationPathFound)
+{
+    URHO3D_PARAM(P_NODE, Node); // Node pointer
+    URHO3D_PARAM(P_MESH, Mesh); // NavigationMesh pointer
+    URHO3D_PARAM(P_REQUEST, Request); // unsigned
+    URHO3D_PARAM(P_SUCCESS, Success); // bool
+    URHO3D_PARAM(P_PATH, Path); // VariantVector of world space Vector3 path points, empty if no path was found
+}
+
 /// Mesh tile is added to navigation mesh.
 URHO3D_EVENT(E_NAVIGATION_TILE_ADDED, NavigationTileAdded)
 {
@@ -23,7 +23,11 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -81,6 +85,9 @@ static const float DEFAULT_EDGE_MAX_ERROR = 1.3f;
 static const float DEFAULT_DETAIL_SAMPLE_DISTANCE = 6.0f;
 static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 
+static const int DEFAULT_PATH_QUERY_BUDGET = 4096;
+static const unsigned DEFAULT_PATH_CACHE_SIZE = 128;
+
 static const int MAX_POLYS = 2048;
 
 
@@ -97,12 +104,168 @@ struct FindPathData
     unsigned char pathFlags_[MAX_POLYS];
 };
 
+/// Asynchronous path request.
+struct NavPathRequest
+{
+    /// Construct.
+    NavPathRequest() :
+        id_(0),
+        startRef_(0),
+        endRef_(0),
+        searching_(false),
+        finished_(false),
+        cached_(false)
+    {
+    }
+
+    /// Request ID.
+    unsigned id_;
+    /// Start point in navigation mesh space.
+    Vector3 start_;
+    /// End point in navigation mesh space.
+    Vector3 end_;
+    /// Extents for finding the start and end polygons.
+    Vector3 extents_;
+    /// Start polygon.
+    dtPolyRef startRef_;
+    /// End polygon.
+    dtPolyRef endRef_;
+    /// Sliced path search in progress in the lane's query.
+    bool searching_;
+    /// Finished, waiting for the result to be sent.
+    bool finished_;
+    /// Polygons were taken from the path cache.
+    bool cached_;
+    /// Polygons of the path.
+    PODVector<dtPolyRef> polys_;
+    /// Path points in navigation mesh space. Empty if no path was found.
+    PODVector<Vector3> points_;
+};
+
+/// Queue of path requests processed by one thread at a time. Each lane has its own query, as a query can only run one sliced path search.
+struct NavPathLane : public RefCounted
+{
+    /// Construct.
+    NavPathLane() :
+        query_(nullptr)
+    {
+    }
+
+    /// Destruct.
+    ~NavPathLane() override
+    {
+        dtFreeNavMeshQuery(query_);
+    }
+
+    /// Detour navigation mesh query.
+    dtNavMeshQuery* query_;
+    /// Temporary data for finding the path points.
+    FindPathData pathData_;
+    /// Path requests in order.
+    List<NavPathRequest> requests_;
+};
+
+/// Asynchronous path requests and the path cache.
+struct NavPathQueryData
+{
+    /// Construct.
+    NavPathQueryData() :
+        nextID_(1)
+    {
+    }
+
+    /// Request lanes, one for each worker thread and the main thread.
+    Vector<SharedPtr<NavPathLane> > lanes_;
+    /// Copy of the query filter for the current update.
+    dtQueryFilter filter_;
+    /// Polygons of recently found paths by start and end polygon, in least recently used order.
+    HashMap<Pair<dtPolyRef, dtPolyRef>, PODVector<dtPolyRef> > cache_;
+    /// Next request ID.
+    unsigned nextID_;
+};
+
+/// Search paths for the requests of a lane within an iteration budget. Called from worker threads.
+static void ProcessPathLane(NavPathLane& lane, const NavPathQueryData& data, int budget)
+{
+    dtNavMeshQuery* query = lane.query_;
+    const dtQueryFilter* filter = &data.filter_;
+    FindPathData& pathData = lane.pathData_;
+
+    for (List<NavPathRequest>::Iterator i = lane.requests_.Begin(); i != lane.requests_.End() && budget > 0; ++i)
+    {
+        NavPathRequest& request = *i;
+        if (request.finished_)
+            continue;
+
+        if (!request.searching_)
+        {
+            // Count finding the polygons as an iteration, so that the budget also limits the number of started requests
+            --budget;
+            query->findNearestPoly(&request.start_.x_, &request.extents_.x_, filter, &request.startRef_, nullptr);
+            query->findNearestPoly(&request.end_.x_, &request.extents_.x_, filter, &request.endRef_, nullptr);
+            if (!request.startRef_ || !request.endRef_)
+            {
+                request.finished_ = true;
+                continue;
+            }
+
+            // The cache is only modified in the main thread between the updates, so it can be read here
+            HashMap<Pair<dtPolyRef, dtPolyRef>, PODVector<dtPolyRef> >::ConstIterator j =
+                data.cache_.Find(MakePair(request.startRef_, request.endRef_));
+            if (j != data.cache_.End())
+            {
+                request.polys_ = j->second_;
+                request.cached_ = true;
+            }
+            else if (!dtStatusFailed(query->initSlicedFindPath(request.startRef_, request.endRef_, &request.start_.x_,
+                &request.end_.x_, filter)))
+                request.searching_ = true;
+        }
+
+        if (request.searching_)
+        {
+            int iterations = 0;
+            dtStatus status = query->updateSlicedFindPath(budget, &iterations);
+            budget -= iterations;
+            // If the budget ran out, continue the search during the next update
+            if (dtStatusInProgress(status))
+                break;
+
+            request.searching_ = false;
+            int numPolys = 0;
+            if (dtStatusSucceed(status))
+                query->finalizeSlicedFindPath(pathData.polys_, &numPolys, MAX_POLYS);
+            request.polys_.Resize((unsigned)numPolys);
+            for (int j = 0; j < numPolys; ++j)
+                request.polys_[j] = pathData.polys_[j];
+        }
+
+        request.finished_ = true;
+        if (request.polys_.Empty())
+            continue;
+
+        Vector3 actualEnd = request.end_;
+
+        // If full path was not found, clamp end point to the end polygon
+        if (request.polys_.Back() != request.endRef_)
+            query->closestPointOnPoly(request.polys_.Back(), &request.end_.x_, &actualEnd.x_, nullptr);
+
+        int numPathPoints = 0;
+        query->findStraightPath(&request.start_.x_, &actualEnd.x_, &request.polys_[0], (int)request.polys_.Size(),
+            &pathData.pathPoints_[0].x_, pathData.pathFlags_, pathData.pathPolys_, &numPathPoints, MAX_POLYS);
+        request.points_.Resize((unsigned)numPathPoints);
+        for (int j = 0; j < numPathPoints; ++j)
+            request.points_[j] = pathData.pathPoints_[j];
+    }
+}
+
 NavigationMesh::NavigationMesh(Context* context) :
     Component(context),
     navMesh_(nullptr),
     navMeshQuery_(nullptr),
     queryFilter_(new dtQueryFilter()),
     pathData_(new FindPathData()),
+    pathQueries_(new NavPathQueryData()),
     tileSize_(DEFAULT_TILE_SIZE),
     cellSize_(DEFAULT_CELL_SIZE),
     cellHeight_(DEFAULT_CELL_HEIGHT),
@@ -122,7 +285,10 @@ NavigationMesh::NavigationMesh(Context* context) :
     partitionType_(NAVMESH_PARTITION_WATERSHED),
     keepInterResults_(false),
     drawOffMeshConnections_(false),
-    drawNavAreas_(false)
+    drawNavAreas_(false),
+    asyncBuild_(false),
+    pathQueryBudget_(DEFAULT_PATH_QUERY_BUDGET),
+    pathCacheSize_(DEFAULT_PATH_CACHE_SIZE)
 {
 }
 
@@ -157,6 +323,9 @@ void NavigationMesh::RegisterObject(Context* context)
         NAVMESH_PARTITION_WATERSHED, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw OffMeshConnections", GetDrawOffMeshConnections, SetDrawOffMeshConnections, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw NavAreas", GetDrawNavAreas, SetDrawNavAreas, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Async Build", GetAsyncBuild, SetAsyncBuild, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Path Query Budget", GetPathQueryBudget, SetPathQueryBudget, int, DEFAULT_PATH_QUERY_BUDGET, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Path Cache Size", GetPathCacheSize, SetPathCacheSize, unsigned, DEFAULT_PATH_CACHE_SIZE, AM_DEFAULT);
 }
 
 void NavigationMesh::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -444,19 +613,10 @@ bool NavigationMesh::Build()
             return false;
         }
 
-        // Build each tile
-        unsigned numTiles = BuildTiles(geometryList, IntVector2::ZERO, GetNumTiles() - IntVector2::ONE);
-
-        URHO3D_LOGDEBUG("Built navigation mesh with " + String(numTiles) + " tiles");
-
-        // Send a notification event to concerned parties that we've been fully rebuilt
-        {
-            using namespace NavigationMeshRebuilt;
-            VariantMap& buildEventParams = GetContext()->GetEventDataMap();
-            buildEventParams[P_NODE] = node_;
-            buildEventParams[P_MESH] = this;
-            SendEvent(E_NAVIGATION_MESH_REBUILT, buildEventParams);
-        }
+        // Build each tile. If building in the background, the build is finished once all tiles have been inserted
+        unsigned numTiles = BuildTiles(geometryList, IntVector2::ZERO, GetNumTiles() - IntVector2::ONE, true);
+        if (!IsBuilding())
+            FinishFullBuild(numTiles);
 
         return true;
     }
@@ -492,7 +652,8 @@ bool NavigationMesh::Build(const BoundingBox& boundingBox)
 
     unsigned numTiles = BuildTiles(geometryList, IntVector2(sx, sz), IntVector2(ex, ez));
 
-    URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
+    if (!IsBuilding())
+        URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
     return true;
 }
 
@@ -517,7 +678,8 @@ bool NavigationMesh::Build(const IntVector2& from, const IntVector2& to)
 
     unsigned numTiles = BuildTiles(geometryList, from, to);
 
-    URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
+    if (!IsBuilding())
+        URHO3D_LOGDEBUG("Rebuilt " + String(numTiles) + " tiles of the navigation mesh");
     return true;
 }
 
@@ -575,6 +737,7 @@ void NavigationMesh::RemoveTile(const IntVector2& tile)
         return;
 
     navMesh_->removeTile(tileRef, nullptr, nullptr);
+    InvalidatePathRequests();
 
     // Send event
     using namespace NavigationTileRemoved;
@@ -596,6 +759,8 @@ void NavigationMesh::RemoveAllTiles()
             navMesh_->removeTile(navMesh_->getTileRef(tile), nullptr, nullptr);
     }
 
+    InvalidatePathRequests();
+
     // Send event
     using namespace NavigationAllTilesRemoved;
     VariantMap& eventData = GetContext()->GetEventDataMap();
@@ -737,6 +902,78 @@ void NavigationMesh::FindPath(PODVector<NavigationPathPoint>& dest, const Vector
     }
 }
 
+unsigned NavigationMesh::FindPathAsync(const Vector3& start, const Vector3& end, const Vector3& extents)
+{
+    if (!navMesh_ || !node_)
+        return 0;
+
+    NavPathQueryData& data = *pathQueries_;
+    if (data.lanes_.Empty())
+    {
+        auto* queue = GetSubsystem<WorkQueue>();
+        unsigned numLanes = queue ? queue->GetNumThreads() + 1 : 1;
+        for (unsigned i = 0; i < numLanes; ++i)
+            data.lanes_.Push(SharedPtr<NavPathLane>(new NavPathLane()));
+    }
+
+    // Queue to the lane with the least requests
+    NavPathLane* lane = data.lanes_[0];
+    for (unsigned i = 1; i < data.lanes_.Size(); ++i)
+    {
+        if (data.lanes_[i]->requests_.Size() < lane->requests_.Size())
+            lane = data.lanes_[i];
+    }
+
+    // Navigation data is in local space. Transform path points from world to local
+    Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+
+    NavPathRequest request;
+    request.id_ = data.nextID_++;
+    if (!data.nextID_)
+        data.nextID_ = 1;
+    request.start_ = inverse * start;
+    request.end_ = inverse * end;
+    request.extents_ = extents;
+    lane->requests_.Push(request);
+
+    UpdateFrameSubscription();
+    return request.id_;
+}
+
+void NavigationMesh::CancelPathRequest(unsigned requestID)
+{
+    Vector<SharedPtr<NavPathLane> >& lanes = pathQueries_->lanes_;
+    for (unsigned i = 0; i < lanes.Size(); ++i)
+    {
+        List<NavPathRequest>& requests = lanes[i]->requests_;
+        for (List<NavPathRequest>::Iterator j = requests.Begin(); j != requests.End(); ++j)
+        {
+            if (j->id_ == requestID)
+            {
+                requests.Erase(j);
+                UpdateFrameSubscription();
+                return;
+            }
+        }
+    }
+}
+
+bool NavigationMesh::IsPathRequestPending(unsigned requestID) const
+{
+    const Vector<SharedPtr<NavPathLane> >& lanes = pathQueries_->lanes_;
+    for (unsigned i = 0; i < lanes.Size(); ++i)
+    {
+        const List<NavPathRequest>& requests = lanes[i]->requests_;
+        for (List<NavPathRequest>::ConstIterator j = requests.Begin(); j != requests.End(); ++j)
+        {
+            if (j->id_ == requestID)
+                return true;
+        }
+    }
+
+    return false;
+}
+
 Vector3 NavigationMesh::GetRandomPoint(const dtQueryFilter* filter, dtPolyRef* randomRef)
 {
     if (!InitializeQuery())
@@ -862,6 +1099,9 @@ void NavigationMesh::SetAreaCost(unsigned areaID, float cost)
 {
     if (queryFilter_)
         queryFilter_->setAreaCost((int)areaID, cost);
+
+    // Cached paths may no longer be the cheapest
+    InvalidatePathRequests();
 }
 
 BoundingBox NavigationMesh::GetWorldBoundingBox() const
@@ -950,6 +1190,57 @@ PODVector<unsigned char> NavigationMesh::GetNavigationDataAttr() const
     return ret.GetBuffer();
 }
 
+float NavigationMesh::GetBuildProgress() const
+{
+    return buildJob_ ? (float)buildJob_->numInserted_ / (float)buildJob_->tiles_.Size() : 1.0f;
+}
+
+void NavigationMesh::SetPathQueryBudget(int iterations)
+{
+    pathQueryBudget_ = Max(iterations, 1);
+    MarkNetworkUpdate();
+}
+
+void NavigationMesh::SetPathCacheSize(unsigned size)
+{
+    pathCacheSize_ = size;
+
+    HashMap<Pair<dtPolyRef, dtPolyRef>, PODVector<dtPolyRef> >& cache = pathQueries_->cache_;
+    while (cache.Size() > pathCacheSize_)
+        cache.Erase(cache.Begin());
+
+    MarkNetworkUpdate();
+}
+
+unsigned NavigationMesh::GetNumPathRequests() const
+{
+    unsigned numRequests = 0;
+    for (unsigned i = 0; i < pathQueries_->lanes_.Size(); ++i)
+        numRequests += pathQueries_->lanes_[i]->requests_.Size();
+    return numRequests;
+}
+
+void NavigationMesh::CompleteBuild()
+{
+    if (!buildJob_)
+        return;
+
+    URHO3D_PROFILE(CompleteNavigationMeshBuild);
+
+    WaitForBuild(true);
+    UpdateBuild(true);
+}
+
+void NavigationMesh::CancelBuild()
+{
+    if (!buildJob_)
+        return;
+
+    WaitForBuild(false);
+    buildJob_.Reset();
+    UpdateFrameSubscription();
+}
+
 void NavigationMesh::CollectGeometries(Vector<NavigationGeometryInfo>& geometryList)
 {
     URHO3D_PROFILE(CollectNavigationGeometry);
@@ -1089,108 +1380,141 @@ void NavigationMesh::GetTileGeometry(NavBuildData* build, Vector<NavigationGeome
     for (unsigned i = 0; i < geometryList.Size(); ++i)
     {
         if (box.IsInsideFast(geometryList[i].boundingBox_) != OUTSIDE)
-        {
-            const Matrix3x4& transform = geometryList[i].transform_;
+            AddGeometry(build, geometryList[i], inverse);
+    }
+}
 
-            if (geometryList[i].component_->GetType() == OffMeshConnection::GetTypeStatic())
-            {
-                auto* connection = static_cast<OffMeshConnection*>(geometryList[i].component_);
-                Vector3 start = inverse * connection->GetNode()->GetWorldPosition();
-                Vector3 end = inverse * connection->GetEndPoint()->GetWorldPosition();
-
-                build->offMeshVertices_.Push(start);
-                build->offMeshVertices_.Push(end);
-                build->offMeshRadii_.Push(connection->GetRadius());
-                build->offMeshFlags_.Push((unsigned short)connection->GetMask());
-                build->offMeshAreas_.Push((unsigned char)connection->GetAreaID());
-                build->offMeshDir_.Push((unsigned char)(connection->IsBidirectional() ? DT_OFFMESH_CON_BIDIR : 0));
-                continue;
-            }
-            else if (geometryList[i].component_->GetType() == NavArea::GetTypeStatic())
-            {
-                auto* area = static_cast<NavArea*>(geometryList[i].component_);
-                NavAreaStub stub;
-                stub.areaID_ = (unsigned char)area->GetAreaID();
-                stub.bounds_ = area->GetWorldBoundingBox();
-                build->navAreas_.Push(stub);
-                continue;
-            }
+void NavigationMesh::GetBuildGeometry(NavBuildGeometry& dest, const Vector<NavigationGeometryInfo>& geometryList,
+    const BoundingBox& box)
+{
+    URHO3D_PROFILE(ExtractNavigationGeometry);
 
-#ifdef URHO3D_PHYSICS
-            auto* shape = dynamic_cast<CollisionShape*>(geometryList[i].component_);
-            if (shape)
-            {
-                switch (shape->GetShapeType())
-                {
-                case SHAPE_TRIANGLEMESH:
-                    {
-                        Model* model = shape->GetModel();
-                        if (!model)
-                            continue;
+    Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+    NavBuildData& data = dest.data_;
 
-                        unsigned lodLevel = shape->GetLodLevel();
-                        for (unsigned j = 0; j < model->GetNumGeometries(); ++j)
-                            AddTriMeshGeometry(build, model->GetGeometry(j, lodLevel), transform);
-                    }
-                    break;
+    for (unsigned i = 0; i < geometryList.Size(); ++i)
+    {
+        if (box.IsInsideFast(geometryList[i].boundingBox_) == OUTSIDE)
+            continue;
 
-                case SHAPE_CONVEXHULL:
-                    {
-                        auto* data = static_cast<ConvexData*>(shape->GetGeometryData());
-                        if (!data)
-                            continue;
+        NavBuildGeometrySource source;
+        source.boundingBox_ = geometryList[i].boundingBox_;
+        source.vertexStart_ = data.vertices_.Size();
+        source.indexStart_ = data.indices_.Size();
+        source.offMeshStart_ = data.offMeshRadii_.Size();
+        source.areaStart_ = data.navAreas_.Size();
 
-                        unsigned numVertices = data->vertexCount_;
-                        unsigned numIndices = data->indexCount_;
-                        unsigned destVertexStart = build->vertices_.Size();
+        AddGeometry(&data, geometryList[i], inverse);
 
-                        for (unsigned j = 0; j < numVertices; ++j)
-                            build->vertices_.Push(transform * data->vertexData_[j]);
+        source.vertexCount_ = data.vertices_.Size() - source.vertexStart_;
+        source.indexCount_ = data.indices_.Size() - source.indexStart_;
+        source.offMeshCount_ = data.offMeshRadii_.Size() - source.offMeshStart_;
+        source.areaCount_ = data.navAreas_.Size() - source.areaStart_;
+        dest.sources_.Push(source);
+    }
+}
 
-                        for (unsigned j = 0; j < numIndices; ++j)
-                            build->indices_.Push(data->indexData_[j] + destVertexStart);
-                    }
-                    break;
+void NavigationMesh::AddGeometry(NavBuildData* build, const NavigationGeometryInfo& info, const Matrix3x4& inverse)
+{
+    const Matrix3x4& transform = info.transform_;
 
-                case SHAPE_BOX:
-                    {
-                        unsigned destVertexStart = build->vertices_.Size();
-
-                        build->vertices_.Push(transform * Vector3(-0.5f, 0.5f, -0.5f));
-                        build->vertices_.Push(transform * Vector3(0.5f, 0.5f, -0.5f));
-                        build->vertices_.Push(transform * Vector3(0.5f, -0.5f, -0.5f));
-                        build->vertices_.Push(transform * Vector3(-0.5f, -0.5f, -0.5f));
-                        build->vertices_.Push(transform * Vector3(-0.5f, 0.5f, 0.5f));
-                        build->vertices_.Push(transform * Vector3(0.5f, 0.5f, 0.5f));
-                        build->vertices_.Push(transform * Vector3(0.5f, -0.5f, 0.5f));
-                        build->vertices_.Push(transform * Vector3(-0.5f, -0.5f, 0.5f));
-
-                        const unsigned indices[] = {
-                            0, 1, 2, 0, 2, 3, 1, 5, 6, 1, 6, 2, 4, 5, 1, 4, 1, 0, 5, 4, 7, 5, 7, 6,
-                            4, 0, 3, 4, 3, 7, 1, 0, 4, 1, 4, 5
-                        };
-
-                        for (unsigned index : indices)
-                            build->indices_.Push(index + destVertexStart);
-                    }
-                    break;
+    if (info.component_->GetType() == OffMeshConnection::GetTypeStatic())
+    {
+        auto* connection = static_cast<OffMeshConnection*>(info.component_);
+        Vector3 start = inverse * connection->GetNode()->GetWorldPosition();
+        Vector3 end = inverse * connection->GetEndPoint()->GetWorldPosition();
+
+        build->offMeshVertices_.Push(start);
+        build->offMeshVertices_.Push(end);
+        build->offMeshRadii_.Push(connection->GetRadius());
+        build->offMeshFlags_.Push((unsigned short)connection->GetMask());
+        build->offMeshAreas_.Push((unsigned char)connection->GetAreaID());
+        build->offMeshDir_.Push((unsigned char)(connection->IsBidirectional() ? DT_OFFMESH_CON_BIDIR : 0));
+        return;
+    }
+    else if (info.component_->GetType() == NavArea::GetTypeStatic())
+    {
+        auto* area = static_cast<NavArea*>(info.component_);
+        NavAreaStub stub;
+        stub.areaID_ = (unsigned char)area->GetAreaID();
+        stub.bounds_ = area->GetWorldBoundingBox();
+        build->navAreas_.Push(stub);
+        return;
+    }
 
-                default:
-                    break;
-                }
+#ifdef URHO3D_PHYSICS
+    auto* shape = dynamic_cast<CollisionShape*>(info.component_);
+    if (shape)
+    {
+        switch (shape->GetShapeType())
+        {
+        case SHAPE_TRIANGLEMESH:
+            {
+                Model* model = shape->GetModel();
+                if (!model)
+                    return;
 
-                continue;
+                unsigned lodLevel = shape->GetLodLevel();
+                for (unsigned j = 0; j < model->GetNumGeometries(); ++j)
+                    AddTriMeshGeometry(build, model->GetGeometry(j, lodLevel), transform);
             }
-#endif
-            auto* drawable = dynamic_cast<Drawable*>(geometryList[i].component_);
-            if (drawable)
+            break;
+
+        case SHAPE_CONVEXHULL:
             {
-                const Vector<SourceBatch>& batches = drawable->GetBatches();
+                auto* data = static_cast<ConvexData*>(shape->GetGeometryData());
+                if (!data)
+                    return;
+
+                unsigned numVertices = data->vertexCount_;
+                unsigned numIndices = data->indexCount_;
+                unsigned destVertexStart = build->vertices_.Size();
 
-                for (unsigned j = 0; j < batches.Size(); ++j)
-                    AddTriMeshGeometry(build, drawable->GetLodGeometry(j, geometryList[i].lodLevel_), transform);
+                for (unsigned j = 0; j < numVertices; ++j)
+                    build->vertices_.Push(transform * data->vertexData_[j]);
+
+                for (unsigned j = 0; j < numIndices; ++j)
+                    build->indices_.Push(data->indexData_[j] + destVertexStart);
+            }
+            break;
+
+        case SHAPE_BOX:
+            {
+                unsigned destVertexStart = build->vertices_.Size();
+
+                build->vertices_.Push(transform * Vector3(-0.5f, 0.5f, -0.5f));
+                build->vertices_.Push(transform * Vector3(0.5f, 0.5f, -0.5f));
+                build->vertices_.Push(transform * Vector3(0.5f, -0.5f, -0.5f));
+                build->vertices_.Push(transform * Vector3(-0.5f, -0.5f, -0.5f));
+                build->vertices_.Push(transform * Vector3(-0.5f, 0.5f, 0.5f));
+                build->vertices_.Push(transform * Vector3(0.5f, 0.5f, 0.5f));
+                build->vertices_.Push(transform * Vector3(0.5f, -0.5f, 0.5f));
+                build->vertices_.Push(transform * Vector3(-0.5f, -0.5f, 0.5f));
+
+                const unsigned indices[] = {
+                    0, 1, 2, 0, 2, 3, 1, 5, 6, 1, 6, 2, 4, 5, 1, 4, 1, 0, 5, 4, 7, 5, 7, 6,
+                    4, 0, 3, 4, 3, 7, 1, 0, 4, 1, 4, 5
+                };
+
+                for (unsigned index : indices)
+                    build->indices_.Push(index + destVertexStart);
             }
+            break;
+
+        default:
+            break;
         }
+
+        return;
+    }
+#endif
+    auto* drawable = dynamic_cast<Drawable*>(info.component_);
+    if (drawable)
+    {
+        const Vector<SourceBatch>& batches = drawable->GetBatches();
+
+        for (unsigned j = 0; j < batches.Size(); ++j)
+            AddTriMeshGeometry(build, drawable->GetLodGeometry(j, info.lodLevel_), transform);
     }
 }
 
@@ -1286,6 +1610,8 @@ bool NavigationMesh::ReadTile(Deserializer& source, bool silent)
         return false;
     }
 
+    InvalidatePathRequests();
+
     // Send event
     if (!silent)
     {
@@ -1299,19 +1625,229 @@ bool NavigationMesh::ReadTile(Deserializer& source, bool silent)
     return true;
 }
 
-bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int x, int z)
+void NavigationMesh::WaitForBuild(bool buildPending)
 {
-    URHO3D_PROFILE(BuildNavigationMeshTile);
+    auto* queue = GetSubsystem<WorkQueue>();
 
-    // Remove previous tile (if any)
-    navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
+    for (unsigned i = 0; i < buildJob_->workItems_.Size(); ++i)
+    {
+        const SharedPtr<WorkItem>& item = buildJob_->workItems_[i];
+        if (item->completed_)
+            continue;
 
-    const BoundingBox tileBoundingBox = GetTileBoudningBox(IntVector2(x, z));
+        if (!queue || queue->RemoveWorkItem(item))
+        {
+            if (buildPending)
+                BuildTileData(*buildJob_, buildJob_->tiles_[i]);
+        }
+        else
+        {
+            // Already being built in a worker thread
+            while (!item->completed_)
+                Time::Sleep(1);
+        }
+    }
+}
 
-    SimpleNavBuildData build;
+void NavigationMesh::UpdateBuild(bool complete)
+{
+    // Hold a reference, as event handlers may cancel the build or start a new one
+    SharedPtr<NavBuildJob> job = buildJob_;
+    unsigned numInserted = job->numInserted_;
+
+    for (unsigned i = 0; i < job->tiles_.Size(); ++i)
+    {
+        NavBuildTile& tile = job->tiles_[i];
+        if (tile.inserted_ || (!complete && !job->workItems_[i]->completed_))
+            continue;
+
+        tile.inserted_ = true;
+        ++job->numInserted_;
+        job->numBuilt_ += InsertTile(*job, tile);
+        if (buildJob_ != job)
+            break;
+    }
+
+    if (job->numInserted_ == numInserted)
+        return;
+
+    // Invalidate the path requests once for all the tiles inserted during this update
+    InvalidatePathRequests();
+    if (buildJob_ != job)
+        return;
 
-    rcConfig cfg;
-    memset(&cfg, 0, sizeof cfg);
+    bool finished = job->numInserted_ == job->tiles_.Size();
+    if (finished)
+    {
+        buildJob_.Reset();
+        UpdateFrameSubscription();
+    }
+
+    {
+        using namespace NavigationBuildProgress;
+        VariantMap& eventData = GetContext()->GetEventDataMap();
+        eventData[P_NODE] = GetNode();
+        eventData[P_MESH] = this;
+        eventData[P_PROGRESS] = (float)job->numInserted_ / (float)job->tiles_.Size();
+        SendEvent(E_NAVIGATION_BUILD_PROGRESS, eventData);
+    }
+
+    if (finished)
+    {
+        if (job->fullBuild_)
+            FinishFullBuild(job->numBuilt_);
+        else
+            URHO3D_LOGDEBUG("Rebuilt " + String(job->numBuilt_) + " tiles of the navigation mesh");
+    }
+}
+
+void NavigationMesh::UpdatePathRequests()
+{
+    if (!GetNumPathRequests())
+        return;
+
+    URHO3D_PROFILE(UpdatePathRequests);
+
+    NavPathQueryData& data = *pathQueries_;
+    Vector<SharedPtr<NavPathLane> >& lanes = data.lanes_;
+    bool initialized = navMesh_ && node_;
+
+    for (unsigned i = 0; i < lanes.Size() && initialized; ++i)
+    {
+        NavPathLane* lane = lanes[i];
+        if (lane->query_)
+            continue;
+
+        lane->query_ = dtAllocNavMeshQuery();
+        if (!lane->query_ || dtStatusFailed(lane->query_->init(navMesh_, MAX_POLYS)))
+        {
+            URHO3D_LOGERROR("Could not init navigation mesh query for path requests");
+            dtFreeNavMeshQuery(lane->query_);
+            lane->query_ = nullptr;
+            initialized = false;
+        }
+    }
+
+    if (initialized)
+    {
+        // Copy the filter, as its area costs may change while the lanes are processed
+        data.filter_ = *queryFilter_;
+        int laneBudget = Max(pathQueryBudget_ / (int)lanes.Size(), 1);
+
+        auto* queue = GetSubsystem<WorkQueue>();
+        if (queue && lanes.Size() > 1)
+        {
+            queue->ParallelFor(lanes.Size(), 1, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    ProcessPathLane(*lanes[i], data, laneBudget);
+            });
+        }
+        else
+        {
+            for (unsigned i = 0; i < lanes.Size(); ++i)
+                ProcessPathLane(*lanes[i], data, laneBudget);
+        }
+    }
+
+    // Take the finished requests out of the lanes before sending the results, as event handlers may add or cancel requests
+    Vector<NavPathRequest> results;
+    for (unsigned i = 0; i < lanes.Size(); ++i)
+    {
+        List<NavPathRequest>& requests = lanes[i]->requests_;
+        for (List<NavPathRequest>::Iterator j = requests.Begin(); j != requests.End();)
+        {
+            if (j->finished_ || !initialized)
+            {
+                results.Push(*j);
+                j = requests.Erase(j);
+            }
+            else
+                ++j;
+        }
+    }
+
+    if (pathCacheSize_)
+    {
+        HashMap<Pair<dtPolyRef, dtPolyRef>, PODVector<dtPolyRef> >& cache = data.cache_;
+        for (unsigned i = 0; i < results.Size(); ++i)
+        {
+            const NavPathRequest& request = results[i];
+            if (request.polys_.Empty())
+                continue;
+
+            // Move a used path to the back to keep it cached longest
+            Pair<dtPolyRef, dtPolyRef> key = MakePair(request.startRef_, request.endRef_);
+            if (request.cached_)
+                cache.Erase(key);
+            cache[key] = request.polys_;
+        }
+
+        while (cache.Size() > pathCacheSize_)
+            cache.Erase(cache.Begin());
+    }
+
+    UpdateFrameSubscription();
+
+    WeakPtr<NavigationMesh> self(this);
+    for (unsigned i = 0; i < results.Size(); ++i)
+    {
+        const NavPathRequest& request = results[i];
+
+        // Transform path result back to world space
+        VariantVector path;
+        if (node_)
+        {
+            const Matrix3x4& transform = node_->GetWorldTransform();
+            for (unsigned j = 0; j < request.points_.Size(); ++j)
+                path.Push(transform * request.points_[j]);
+        }
+
+        using namespace NavigationPathFound;
+        VariantMap& eventData = GetContext()->GetEventDataMap();
+        eventData[P_NODE] = GetNode();
+        eventData[P_MESH] = this;
+        eventData[P_REQUEST] = request.id_;
+        eventData[P_SUCCESS] = !path.Empty();
+        eventData[P_PATH] = path;
+        SendEvent(E_NAVIGATION_PATH_FOUND, eventData);
+
+        // The mesh may have been destroyed by the event handler
+        if (self.Expired())
+            return;
+    }
+}
+
+void NavigationMesh::UpdateFrameSubscription()
+{
+    if (buildJob_ || GetNumPathRequests())
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(NavigationMesh, HandleBeginFrame));
+    else
+        UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
+void NavigationMesh::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    WeakPtr<NavigationMesh> self(this);
+
+    if (buildJob_)
+        UpdateBuild(false);
+    if (!self.Expired())
+        UpdatePathRequests();
+}
+
+void NavigationMesh::BuildTileWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    auto* mesh = static_cast<const NavigationMesh*>(item->aux_);
+    mesh->BuildTileData(*static_cast<const NavBuildJob*>(item->start_), *static_cast<NavBuildTile*>(item->end_));
+}
+
+SharedPtr<NavBuildJob> NavigationMesh::CreateBuildJob(const Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from,
+    const IntVector2& to, bool fullBuild)
+{
+    SharedPtr<NavBuildJob> job(new NavBuildJob());
+
+    rcConfig& cfg = *job->config_;
     cfg.cs = cellSize_;
     cfg.ch = cellHeight_;
     cfg.walkableSlopeAngle = agentMaxSlope_;
@@ -1330,31 +1866,72 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
     cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
     cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
 
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
+    job->agentHeight_ = agentHeight_;
+    job->agentRadius_ = agentRadius_;
+    job->agentMaxClimb_ = agentMaxClimb_;
+    job->watershed_ = partitionType_ == NAVMESH_PARTITION_WATERSHED;
+    job->fullBuild_ = fullBuild;
+
+    BoundingBox buildBox;
+    for (int z = from.y_; z <= to.y_; ++z)
+    {
+        for (int x = from.x_; x <= to.x_; ++x)
+        {
+            NavBuildTile tile;
+            tile.tile_ = IntVector2(x, z);
+            tile.boundingBox_ = GetTileBoudningBox(tile.tile_);
+            buildBox.Merge(tile.boundingBox_);
+            job->tiles_.Push(tile);
+        }
+    }
+
+    // Extract the geometry of all tiles including their borders, so that the tile builds do not need to access the scene
+    if (buildBox.Defined())
+    {
+        float border = cfg.borderSize * cfg.cs;
+        buildBox.min_ -= Vector3(border, 0.0f, border);
+        buildBox.max_ += Vector3(border, 0.0f, border);
+        GetBuildGeometry(job->geometry_, geometryList, buildBox);
+    }
+
+    return job;
+}
+
+void NavigationMesh::BuildTileData(const NavBuildJob& job, NavBuildTile& tile) const
+{
+    URHO3D_PROFILE(BuildNavigationMeshTile);
+
+    SimpleNavBuildData build;
+
+    rcConfig cfg = *job.config_;
+    rcVcopy(cfg.bmin, &tile.boundingBox_.min_.x_);
+    rcVcopy(cfg.bmax, &tile.boundingBox_.max_.x_);
     cfg.bmin[0] -= cfg.borderSize * cfg.cs;
     cfg.bmin[2] -= cfg.borderSize * cfg.cs;
     cfg.bmax[0] += cfg.borderSize * cfg.cs;
     cfg.bmax[2] += cfg.borderSize * cfg.cs;
 
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+    job.geometry_.GetTileGeometry(&build, expandedBox);
 
     if (build.vertices_.Empty() || build.indices_.Empty())
-        return true; // Nothing to do
+    {
+        tile.success_ = true;
+        return; // Nothing to do
+    }
 
     build.heightField_ = rcAllocHeightfield();
     if (!build.heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return false;
+        return;
     }
 
     if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return false;
+        return;
     }
 
     unsigned numTriangles = build.indices_.Size() / 3;
@@ -1374,18 +1951,18 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
     if (!build.compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return false;
+        return;
     }
     if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
         *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return false;
+        return;
     }
     if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return false;
+        return;
     }
 
     // Mark area volumes
@@ -1393,18 +1970,18 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
         rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
             build.navAreas_[i].areaID_, *build.compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (job.watershed_)
     {
         if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return false;
+            return;
         }
         if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return false;
+            return;
         }
     }
     else
@@ -1412,7 +1989,7 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
         if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return false;
+            return;
         }
     }
 
@@ -1420,38 +1997,38 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
     if (!build.contourSet_)
     {
         URHO3D_LOGERROR("Could not allocate contour set");
-        return false;
+        return;
     }
     if (!rcBuildContours(build.ctx_, *build.compactHeightField_, cfg.maxSimplificationError, cfg.maxEdgeLen,
         *build.contourSet_))
     {
         URHO3D_LOGERROR("Could not create contours");
-        return false;
+        return;
     }
 
     build.polyMesh_ = rcAllocPolyMesh();
     if (!build.polyMesh_)
     {
         URHO3D_LOGERROR("Could not allocate poly mesh");
-        return false;
+        return;
     }
     if (!rcBuildPolyMesh(build.ctx_, *build.contourSet_, cfg.maxVertsPerPoly, *build.polyMesh_))
     {
         URHO3D_LOGERROR("Could not triangulate contours");
-        return false;
+        return;
     }
 
     build.polyMeshDetail_ = rcAllocPolyMeshDetail();
     if (!build.polyMeshDetail_)
     {
         URHO3D_LOGERROR("Could not allocate detail mesh");
-        return false;
+        return;
     }
     if (!rcBuildPolyMeshDetail(build.ctx_, *build.polyMesh_, *build.compactHeightField_, cfg.detailSampleDist,
         cfg.detailSampleMaxError, *build.polyMeshDetail_))
     {
         URHO3D_LOGERROR("Could not build detail mesh");
-        return false;
+        return;
     }
 
     // Set polygon flags
@@ -1479,11 +2056,11 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
     params.detailVertsCount = build.polyMeshDetail_->nverts;
     params.detailTris = build.polyMeshDetail_->tris;
     params.detailTriCount = build.polyMeshDetail_->ntris;
-    params.walkableHeight = agentHeight_;
-    params.walkableRadius = agentRadius_;
-    params.walkableClimb = agentMaxClimb_;
-    params.tileX = x;
-    params.tileY = z;
+    params.walkableHeight = job.agentHeight_;
+    params.walkableRadius = job.agentRadius_;
+    params.walkableClimb = job.agentMaxClimb_;
+    params.tileX = tile.tile_.x_;
+    params.tileY = tile.tile_.y_;
     rcVcopy(params.bmin, build.polyMesh_->bmin);
     rcVcopy(params.bmax, build.polyMesh_->bmax);
     params.cs = cfg.cs;
@@ -1504,14 +2081,33 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
     if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
     {
         URHO3D_LOGERROR("Could not build navigation mesh tile data");
-        return false;
+        return;
     }
 
-    if (dtStatusFailed(navMesh_->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+    tile.data_.Push(navData);
+    tile.dataSizes_.Push(navDataSize);
+    tile.success_ = true;
+}
+
+unsigned NavigationMesh::InsertTile(NavBuildJob& /*job*/, NavBuildTile& tile)
+{
+    // Remove previous tile (if any)
+    navMesh_->removeTile(navMesh_->getTileRefAt(tile.tile_.x_, tile.tile_.y_, 0), nullptr, nullptr);
+
+    if (!tile.success_)
+        return 0;
+    if (tile.data_.Empty())
+        return 1; // Nothing to do
+
+    // The navigation mesh takes ownership of the data
+    unsigned char* navData = tile.data_[0];
+    tile.data_.Clear();
+
+    if (dtStatusFailed(navMesh_->addTile(navData, tile.dataSizes_[0], DT_TILE_FREE_DATA, 0, nullptr)))
     {
         URHO3D_LOGERROR("Failed to add navigation mesh tile");
         dtFree(navData);
-        return false;
+        return 0;
     }
 
     // Send a notification of the rebuild of this tile to anyone interested
@@ -1520,25 +2116,86 @@ bool NavigationMesh::BuildTile(Vector<NavigationGeometryInfo>& geometryList, int
         VariantMap& eventData = GetContext()->GetEventDataMap();
         eventData[P_NODE] = GetNode();
         eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
+        eventData[P_BOUNDSMIN] = Variant(tile.boundingBox_.min_);
+        eventData[P_BOUNDSMAX] = Variant(tile.boundingBox_.max_);
         SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
     }
-    return true;
+    return 1;
 }
 
-unsigned NavigationMesh::BuildTiles(Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
+void NavigationMesh::FinishFullBuild(unsigned numTiles)
 {
-    unsigned numTiles = 0;
+    URHO3D_LOGDEBUG("Built navigation mesh with " + String(numTiles) + " tiles");
 
-    for (int z = from.y_; z <= to.y_; ++z)
+    // Send a notification event to concerned parties that we've been fully rebuilt
     {
-        for (int x = from.x_; x <= to.x_; ++x)
+        using namespace NavigationMeshRebuilt;
+        VariantMap& buildEventParams = GetContext()->GetEventDataMap();
+        buildEventParams[P_NODE] = node_;
+        buildEventParams[P_MESH] = this;
+        SendEvent(E_NAVIGATION_MESH_REBUILT, buildEventParams);
+    }
+}
+
+unsigned NavigationMesh::BuildTiles(Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to,
+    bool fullBuild)
+{
+    // Finish a previous background build first so that its tiles do not replace the new ones
+    CompleteBuild();
+
+    SharedPtr<NavBuildJob> job = CreateBuildJob(geometryList, from, to, fullBuild);
+    auto* queue = GetSubsystem<WorkQueue>();
+
+    if (asyncBuild_ && queue && !job->tiles_.Empty())
+    {
+        buildJob_ = job;
+
+        for (unsigned i = 0; i < job->tiles_.Size(); ++i)
+        {
+            // Use own work items instead of pooled ones, as their completion is checked after the work queue has purged them.
+            // Use the lowest priority, so that waiting for the frame's parallel work never waits for the tiles
+            SharedPtr<WorkItem> item(new WorkItem());
+            item->workFunction_ = BuildTileWork;
+            item->aux_ = this;
+            item->start_ = job.Get();
+            item->end_ = &job->tiles_[i];
+            item->priority_ = 0;
+            job->workItems_.Push(item);
+            queue->AddWorkItem(item);
+        }
+
+        UpdateFrameSubscription();
+        return 0;
+    }
+
+    {
+        URHO3D_PROFILE(BuildNavigationMeshTiles);
+
+        // The tile builds only access the job, so they can run in parallel
+        if (queue && Thread::IsMainThread())
+        {
+            queue->ParallelFor(job->tiles_.Size(), 1, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    BuildTileData(*job, job->tiles_[i]);
+            });
+        }
+        else
         {
-            if (BuildTile(geometryList, x, z))
-                ++numTiles;
+            for (unsigned i = 0; i < job->tiles_.Size(); ++i)
+                BuildTileData(*job, job->tiles_[i]);
         }
     }
+
+    // Insert the tiles in order in the main thread
+    unsigned numTiles = 0;
+    for (unsigned i = 0; i < job->tiles_.Size(); ++i)
+    {
+        job->tiles_[i].inserted_ = true;
+        numTiles += InsertTile(*job, job->tiles_[i]);
+    }
+    InvalidatePathRequests();
+
     return numTiles;
 }
 
@@ -1566,8 +2223,36 @@ bool NavigationMesh::InitializeQuery()
     return true;
 }
 
+void NavigationMesh::InvalidatePathRequests()
+{
+    Vector<SharedPtr<NavPathLane> >& lanes = pathQueries_->lanes_;
+    for (unsigned i = 0; i < lanes.Size(); ++i)
+    {
+        List<NavPathRequest>& requests = lanes[i]->requests_;
+        for (List<NavPathRequest>::Iterator j = requests.Begin(); j != requests.End(); ++j)
+        {
+            j->searching_ = false;
+            j->cached_ = false;
+            j->polys_.Clear();
+        }
+    }
+
+    pathQueries_->cache_.Clear();
+}
+
 void NavigationMesh::ReleaseNavigationMesh()
 {
+    CancelBuild();
+
+    // Keep the path requests, as a rebuild allocates the new navigation mesh before they are updated
+    Vector<SharedPtr<NavPathLane> >& lanes = pathQueries_->lanes_;
+    for (unsigned i = 0; i < lanes.Size(); ++i)
+    {
+        dtFreeNavMeshQuery(lanes[i]->query_);
+        lanes[i]->query_ = nullptr;
+    }
+    InvalidatePathRequests();
+
     dtFreeNavMesh(navMesh_);
     navMesh_ = nullptr;
 
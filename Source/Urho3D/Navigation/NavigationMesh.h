@@ -51,7 +51,12 @@ class Geometry;
 class NavArea;
 
 struct FindPathData;
+struct NavPathQueryData;
 struct NavBuildData;
+struct NavBuildGeometry;
+struct NavBuildJob;
+struct NavBuildTile;
+struct WorkItem;
 
 /// Description of a navigation mesh geometry component, with transform and bounds information.
 struct NavigationGeometryInfo
@@ -169,6 +174,12 @@ public:
     void FindPath
         (PODVector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE,
             const dtQueryFilter* filter = nullptr);
+    /// Request a path between world space points to be found in worker threads during the following frames. The result is sent with the NavigationPathFound event. Return request ID, or 0 if the navigation mesh is not initialized.
+    unsigned FindPathAsync(const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE);
+    /// Cancel a path request. No result is sent for it.
+    void CancelPathRequest(unsigned requestID);
+    /// Return whether a path request is still waiting for its result.
+    bool IsPathRequestPending(unsigned requestID) const;
     /// Return a random point on the navigation mesh.
     Vector3 GetRandomPoint(const dtQueryFilter* filter = nullptr, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -272,11 +283,54 @@ public:
     /// Return whether to draw NavArea components.
     bool GetDrawNavAreas() const { return drawNavAreas_; }
 
+    /// Set whether to build tiles in the background. Build() then returns immediately and the tiles are inserted into the navigation mesh as they complete.
+    void SetAsyncBuild(bool enable) { asyncBuild_ = enable; }
+
+    /// Return whether to build tiles in the background.
+    bool GetAsyncBuild() const { return asyncBuild_; }
+
+    /// Return whether a background build is in progress.
+    bool IsBuilding() const { return buildJob_.NotNull(); }
+
+    /// Return progress of the background build from 0 to 1, or 1 if not building.
+    float GetBuildProgress() const;
+    /// Finish the background build immediately, building the remaining tiles in the main thread.
+    void CompleteBuild();
+    /// Cancel the background build. Tiles inserted so far are kept.
+    void CancelBuild();
+
+    /// Set the maximum number of path search iterations per frame for path requests. The budget is divided between the worker threads.
+    void SetPathQueryBudget(int iterations);
+
+    /// Return the maximum number of path search iterations per frame for path requests.
+    int GetPathQueryBudget() const { return pathQueryBudget_; }
+
+    /// Set the number of recently found paths to cache by their start and end polygons for path requests. 0 disables the cache.
+    void SetPathCacheSize(unsigned size);
+
+    /// Return the number of recently found paths to cache for path requests.
+    unsigned GetPathCacheSize() const { return pathCacheSize_; }
+
+    /// Return number of path requests waiting for their result.
+    unsigned GetNumPathRequests() const;
+
 private:
     /// Write tile data.
     void WriteTile(Serializer& dest, int x, int z) const;
     /// Read tile data to the navigation mesh.
     bool ReadTile(Deserializer& source, bool silent);
+    /// Take back the background work items which have not started, optionally building their tiles in the main thread, and wait for the rest to finish.
+    void WaitForBuild(bool buildPending);
+    /// Insert the tiles which have finished building in the background, and finish the build when all are inserted.
+    void UpdateBuild(bool complete);
+    /// Search paths for the pending path requests in worker threads and send the finished results.
+    void UpdatePathRequests();
+    /// Subscribe to the frame start event while a background build or path requests are pending.
+    void UpdateFrameSubscription();
+    /// Handle frame start event to insert tiles built in the background and to update path requests.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Build one tile in a worker thread.
+    static void BuildTileWork(const WorkItem* item, unsigned threadIndex);
 
 protected:
     /// Collect geometry from under Navigable components.
@@ -285,14 +339,27 @@ protected:
     void CollectGeometries(Vector<NavigationGeometryInfo>& geometryList, Node* node, HashSet<Node*>& processedNodes, bool recursive);
     /// Get geometry data within a bounding box.
     void GetTileGeometry(NavBuildData* build, Vector<NavigationGeometryInfo>& geometryList, BoundingBox& box);
+    /// Extract geometry data within a bounding box, so that tiles can be built without accessing the scene.
+    void GetBuildGeometry(NavBuildGeometry& dest, const Vector<NavigationGeometryInfo>& geometryList, const BoundingBox& box);
+    /// Add the geometry data of a navigable component.
+    void AddGeometry(NavBuildData* build, const NavigationGeometryInfo& info, const Matrix3x4& inverse);
     /// Add a triangle mesh to the geometry data.
     void AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform);
-    /// Build one tile of the navigation mesh. Return true if successful.
-    virtual bool BuildTile(Vector<NavigationGeometryInfo>& geometryList, int x, int z);
-    /// Build tiles in the rectangular area. Return number of built tiles.
-    unsigned BuildTiles(Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
+    /// Create a job for building the tiles in the rectangular area.
+    SharedPtr<NavBuildJob> CreateBuildJob(const Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to,
+        bool fullBuild);
+    /// Build the data of one tile. Called from worker threads, so may only access the job and the tile.
+    virtual void BuildTileData(const NavBuildJob& job, NavBuildTile& tile) const;
+    /// Insert a built tile into the navigation mesh. Return number of tiles added. The caller invalidates the path requests once after inserting a batch of tiles.
+    virtual unsigned InsertTile(NavBuildJob& job, NavBuildTile& tile);
+    /// Finish a full rebuild after all tiles have been inserted.
+    virtual void FinishFullBuild(unsigned numTiles);
+    /// Build tiles in the rectangular area, using worker threads. If building in the background, only start the build and return 0. Return number of built tiles.
+    unsigned BuildTiles(Vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to, bool fullBuild = false);
     /// Ensure that the navigation mesh query is initialized. Return true if successful.
     bool InitializeQuery();
+    /// Restart the searches of the pending path requests and clear the path cache after the navigation mesh has changed.
+    void InvalidatePathRequests();
     /// Release the navigation mesh and the query.
     virtual void ReleaseNavigationMesh();
 
@@ -306,6 +373,8 @@ protected:
     UniquePtr<dtQueryFilter> queryFilter_;
     /// Temporary data for finding a path.
     UniquePtr<FindPathData> pathData_;
+    /// Path requests and the path cache.
+    UniquePtr<NavPathQueryData> pathQueries_;
     /// Tile size.
     int tileSize_;
     /// Cell size.
@@ -350,6 +419,14 @@ protected:
     bool drawNavAreas_;
     /// NavAreas for this NavMesh
     Vector<WeakPtr<NavArea> > areas_;
+    /// Build tiles in the background.
+    bool asyncBuild_;
+    /// Background build in progress.
+    SharedPtr<NavBuildJob> buildJob_;
+    /// Path search iterations per frame for path requests.
+    int pathQueryBudget_;
+    /// Number of cached paths for path requests.
+    unsigned pathCacheSize_;
 };
 
 /// Register Navigation library objects.
@@ -249,12 +249,47 @@ void Connection::SendServerUpdate()
     // Always check the root node (scene) first so that the scene-wide components get sent first,
     // and all other replicated nodes get added to the dirty set for sending the initial state
     unsigned sceneID = scene_->GetID();
-    nodesToProcess_.Insert(sceneID);
-    ProcessNode(sceneID);
+    if (CheckNodePriority(sceneID))
+    {
+        nodesToProcess_.Insert(sceneID);
+        ProcessNode(sceneID);
+    }
+
+    // Then go through all dirtied nodes. Update the interest management accumulators in bulk first and leave out
+    // the nodes that should not update now, so that they will not be processed as dependencies either.
+    // Existing nodes in the scene's interest management grid are taken out of the dirty set. They stay marked dirty,
+    // and are found again through the grid once the observer is near
+    for (HashSet<unsigned>::Iterator i = sceneState_.dirtyNodes_.Begin(); i != sceneState_.dirtyNodes_.End();)
+    {
+        unsigned nodeID = *i;
+        // Do not process the root node twice
+        if (nodeID == sceneID)
+            ++i;
+        else if (IsNodeInNetworkGrid(nodeID))
+            i = sceneState_.dirtyNodes_.Erase(i);
+        else
+        {
+            if (CheckNodePriority(nodeID))
+                nodesToProcess_.Insert(nodeID);
+            ++i;
+        }
+    }
+
+    // Check the dirty grid nodes near the observer, so that the cost depends on the nearby nodes only
+    scene_->GetNetworkGridNodes(relevantNodes_, position_);
+    for (PODVector<unsigned>::ConstIterator i = relevantNodes_.Begin(); i != relevantNodes_.End(); ++i)
+    {
+        unsigned nodeID = *i;
+        HashMap<unsigned, NodeReplicationState>::ConstIterator j = sceneState_.nodeStates_.Find(nodeID);
+        if (j == sceneState_.nodeStates_.End() || !j->second_.markedDirty_ || sceneState_.dirtyNodes_.Contains(nodeID))
+            continue;
 
-    // Then go through all dirtied nodes
-    nodesToProcess_.Insert(sceneState_.dirtyNodes_);
-    nodesToProcess_.Erase(sceneID); // Do not process the root node twice
+        if (CheckNodePriority(nodeID))
+        {
+            sceneState_.dirtyNodes_.Insert(nodeID);
+            nodesToProcess_.Insert(nodeID);
+        }
+    }
 
     while (nodesToProcess_.Size())
     {
@@ -945,7 +980,7 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
         StringHash eventType = msg.ReadStringHash();
         if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
         {
-            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToDebugString());
             return;
         }
 
@@ -965,7 +1000,7 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
         StringHash eventType = msg.ReadStringHash();
         if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
         {
-            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToDebugString());
             return;
         }
 
@@ -1122,6 +1157,9 @@ void Connection::ProcessNode(unsigned nodeID)
             // would be enough. However, this may be better due to the client not possibly having updated parenting
             // information at the time of receiving this message
             SendMessage(MSG_REMOVENODE, true, true, msg_);
+
+            // Releasing the weak references to the removed node and its components is not threadsafe
+            MutexLock lock(GetSubsystem<Network>()->GetReplicationMutex());
             sceneState_.nodeStates_.Erase(nodeID);
         }
         else
@@ -1155,11 +1193,17 @@ void Connection::ProcessNewNode(Node* node)
     msg_.Clear();
     msg_.WriteNetID(node->GetID());
 
+    // Weak references and replication state registration are shared with other connections being updated in parallel
+    Mutex& replicationMutex = GetSubsystem<Network>()->GetReplicationMutex();
+
     NodeReplicationState& nodeState = sceneState_.nodeStates_[node->GetID()];
     nodeState.connection_ = this;
     nodeState.sceneState_ = &sceneState_;
-    nodeState.node_ = node;
-    node->AddReplicationState(&nodeState);
+    {
+        MutexLock lock(replicationMutex);
+        nodeState.node_ = node;
+        node->AddReplicationState(&nodeState);
+    }
 
     // Write node's attributes
     node->WriteInitialDeltaUpdate(msg_, timeStamp_);
@@ -1186,8 +1230,11 @@ void Connection::ProcessNewNode(Node* node)
         ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
         componentState.connection_ = this;
         componentState.nodeState_ = &nodeState;
-        componentState.component_ = component;
-        component->AddReplicationState(&componentState);
+        {
+            MutexLock lock(replicationMutex);
+            componentState.component_ = component;
+            component->AddReplicationState(&componentState);
+        }
 
         msg_.WriteStringHash(component->GetType());
         msg_.WriteNetID(component->GetID());
@@ -1200,6 +1247,39 @@ void Connection::ProcessNewNode(Node* node)
     sceneState_.dirtyNodes_.Erase(node->GetID());
 }
 
+bool Connection::CheckNodePriority(unsigned nodeID)
+{
+    HashMap<unsigned, NodeReplicationState>::Iterator i = sceneState_.nodeStates_.Find(nodeID);
+    if (i == sceneState_.nodeStates_.End())
+        return true;
+
+    Node* node = i->second_.node_;
+    if (!node)
+        return true;
+
+    NetworkPriority* priority = node->GetNetworkPriority();
+    if (!priority || (priority->GetAlwaysUpdateOwner() && node->GetOwner() == this))
+        return true;
+
+    float distanceSquared = (node->GetNetworkPosition() - position_).LengthSquared();
+    return priority->CheckUpdateSquared(distanceSquared, i->second_.priorityAcc_);
+}
+
+bool Connection::IsNodeInNetworkGrid(unsigned nodeID) const
+{
+    HashMap<unsigned, NodeReplicationState>::ConstIterator i = sceneState_.nodeStates_.Find(nodeID);
+    if (i == sceneState_.nodeStates_.End())
+        return false;
+
+    Node* node = i->second_.node_;
+    if (!node || !node->IsInNetworkGrid())
+        return false;
+
+    // Nodes updated always at full rate to their owner are checked from the dirty set as usual
+    NetworkPriority* priority = node->GetNetworkPriority();
+    return priority && !(priority->GetAlwaysUpdateOwner() && node->GetOwner() == this);
+}
+
 void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState)
 {
     // Process depended upon nodes first, if they are dirty
@@ -1211,16 +1291,6 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             ProcessNode(nodeID);
     }
 
-    // Check from the interest management component, if exists, whether should update
-    /// \todo Searching for the component is a potential CPU hotspot. It should be cached
-    auto* priority = node->GetComponent<NetworkPriority>();
-    if (priority && (!priority->GetAlwaysUpdateOwner() || node->GetOwner() != this))
-    {
-        float distance = (node->GetWorldPosition() - position_).Length();
-        if (!priority->CheckUpdate(distance, nodeState.priorityAcc_))
-            return;
-    }
-
     // Check if attributes have changed
     if (nodeState.dirtyAttributes_.Count() || nodeState.dirtyVars_.Size())
     {
@@ -1295,6 +1365,8 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             msg_.WriteNetID(current->first_);
 
             SendMessage(MSG_REMOVECOMPONENT, true, true, msg_);
+
+            MutexLock lock(GetSubsystem<Network>()->GetReplicationMutex());
             nodeState.componentStates_.Erase(current);
         }
         else
@@ -1358,8 +1430,11 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
                 componentState.connection_ = this;
                 componentState.nodeState_ = &nodeState;
-                componentState.component_ = component;
-                component->AddReplicationState(&componentState);
+                {
+                    MutexLock lock(GetSubsystem<Network>()->GetReplicationMutex());
+                    componentState.component_ = component;
+                    component->AddReplicationState(&componentState);
+                }
 
                 msg_.Clear();
                 msg_.WriteNetID(node->GetID());
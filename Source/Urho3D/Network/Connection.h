@@ -255,6 +255,10 @@ private:
     void ProcessNewNode(Node* node);
     /// Process a node that the client has already received.
     void ProcessExistingNode(Node* node, NodeReplicationState& nodeState);
+    /// Check from the interest management component, if exists, whether a node should be processed on this update. New and removed nodes are always processed.
+    bool CheckNodePriority(unsigned nodeID);
+    /// Return whether an existing node is in the scene's interest management grid, so that it is checked only when the observer is near.
+    bool IsNodeInNetworkGrid(unsigned nodeID) const;
     /// Process a SyncPackagesInfo message from server.
     void ProcessPackageInfo(int msgID, MemoryBuffer& msg);
     /// Check a package list received from server and initiate package downloads as necessary. Return true on success, or false if failed to initialze downloads (cache dir not set)
@@ -286,6 +290,8 @@ private:
     HashMap<unsigned, PODVector<unsigned char> > componentLatestData_;
     /// Node ID's to process during a replication update.
     HashSet<unsigned> nodesToProcess_;
+    /// Interest management grid node ID's near the observer, reused between updates.
+    PODVector<unsigned> relevantNodes_;
     /// Reusable message buffer.
     VectorBuffer msg_;
     /// Queued remote events.
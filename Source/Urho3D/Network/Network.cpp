@@ -514,13 +514,33 @@ void Network::PostUpdate(float timeStep)
             {
                 URHO3D_PROFILE(SendServerUpdate);
 
-                // Then send server updates for each client connection
+                serverUpdateConnections_.Clear();
                 for (HashMap<kNet::MessageConnection*, SharedPtr<Connection> >::Iterator i = clientConnections_.Begin();
                      i != clientConnections_.End(); ++i)
+                    serverUpdateConnections_.Push(i->second_);
+
+                // Then send server updates for each client connection. The connections only share the prepared network
+                // attribute values and replication state registration, so they can be serialized in parallel
+                auto* queue = GetSubsystem<WorkQueue>();
+                if (queue && serverUpdateConnections_.Size() > 1)
+                {
+                    queue->ParallelFor(serverUpdateConnections_.Size(), 0, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+                    {
+                        for (unsigned i = begin; i < end; ++i)
+                            serverUpdateConnections_[i]->SendServerUpdate();
+                    }, &serverUpdateCost_);
+                }
+                else
+                {
+                    for (unsigned i = 0; i < serverUpdateConnections_.Size(); ++i)
+                        serverUpdateConnections_[i]->SendServerUpdate();
+                }
+
+                // Remote events may send events and access resources, so send them from the main thread
+                for (unsigned i = 0; i < serverUpdateConnections_.Size(); ++i)
                 {
-                    i->second_->SendServerUpdate();
-                    i->second_->SendRemoteEvents();
-                    i->second_->SendPackages();
+                    serverUpdateConnections_[i]->SendRemoteEvents();
+                    serverUpdateConnections_[i]->SendPackages();
                 }
             }
         }
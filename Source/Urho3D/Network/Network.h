@@ -23,7 +23,9 @@
 #pragma once
 
 #include "../Container/HashSet.h"
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/VectorBuffer.h"
 #include "../Network/Connection.h"
 
@@ -129,6 +131,9 @@ public:
     /// Return the package download cache directory.
     const String& GetPackageCacheDir() const { return packageCacheDir_; }
 
+    /// Return the mutex that guards replication state changes shared between connections, which happen while client connections are updated in parallel.
+    Mutex& GetReplicationMutex() { return replicationMutex_; }
+
     /// Process incoming messages from connections. Called by HandleBeginFrame.
     void Update(float timeStep);
     /// Send outgoing messages after frame logic. Called by HandleRenderUpdate.
@@ -158,6 +163,12 @@ private:
     HashSet<StringHash> blacklistedRemoteEvents_;
     /// Networked scenes.
     HashSet<Scene*> networkScenes_;
+    /// Client connections being sent server updates.
+    PODVector<Connection*> serverUpdateConnections_;
+    /// Measured cost of the parallel server update.
+    ParallelForCost serverUpdateCost_;
+    /// Mutex for replication state changes shared between connections.
+    Mutex replicationMutex_;
     /// Update FPS.
     int updateFps_;
     /// Simulated latency (send delay) in milliseconds.
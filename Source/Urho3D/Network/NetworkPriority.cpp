@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Network/NetworkPriority.h"
+#include "../Scene/Node.h"
 
 #include "../DebugNew.h"
 
@@ -42,7 +43,8 @@ NetworkPriority::NetworkPriority(Context* context) :
     basePriority_(DEFAULT_BASE_PRIORITY),
     distanceFactor_(DEFAULT_DISTANCE_FACTOR),
     minPriority_(DEFAULT_MIN_PRIORITY),
-    alwaysUpdateOwner_(true)
+    alwaysUpdateOwner_(true),
+    registeredNode_(nullptr)
 {
 }
 
@@ -95,4 +97,44 @@ bool NetworkPriority::CheckUpdate(float distance, float& accumulator)
         return false;
 }
 
+bool NetworkPriority::CheckUpdateSquared(float distanceSquared, float& accumulator)
+{
+    // When there is no minimum priority, the priority reaches zero at a fixed distance. Reject nodes beyond it without
+    // calculating the actual distance, as adding zero priority would not change the accumulator
+    float relevanceDistance = GetRelevanceDistance();
+    if (relevanceDistance < M_INFINITY && distanceSquared >= relevanceDistance * relevanceDistance)
+        return false;
+
+    return CheckUpdate(sqrtf(distanceSquared), accumulator);
+}
+
+void NetworkPriority::OnNodeSet(Node* node)
+{
+    if (node)
+    {
+        node->SetNetworkPriority(this);
+        registeredNode_ = node;
+    }
+    else if (registeredNode_)
+    {
+        // If the node has another interest management component, let it take over
+        if (registeredNode_->GetNetworkPriority() == this)
+        {
+            PODVector<NetworkPriority*> priorities;
+            registeredNode_->GetComponents<NetworkPriority>(priorities);
+            NetworkPriority* replacement = nullptr;
+            for (PODVector<NetworkPriority*>::ConstIterator i = priorities.Begin(); i != priorities.End(); ++i)
+            {
+                if (*i != this)
+                {
+                    replacement = *i;
+                    break;
+                }
+            }
+            registeredNode_->SetNetworkPriority(replacement);
+        }
+        registeredNode_ = nullptr;
+    }
+}
+
 }
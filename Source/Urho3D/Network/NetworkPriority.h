@@ -61,8 +61,20 @@ public:
     /// Return whether updates to owner should be sent always at full rate.
     bool GetAlwaysUpdateOwner() const { return alwaysUpdateOwner_; }
 
+    /// Return distance at which the priority drops to zero and updates stop, or infinity if there is a minimum priority.
+    float GetRelevanceDistance() const
+    {
+        return minPriority_ <= 0.0f && distanceFactor_ > 0.0f ? basePriority_ / distanceFactor_ : M_INFINITY;
+    }
+
     /// Increment and check priority accumulator. Return true if should update. Called by Connection.
     bool CheckUpdate(float distance, float& accumulator);
+    /// Increment and check priority accumulator using squared distance. Beyond the distance where the priority drops to zero the accumulator is left untouched. Return true if should update. Called by Connection.
+    bool CheckUpdateSquared(float distanceSquared, float& accumulator);
+
+protected:
+    /// Handle node being assigned.
+    void OnNodeSet(Node* node) override;
 
 private:
     /// Base priority.
@@ -73,6 +85,8 @@ private:
     float minPriority_;
     /// Update owner at full rate flag.
     bool alwaysUpdateOwner_;
+    /// Node that caches this component for network updates.
+    Node* registeredNode_;
 };
 
 }
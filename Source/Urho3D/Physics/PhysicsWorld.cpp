@@ -25,6 +25,8 @@
 #include "../Core/Context.h"
 #include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
 #include "../IO/Log.h"
@@ -47,6 +49,10 @@
 #include <Bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#ifdef URHO3D_THREADING
+#include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <Bullet/BulletDynamics/Dynamics/btSimulationIslandManagerMt.h>
+#endif
 
 extern ContactAddedCallback gContactAddedCallback;
 
@@ -62,6 +68,102 @@ static const Vector3 DEFAULT_GRAVITY = Vector3(0.0f, -9.81f, 0.0f);
 
 PhysicsWorldConfig PhysicsWorld::config;
 
+#ifdef URHO3D_THREADING
+/// Work queue used to dispatch simulation islands on this thread while a multithreaded physics world is stepping. Bullet's island dispatch function takes no user pointer, so it is passed here.
+static thread_local WorkQueue* islandWorkQueue = nullptr;
+/// Index of the pool solver used by this thread to solve islands.
+static thread_local unsigned islandSolverIndex = 0;
+
+/// Constraint solver that owns a sequential impulse solver for each thread, so that simulation islands can be solved in parallel.
+class PhysicsSolverPool : public btConstraintSolver
+{
+public:
+    /// Construct with one solver.
+    PhysicsSolverPool()
+    {
+        SetNumSolvers(1);
+    }
+
+    /// Destruct.
+    ~PhysicsSolverPool() override
+    {
+        SetNumSolvers(0);
+    }
+
+    /// Set number of solvers. Must be at least the number of threads that solve islands.
+    void SetNumSolvers(unsigned num)
+    {
+        for (unsigned i = num; i < solvers_.Size(); ++i)
+            delete solvers_[i];
+        unsigned oldSize = solvers_.Size();
+        solvers_.Resize(num);
+        for (unsigned i = oldSize; i < num; ++i)
+            solvers_[i] = new btSequentialImpulseConstraintSolver();
+    }
+
+    /// Solve an island with the calling thread's solver.
+    btScalar solveGroup(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+        btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info, btIDebugDraw* debugDrawer,
+        btDispatcher* dispatcher) override
+    {
+        btSequentialImpulseConstraintSolver* solver = solvers_[islandSolverIndex];
+        // Restart the random sequence on each island, so that the result does not depend on which thread solved it
+        solver->reset();
+        return solver->solveGroup(bodies, numBodies, manifolds, numManifolds, constraints, numConstraints, info, debugDrawer,
+            dispatcher);
+    }
+
+    /// Reset all solvers.
+    void reset() override
+    {
+        for (unsigned i = 0; i < solvers_.Size(); ++i)
+            solvers_[i]->reset();
+    }
+
+    /// Return solver type.
+    btConstraintSolverType getSolverType() const override { return BT_SEQUENTIAL_IMPULSE_SOLVER; }
+
+private:
+    /// Solvers by thread index.
+    PODVector<btSequentialImpulseConstraintSolver*> solvers_;
+};
+
+static void DispatchIslands(btAlignedObjectArray<btSimulationIslandManagerMt::Island*>* islandsPtr,
+    btSimulationIslandManagerMt::IslandCallback* callback)
+{
+    btAlignedObjectArray<btSimulationIslandManagerMt::Island*>& islands = *islandsPtr;
+
+    if (!islandWorkQueue || islands.size() < 2)
+    {
+        btSimulationIslandManagerMt::defaultIslandDispatch(islandsPtr, callback);
+        return;
+    }
+
+    // Bullet orders the islands by decreasing size, so the largest ones start first. Each island is one work item
+    islandWorkQueue->ParallelFor((unsigned)islands.size(), 1, [&](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        islandSolverIndex = threadIndex;
+
+        for (unsigned i = begin; i < end; ++i)
+        {
+            btSimulationIslandManagerMt::Island* island = islands[i];
+            callback->processIsland(&island->bodyArray[0], island->bodyArray.size(),
+                island->manifoldArray.size() ? &island->manifoldArray[0] : nullptr, island->manifoldArray.size(),
+                island->constraintArray.size() ? &island->constraintArray[0] : nullptr, island->constraintArray.size(), island->id);
+        }
+
+        islandSolverIndex = 0;
+    });
+}
+
+/// Access to the actions of a Bullet world, so that they can be moved to a recreated world.
+struct PhysicsWorldActions : public btDiscreteDynamicsWorld
+{
+    /// Return the actions of a world.
+    static btAlignedObjectArray<btActionInterface*>& Get(btDiscreteDynamicsWorld* world) { return world->*(&PhysicsWorldActions::m_actions); }
+};
+#endif
+
 static bool CompareRaycastResults(const PhysicsRaycastResult& lhs, const PhysicsRaycastResult& rhs)
 {
     return lhs.distance_ < rhs.distance_;
@@ -148,6 +250,7 @@ struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
 PhysicsWorld::PhysicsWorld(Context* context) :
     Component(context),
     collisionConfiguration_(nullptr),
+    subStep_(0),
     fps_(DEFAULT_FPS),
     maxSubSteps_(0),
     timeAcc_(0.0f),
@@ -157,6 +260,7 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     internalEdge_(true),
     applyingTransforms_(false),
     simulating_(false),
+    multiThreaded_(false),
     debugRenderer_(nullptr),
     debugMode_(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawConstraints | btIDebugDraw::DBG_DrawConstraintLimits)
 {
@@ -171,16 +275,11 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.Get()));
 
     broadphase_ = new btDbvtBroadphase();
-    solver_ = new btSequentialImpulseConstraintSolver();
-    world_ = new btDiscreteDynamicsWorld(collisionDispatcher_.Get(), broadphase_.Get(), solver_.Get(), collisionConfiguration_);
+    CreateWorld();
 
     world_->setGravity(ToBtVector3(DEFAULT_GRAVITY));
     world_->getDispatchInfo().m_useContinuous = true;
     world_->getSolverInfo().m_splitImpulse = false; // Disable by default for performance
-    world_->setDebugDrawer(this);
-    world_->setInternalTickCallback(InternalPreTickCallback, static_cast<void*>(this), true);
-    world_->setInternalTickCallback(InternalTickCallback, static_cast<void*>(this), false);
-    world_->setSynchronizeAllMotionStates(true);
 }
 
 PhysicsWorld::~PhysicsWorld()
@@ -221,6 +320,7 @@ void PhysicsWorld::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
     URHO3D_ATTRIBUTE("Internal Edge Utility", bool, internalEdge_, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Split Impulse", GetSplitImpulse, SetSplitImpulse, bool, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Multithreaded", bool, multiThreaded_, false, AM_FILE);
 }
 
 bool PhysicsWorld::isVisible(const btVector3& aabbMin, const btVector3& aabbMax)
@@ -279,8 +379,21 @@ void PhysicsWorld::Update(float timeStep)
         maxSubSteps = Min(maxSubSteps, maxSubSteps_);
 
     delayedWorldTransforms_.Clear();
+    contactPairs_.Clear();
+    contactPoints_.Clear();
+    subStep_ = 0;
     simulating_ = true;
 
+#ifdef URHO3D_THREADING
+    // Solve the simulation islands in worker threads. The work queue can only be driven from the main thread
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (multiThreaded_ && workQueue && workQueue->GetNumThreads() && Thread::IsMainThread())
+    {
+        static_cast<PhysicsSolverPool*>(solver_.Get())->SetNumSolvers(workQueue->GetNumThreads() + 1);
+        islandWorkQueue = workQueue;
+    }
+#endif
+
     if (interpolation_)
         world_->stepSimulation(timeStep, maxSubSteps, internalTimeStep);
     else
@@ -294,6 +407,9 @@ void PhysicsWorld::Update(float timeStep)
         }
     }
 
+#ifdef URHO3D_THREADING
+    islandWorkQueue = nullptr;
+#endif
     simulating_ = false;
 
     // Apply delayed (parented) world transforms now
@@ -373,6 +489,23 @@ void PhysicsWorld::SetSplitImpulse(bool enable)
     MarkNetworkUpdate();
 }
 
+void PhysicsWorld::SetMultiThreaded(bool enable)
+{
+    if (enable == multiThreaded_)
+        return;
+
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Can not change multithreaded mode during the simulation step");
+        return;
+    }
+
+    multiThreaded_ = enable;
+#ifdef URHO3D_THREADING
+    RecreateWorld();
+#endif
+}
+
 void PhysicsWorld::SetMaxNetworkAngularVelocity(float velocity)
 {
     maxNetworkAngularVelocity_ = Clamp(velocity, 1.0f, 32767.0f);
@@ -831,6 +964,7 @@ void PhysicsWorld::PostStep(float timeStep)
 #endif
 
     SendCollisionEvents();
+    ++subStep_;
 
     // Send post-step event
     using namespace PhysicsPostStep;
@@ -851,52 +985,59 @@ void PhysicsWorld::SendCollisionEvents()
 
     int numManifolds = collisionDispatcher_->getNumManifolds();
 
-    if (numManifolds)
+    for (int i = 0; i < numManifolds; ++i)
     {
-        physicsCollisionData_[PhysicsCollision::P_WORLD] = this;
-
-        for (int i = 0; i < numManifolds; ++i)
+        btPersistentManifold* contactManifold = collisionDispatcher_->getManifoldByIndexInternal(i);
+        // First check that there are actual contacts, as the manifold exists also when objects are close but not touching
+        if (!contactManifold->getNumContacts())
+            continue;
+
+        const btCollisionObject* objectA = contactManifold->getBody0();
+        const btCollisionObject* objectB = contactManifold->getBody1();
+
+        auto* bodyA = static_cast<RigidBody*>(objectA->getUserPointer());
+        auto* bodyB = static_cast<RigidBody*>(objectB->getUserPointer());
+        // If it's not a rigidbody, maybe a ghost object
+        if (!bodyA || !bodyB)
+            continue;
+
+        // Skip collision event signaling if both objects are static, or if collision event mode does not match
+        if (bodyA->GetMass() == 0.0f && bodyB->GetMass() == 0.0f)
+            continue;
+        if (bodyA->GetCollisionEventMode() == COLLISION_NEVER || bodyB->GetCollisionEventMode() == COLLISION_NEVER)
+            continue;
+        if (bodyA->GetCollisionEventMode() == COLLISION_ACTIVE && bodyB->GetCollisionEventMode() == COLLISION_ACTIVE &&
+            !bodyA->IsActive() && !bodyB->IsActive())
+            continue;
+
+        WeakPtr<RigidBody> bodyWeakA(bodyA);
+        WeakPtr<RigidBody> bodyWeakB(bodyB);
+
+        // First only store the collision pair as weak pointers and the manifold pointer, so user code can safely destroy
+        // objects during collision event handling
+        Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> > bodyPair;
+        if (bodyA < bodyB)
         {
-            btPersistentManifold* contactManifold = collisionDispatcher_->getManifoldByIndexInternal(i);
-            // First check that there are actual contacts, as the manifold exists also when objects are close but not touching
-            if (!contactManifold->getNumContacts())
-                continue;
-
-            const btCollisionObject* objectA = contactManifold->getBody0();
-            const btCollisionObject* objectB = contactManifold->getBody1();
-
-            auto* bodyA = static_cast<RigidBody*>(objectA->getUserPointer());
-            auto* bodyB = static_cast<RigidBody*>(objectB->getUserPointer());
-            // If it's not a rigidbody, maybe a ghost object
-            if (!bodyA || !bodyB)
-                continue;
+            bodyPair = MakePair(bodyWeakA, bodyWeakB);
+            currentCollisions_[bodyPair].manifold_ = contactManifold;
+        }
+        else
+        {
+            bodyPair = MakePair(bodyWeakB, bodyWeakA);
+            currentCollisions_[bodyPair].flippedManifold_ = contactManifold;
+        }
+    }
 
-            // Skip collision event signaling if both objects are static, or if collision event mode does not match
-            if (bodyA->GetMass() == 0.0f && bodyB->GetMass() == 0.0f)
-                continue;
-            if (bodyA->GetCollisionEventMode() == COLLISION_NEVER || bodyB->GetCollisionEventMode() == COLLISION_NEVER)
-                continue;
-            if (bodyA->GetCollisionEventMode() == COLLISION_ACTIVE && bodyB->GetCollisionEventMode() == COLLISION_ACTIVE &&
-                !bodyA->IsActive() && !bodyB->IsActive())
-                continue;
+    // Record the contact stream before sending any events, so that it is complete even if event handlers remove bodies
+    RecordContacts();
 
-            WeakPtr<RigidBody> bodyWeakA(bodyA);
-            WeakPtr<RigidBody> bodyWeakB(bodyB);
+    // The per-pair events are only generated when something is subscribed to them
+    bool physicsEvents = HasEventReceivers(this, E_PHYSICSCOLLISIONSTART) || HasEventReceivers(this, E_PHYSICSCOLLISION);
+    bool physicsEndEvents = HasEventReceivers(this, E_PHYSICSCOLLISIONEND);
 
-            // First only store the collision pair as weak pointers and the manifold pointer, so user code can safely destroy
-            // objects during collision event handling
-            Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> > bodyPair;
-            if (bodyA < bodyB)
-            {
-                bodyPair = MakePair(bodyWeakA, bodyWeakB);
-                currentCollisions_[bodyPair].manifold_ = contactManifold;
-            }
-            else
-            {
-                bodyPair = MakePair(bodyWeakB, bodyWeakA);
-                currentCollisions_[bodyPair].flippedManifold_ = contactManifold;
-            }
-        }
+    if (!currentCollisions_.Empty())
+    {
+        physicsCollisionData_[PhysicsCollision::P_WORLD] = this;
 
         for (HashMap<Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair>::Iterator i = currentCollisions_.Begin();
              i != currentCollisions_.End(); ++i)
@@ -908,6 +1049,11 @@ void PhysicsWorld::SendCollisionEvents()
 
             Node* nodeA = bodyA->GetNode();
             Node* nodeB = bodyB->GetNode();
+            bool nodeEventsA = HasEventReceivers(nodeA, E_NODECOLLISIONSTART) || HasEventReceivers(nodeA, E_NODECOLLISION);
+            bool nodeEventsB = HasEventReceivers(nodeB, E_NODECOLLISIONSTART) || HasEventReceivers(nodeB, E_NODECOLLISION);
+            if (!physicsEvents && !nodeEventsA && !nodeEventsB)
+                continue;
+
             WeakPtr<Node> nodeWeakA(nodeA);
             WeakPtr<Node> nodeWeakB(nodeB);
 
@@ -949,37 +1095,50 @@ void PhysicsWorld::SendCollisionEvents()
                 }
             }
 
-            physicsCollisionData_[PhysicsCollision::P_CONTACTS] = contacts_.GetBuffer();
-
-            // Send separate collision start event if collision is new
-            if (newCollision)
+            if (physicsEvents)
             {
-                SendEvent(E_PHYSICSCOLLISIONSTART, physicsCollisionData_);
-                // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
+                physicsCollisionData_[PhysicsCollision::P_CONTACTS] = contacts_.GetBuffer();
+
+                // Send separate collision start event if collision is new
+                if (newCollision)
+                {
+                    SendEvent(E_PHYSICSCOLLISIONSTART, physicsCollisionData_);
+                    // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
+                    if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
+                        continue;
+                }
+
+                // Then send the ongoing collision event
+                SendEvent(E_PHYSICSCOLLISION, physicsCollisionData_);
                 if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
                     continue;
             }
 
-            // Then send the ongoing collision event
-            SendEvent(E_PHYSICSCOLLISION, physicsCollisionData_);
-            if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
-                continue;
-
-            nodeCollisionData_[NodeCollision::P_BODY] = bodyA;
-            nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeB;
-            nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyB;
-            nodeCollisionData_[NodeCollision::P_TRIGGER] = trigger;
-            nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
+            // The ongoing collision event is sent as a typed event, so the contacts are converted to a VariantMap only if needed
+            NodeCollisionEvent nodeCollision;
 
-            if (newCollision)
+            if (nodeEventsA)
             {
-                nodeA->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
+                nodeCollision.body_ = bodyA;
+                nodeCollision.otherNode_ = nodeB;
+                nodeCollision.otherBody_ = bodyB;
+                nodeCollision.trigger_ = trigger;
+                nodeCollision.contacts_ = &contacts_.GetBuffer();
+
+                if (newCollision)
+                {
+                    nodeCollision.ToVariantMap(nodeCollisionData_);
+                    nodeA->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
+                        continue;
+                }
+
+                nodeA->SendTypedEvent(nodeCollision);
                 if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
                     continue;
             }
 
-            nodeA->SendEvent(E_NODECOLLISION, nodeCollisionData_);
-            if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
+            if (!nodeEventsB)
                 continue;
 
             // Flip perspective to body B
@@ -1009,19 +1168,21 @@ void PhysicsWorld::SendCollisionEvents()
                 }
             }
 
-            nodeCollisionData_[NodeCollision::P_BODY] = bodyB;
-            nodeCollisionData_[NodeCollision::P_OTHERNODE] = nodeA;
-            nodeCollisionData_[NodeCollision::P_OTHERBODY] = bodyA;
-            nodeCollisionData_[NodeCollision::P_CONTACTS] = contacts_.GetBuffer();
+            nodeCollision.body_ = bodyB;
+            nodeCollision.otherNode_ = nodeA;
+            nodeCollision.otherBody_ = bodyA;
+            nodeCollision.trigger_ = trigger;
+            nodeCollision.contacts_ = &contacts_.GetBuffer();
 
             if (newCollision)
             {
+                nodeCollision.ToVariantMap(nodeCollisionData_);
                 nodeB->SendEvent(E_NODECOLLISIONSTART, nodeCollisionData_);
                 if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
                     continue;
             }
 
-            nodeB->SendEvent(E_NODECOLLISION, nodeCollisionData_);
+            nodeB->SendTypedEvent(nodeCollision);
         }
     }
 
@@ -1055,31 +1216,41 @@ void PhysicsWorld::SendCollisionEvents()
                 WeakPtr<Node> nodeWeakA(nodeA);
                 WeakPtr<Node> nodeWeakB(nodeB);
 
-                physicsCollisionData_[PhysicsCollisionEnd::P_BODYA] = bodyA;
-                physicsCollisionData_[PhysicsCollisionEnd::P_BODYB] = bodyB;
-                physicsCollisionData_[PhysicsCollisionEnd::P_NODEA] = nodeA;
-                physicsCollisionData_[PhysicsCollisionEnd::P_NODEB] = nodeB;
-                physicsCollisionData_[PhysicsCollisionEnd::P_TRIGGER] = trigger;
-
-                SendEvent(E_PHYSICSCOLLISIONEND, physicsCollisionData_);
-                // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
-                if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
-                    continue;
-
-                nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyA;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeB;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyB;
-                nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
+                if (physicsEndEvents)
+                {
+                    physicsCollisionData_[PhysicsCollisionEnd::P_BODYA] = bodyA;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_BODYB] = bodyB;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_NODEA] = nodeA;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_NODEB] = nodeB;
+                    physicsCollisionData_[PhysicsCollisionEnd::P_TRIGGER] = trigger;
+
+                    SendEvent(E_PHYSICSCOLLISIONEND, physicsCollisionData_);
+                    // Skip rest of processing if either of the nodes or bodies is removed as a response to the event
+                    if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
+                        continue;
+                }
 
-                nodeA->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
-                if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
-                    continue;
+                if (HasEventReceivers(nodeA, E_NODECOLLISIONEND))
+                {
+                    nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyA;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeB;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyB;
+                    nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
+
+                    nodeA->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                    if (!nodeWeakA || !nodeWeakB || !i->first_.first_ || !i->first_.second_)
+                        continue;
+                }
 
-                nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyB;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeA;
-                nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyA;
+                if (HasEventReceivers(nodeB, E_NODECOLLISIONEND))
+                {
+                    nodeCollisionData_[NodeCollisionEnd::P_BODY] = bodyB;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERNODE] = nodeA;
+                    nodeCollisionData_[NodeCollisionEnd::P_OTHERBODY] = bodyA;
+                    nodeCollisionData_[NodeCollisionEnd::P_TRIGGER] = trigger;
 
-                nodeB->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                    nodeB->SendEvent(E_NODECOLLISIONEND, nodeCollisionData_);
+                }
             }
         }
     }
@@ -1087,6 +1258,205 @@ void PhysicsWorld::SendCollisionEvents()
     previousCollisions_ = currentCollisions_;
 }
 
+void PhysicsWorld::RecordContacts()
+{
+    for (HashMap<Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair>::Iterator i = currentCollisions_.Begin();
+         i != currentCollisions_.End(); ++i)
+    {
+        RigidBody* bodyA = i->first_.first_;
+        RigidBody* bodyB = i->first_.second_;
+        if (!bodyA || !bodyB || (!bodyA->GetReportContacts() && !bodyB->GetReportContacts()))
+            continue;
+
+        PhysicsContactPair pair;
+        pair.bodyA_ = bodyA;
+        pair.bodyB_ = bodyB;
+        pair.bodyIdA_ = bodyA->GetID();
+        pair.bodyIdB_ = bodyB->GetID();
+        pair.type_ = previousCollisions_.Contains(i->first_) ? CONTACT_STAY : CONTACT_BEGIN;
+        pair.subStep_ = subStep_;
+        pair.firstPoint_ = contactPoints_.Size();
+        pair.trigger_ = bodyA->IsTrigger() || bodyB->IsTrigger();
+
+        if (i->second_.manifold_)
+            RecordContactPoints(i->second_.manifold_, false);
+        if (i->second_.flippedManifold_)
+            RecordContactPoints(i->second_.flippedManifold_, true);
+
+        pair.numPoints_ = contactPoints_.Size() - pair.firstPoint_;
+        contactPairs_.Push(pair);
+    }
+
+    for (HashMap<Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair>::Iterator i = previousCollisions_.Begin();
+         i != previousCollisions_.End(); ++i)
+    {
+        RigidBody* bodyA = i->first_.first_;
+        RigidBody* bodyB = i->first_.second_;
+        if (!bodyA || !bodyB || (!bodyA->GetReportContacts() && !bodyB->GetReportContacts()) ||
+            currentCollisions_.Contains(i->first_))
+            continue;
+
+        PhysicsContactPair pair;
+        pair.bodyA_ = bodyA;
+        pair.bodyB_ = bodyB;
+        pair.bodyIdA_ = bodyA->GetID();
+        pair.bodyIdB_ = bodyB->GetID();
+        pair.type_ = CONTACT_END;
+        pair.subStep_ = subStep_;
+        pair.firstPoint_ = contactPoints_.Size();
+        pair.numPoints_ = 0;
+        pair.trigger_ = bodyA->IsTrigger() || bodyB->IsTrigger();
+        contactPairs_.Push(pair);
+    }
+}
+
+void PhysicsWorld::RecordContactPoints(btPersistentManifold* manifold, bool flipped)
+{
+    int numContacts = manifold->getNumContacts();
+    unsigned first = contactPoints_.Size();
+    contactPoints_.Resize(first + numContacts);
+
+    for (int j = 0; j < numContacts; ++j)
+    {
+        const btManifoldPoint& point = manifold->getContactPoint(j);
+        PhysicsContactPoint& dest = contactPoints_[first + j];
+        dest.position_ = ToVector3(point.m_positionWorldOnB);
+        dest.normal_ = flipped ? -ToVector3(point.m_normalWorldOnB) : ToVector3(point.m_normalWorldOnB);
+        dest.distance_ = point.m_distance1;
+        dest.impulse_ = point.m_appliedImpulse;
+    }
+}
+
+bool PhysicsWorld::HasEventReceivers(Object* sender, StringHash eventType) const
+{
+    EventReceiverGroup* group = context_->GetEventReceivers(sender, eventType);
+    if (group && !group->receivers_.Empty())
+        return true;
+    group = context_->GetEventReceivers(eventType);
+    if (group && !group->receivers_.Empty())
+        return true;
+
+    TypedEventReceiverGroup* typedGroup = context_->GetTypedEventReceivers(sender, eventType);
+    if (typedGroup && !typedGroup->handlers_.Empty())
+        return true;
+    typedGroup = context_->GetTypedEventReceivers(eventType);
+    return typedGroup && !typedGroup->handlers_.Empty();
+}
+
+void PhysicsWorld::CreateWorld()
+{
+#ifdef URHO3D_THREADING
+    // The multithreaded world and its solver pool are only used when enabled, as they change the solving of serial steps too
+    if (multiThreaded_)
+    {
+        solver_ = new PhysicsSolverPool();
+        world_ = new btDiscreteDynamicsWorldMt(collisionDispatcher_.Get(), broadphase_.Get(), solver_.Get(), collisionConfiguration_);
+        static_cast<btSimulationIslandManagerMt*>(world_->getSimulationIslandManager())->setIslandDispatchFunction(DispatchIslands);
+    }
+    else
+#endif
+    {
+        solver_ = new btSequentialImpulseConstraintSolver();
+        world_ = new btDiscreteDynamicsWorld(collisionDispatcher_.Get(), broadphase_.Get(), solver_.Get(), collisionConfiguration_);
+    }
+
+    world_->setDebugDrawer(this);
+    world_->setInternalTickCallback(InternalPreTickCallback, static_cast<void*>(this), true);
+    world_->setInternalTickCallback(InternalTickCallback, static_cast<void*>(this), false);
+    world_->setSynchronizeAllMotionStates(true);
+}
+
+#ifdef URHO3D_THREADING
+void PhysicsWorld::RecreateWorld()
+{
+    // Take out the constraints, actions and collision objects in order, remembering the settings that live in the world
+    btAlignedObjectArray<btActionInterface*> actions = PhysicsWorldActions::Get(world_.Get());
+    PODVector<Pair<btTypedConstraint*, bool> > constraints;
+    for (int i = world_->getNumConstraints() - 1; i >= 0; --i)
+    {
+        // Disabling collisions between the constrained bodies is recorded as a constraint reference in the bodies
+        btTypedConstraint* constraint = world_->getConstraint(i);
+        btRigidBody& bodyA = constraint->getRigidBodyA();
+        bool disableCollision = false;
+        for (int j = 0; j < bodyA.getNumConstraintRefs(); ++j)
+        {
+            if (bodyA.getConstraintRef(j) == constraint)
+                disableCollision = true;
+        }
+        constraints.Insert(0, MakePair(constraint, disableCollision));
+        world_->removeConstraint(constraint);
+    }
+    for (int i = 0; i < actions.size(); ++i)
+        world_->removeAction(actions[i]);
+
+    // The collision filter group and mask are stored in the broadphase proxy, which is destroyed on removal
+    PODVector<btCollisionObject*> objects;
+    PODVector<IntVector2> filters;
+    btCollisionObjectArray& worldObjects = world_->getCollisionObjectArray();
+    for (int i = 0; i < worldObjects.size(); ++i)
+    {
+        btBroadphaseProxy* proxy = worldObjects[i]->getBroadphaseHandle();
+        objects.Push(worldObjects[i]);
+        filters.Push(proxy ? IntVector2(proxy->m_collisionFilterGroup, proxy->m_collisionFilterMask) : IntVector2::ZERO);
+    }
+    for (int i = (int)objects.Size() - 1; i >= 0; --i)
+    {
+        btRigidBody* body = btRigidBody::upcast(objects[i]);
+        if (body)
+            world_->removeRigidBody(body);
+        else
+            world_->removeCollisionObject(objects[i]);
+    }
+
+    btVector3 gravity = world_->getGravity();
+    btContactSolverInfo solverInfo = world_->getSolverInfo();
+    bool useContinuous = world_->getDispatchInfo().m_useContinuous;
+
+    world_.Reset();
+    solver_.Reset();
+    CreateWorld();
+
+    world_->setGravity(gravity);
+    world_->getSolverInfo() = solverInfo;
+    world_->getDispatchInfo().m_useContinuous = useContinuous;
+
+    for (unsigned i = 0; i < objects.Size(); ++i)
+    {
+        btRigidBody* body = btRigidBody::upcast(objects[i]);
+        if (body)
+            world_->addRigidBody(body, filters[i].x_, filters[i].y_);
+        else
+            world_->addCollisionObject(objects[i], filters[i].x_, filters[i].y_);
+    }
+    for (unsigned i = 0; i < constraints.Size(); ++i)
+        world_->addConstraint(constraints[i].first_, constraints[i].second_);
+    for (int i = 0; i < actions.size(); ++i)
+        world_->addAction(actions[i]);
+}
+#endif
+
+void NodeCollisionEvent::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace NodeCollision;
+
+    eventData[P_BODY] = body_;
+    eventData[P_OTHERNODE] = otherNode_;
+    eventData[P_OTHERBODY] = otherBody_;
+    eventData[P_TRIGGER] = trigger_;
+    eventData[P_CONTACTS] = *contacts_;
+}
+
+void NodeCollisionEvent::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace NodeCollision;
+
+    body_ = static_cast<RigidBody*>(GetEventParam(eventData, P_BODY).GetPtr());
+    otherNode_ = static_cast<Node*>(GetEventParam(eventData, P_OTHERNODE).GetPtr());
+    otherBody_ = static_cast<RigidBody*>(GetEventParam(eventData, P_OTHERBODY).GetPtr());
+    trigger_ = GetEventParam(eventData, P_TRIGGER).GetBool();
+    contacts_ = &GetEventParam(eventData, P_CONTACTS).GetBuffer();
+}
+
 void RegisterPhysicsLibrary(Context* context)
 {
     CollisionShape::RegisterObject(context);
@@ -112,6 +112,50 @@ struct ManifoldPair
     btPersistentManifold* flippedManifold_;
 };
 
+/// Contact pair state in the batched contact stream.
+enum PhysicsContactType
+{
+    CONTACT_BEGIN = 0,
+    CONTACT_STAY,
+    CONTACT_END
+};
+
+/// Colliding body pair in the batched contact stream. The body pointers are only guaranteed to be valid until bodies are removed, for example by collision event handlers; the component IDs can be used to look them up safely.
+struct URHO3D_API PhysicsContactPair
+{
+    /// First rigid body. Has the lower address of the pair.
+    RigidBody* bodyA_;
+    /// Second rigid body.
+    RigidBody* bodyB_;
+    /// Component ID of the first rigid body.
+    unsigned bodyIdA_;
+    /// Component ID of the second rigid body.
+    unsigned bodyIdB_;
+    /// Contact state.
+    PhysicsContactType type_;
+    /// Index of the simulation substep within the last update.
+    unsigned subStep_;
+    /// Index of the first contact point in the contact point array.
+    unsigned firstPoint_;
+    /// Number of contact points. Zero for ended contacts.
+    unsigned numPoints_;
+    /// Whether either of the bodies is a trigger.
+    bool trigger_;
+};
+
+/// Contact point in the batched contact stream. The normal is on body B and points towards body A.
+struct URHO3D_API PhysicsContactPoint
+{
+    /// Worldspace contact position.
+    Vector3 position_;
+    /// Worldspace normal.
+    Vector3 normal_;
+    /// Distance between the bodies, negative when penetrating.
+    float distance_;
+    /// Impulse applied by the constraint solver.
+    float impulse_;
+};
+
 /// Custom overrides of physics internals. To use overrides, must be set before the physics component is created.
 struct PhysicsWorldConfig
 {
@@ -186,6 +230,8 @@ public:
     void SetInternalEdge(bool enable);
     /// Set split impulse collision mode. This is more accurate, but slower. Disabled by default.
     void SetSplitImpulse(bool enable);
+    /// Set whether to solve simulation islands in parallel in the work queue's threads. Disabled by default. The result does not depend on the number of threads. Changing the mode recreates the Bullet physics world. Has no effect if built without threading support.
+    void SetMultiThreaded(bool enable);
     /// Set maximum angular velocity for network replication.
     void SetMaxNetworkAngularVelocity(float velocity);
     /// Perform a physics world raycast and return all hits.
@@ -239,9 +285,18 @@ public:
     /// Return simulation steps per second.
     int GetFps() const { return fps_; }
 
+    /// Return whether simulation islands are solved in parallel.
+    bool GetMultiThreaded() const { return multiThreaded_; }
+
     /// Return maximum angular velocity for network replication.
     float GetMaxNetworkAngularVelocity() const { return maxNetworkAngularVelocity_; }
 
+    /// Return contact pairs recorded during the last update for bodies that report contacts. Valid until the next update.
+    const PODVector<PhysicsContactPair>& GetContactPairs() const { return contactPairs_; }
+
+    /// Return contact points referenced by the recorded contact pairs.
+    const PODVector<PhysicsContactPoint>& GetContactPoints() const { return contactPoints_; }
+
     /// Add a rigid body to keep track of. Called by RigidBody.
     void AddRigidBody(RigidBody* body);
     /// Remove a rigid body. Called by RigidBody.
@@ -263,7 +318,7 @@ public:
     /// Set debug geometry depth test mode. Called both by PhysicsWorld itself and physics components.
     void SetDebugDepthTest(bool enable);
 
-    /// Return the Bullet physics world.
+    /// Return the Bullet physics world. It is recreated when the multithreaded mode is changed, so the pointer should not be stored.
     btDiscreteDynamicsWorld* GetWorld() { return world_.Get(); }
 
     /// Clean up the geometry cache.
@@ -303,6 +358,16 @@ private:
     void PostStep(float timeStep);
     /// Send accumulated collision events.
     void SendCollisionEvents();
+    /// Record the collision pairs of the current substep into the batched contact stream.
+    void RecordContacts();
+    /// Append manifold contact points to the batched contact stream.
+    void RecordContactPoints(btPersistentManifold* manifold, bool flipped);
+    /// Return whether an event from a sender has any receivers, including typed event receivers.
+    bool HasEventReceivers(Object* sender, StringHash eventType) const;
+    /// Create the Bullet physics world and constraint solver for the current multithreaded mode.
+    void CreateWorld();
+    /// Recreate the Bullet physics world after the multithreaded mode changed, and move the collision objects, constraints and actions to it.
+    void RecreateWorld();
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_;
@@ -340,6 +405,12 @@ private:
     VariantMap nodeCollisionData_;
     /// Preallocated buffer for physics collision contact data.
     VectorBuffer contacts_;
+    /// Batched contact stream pairs.
+    PODVector<PhysicsContactPair> contactPairs_;
+    /// Batched contact stream points.
+    PODVector<PhysicsContactPoint> contactPoints_;
+    /// Substep index within the current update.
+    unsigned subStep_;
     /// Simulation substeps per second.
     unsigned fps_;
     /// Maximum number of simulation substeps per frame. 0 (default) unlimited, or negative values for adaptive timestep.
@@ -358,6 +429,8 @@ private:
     bool applyingTransforms_;
     /// Simulating flag.
     bool simulating_;
+    /// Multithreaded island solving flag.
+    bool multiThreaded_;
     /// Debug draw depth test mode.
     bool debugDepthTest_;
     /// Debug renderer.
@@ -34,6 +34,31 @@
 namespace Urho3D
 {
 
+/// Vehicle raycaster that casts into the physics world's current Bullet world, which is recreated when the multithreaded mode changes.
+class PhysicsVehicleRaycaster : public btVehicleRaycaster
+{
+public:
+    /// Construct.
+    explicit PhysicsVehicleRaycaster(PhysicsWorld* physicsWorld) :
+        physicsWorld_(physicsWorld)
+    {
+    }
+
+    /// Cast a ray for a wheel. Return the hit rigid body or null.
+    void* castRay(const btVector3& from, const btVector3& to, btVehicleRaycasterResult& result) override
+    {
+        if (!physicsWorld_)
+            return nullptr;
+
+        btDefaultVehicleRaycaster raycaster(physicsWorld_->GetWorld());
+        return raycaster.castRay(from, to, result);
+    }
+
+private:
+    /// Physics world.
+    WeakPtr<PhysicsWorld> physicsWorld_;
+};
+
 const IntVector3 RaycastVehicle::RIGHT_UP_FORWARD(0, 1, 2);
 const IntVector3 RaycastVehicle::RIGHT_FORWARD_UP(0, 2, 1);
 const IntVector3 RaycastVehicle::UP_FORWARD_RIGHT(1, 2, 0);
@@ -90,7 +115,7 @@ struct RaycastVehicleData
             delete vehicle_;
         }
 
-        vehicleRayCaster_ = new btDefaultVehicleRaycaster(pbtDynWorld);
+        vehicleRayCaster_ = new PhysicsVehicleRaycaster(pPhysWorld);
         btRigidBody* bthullBody = body->GetBody();
         vehicle_ = new btRaycastVehicle(tuning_, bthullBody, vehicleRayCaster_);
         if (enabled)
@@ -73,6 +73,7 @@ RigidBody::RigidBody(Context* context) :
     lastRotation_(Quaternion::IDENTITY),
     kinematic_(false),
     trigger_(false),
+    reportContacts_(false),
     useGravity_(true),
     readdBody_(false),
     inWorld_(false),
@@ -126,6 +127,7 @@ void RigidBody::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Is Kinematic", bool, kinematic_, MarkBodyDirty, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Is Trigger", bool, trigger_, MarkBodyDirty, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Gravity Override", GetGravityOverride, SetGravityOverride, Vector3, Vector3::ZERO, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Report Contacts", bool, reportContacts_, false, AM_DEFAULT);
 }
 
 void RigidBody::ApplyAttributes()
@@ -510,6 +512,12 @@ void RigidBody::SetCollisionEventMode(CollisionEventMode mode)
     MarkNetworkUpdate();
 }
 
+void RigidBody::SetReportContacts(bool enable)
+{
+    reportContacts_ = enable;
+    MarkNetworkUpdate();
+}
+
 void RigidBody::ApplyForce(const Vector3& force)
 {
     if (body_ && force != Vector3::ZERO)
@@ -124,6 +124,8 @@ public:
     void SetCollisionLayerAndMask(unsigned layer, unsigned mask);
     /// Set collision event signaling mode. Default is to signal when rigid bodies are active.
     void SetCollisionEventMode(CollisionEventMode mode);
+    /// Set whether to record this body's collisions into the physics world's batched contact stream. Default false.
+    void SetReportContacts(bool enable);
     /// Apply force to center of mass.
     void ApplyForce(const Vector3& force);
     /// Apply force at local position.
@@ -223,6 +225,9 @@ public:
     /// Return collision event signaling mode.
     CollisionEventMode GetCollisionEventMode() const { return collisionEventMode_; }
 
+    /// Return whether collisions are recorded into the batched contact stream.
+    bool GetReportContacts() const { return reportContacts_; }
+
     /// Return colliding rigid bodies from the last simulation step. Only returns collisions that were sent as events (depends on collision event mode) and excludes e.g. static-static collisions.
     void GetCollidingBodies(PODVector<RigidBody*>& result) const;
 
@@ -297,6 +302,8 @@ private:
     bool kinematic_;
     /// Trigger flag.
     bool trigger_;
+    /// Batched contact reporting flag.
+    bool reportContacts_;
     /// Use gravity flag.
     bool useGravity_;
     /// Readd body to world flag.
@@ -26,6 +26,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../IO/Log.h"
 #include "../Resource/BackgroundLoader.h"
 #include "../Resource/ResourceCache.h"
@@ -36,35 +37,51 @@
 namespace Urho3D
 {
 
+/// Background loader thread.
+class BackgroundLoaderThread : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit BackgroundLoaderThread(BackgroundLoader* owner) :
+        owner_(owner)
+    {
+    }
+
+    /// Load queued resources until stopped.
+    void ThreadFunction() override
+    {
+        owner_->ProcessItems();
+    }
+
+private:
+    /// Background loader.
+    BackgroundLoader* owner_;
+};
+
 BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
-    owner_(owner)
+    owner_(owner),
+    numThreads_(1),
+    shouldRun_(false)
 {
 }
 
 BackgroundLoader::~BackgroundLoader()
 {
+    StopThreads();
+
     MutexLock lock(backgroundLoadMutex_);
 
+    pendingItems_.Clear();
     backgroundLoadQueue_.Clear();
 }
 
-void BackgroundLoader::ThreadFunction()
+void BackgroundLoader::ProcessItems()
 {
     while (shouldRun_)
     {
         backgroundLoadMutex_.Acquire();
 
-        // Search for a queued resource that has not been loaded yet
-        HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem>::Iterator i = backgroundLoadQueue_.Begin();
-        while (i != backgroundLoadQueue_.End())
-        {
-            if (i->second_.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
-                break;
-            else
-                ++i;
-        }
-
-        if (i == backgroundLoadQueue_.End())
+        if (pendingItems_.Empty())
         {
             // No resources to load found
             backgroundLoadMutex_.Release();
@@ -72,41 +89,32 @@ void BackgroundLoader::ThreadFunction()
         }
         else
         {
-            BackgroundLoadItem& item = i->second_;
-            Resource* resource = item.resource_;
-            // We can be sure that the item is not removed from the queue as long as it is in the
-            // "queued" or "loading" state
+            // Take the oldest queued resource. Mark it loading while still holding the mutex so that the other loader
+            // threads and WaitForResource() do not take it too. We can be sure that the item is not removed from the
+            // queue as long as it is in the "queued" or "loading" state
+            BackgroundLoadItem& item = *pendingItems_.Front();
+            pendingItems_.PopFront();
+            item.resource_->SetAsyncLoadState(ASYNC_LOADING);
             backgroundLoadMutex_.Release();
 
-            bool success = false;
-            SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
-            if (file)
-            {
-                resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
-            }
+            BeginBackgroundLoading(item);
+        }
+    }
+}
 
-            // Process dependencies now
-            // Need to lock the queue again when manipulating other entries
-            Pair<StringHash, StringHash> key = MakePair(resource->GetType(), resource->GetNameHash());
-            backgroundLoadMutex_.Acquire();
-            if (item.dependents_.Size())
-            {
-                for (HashSet<Pair<StringHash, StringHash> >::Iterator i = item.dependents_.Begin();
-                     i != item.dependents_.End(); ++i)
-                {
-                    HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem>::Iterator j = backgroundLoadQueue_.Find(*i);
-                    if (j != backgroundLoadQueue_.End())
-                        j->second_.dependencies_.Erase(key);
-                }
+void BackgroundLoader::SetNumThreads(unsigned num)
+{
+    num = Max(num, 1U);
+    if (num == numThreads_)
+        return;
 
-                item.dependents_.Clear();
-            }
+    // Restart now if resources are still being loaded, otherwise on the next queued resource
+    StopThreads();
+    numThreads_ = num;
 
-            resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
-            backgroundLoadMutex_.Release();
-        }
-    }
+    MutexLock lock(backgroundLoadMutex_);
+    if (!backgroundLoadQueue_.Empty())
+        StartThreads();
 }
 
 bool BackgroundLoader::QueueResource(StringHash type, const String& name, bool sendEventOnFailure, Resource* caller)
@@ -163,9 +171,11 @@ bool BackgroundLoader::QueueResource(StringHash type, const String& name, bool s
                        " requested for a background loaded resource but was not in the background load queue");
     }
 
-    // Start the background loader thread now
-    if (!IsStarted())
-        Run();
+    pendingItems_.Push(&item);
+
+    // Start the background loader threads now
+    if (threads_.Empty())
+        StartThreads();
 
     return true;
 }
@@ -179,8 +189,23 @@ void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
     HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem>::Iterator i = backgroundLoadQueue_.Find(key);
     if (i != backgroundLoadQueue_.End())
     {
+        // If no loader thread has taken the resource yet, load it right away in this thread instead of waiting for
+        // the resources queued before it
+        bool loadNow = false;
+        if (i->second_.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
+        {
+            List<BackgroundLoadItem*>::Iterator j = pendingItems_.Find(&i->second_);
+            if (j != pendingItems_.End())
+                pendingItems_.Erase(j);
+            i->second_.resource_->SetAsyncLoadState(ASYNC_LOADING);
+            loadNow = true;
+        }
+
         backgroundLoadMutex_.Release();
 
+        if (loadNow)
+            BeginBackgroundLoading(i->second_);
+
         {
             Resource* resource = i->second_.resource_;
             HiresTimer waitTimer;
@@ -217,7 +242,7 @@ void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
 
 void BackgroundLoader::FinishResources(int maxMs)
 {
-    if (IsStarted())
+    if (!threads_.Empty())
     {
         HiresTimer timer;
 
@@ -256,6 +281,53 @@ unsigned BackgroundLoader::GetNumQueuedResources() const
     return backgroundLoadQueue_.Size();
 }
 
+void BackgroundLoader::StartThreads()
+{
+    shouldRun_ = true;
+    for (unsigned i = 0; i < numThreads_; ++i)
+    {
+        SharedPtr<BackgroundLoaderThread> thread(new BackgroundLoaderThread(this));
+        thread->Run();
+        threads_.Push(thread);
+    }
+}
+
+void BackgroundLoader::StopThreads()
+{
+    shouldRun_ = false;
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+        threads_[i]->Stop();
+    threads_.Clear();
+}
+
+void BackgroundLoader::BeginBackgroundLoading(BackgroundLoadItem& item)
+{
+    Resource* resource = item.resource_;
+
+    bool success = false;
+    SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
+    if (file)
+        success = resource->BeginLoad(*file);
+
+    // Process dependencies now
+    // Need to lock the queue again when manipulating other entries
+    Pair<StringHash, StringHash> key = MakePair(resource->GetType(), resource->GetNameHash());
+    MutexLock lock(backgroundLoadMutex_);
+    if (item.dependents_.Size())
+    {
+        for (HashSet<Pair<StringHash, StringHash> >::Iterator i = item.dependents_.Begin(); i != item.dependents_.End(); ++i)
+        {
+            HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem>::Iterator j = backgroundLoadQueue_.Find(*i);
+            if (j != backgroundLoadQueue_.End())
+                j->second_.dependencies_.Erase(key);
+        }
+
+        item.dependents_.Clear();
+    }
+
+    resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
+}
+
 void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
 {
     Resource* resource = item.resource_;
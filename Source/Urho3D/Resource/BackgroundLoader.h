@@ -24,15 +24,16 @@
 
 #include "../Container/HashMap.h"
 #include "../Container/HashSet.h"
+#include "../Container/List.h"
 #include "../Core/Mutex.h"
 #include "../Container/Ptr.h"
 #include "../Container/RefCounted.h"
-#include "../Core/Thread.h"
 #include "../Math/StringHash.h"
 
 namespace Urho3D
 {
 
+class BackgroundLoaderThread;
 class Resource;
 class ResourceCache;
 
@@ -49,19 +50,21 @@ struct BackgroundLoadItem
     bool sendEventOnFailure_;
 };
 
-/// Background loader of resources. Owned by the ResourceCache.
-class BackgroundLoader : public RefCounted, public Thread
+/// Background loader of resources. Owned by the ResourceCache. Runs the BeginLoad() phase of queued resources in a pool of loader threads, in queue order.
+class BackgroundLoader : public RefCounted
 {
 public:
     /// Construct.
     explicit BackgroundLoader(ResourceCache* owner);
 
-    /// Destruct. Forcibly clear the load queue.
+    /// Destruct. Stop the loader threads and forcibly clear the load queue.
     ~BackgroundLoader() override;
 
-    /// Resource background loading loop.
-    void ThreadFunction() override;
+    /// Resource background loading loop, run by each loader thread.
+    void ProcessItems();
 
+    /// Set number of loader threads. Running threads are stopped after finishing their current resource and restarted with the new amount. Call only from the main thread.
+    void SetNumThreads(unsigned num);
     /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type).
     bool QueueResource(StringHash type, const String& name, bool sendEventOnFailure, Resource* caller);
     /// Wait and finish possible loading of a resource when being requested from the cache.
@@ -71,8 +74,16 @@ public:
 
     /// Return amount of resources in the load queue.
     unsigned GetNumQueuedResources() const;
+    /// Return number of loader threads.
+    unsigned GetNumThreads() const { return numThreads_; }
 
 private:
+    /// Start the loader threads.
+    void StartThreads();
+    /// Stop the loader threads.
+    void StopThreads();
+    /// Run the BeginLoad() phase of an item that has been taken from the pending queue. Called without holding the mutex.
+    void BeginBackgroundLoading(BackgroundLoadItem& item);
     /// Finish one background loaded resource.
     void FinishBackgroundLoading(BackgroundLoadItem& item);
 
@@ -82,6 +93,14 @@ private:
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
     HashMap<Pair<StringHash, StringHash>, BackgroundLoadItem> backgroundLoadQueue_;
+    /// Items that are waiting for a loader thread, in queue order. Items in the load queue are not moved in memory, and are only erased after leaving this list.
+    List<BackgroundLoadItem*> pendingItems_;
+    /// Loader threads.
+    Vector<SharedPtr<BackgroundLoaderThread> > threads_;
+    /// Number of loader threads to start.
+    unsigned numThreads_;
+    /// Running flag for the loader threads.
+    volatile bool shouldRun_;
 };
 
 }
@@ -766,17 +766,22 @@ bool Image::BeginLoad(Deserializer& source)
             return false;
         }
 
-        // Read the file to buffer.
+        // Read the file to buffer, unless the source is already in memory
         size_t dataSize(source.GetSize());
-        SharedArrayPtr<uint8_t> data(new uint8_t[dataSize]);
-
-        memset(data.Get(), 0, sizeof(uint8_t) * dataSize);
+        SharedArrayPtr<uint8_t> dataBuffer;
         source.Seek(0);
-        source.Read(data.Get(), dataSize);
+        const uint8_t* data = source.GetContiguousData();
+        if (!data)
+        {
+            dataBuffer = new uint8_t[dataSize];
+            memset(dataBuffer.Get(), 0, sizeof(uint8_t) * dataSize);
+            source.Read(dataBuffer.Get(), dataSize);
+            data = dataBuffer.Get();
+        }
 
         WebPBitstreamFeatures features;
 
-        if (WebPGetFeatures(data.Get(), dataSize, &features) != VP8_STATUS_OK)
+        if (WebPGetFeatures(data, dataSize, &features) != VP8_STATUS_OK)
         {
             URHO3D_LOGERROR("Error reading WebP image: " + source.GetName());
             return false;
@@ -788,11 +793,11 @@ bool Image::BeginLoad(Deserializer& source)
         bool decodeError(false);
         if (features.has_alpha)
         {
-            decodeError = WebPDecodeRGBAInto(data.Get(), dataSize, pixelData.Get(), imgSize, 4 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBAInto(data, dataSize, pixelData.Get(), imgSize, 4 * features.width) == nullptr;
         }
         else
         {
-            decodeError = WebPDecodeRGBInto(data.Get(), dataSize, pixelData.Get(), imgSize, 3 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBInto(data, dataSize, pixelData.Get(), imgSize, 3 * features.width) == nullptr;
         }
         if (decodeError)
         {
@@ -2297,6 +2302,15 @@ unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height
 {
     unsigned dataSize = source.GetSize();
 
+    // Decode straight from memory-backed sources, such as files in a memory-mapped package, without copying first
+    const unsigned char* data = source.GetContiguousData();
+    if (data)
+    {
+        dataSize -= source.GetPosition();
+        source.Seek(source.GetSize());
+        return stbi_load_from_memory(data, dataSize, &width, &height, (int*)&components, 0);
+    }
+
     SharedArrayPtr<unsigned char> buffer(new unsigned char[dataSize]);
     source.Read(buffer.Get(), dataSize);
     return stbi_load_from_memory(buffer.Get(), dataSize, &width, &height, (int*)&components, 0);
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
 #include "../Core/WorkQueue.h"
 #include "../IO/FileSystem.h"
@@ -73,14 +74,16 @@ ResourceCache::ResourceCache(Context* context) :
     returnFailedResources_(false),
     searchPackagesFirst_(true),
     isRouting_(false),
-    finishBackgroundResourcesMs_(5)
+    finishBackgroundResourcesMs_(5),
+    numBackgroundLoadThreads_((unsigned)Clamp((int)GetNumPhysicalCPUs() - 1, 1, 4))
 {
     // Register Resource library object factories
     RegisterResourceLibrary(context_);
 
 #ifdef URHO3D_THREADING
-    // Create resource background loader. Its thread will start on the first background request
+    // Create resource background loader. Its threads will start on the first background request
     backgroundLoader_ = new BackgroundLoader(this);
+    backgroundLoader_->SetNumThreads(numBackgroundLoadThreads_);
 #endif
 
     // Subscribe BeginFrame for handling directory watchers and background loaded resource finalization
@@ -458,6 +461,14 @@ void ResourceCache::SetAutoReloadResources(bool enable)
     }
 }
 
+void ResourceCache::SetNumBackgroundLoadThreads(unsigned num)
+{
+    numBackgroundLoadThreads_ = Max(num, 1U);
+#ifdef URHO3D_THREADING
+    backgroundLoader_->SetNumThreads(numBackgroundLoadThreads_);
+#endif
+}
+
 void ResourceCache::AddResourceRouter(ResourceRouter* router, bool addAsFirst)
 {
     // Check for duplicate
@@ -128,6 +128,8 @@ public:
 
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     void SetFinishBackgroundResourcesMs(int ms) { finishBackgroundResourcesMs_ = Max(ms, 1); }
+    /// Set number of threads that run the loading of background loaded resources in parallel. Default is the number of physical CPU cores minus one, at most 4. Call only from the main thread.
+    void SetNumBackgroundLoadThreads(unsigned num);
 
     /// Add a resource router object. By default there is none, so the routing process is skipped.
     void AddResourceRouter(ResourceRouter* router, bool addAsFirst = false);
@@ -193,6 +195,9 @@ public:
     /// Return how many milliseconds maximum to spend on finishing background loaded resources.
     int GetFinishBackgroundResourcesMs() const { return finishBackgroundResourcesMs_; }
 
+    /// Return number of background loading threads.
+    unsigned GetNumBackgroundLoadThreads() const { return numBackgroundLoadThreads_; }
+
     /// Return a resource router by index.
     ResourceRouter* GetResourceRouter(unsigned index) const;
 
@@ -252,6 +257,8 @@ private:
     mutable bool isRouting_;
     /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
     int finishBackgroundResourcesMs_;
+    /// Number of background loading threads.
+    unsigned numBackgroundLoadThreads_;
 };
 
 template <class T> T* ResourceCache::GetExistingResource(const String& name)
@@ -175,6 +175,7 @@ void Component::PrepareNetworkUpdate()
         return;
 
     unsigned numAttributes = attributes->Size();
+    DirtyBits changedAttributes;
 
     // Check for attribute changes
     for (unsigned i = 0; i < numAttributes; ++i)
@@ -189,6 +190,7 @@ void Component::PrepareNetworkUpdate()
         if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
         {
             networkState_->previousValues_[i] = networkState_->currentValues_[i];
+            changedAttributes.Set(i);
 
             // Mark the attribute dirty in all replication states that are tracking this component
             for (PODVector<ReplicationState*>::Iterator j = networkState_->replicationStates_.Begin();
@@ -208,6 +210,7 @@ void Component::PrepareNetworkUpdate()
         }
     }
 
+    PrepareSharedNetworkUpdates(changedAttributes);
     networkUpdate_ = false;
 }
 
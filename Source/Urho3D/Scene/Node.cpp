@@ -62,6 +62,8 @@ Node::Node(Context* context) :
 {
     impl_ = new NodeImpl();
     impl_->owner_ = nullptr;
+    impl_->networkPriority_ = nullptr;
+    impl_->inNetworkGrid_ = false;
 }
 
 Node::~Node()
@@ -735,6 +737,10 @@ void Node::SetOwner(Connection* owner)
 
 void Node::MarkDirty()
 {
+    // Let the scene know that batched transform updates have work to do
+    if (!dirty_ && scene_)
+        scene_->MarkTransformsDirty();
+
     Node *cur = this;
     for (;;)
     {
@@ -836,6 +842,8 @@ void Node::AddChild(Node* node, unsigned index)
         scene_->NodeAdded(node);
 
     node->parent_ = this;
+    if (scene_)
+        scene_->MarkTransformHierarchyDirty();
     node->MarkDirty();
     node->MarkNetworkUpdate();
     // If the child node has components, also mark network update on them to ensure they have a valid NetworkState
@@ -915,7 +923,7 @@ Component* Node::CreateComponent(StringHash type, CreateMode mode, unsigned id)
     SharedPtr<Component> newComponent = DynamicCast<Component>(context_->CreateObject(type));
     if (!newComponent)
     {
-        URHO3D_LOGERROR("Could not create unknown component type " + type.ToString());
+        URHO3D_LOGERROR("Could not create unknown component type " + type.ToDebugString());
         return nullptr;
     }
 
@@ -1496,7 +1504,7 @@ void Node::SetNetParentAttr(const PODVector<unsigned char>& value)
         StringHash nameHash = buf.ReadStringHash();
         Node* parentNode = baseNode->GetChild(nameHash, true);
         if (!parentNode)
-            URHO3D_LOGWARNING("Failed to find parent node with name hash " + nameHash.ToString());
+            URHO3D_LOGWARNING("Failed to find parent node with name hash " + nameHash.ToDebugString());
         else
             parentNode->AddChild(this);
     }
@@ -1704,6 +1712,7 @@ void Node::PrepareNetworkUpdate()
 
     const Vector<AttributeInfo>* attributes = networkState_->attributes_;
     unsigned numAttributes = attributes->Size();
+    DirtyBits changedAttributes;
 
     // Check for attribute changes
     for (unsigned i = 0; i < numAttributes; ++i)
@@ -1718,6 +1727,7 @@ void Node::PrepareNetworkUpdate()
         if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
         {
             networkState_->previousValues_[i] = networkState_->currentValues_[i];
+            changedAttributes.Set(i);
 
             // Mark the attribute dirty in all replication states that are tracking this node
             for (PODVector<ReplicationState*>::Iterator j = networkState_->replicationStates_.Begin();
@@ -1736,6 +1746,8 @@ void Node::PrepareNetworkUpdate()
         }
     }
 
+    PrepareSharedNetworkUpdates(changedAttributes);
+
     // Finally check for user var changes
     for (VariantMap::ConstIterator i = vars_.Begin(); i != vars_.End(); ++i)
     {
@@ -1795,6 +1807,27 @@ void Node::MarkReplicationDirty()
     }
 }
 
+void Node::SetInNetworkGrid(bool enable)
+{
+    if (enable == impl_->inNetworkGrid_)
+        return;
+
+    impl_->inNetworkGrid_ = enable;
+
+    // Connections keep dirty nodes of the grid out of their dirty sets until the observer comes near. When the node leaves
+    // the grid it will not be found that way anymore, so put it back into the dirty sets
+    if (!enable && networkState_)
+    {
+        for (PODVector<ReplicationState*>::Iterator j = networkState_->replicationStates_.Begin();
+             j != networkState_->replicationStates_.End(); ++j)
+        {
+            auto* nodeState = static_cast<NodeReplicationState*>(*j);
+            if (nodeState->markedDirty_)
+                nodeState->sceneState_->dirtyNodes_.Insert(id_);
+        }
+    }
+}
+
 Node* Node::CreateChild(unsigned id, CreateMode mode, bool temporary)
 {
     SharedPtr<Node> newNode(new Node(context_));
@@ -2064,7 +2097,7 @@ Component* Node::SafeCreateComponent(const String& typeName, StringHash type, Cr
         return CreateComponent(type, mode, id);
     else
     {
-        URHO3D_LOGWARNING("Component type " + type.ToString() + " not known, creating UnknownComponent as placeholder");
+        URHO3D_LOGWARNING("Component type " + type.ToDebugString() + " not known, creating UnknownComponent as placeholder");
         // Else create as UnknownComponent
         SharedPtr<UnknownComponent> newComponent(new UnknownComponent(context_));
         if (typeName.Empty() || typeName.StartsWith("Unknown", false))
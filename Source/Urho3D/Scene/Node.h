@@ -31,6 +31,7 @@ namespace Urho3D
 
 class Component;
 class Connection;
+class NetworkPriority;
 class Node;
 class Scene;
 class SceneResolver;
@@ -59,6 +60,12 @@ struct URHO3D_API NodeImpl
     PODVector<Node*> dependencyNodes_;
     /// Network owner connection.
     Connection* owner_;
+    /// Interest management component, cached for network updates.
+    NetworkPriority* networkPriority_;
+    /// World position for interest management, captured in the main thread before the network update.
+    Vector3 networkPosition_;
+    /// Whether the node is in the scene's interest management grid.
+    bool inNetworkGrid_;
     /// Name.
     String name_;
     /// Tag strings.
@@ -75,6 +82,7 @@ class URHO3D_API Node : public Animatable
     URHO3D_OBJECT(Node, Animatable);
 
     friend class Connection;
+    friend class TransformHierarchy;
 
 public:
     /// Construct.
@@ -601,6 +609,18 @@ public:
         CreateMode mode = REPLICATED);
     /// Return the depended on nodes to order network updates.
     const PODVector<Node*>& GetDependencyNodes() const { return impl_->dependencyNodes_; }
+    /// Set the cached interest management component. Called by NetworkPriority.
+    void SetNetworkPriority(NetworkPriority* priority) { impl_->networkPriority_ = priority; }
+    /// Return the cached interest management component, or null if none.
+    NetworkPriority* GetNetworkPriority() const { return impl_->networkPriority_; }
+    /// Capture the world position for interest management. Called by Scene before the network update.
+    void UpdateNetworkPosition() { impl_->networkPosition_ = GetWorldPosition(); }
+    /// Return the world position captured for interest management. Safe to call while network updates run in worker threads.
+    const Vector3& GetNetworkPosition() const { return impl_->networkPosition_; }
+    /// Set whether the node is in the scene's interest management grid. Called by Scene before the network update.
+    void SetInNetworkGrid(bool enable);
+    /// Return whether the node is in the scene's interest management grid, so that connections check it only when their observer is near.
+    bool IsInNetworkGrid() const { return impl_->inNetworkGrid_; }
 
     /// Prepare network update by comparing attributes and marking replication states dirty as necessary.
     void PrepareNetworkUpdate();
@@ -26,6 +26,7 @@
 #include "../Container/HashMap.h"
 #include "../Container/HashSet.h"
 #include "../Container/Ptr.h"
+#include "../IO/VectorBuffer.h"
 #include "../Math/StringHash.h"
 
 #include <cstring>
@@ -56,11 +57,10 @@ struct URHO3D_API DirtyBits
     }
 
     /// Copy-construct.
-    DirtyBits(const DirtyBits& bits) :
-        count_(bits.count_)
-    {
-        memcpy(data_, bits.data_, MAX_NETWORK_ATTRIBUTES / 8);
-    }
+    DirtyBits(const DirtyBits& bits) = default;
+
+    /// Assign from another set of bits.
+    DirtyBits& operator =(const DirtyBits& rhs) = default;
 
     /// Set a bit.
     void Set(unsigned index)
@@ -112,6 +112,12 @@ struct URHO3D_API DirtyBits
             return false;
     }
 
+    /// Test for equality with another set of bits.
+    bool operator ==(const DirtyBits& rhs) const
+    {
+        return count_ == rhs.count_ && !memcmp(data_, rhs.data_, MAX_NETWORK_ATTRIBUTES / 8);
+    }
+
     /// Return number of set bits.
     unsigned Count() const { return count_; }
 
@@ -140,6 +146,12 @@ struct URHO3D_API NetworkState
     PODVector<ReplicationState*> replicationStates_;
     /// Previous user variables.
     VariantMap previousVars_;
+    /// Dirty attribute bits that the shared delta update was encoded for.
+    DirtyBits sharedDeltaBits_;
+    /// Delta update data without the timestamp, encoded once for the connections that have the same dirty attributes. Empty if not available.
+    VectorBuffer sharedDeltaUpdate_;
+    /// Latest data update without the timestamp, encoded once for all connections. Empty if not available.
+    VectorBuffer sharedLatestDataUpdate_;
     /// Bitmask for intercepting network messages. Used on the client only.
     unsigned long long interceptMask_;
 };
@@ -29,6 +29,7 @@
 #include "../IO/File.h"
 #include "../IO/Log.h"
 #include "../IO/PackageFile.h"
+#include "../Network/NetworkPriority.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
 #include "../Resource/XMLFile.h"
@@ -40,6 +41,7 @@
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SmoothedTransform.h"
 #include "../Scene/SplinePath.h"
+#include "../Scene/TransformHierarchy.h"
 #include "../Scene/UnknownComponent.h"
 #include "../Scene/ValueAnimation.h"
 
@@ -54,6 +56,19 @@ const char* SUBSYSTEM_CATEGORY = "Subsystem";
 
 static const float DEFAULT_SMOOTHING_CONSTANT = 50.0f;
 static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
+static const float DEFAULT_NETWORK_GRID_CELL_SIZE = 100.0f;
+
+/// Return network interest management grid cell coordinate.
+static inline int GetNetworkGridCoordinate(float value, float cellSize)
+{
+    return (int)Clamp(floorf(value / cellSize), -1.0e9f, 1.0e9f);
+}
+
+/// Return network interest management grid cell key from cell coordinates.
+static inline unsigned long long GetNetworkGridKey(int x, int z)
+{
+    return (unsigned long long)(unsigned)x << 32u | (unsigned)z;
+}
 
 Scene::Scene(Context* context) :
     Node(context),
@@ -67,15 +82,19 @@ Scene::Scene(Context* context) :
     elapsedTime_(0),
     smoothingConstant_(DEFAULT_SMOOTHING_CONSTANT),
     snapThreshold_(DEFAULT_SNAP_THRESHOLD),
+    networkGridCellSize_(DEFAULT_NETWORK_GRID_CELL_SIZE),
+    networkGridRadius_(0.0f),
+    numNetworkGridNodes_(0),
     updateEnabled_(true),
     asyncLoading_(false),
-    threadedUpdate_(false)
+    threadedUpdate_(false),
+    transformsDirty_(false)
 {
     // Assign an ID to self so that nodes can refer to this node as a parent
     SetID(GetFreeNodeID(REPLICATED));
     NodeAdded(this);
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(Scene, HandleUpdate));
+    SubscribeToTypedEvent(&Scene::HandleUpdate);
     SubscribeToEvent(E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(Scene, HandleResourceBackgroundLoaded));
 }
 
@@ -664,11 +683,32 @@ void Scene::SetSnapThreshold(float threshold)
     Node::MarkNetworkUpdate();
 }
 
+void Scene::SetNetworkGridCellSize(float size)
+{
+    networkGridCellSize_ = Max(size, M_EPSILON);
+    // The cells are rebuilt on the next network update
+    networkGrid_.Clear();
+}
+
 void Scene::SetAsyncLoadingMs(int ms)
 {
     asyncLoadingMs_ = Max(ms, 1);
 }
 
+void Scene::SetBatchedTransforms(bool enable)
+{
+    if (enable == transformHierarchy_.NotNull())
+        return;
+
+    if (enable)
+    {
+        transformHierarchy_ = new TransformHierarchy(this);
+        transformsDirty_ = true;
+    }
+    else
+        transformHierarchy_.Reset();
+}
+
 void Scene::SetElapsedTime(float time)
 {
     elapsedTime_ = time;
@@ -771,15 +811,18 @@ void Scene::Update(float timeStep)
 
     timeStep *= timeScale_;
 
+    // Update variable timestep logic
+    SceneUpdateEvent updateEvent;
+    updateEvent.scene_ = this;
+    updateEvent.timeStep_ = timeStep;
+    SendTypedEvent(updateEvent);
+
     using namespace SceneUpdate;
 
     VariantMap& eventData = GetEventDataMap();
     eventData[P_SCENE] = this;
     eventData[P_TIMESTEP] = timeStep;
 
-    // Update variable timestep logic
-    SendEvent(E_SCENEUPDATE, eventData);
-
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
@@ -801,7 +844,10 @@ void Scene::Update(float timeStep)
     }
 
     // Post-update variable timestep logic
-    SendEvent(E_SCENEPOSTUPDATE, eventData);
+    ScenePostUpdateEvent postUpdateEvent;
+    postUpdateEvent.scene_ = this;
+    postUpdateEvent.timeStep_ = timeStep;
+    SendTypedEvent(postUpdateEvent);
 
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
@@ -839,6 +885,26 @@ void Scene::DelayedMarkedDirty(Component* component)
     delayedDirtyComponents_.Push(component);
 }
 
+void Scene::UpdateTransforms()
+{
+    if (!transformHierarchy_ || !transformsDirty_)
+        return;
+
+    URHO3D_PROFILE(UpdateTransforms);
+
+    transformsDirty_ = false;
+    transformHierarchy_->Update();
+}
+
+void Scene::MarkTransformHierarchyDirty()
+{
+    if (transformHierarchy_)
+    {
+        transformHierarchy_->MarkHierarchyDirty();
+        transformsDirty_ = true;
+    }
+}
+
 unsigned Scene::GetFreeNodeID(CreateMode mode)
 {
     if (mode == REPLICATED)
@@ -985,12 +1051,14 @@ void Scene::NodeRemoved(Node* node)
     if (Scene::IsReplicatedID(id))
     {
         replicatedNodes_.Erase(id);
+        node->SetInNetworkGrid(false);
         MarkReplicationDirty(node);
     }
     else
         localNodes_.Erase(id);
 
     node->ResetScene();
+    MarkTransformHierarchyDirty();
 
     // Remove node from tag cache
     if (!node->GetTags().Empty())
@@ -1090,6 +1158,41 @@ String Scene::GetVarNamesAttr() const
 
 void Scene::PrepareNetworkUpdate()
 {
+    // Resolve the world positions used for interest management now. The connections check the priorities in worker
+    // threads, where updating a dirty world transform would race with the other connections.
+    // Nodes whose priority drops to zero at a fixed distance also go into the interest management grid, so that each
+    // connection only needs to check those of them that are near its observer
+    for (HashMap<unsigned long long, PODVector<unsigned> >::Iterator i = networkGrid_.Begin(); i != networkGrid_.End(); ++i)
+        i->second_.Clear();
+    networkGridRadius_ = 0.0f;
+    numNetworkGridNodes_ = 0;
+
+    for (HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    {
+        Node* node = i->second_;
+        NetworkPriority* priority = node->GetNetworkPriority();
+        if (!priority)
+        {
+            node->SetInNetworkGrid(false);
+            continue;
+        }
+
+        node->UpdateNetworkPosition();
+
+        // The scene is always checked first by the connections, so it is never in the grid
+        float relevanceDistance = priority->GetRelevanceDistance();
+        bool inGrid = node != this && relevanceDistance < M_INFINITY;
+        node->SetInNetworkGrid(inGrid);
+        if (inGrid)
+        {
+            const Vector3& position = node->GetNetworkPosition();
+            networkGrid_[GetNetworkGridKey(GetNetworkGridCoordinate(position.x_, networkGridCellSize_),
+                GetNetworkGridCoordinate(position.z_, networkGridCellSize_))].Push(node->GetID());
+            networkGridRadius_ = Max(networkGridRadius_, relevanceDistance);
+            ++numNetworkGridNodes_;
+        }
+    }
+
     for (HashSet<unsigned>::Iterator i = networkUpdateNodes_.Begin(); i != networkUpdateNodes_.End(); ++i)
     {
         Node* node = GetNode(*i);
@@ -1108,6 +1211,42 @@ void Scene::PrepareNetworkUpdate()
     networkUpdateComponents_.Clear();
 }
 
+void Scene::GetNetworkGridNodes(PODVector<unsigned>& dest, const Vector3& position) const
+{
+    dest.Clear();
+    if (!numNetworkGridNodes_)
+        return;
+
+    int minX = GetNetworkGridCoordinate(position.x_ - networkGridRadius_, networkGridCellSize_);
+    int maxX = GetNetworkGridCoordinate(position.x_ + networkGridRadius_, networkGridCellSize_);
+    int minZ = GetNetworkGridCoordinate(position.z_ - networkGridRadius_, networkGridCellSize_);
+    int maxZ = GetNetworkGridCoordinate(position.z_ + networkGridRadius_, networkGridCellSize_);
+
+    // If the search area covers more cells than there are in use, go through the used cells instead
+    if ((double)(maxX - minX + 1) * (double)(maxZ - minZ + 1) > (double)networkGrid_.Size())
+    {
+        for (HashMap<unsigned long long, PODVector<unsigned> >::ConstIterator i = networkGrid_.Begin(); i != networkGrid_.End(); ++i)
+        {
+            auto x = (int)(unsigned)(i->first_ >> 32u);
+            auto z = (int)(unsigned)(i->first_ & 0xffffffffu);
+            if (x >= minX && x <= maxX && z >= minZ && z <= maxZ)
+                dest.Push(i->second_);
+        }
+    }
+    else
+    {
+        for (int z = minZ; z <= maxZ; ++z)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                HashMap<unsigned long long, PODVector<unsigned> >::ConstIterator i = networkGrid_.Find(GetNetworkGridKey(x, z));
+                if (i != networkGrid_.End())
+                    dest.Push(i->second_);
+            }
+        }
+    }
+}
+
 void Scene::CleanupConnection(Connection* connection)
 {
     Node::CleanupConnection(connection);
@@ -1161,13 +1300,28 @@ void Scene::MarkReplicationDirty(Node* node)
     }
 }
 
-void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void SceneTimeStepEventData::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace SceneUpdate;
+
+    eventData[P_SCENE] = scene_;
+    eventData[P_TIMESTEP] = timeStep_;
+}
+
+void SceneTimeStepEventData::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace SceneUpdate;
+
+    scene_ = static_cast<Scene*>(GetEventParam(eventData, P_SCENE).GetPtr());
+    timeStep_ = GetEventParam(eventData, P_TIMESTEP).GetFloat();
+}
+
+void Scene::HandleUpdate(UpdateEvent& eventData)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace Update;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(eventData.timeStep_);
 }
 
 void Scene::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData)
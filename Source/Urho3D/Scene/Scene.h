@@ -34,6 +34,8 @@ namespace Urho3D
 
 class File;
 class PackageFile;
+class TransformHierarchy;
+struct UpdateEvent;
 
 static const unsigned FIRST_REPLICATED_ID = 0x1;
 static const unsigned LAST_REPLICATED_ID = 0xffffff;
@@ -154,6 +156,10 @@ public:
     void SetSnapThreshold(float threshold);
     /// Set maximum milliseconds per frame to spend on async scene loading.
     void SetAsyncLoadingMs(int ms);
+    /// Set cell size of the network interest management grid. Default 100.
+    void SetNetworkGridCellSize(float size);
+    /// Enable or disable batched world transform updates. When enabled, the scene keeps its nodes in a depth-ordered structure-of-arrays store and resolves dirty world transforms level by level in worker threads before rendering. Default false.
+    void SetBatchedTransforms(bool enable);
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -205,6 +211,12 @@ public:
     /// Return maximum milliseconds per frame to spend on async loading.
     int GetAsyncLoadingMs() const { return asyncLoadingMs_; }
 
+    /// Return cell size of the network interest management grid.
+    float GetNetworkGridCellSize() const { return networkGridCellSize_; }
+
+    /// Return whether batched world transform updates are enabled.
+    bool GetBatchedTransforms() const { return transformHierarchy_.NotNull(); }
+
     /// Return required package files.
     const Vector<SharedPtr<PackageFile> >& GetRequiredPackageFiles() const { return requiredPackageFiles_; }
 
@@ -219,6 +231,12 @@ public:
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Resolve dirty world transforms if batched transform updates are enabled. Called by Octree before rendering. Must be called from the main thread.
+    void UpdateTransforms();
+    /// Mark that some node has a dirty world transform. Called by Node.
+    void MarkTransformsDirty() { transformsDirty_ = true; }
+    /// Mark that the node hierarchy has changed. Called by Node.
+    void MarkTransformHierarchyDirty();
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
@@ -247,8 +265,10 @@ public:
     void SetVarNamesAttr(const String& value);
     /// Return node user variable reverse mappings.
     String GetVarNamesAttr() const;
-    /// Prepare network update by comparing attributes and marking replication states dirty as necessary.
+    /// Prepare network update by capturing the interest management positions, rebuilding the interest management grid, comparing attributes and marking replication states dirty as necessary.
     void PrepareNetworkUpdate();
+    /// Return IDs of the interest management grid nodes in the cells near a position. Safe to call from worker threads during the network update.
+    void GetNetworkGridNodes(PODVector<unsigned>& dest, const Vector3& position) const;
     /// Clean up all references to a network connection that is about to be removed.
     void CleanupConnection(Connection* connection);
     /// Mark a node for attribute check on the next network update.
@@ -260,7 +280,7 @@ public:
 
 private:
     /// Handle the logic update event to update the scene, if active.
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleUpdate(UpdateEvent& eventData);
     /// Handle a background loaded resource completing.
     void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
     /// Update asynchronous loading.
@@ -308,6 +328,10 @@ private:
     Mutex sceneMutex_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
+    /// Network interest management grid cells by packed cell coordinates. Contain IDs of replicated nodes whose priority drops to zero at a fixed distance.
+    HashMap<unsigned long long, PODVector<unsigned> > networkGrid_;
+    /// Depth-ordered transform store for batched transform updates.
+    UniquePtr<TransformHierarchy> transformHierarchy_;
     /// Next free non-local node ID.
     unsigned replicatedNodeID_;
     /// Next free non-local component ID.
@@ -328,12 +352,20 @@ private:
     float smoothingConstant_;
     /// Motion smoothing snap threshold.
     float snapThreshold_;
+    /// Network interest management grid cell size.
+    float networkGridCellSize_;
+    /// Largest relevance distance of the nodes in the network interest management grid.
+    float networkGridRadius_;
+    /// Number of nodes in the network interest management grid.
+    unsigned numNetworkGridNodes_;
     /// Update enabled flag.
     bool updateEnabled_;
     /// Asynchronous loading flag.
     bool asyncLoading_;
     /// Threaded update flag.
     bool threadedUpdate_;
+    /// Dirty world transforms flag. May be set from worker threads.
+    volatile bool transformsDirty_;
 };
 
 /// Register Scene library objects.
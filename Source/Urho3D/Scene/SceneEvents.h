@@ -27,6 +27,8 @@
 namespace Urho3D
 {
 
+class Scene;
+
 /// Variable timestep scene update.
 URHO3D_EVENT(E_SCENEUPDATE, SceneUpdate)
 {
@@ -93,6 +95,34 @@ URHO3D_EVENT(E_SCENEPOSTUPDATE, ScenePostUpdate)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Typed event data with scene and timestep parameters.
+struct URHO3D_API SceneTimeStepEventData
+{
+    /// Convert to VariantMap event data.
+    void ToVariantMap(VariantMap& eventData) const;
+    /// Convert from VariantMap event data.
+    void FromVariantMap(const VariantMap& eventData);
+
+    /// Scene being updated.
+    Scene* scene_;
+    /// Scaled timestep in seconds.
+    float timeStep_;
+};
+
+/// Typed variable timestep scene update.
+struct SceneUpdateEvent : public SceneTimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_SCENEUPDATE; }
+};
+
+/// Typed variable timestep scene post-update.
+struct ScenePostUpdateEvent : public SceneTimeStepEventData
+{
+    /// Return event type.
+    static StringHash GetEventType() { return E_SCENEPOSTUPDATE; }
+};
+
 /// Asynchronous scene loading progress.
 URHO3D_EVENT(E_ASYNCLOADPROGRESS, AsyncLoadProgress)
 {
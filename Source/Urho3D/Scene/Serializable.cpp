@@ -725,6 +725,8 @@ void Serializable::AllocateNetworkState()
 
     if (networkState_->currentValues_.Size() != numAttributes)
     {
+        networkState_->sharedDeltaUpdate_.Clear();
+        networkState_->sharedLatestDataUpdate_.Clear();
         networkState_->currentValues_.Resize(numAttributes);
         networkState_->previousValues_.Resize(numAttributes);
 
@@ -785,6 +787,15 @@ void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attribute
     // First write the change bitfield, then attribute data for changed attributes
     // Note: the attribute bits should not contain LATESTDATA attributes
     dest.WriteUByte(timeStamp);
+
+    // Use the shared encoding if it was prepared for the same attributes
+    const VectorBuffer& shared = networkState_->sharedDeltaUpdate_;
+    if (shared.GetSize() && attributeBits == networkState_->sharedDeltaBits_)
+    {
+        dest.Write(shared.GetData(), shared.GetSize());
+        return;
+    }
+
     dest.Write(attributeBits.data_, (numAttributes + 7) >> 3);
 
     for (unsigned i = 0; i < numAttributes; ++i)
@@ -810,6 +821,13 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
 
     dest.WriteUByte(timeStamp);
 
+    const VectorBuffer& shared = networkState_->sharedLatestDataUpdate_;
+    if (shared.GetSize())
+    {
+        dest.Write(shared.GetData(), shared.GetSize());
+        return;
+    }
+
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributes->At(i).mode_ & AM_LATESTDATA)
@@ -817,6 +835,56 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
     }
 }
 
+void Serializable::PrepareSharedNetworkUpdates(const DirtyBits& changedAttributes)
+{
+    if (!networkState_)
+        return;
+
+    // The current values change now, so any previous encoding is invalid
+    networkState_->sharedDeltaUpdate_.Clear();
+    networkState_->sharedLatestDataUpdate_.Clear();
+
+    // Encoding once only pays off if several connections replicate this object
+    const Vector<AttributeInfo>* attributes = networkState_->attributes_;
+    if (!attributes || !changedAttributes.Count() || networkState_->replicationStates_.Size() < 2)
+        return;
+
+    unsigned numAttributes = attributes->Size();
+    DirtyBits deltaBits = changedAttributes;
+    bool hasLatestData = false;
+
+    for (unsigned i = 0; i < numAttributes; ++i)
+    {
+        if (deltaBits.IsSet(i) && (attributes->At(i).mode_ & AM_LATESTDATA))
+        {
+            hasLatestData = true;
+            deltaBits.Clear(i);
+        }
+    }
+
+    if (deltaBits.Count())
+    {
+        VectorBuffer& dest = networkState_->sharedDeltaUpdate_;
+        dest.Write(deltaBits.data_, (numAttributes + 7) >> 3);
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            if (deltaBits.IsSet(i))
+                dest.WriteVariantData(networkState_->currentValues_[i]);
+        }
+        networkState_->sharedDeltaBits_ = deltaBits;
+    }
+
+    if (hasLatestData)
+    {
+        VectorBuffer& dest = networkState_->sharedLatestDataUpdate_;
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            if (attributes->At(i).mode_ & AM_LATESTDATA)
+                dest.WriteVariantData(networkState_->currentValues_[i]);
+        }
+    }
+}
+
 bool Serializable::ReadDeltaUpdate(Deserializer& source)
 {
     const Vector<AttributeInfo>* attributes = GetNetworkAttributes();
@@ -103,6 +103,8 @@ public:
     void WriteDeltaUpdate(Serializer& dest, const DirtyBits& attributeBits, unsigned char timeStamp);
     /// Write a latest data network update.
     void WriteLatestDataUpdate(Serializer& dest, unsigned char timeStamp);
+    /// Encode the delta and latest data network updates for attributes that changed in the network update preparation. These are written as-is for every connection that needs exactly the same data.
+    void PrepareSharedNetworkUpdates(const DirtyBits& changedAttributes);
     /// Read and apply a network delta update. Return true if attributes were changed.
     bool ReadDeltaUpdate(Deserializer& source);
     /// Read and apply a network latest data update. Return true if attributes were changed.
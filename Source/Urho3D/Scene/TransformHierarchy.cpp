@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Scene/Scene.h"
+#include "../Scene/TransformHierarchy.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned NO_PARENT = M_MAX_UNSIGNED;
+
+TransformHierarchy::TransformHierarchy(Scene* scene) :
+    scene_(scene),
+    hierarchyDirty_(true)
+{
+}
+
+TransformHierarchy::~TransformHierarchy() = default;
+
+void TransformHierarchy::Update()
+{
+    if (hierarchyDirty_)
+        Rebuild();
+
+    auto* queue = scene_->GetSubsystem<WorkQueue>();
+    unsigned numLevels = GetNumLevels();
+
+    // Each level only reads the world transforms of the previous level, so the nodes within a level can be updated in parallel
+    for (unsigned i = 0; i < numLevels; ++i)
+    {
+        unsigned levelStart = levelStarts_[i];
+        unsigned levelEnd = levelStarts_[i + 1];
+
+        if (queue)
+        {
+            queue->ParallelFor(levelEnd - levelStart, 0, [&](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+            {
+                UpdateRange(levelStart + begin, levelStart + end);
+            }, &updateCost_);
+        }
+        else
+            UpdateRange(levelStart, levelEnd);
+    }
+}
+
+void TransformHierarchy::Rebuild()
+{
+    nodes_.Clear();
+    parents_.Clear();
+    levelStarts_.Clear();
+
+    // Breadth-first traversal puts every parent before its children and groups the nodes by depth
+    const Vector<SharedPtr<Node> >& rootChildren = scene_->GetChildren();
+    for (Vector<SharedPtr<Node> >::ConstIterator i = rootChildren.Begin(); i != rootChildren.End(); ++i)
+    {
+        nodes_.Push(*i);
+        parents_.Push(NO_PARENT);
+    }
+
+    unsigned levelStart = 0;
+    while (levelStart < nodes_.Size())
+    {
+        unsigned levelEnd = nodes_.Size();
+        levelStarts_.Push(levelStart);
+
+        for (unsigned i = levelStart; i < levelEnd; ++i)
+        {
+            const Vector<SharedPtr<Node> >& children = nodes_[i]->GetChildren();
+            for (Vector<SharedPtr<Node> >::ConstIterator j = children.Begin(); j != children.End(); ++j)
+            {
+                nodes_.Push(*j);
+                parents_.Push(i);
+            }
+        }
+
+        levelStart = levelEnd;
+    }
+    levelStarts_.Push(nodes_.Size());
+
+    worldTransforms_.Resize(nodes_.Size());
+    worldRotations_.Resize(nodes_.Size());
+    hierarchyDirty_ = false;
+}
+
+void TransformHierarchy::UpdateRange(unsigned start, unsigned end)
+{
+    for (unsigned i = start; i < end; ++i)
+    {
+        Node* node = nodes_[i];
+
+        // A dirty parent always has dirty children, so a clean node can just publish its transform for its children
+        if (node->dirty_)
+        {
+            unsigned parent = parents_[i];
+            if (parent == NO_PARENT)
+            {
+                node->worldTransform_ = node->GetTransform();
+                node->worldRotation_ = node->rotation_;
+            }
+            else
+            {
+                node->worldTransform_ = worldTransforms_[parent] * node->GetTransform();
+                node->worldRotation_ = worldRotations_[parent] * node->rotation_;
+            }
+            node->dirty_ = false;
+        }
+
+        worldTransforms_[i] = node->worldTransform_;
+        worldRotations_[i] = node->worldRotation_;
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Vector.h"
+#include "../Core/WorkQueue.h"
+#include "../Math/Matrix3x4.h"
+
+namespace Urho3D
+{
+
+class Node;
+class Scene;
+
+/// Structure-of-arrays store of a scene's node hierarchy for batched world transform updates. Nodes are stored in depth order, so that each depth level can be updated in parallel once its parent level is done. The nodes keep their transform API and remain the owners of their transforms; the store only resolves dirty world transforms eagerly.
+class URHO3D_API TransformHierarchy
+{
+public:
+    /// Construct.
+    explicit TransformHierarchy(Scene* scene);
+    /// Destruct.
+    ~TransformHierarchy();
+
+    /// Mark the hierarchy changed. The node order is rebuilt on the next update.
+    void MarkHierarchyDirty() { hierarchyDirty_ = true; }
+    /// Update the dirty world transforms of all nodes.
+    void Update();
+
+    /// Return number of nodes in the store.
+    unsigned GetNumNodes() const { return nodes_.Size(); }
+    /// Return number of depth levels.
+    unsigned GetNumLevels() const { return levelStarts_.Size() ? levelStarts_.Size() - 1 : 0; }
+
+private:
+    /// Rebuild the depth-ordered node arrays from the scene.
+    void Rebuild();
+    /// Update a range of nodes within one depth level.
+    void UpdateRange(unsigned start, unsigned end);
+
+    /// Scene.
+    Scene* scene_;
+    /// Nodes in depth order.
+    PODVector<Node*> nodes_;
+    /// Parent indices. M_MAX_UNSIGNED for children of the scene.
+    PODVector<unsigned> parents_;
+    /// Start indices of the depth levels, with the node count as the last element.
+    PODVector<unsigned> levelStarts_;
+    /// World transforms in depth order.
+    PODVector<Matrix3x4> worldTransforms_;
+    /// World rotations in depth order.
+    PODVector<Quaternion> worldRotations_;
+    /// Measured cost of the threaded update.
+    ParallelForCost updateCost_;
+    /// Hierarchy changed flag.
+    bool hierarchyDirty_;
+};
+
+}
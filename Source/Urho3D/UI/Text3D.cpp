@@ -362,7 +362,8 @@ void Text3D::SetFixedScreenSize(bool enable)
     {
         fixedScreenSize_ = enable;
 
-        // Bounding box must be recalculated
+        // Bounding box must be recalculated, and is recalculated for each camera during rendering
+        SetCameraDependentBounds(faceCameraMode_ != FC_NONE || fixedScreenSize_);
         OnMarkedDirty(node_);
         MarkNetworkUpdate();
     }
@@ -374,7 +375,8 @@ void Text3D::SetFaceCameraMode(FaceCameraMode mode)
     {
         faceCameraMode_ = mode;
 
-        // Bounding box must be recalculated
+        // Bounding box must be recalculated, and is recalculated for each camera during rendering
+        SetCameraDependentBounds(faceCameraMode_ != FC_NONE || fixedScreenSize_);
         OnMarkedDirty(node_);
         MarkNetworkUpdate();
     }
@@ -754,7 +756,7 @@ void Text3D::CalculateFixedScreenSize(const FrameInfo& frame)
 
     customWorldTransform_ = Matrix3x4(worldPosition, frame.camera_->GetFaceCameraRotation(
         worldPosition, node_->GetWorldRotation(), faceCameraMode_, minAngle_), worldScale);
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 }
@@ -1319,7 +1319,7 @@ UIElement* UIElement::CreateChild(StringHash type, const String& name, unsigned
     SharedPtr<UIElement> newElement = DynamicCast<UIElement>(context_->CreateObject(type));
     if (!newElement)
     {
-        URHO3D_LOGERROR("Could not create unknown UI element type " + type.ToString());
+        URHO3D_LOGERROR("Could not create unknown UI element type " + type.ToDebugString());
         return nullptr;
     }
 
@@ -30,6 +30,7 @@
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Material.h"
+#include "../Graphics/Octree.h"
 #include "../Graphics/OctreeQuery.h"
 #include "../Graphics/Technique.h"
 #include "../Graphics/Texture2D.h"
@@ -303,20 +304,6 @@ SharedPtr<Material> Renderer2D::CreateMaterial(Texture2D* texture, BlendMode ble
     return newMaterial;
 }
 
-void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex)
-{
-    auto* renderer = reinterpret_cast<Renderer2D*>(item->aux_);
-    auto** start = reinterpret_cast<Drawable2D**>(item->start_);
-    auto** end = reinterpret_cast<Drawable2D**>(item->end_);
-
-    while (start != end)
-    {
-        Drawable2D* drawable = *start++;
-        if (renderer->CheckVisibility(drawable))
-            drawable->MarkInView(renderer->frame_);
-    }
-}
-
 void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace BeginViewUpdate;
@@ -331,36 +318,28 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
 
     auto* camera = static_cast<Camera*>(eventData[P_CAMERA].GetPtr());
     frustum_ = camera->GetFrustum();
-    viewMask_ = camera->GetViewMask();
+    // Follow the camera's view mask. Mark the octant's packed view mask outdated when it changes, so that queries test it individually
+    unsigned viewMask = camera->GetViewMask();
+    if (viewMask != viewMask_)
+    {
+        viewMask_ = viewMask;
+        if (octant_)
+            octant_->MarkDrawableBoundsDirty(this);
+    }
 
     // Check visibility
     {
         URHO3D_PROFILE(CheckDrawableVisibility);
 
-        auto* queue = GetSubsystem<WorkQueue>();
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = drawables_.Size() / numWorkItems;
-
-        PODVector<Drawable2D*>::Iterator start = drawables_.Begin();
-        for (int i = 0; i < numWorkItems; ++i)
+        GetSubsystem<WorkQueue>()->ParallelFor(drawables_.Size(), 0, [&](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckDrawableVisibilityWork;
-            item->aux_ = this;
-
-            PODVector<Drawable2D*>::Iterator end = drawables_.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
-        queue->Complete(M_MAX_UNSIGNED);
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable2D* drawable = drawables_[i];
+                if (CheckVisibility(drawable))
+                    drawable->MarkInView(frame_);
+            }
+        }, &visibilityCost_);
     }
 
     ViewBatchInfo2D& viewBatchInfo = viewBatchInfos_[camera];
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Drawable.h"
 #include "../Math/Frustum.h"
 
@@ -69,8 +70,6 @@ class URHO3D_API Renderer2D : public Drawable
 {
     URHO3D_OBJECT(Renderer2D, Drawable);
 
-    friend void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex);
-
 public:
     /// Construct.
     explicit Renderer2D(Context* context);
@@ -121,6 +120,8 @@ private:
     PODVector<Drawable2D*> drawables_;
     /// View frame info for current frame.
     FrameInfo frame_;
+    /// Measured cost of the threaded visibility check.
+    ParallelForCost visibilityCost_;
     /// View batch info.
     HashMap<Camera*, ViewBatchInfo2D> viewBatchInfos_;
     /// Frustum for current frame.